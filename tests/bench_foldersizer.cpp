@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        bench_foldersizer.cpp
+// Purpose:     Benchmark of wxExplorerBrowserFolderSizer and of cancelling it
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+using wxExplorerBrowserTesting::GetMilliseconds;
+using wxExplorerBrowserTesting::TempDirectory;
+
+// usage: bench_foldersizer [directories]
+int main(int argc, char** argv)
+{
+    const int directoryCount = argc > 1 ? atoi(argv[1]) : 2000;
+    const int filesPerDirectory = 10;
+    TempDirectory dir("bench_foldersizer_tree");
+    wxArrayString folders;
+
+    for ( int i = 0; i < directoryCount; ++i )
+    {
+        for ( int j = 0; j < filesPerDirectory; ++j )
+            dir.AddFile(wxString::Format(wxS("d%03d/s%d/f%d.txt"), i % 100, i, j).utf8_str(), "data");
+    }
+    folders.push_back(dir.GetPath());
+
+    for ( unsigned threadCount : { 1u, 2u, 0u } )
+    {
+        wxExplorerBrowserFolderSizer sizer(threadCount);
+        const double start = GetMilliseconds();
+
+        sizer.Start(folders);
+        sizer.Wait();
+
+        const wxExplorerBrowserFolderSizer::Totals totals = sizer.GetTotals();
+
+        printf("%u threads: %llu files, %llu folders, %llu bytes in %.1f ms\n", threadCount,
+               static_cast<unsigned long long>(totals.fileCount), static_cast<unsigned long long>(totals.folderCount),
+               static_cast<unsigned long long>(totals.size), GetMilliseconds() - start);
+    }
+
+    // the time the UI thread is blocked by cancelling a running computation,
+    // waiting for the walk to stop as before or leaving it to another thread
+    const int rounds = 20;
+    double waited = 0, detached = 0;
+    wxExplorerBrowserReaper reaper;
+
+    for ( int i = 0; i < rounds; ++i )
+    {
+        std::unique_ptr<wxExplorerBrowserFolderSizer> sizer(new wxExplorerBrowserFolderSizer());
+
+        sizer->Start(folders);
+        while ( sizer->GetTotals().fileCount < 1000 )
+            std::this_thread::yield();
+
+        double start = GetMilliseconds();
+
+        sizer->Cancel();
+        sizer->Wait();
+        waited += GetMilliseconds() - start;
+
+        sizer.reset(new wxExplorerBrowserFolderSizer());
+        sizer->Start(folders);
+        while ( sizer->GetTotals().fileCount < 1000 )
+            std::this_thread::yield();
+
+        start = GetMilliseconds();
+        sizer->Cancel();
+        reaper.Destroy(std::move(sizer));
+        detached += GetMilliseconds() - start;
+    }
+
+    // the walks finish before the tree is removed
+    reaper.Shutdown();
+
+    printf("cancelling: %.3f ms waiting for the walk, %.3f ms destroying it on another thread (average of %d)\n",
+           waited / rounds, detached / rounds, rounds);
+
+    return 0;
+}
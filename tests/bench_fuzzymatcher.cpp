@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        bench_fuzzymatcher.cpp
+// Purpose:     Benchmark of wxExplorerBrowserFuzzyMatcher searching a large
+//              listing, against scoring each name on its own
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+using wxExplorerBrowserTesting::GetMilliseconds;
+
+// usage: bench_fuzzymatcher [items]
+int main(int argc, char** argv)
+{
+    const size_t count = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 100000;
+    const size_t maxResults = 50;
+    wxExplorerBrowserItem::List items(count, wxExplorerBrowserItem(wxExplorerBrowserItem::File));
+
+    static const char* const words[] = { "Project", "Report", "invoice", "IMG", "backup", "Budget", "notes",
+                                         "draft", "final", "meeting", "Scan", "photo" };
+    static const char* const extensions[] = { ".xlsx", ".docx", ".jpg", ".pdf", ".txt", ".zip" };
+
+    srand(1);
+    for ( size_t i = 0; i < count; ++i )
+    {
+        const wxString name = wxString(words[rand() % 12]) + wxS("_") + wxString(words[rand() % 12])
+                              + wxString::Format(wxS("_%d"), 2000 + rand() % 30) + wxString(extensions[rand() % 6]);
+
+        items[i].SetDisplayName(name);
+    }
+
+    wxExplorerBrowserFuzzyMatcher matcher;
+    double start = GetMilliseconds();
+
+    matcher.SetItems(items);
+
+    printf("%zu names folded in %.1f ms, %zu kB\n", count, GetMilliseconds() - start, matcher.GetMemoryUsage() / 1024);
+
+    // typed one character after another, as in the quick find box
+    const wxString typed[] = { wxS("prjrpt2023x"), wxS("invfinal"), wxS("zzz"), wxS("scan_photo_2029.pdf") };
+    wxExplorerBrowserFuzzyMatcher::Matches matches;
+
+    for ( const auto& text : typed )
+    {
+        double found = 0, scored = 0;
+        size_t foundCount = 0, scoredCount = 0;
+
+        for ( size_t length = 1; length <= text.length(); ++length )
+        {
+            const wxString pattern = text.substr(0, length);
+
+            start = GetMilliseconds();
+            foundCount = matcher.Find(pattern, maxResults, matches);
+            found += GetMilliseconds() - start;
+
+            // the matching names scored one by one, as without the folded buffers
+            start = GetMilliseconds();
+            scoredCount = 0;
+            for ( const auto& item : items )
+                scoredCount += wxExplorerBrowserFuzzyMatcher::Score(pattern, item.GetDisplayName()) >= 0;
+            scored += GetMilliseconds() - start;
+        }
+
+        printf("\"%s\" typed: Find() %.2f ms per key, %zu shown; scoring each name %.2f ms per key, %zu matching\n",
+               static_cast<const char*>(text.utf8_str()), found / text.length(), foundCount,
+               scored / text.length(), scoredCount);
+    }
+
+    return 0;
+}
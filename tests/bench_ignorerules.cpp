@@ -0,0 +1,85 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        bench_ignorerules.cpp
+// Purpose:     Benchmark of matching the items of a folder with
+//              wxExplorerBrowserIgnoreRules
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+using wxExplorerBrowserTesting::GetMilliseconds;
+using wxExplorerBrowserTesting::TempDirectory;
+
+// usage: bench_ignorerules [items]
+int main(int argc, char** argv)
+{
+    const size_t count = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 200000;
+    const int rounds = 5;
+    TempDirectory dir("bench_ignorerules_tree");
+
+    // a typical .gitignore with literal names, wild-cards and more patterns than
+    // the bits of a word, applying to a folder two levels below it
+    std::string contents = "node_modules/\nbuild/\n.vs/\n*.obj\n*.pdb\n*.log\n!important.log\n"
+                           "**/cache/*.tmp\nout[0-9]*\nThumbs.db\n";
+
+    for ( int i = 0; i < 80; ++i )
+        contents += wxString::Format(wxS("*.gen%d\n"), i).utf8_str().data();
+
+    dir.AddFile(".gitignore", contents);
+    dir.AddFile("src/.gitignore", "*.bak\n");
+    dir.AddDirectory("src/module");
+
+    const wxString folder = dir.GetPath("src/module");
+    std::vector<wxString> names, paths;
+
+    for ( size_t i = 0; i < count; ++i )
+    {
+        static const char* const extensions[] = { ".cpp", ".h", ".obj", ".log", ".gen7", ".txt", ".bak", "" };
+
+        names.push_back(wxString::Format(wxS("source_file_%zu"), i) + wxString(extensions[i % 8]));
+        paths.push_back(folder + wxFILE_SEP_PATH + names.back());
+    }
+
+    wxExplorerBrowserIgnoreRules rules;
+    double byPath = 0, loaded = 0, loading = 0;
+    size_t ignoredByPath = 0, ignoredLoaded = 0;
+
+    for ( int round = 0; round < rounds; ++round )
+    {
+        // as ShouldShow() did: the path of each item, the rules looked up by its directory
+        rules.Set(dir.GetPath());
+
+        double start = GetMilliseconds();
+
+        for ( const auto& path : paths )
+            ignoredByPath += rules.IsIgnored(path, false);
+        byPath += GetMilliseconds() - start;
+
+        // as it does now: the rules of the folder got when navigating to it
+        rules.Set(dir.GetPath());
+        start = GetMilliseconds();
+
+        const wxExplorerBrowserIgnoreRules::DirectoryRulesPtr folderRules = rules.GetDirectoryRules(folder);
+
+        loading += GetMilliseconds() - start;
+
+        wxExplorerBrowserIgnoreRules::DirectoryRules::Buffer buffer;
+
+        start = GetMilliseconds();
+        for ( const auto& name : names )
+            ignoredLoaded += folderRules->IsIgnored(name, false, buffer);
+        loaded += GetMilliseconds() - start;
+    }
+
+    printf("%zu items, %zu ignored (average of %d)\n", count, ignoredByPath / rounds, rounds);
+    printf("by path, reading the files for the first item: %.1f ms, %.0f ns per item\n",
+           byPath / rounds, byPath * 1e6 / rounds / count);
+    printf("loading the rules of the folder: %.3f ms\n", loading / rounds);
+    printf("with the rules of the folder: %.1f ms, %.0f ns per item, %zu ignored\n",
+           loaded / rounds, loaded * 1e6 / rounds / count, ignoredLoaded / rounds);
+
+    return 0;
+}
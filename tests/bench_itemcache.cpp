@@ -0,0 +1,62 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        bench_itemcache.cpp
+// Purpose:     Benchmark of wxExplorerBrowserItemCache shared by several threads
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+using wxExplorerBrowserTesting::GetMilliseconds;
+
+// usage: bench_itemcache [lookups per thread]
+int main(int argc, char** argv)
+{
+    const size_t lookups = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 1000000;
+    const wxUint64 keyCount = 50000; // a few large folders shown by all the panes
+    wxExplorerBrowserItemCache cache;
+
+    for ( wxUint64 key = 0; key < keyCount; ++key )
+    {
+        wxExplorerBrowserItem item(wxExplorerBrowserItem::File);
+        const wxString name = wxString::Format(wxS("file%08llu.txt"), static_cast<unsigned long long>(key));
+
+        item.SetPath(wxS("C:\\Users\\Public\\Documents\\") + name);
+        item.SetDisplayName(name);
+        cache.Insert(key * 0x9E3779B97F4A7C15ULL, key % 16, item);
+    }
+
+    printf("%llu items cached, %zu kB\n", static_cast<unsigned long long>(keyCount), cache.GetMemoryUsage() / 1024);
+
+    // one thread per pane, up to 12 panes
+    for ( size_t threadCount : { 1, 2, 4, 8, 12 } )
+    {
+        std::vector<std::thread> threads;
+        const double start = GetMilliseconds();
+
+        for ( size_t t = 0; t < threadCount; ++t )
+        {
+            threads.push_back(std::thread([&cache, lookups, keyCount, t]()
+            {
+                wxExplorerBrowserItem item;
+
+                for ( size_t i = 0; i < lookups; ++i )
+                    cache.Lookup(((i * 7919 + t * 104729) % keyCount) * 0x9E3779B97F4A7C15ULL, item);
+            }));
+        }
+
+        for ( auto& thread : threads )
+            thread.join();
+
+        const double elapsed = GetMilliseconds() - start;
+
+        printf("%2zu threads: %.1f ms, %.2f M lookups/s\n",
+               threadCount, elapsed, threadCount * lookups / elapsed / 1000);
+    }
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        bench_itemproperties.cpp
+// Purpose:     Benchmark of fetching item properties in chunks, in the calling
+//              thread and on a background thread
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+using wxExplorerBrowserTesting::GetMilliseconds;
+
+namespace {
+
+// most items are local files, every 100th one is slow like a cloud file
+void FetchChunk(size_t begin, size_t end, wxExplorerBrowserItemProperties& properties)
+{
+    for ( size_t i = begin; i < end; ++i )
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(i % 100 ? 20 : 2000));
+        properties.GetSizes()[i] = i;
+        properties.SetFetched(i, wxExplorerBrowserItemProperties::Property_Size);
+    }
+}
+
+} // unnamed namespace
+
+// usage: bench_itemproperties [items]
+int main(int argc, char** argv)
+{
+    const size_t count = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 5000;
+    wxExplorerBrowserItemProperties properties;
+
+    printf("%zu items, %u pool workers\n", count, wxExplorerBrowserThreadPool::Get().GetWorkerCount());
+
+    // GetItemProperties(): the UI thread waits for all of them
+    properties.Reset(count, wxExplorerBrowserItemProperties::Property_Size);
+
+    double start = GetMilliseconds();
+
+    wxExplorerBrowserParallelForChunks(count, 64, [&properties](size_t begin, size_t end)
+                                       { FetchChunk(begin, end, properties); });
+    printf("in the calling thread: blocked for %.1f ms\n", GetMilliseconds() - start);
+
+    // RequestItemProperties(): the UI thread only starts the background thread
+    properties.Reset(count, wxExplorerBrowserItemProperties::Property_Size);
+    start = GetMilliseconds();
+
+    std::thread thread([&properties, count]()
+    {
+        wxExplorerBrowserParallelForChunks(count, 64, [&properties](size_t begin, size_t end)
+                                           { FetchChunk(begin, end, properties); });
+    });
+
+    const double blocked = GetMilliseconds() - start;
+
+    thread.join();
+    printf("on a background thread: blocked for %.3f ms, done after %.1f ms\n", blocked, GetMilliseconds() - start);
+
+    return 0;
+}
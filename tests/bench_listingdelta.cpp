@@ -0,0 +1,68 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        bench_listingdelta.cpp
+// Purpose:     Benchmark of wxExplorerBrowserListingFingerprint
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+using wxExplorerBrowserTesting::GetMilliseconds;
+
+namespace {
+
+wxExplorerBrowserItem::List MakeListing(size_t count)
+{
+    wxExplorerBrowserItem::List items;
+
+    items.reserve(count);
+    for ( size_t i = 0; i < count; ++i )
+    {
+        wxExplorerBrowserItem item(wxExplorerBrowserItem::File);
+        const wxString name = wxString::Format(wxS("file%08zu.txt"), i);
+
+        item.SetPath(wxS("C:\\Users\\Public\\Documents\\") + name);
+        item.SetDisplayName(name);
+        items.push_back(item);
+    }
+
+    return items;
+}
+
+} // unnamed namespace
+
+// usage: bench_listingdelta [item count]
+int main(int argc, char** argv)
+{
+    const size_t count = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 1000000;
+    wxExplorerBrowserItem::List items = MakeListing(count);
+    wxExplorerBrowserListingFingerprint fingerprint;
+    wxExplorerBrowserListingDelta delta;
+
+    double start = GetMilliseconds();
+    fingerprint.Update(items, nullptr);
+    printf("first listing of %zu items: %.1f ms\n", count, GetMilliseconds() - start);
+
+    // one item in a hundred renamed, removed, or added
+    for ( size_t i = 0; i + 2 < items.size(); i += 300 )
+    {
+        items[i].SetDisplayName(wxS("renamed"));
+        items[i + 1].SetPath(wxString::Format(wxS("C:\\Users\\Public\\Documents\\added%zu"), i));
+        items.erase(items.begin() + i + 2);
+    }
+
+    start = GetMilliseconds();
+    fingerprint.Update(items, &delta);
+    printf("delta of %zu items: %.1f ms (added %zu, removed %zu, changed %zu)\n",
+           items.size(), GetMilliseconds() - start, delta.added.size(), delta.removed.size(), delta.changed.size());
+
+    start = GetMilliseconds();
+    fingerprint.Update(std::move(items), &delta);
+    printf("unchanged listing taken over: %.1f ms\n", GetMilliseconds() - start);
+
+    printf("memory usage: %zu kB\n", fingerprint.GetMemoryUsage() / 1024);
+
+    return 0;
+}
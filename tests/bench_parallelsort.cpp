@@ -0,0 +1,69 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        bench_parallelsort.cpp
+// Purpose:     Benchmark of wxExplorerBrowserParallelSort and of the calls
+//              of wxExplorerBrowserParallelFor on the thread pool
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+using wxExplorerBrowserTesting::GetMilliseconds;
+
+// usage: bench_parallelsort [values to sort]
+int main(int argc, char** argv)
+{
+    const size_t count = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 2000000;
+    std::mt19937_64 random(38);
+    std::vector<wxUint64> values(count);
+
+    for ( auto& value : values )
+        value = random();
+
+    printf("%zu values, %u cores, %u pool workers\n", count, std::thread::hardware_concurrency(),
+           wxExplorerBrowserThreadPool::Get().GetWorkerCount());
+
+    std::vector<wxUint64> sorted = values;
+    double start = GetMilliseconds();
+
+    std::stable_sort(sorted.begin(), sorted.end());
+    printf("std::stable_sort: %.1f ms\n", GetMilliseconds() - start);
+
+    for ( unsigned threadCount : { 1u, 2u, 4u, 8u } )
+    {
+        std::vector<wxUint64> copy = values;
+
+        start = GetMilliseconds();
+        wxExplorerBrowserParallelSort(copy.begin(), copy.end(), std::less<wxUint64>(), threadCount);
+        printf("ParallelSort, %u threads: %.1f ms%s\n", threadCount, GetMilliseconds() - start,
+               copy == sorted ? "" : " (WRONG)");
+    }
+
+    // the fixed cost of a call, paid by every sort of a small folder and every merge round
+    const size_t calls = 10000;
+    std::vector<std::thread> threads;
+
+    start = GetMilliseconds();
+    for ( size_t i = 0; i < calls; ++i )
+    {
+        for ( unsigned t = 0; t < 3; ++t )
+            threads.push_back(std::thread([]() {}));
+        for ( auto& thread : threads )
+            thread.join();
+        threads.clear();
+    }
+    printf("%zu x 4 ranges on new threads: %.2f us per call\n", calls, (GetMilliseconds() - start) * 1000 / calls);
+
+    start = GetMilliseconds();
+    for ( size_t i = 0; i < calls; ++i )
+        wxExplorerBrowserParallelFor(4, [](size_t, size_t) {}, 4, 1);
+    printf("%zu x 4 ranges on the pool: %.2f us per call\n", calls, (GetMilliseconds() - start) * 1000 / calls);
+
+    return 0;
+}
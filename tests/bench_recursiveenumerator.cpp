@@ -0,0 +1,82 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        bench_recursiveenumerator.cpp
+// Purpose:     Benchmark of the batches of wxExplorerBrowserRecursiveEnumerator
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <climits>
+#include <cstdlib>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+using wxExplorerBrowserTesting::GetMilliseconds;
+using wxExplorerBrowserTesting::TempDirectory;
+
+namespace {
+
+// polls the items as wxExplorerBrowser does and prints how long
+// the items found waited on average before they could be taken
+void Poll(const wxString& root, const wxExplorerBrowserMaskMatcher& filter, unsigned maxBatchDelay,
+          const char* description)
+{
+    wxExplorerBrowserRecursiveEnumerator enumerator;
+    wxExplorerBrowserItem::List items;
+    double waited = 0; // in item-milliseconds
+
+    const double start = GetMilliseconds();
+    double last = start;
+
+    enumerator.Start(root, wxExplorerBrowserItem::File, filter, 0, 256, maxBatchDelay);
+    while ( enumerator.IsRunning() )
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        enumerator.TakeItems(items);
+
+        const double now = GetMilliseconds();
+
+        waited += (enumerator.GetFoundCount() - items.size()) * (now - last);
+        last = now;
+    }
+
+    const double elapsed = GetMilliseconds() - start;
+
+    enumerator.TakeItems(items);
+
+    printf("%s: %zu items in %.1f ms, found items not available for %.1f ms on average\n",
+           description, items.size(), elapsed, items.empty() ? 0. : waited / items.size());
+}
+
+} // unnamed namespace
+
+// usage: bench_recursiveenumerator [directories]
+int main(int argc, char** argv)
+{
+    const int directoryCount = argc > 1 ? atoi(argv[1]) : 10000;
+    TempDirectory dir("bench_recursiveenumerator_tree");
+
+    // one file in a hundred matches, so that the batches of 256 items fill up slowly
+    for ( int i = 0; i < directoryCount; ++i )
+    {
+        for ( int j = 0; j < 10; ++j )
+        {
+            const wxString path = wxString::Format(wxS("d%03d/s%d/f%d"), i % 100, i, j)
+                                  + ((i * 10 + j) % 100 == 0 ? wxS(".match") : wxS(".txt"));
+
+            dir.AddFile(path.utf8_str());
+        }
+    }
+
+    wxArrayString masks;
+
+    masks.push_back(wxS("*.match"));
+
+    const wxExplorerBrowserMaskMatcher rare(masks, wxExplorerBrowserItem::File);
+
+    Poll(dir.GetPath(), rare, UINT_MAX, "rare matches, batches taken only when full");
+    Poll(dir.GetPath(), rare, 10, "rare matches, incomplete batches taken after 10 ms");
+    Poll(dir.GetPath(), wxExplorerBrowserMaskMatcher(), UINT_MAX, "all files, batches taken only when full");
+    Poll(dir.GetPath(), wxExplorerBrowserMaskMatcher(), 10, "all files, incomplete batches taken after 10 ms");
+
+    return 0;
+}
@@ -0,0 +1,58 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        bench_resultinjector.cpp
+// Purpose:     Benchmark of wxExplorerBrowserResultInjector feeding a slow sink
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+using wxExplorerBrowserTesting::GetMilliseconds;
+
+// usage: bench_resultinjector [paths]
+int main(int argc, char** argv)
+{
+    const size_t count = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 200000;
+    wxArrayString paths;
+
+    for ( size_t i = 0; i < count; ++i )
+        paths.push_back(wxString::Format(wxS("C:\\Users\\Public\\Documents\\results\\file%08zu.txt"), i));
+
+    wxExplorerBrowserResultInjector injector;
+    double start = GetMilliseconds();
+
+    injector.AddPaths(paths, 0);
+    printf("%zu paths queued in %.1f ms, %zu kB\n", count, GetMilliseconds() - start,
+           injector.GetMemoryUsage() / 1024);
+
+    // a sink costing about as much as adding an item to a results folder
+    size_t sum = 0;
+    const auto sink = [&sum](const wxExplorerBrowserResultInjector::Entry& entry)
+        {
+            for ( int i = 0; i < 200; ++i )
+                sum += entry.path[i % entry.path.length()];
+            return true;
+        };
+    const auto clock = []() { return static_cast<wxUint64>(GetMilliseconds()); };
+
+    size_t batches = 0;
+    double longest = 0;
+
+    start = GetMilliseconds();
+    while ( injector.HasPending() )
+    {
+        const double batchStart = GetMilliseconds();
+
+        injector.ProcessBatch(sink, clock);
+        longest = std::max(longest, GetMilliseconds() - batchStart);
+        ++batches;
+    }
+
+    printf("%zu batches in %.1f ms (without the intervals), the longest %.2f ms for the 15 ms limit (%zu)\n",
+           batches, GetMilliseconds() - start, longest, sum % 10);
+
+    return 0;
+}
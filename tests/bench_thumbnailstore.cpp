@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        bench_thumbnailstore.cpp
+// Purpose:     Benchmark of wxExplorerBrowserThumbnailStore
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+#include <vector>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+using wxExplorerBrowserTesting::GetMilliseconds;
+using wxExplorerBrowserTesting::TempDirectory;
+
+// usage: bench_thumbnailstore [thumbnails]
+int main(int argc, char** argv)
+{
+    const size_t count = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 5000;
+    TempDirectory dir("bench_thumbnailstore_files");
+    const wxString fileName = dir.GetPath("thumbnails.db");
+    std::vector<wxExplorerBrowserThumbnailStore::Key> keys;
+    wxExplorerBrowserThumbnail thumbnail;
+
+    // 96x96 RGBA, the size of the large icons
+    thumbnail.width = 96;
+    thumbnail.height = 96;
+    thumbnail.pixels.assign(96 * 96 * 4, 0x7F);
+
+    keys.resize(count);
+
+    double start = GetMilliseconds();
+
+    for ( size_t i = 0; i < count; ++i )
+    {
+        wxExplorerBrowserItem item(wxExplorerBrowserItem::File);
+
+        item.SetPath(wxString::Format(wxS("C:\\Users\\Public\\Pictures\\IMG_%06zu.jpg"), i));
+        keys[i] = wxExplorerBrowserThumbnailStore::MakeKey(item, 132000000000000000ULL + i, 96);
+    }
+    printf("%zu keys made in %.1f ms\n", count, GetMilliseconds() - start);
+
+    {
+        wxExplorerBrowserThumbnailStore store;
+
+        if ( !store.Open(fileName) )
+        {
+            printf("cannot open the store\n");
+            return 1;
+        }
+
+        start = GetMilliseconds();
+        for ( size_t i = 0; i < count; ++i )
+            store.Insert(keys[i], thumbnail);
+        store.Flush();
+        printf("%zu thumbnails inserted in %.1f ms, %zu MB\n", count, GetMilliseconds() - start,
+               store.GetUsedSize() / (1024 * 1024));
+    }
+
+    wxExplorerBrowserThumbnailStore store;
+
+    start = GetMilliseconds();
+    store.Open(fileName);
+    printf("opened with %zu thumbnails in %.1f ms\n", store.GetCount(), GetMilliseconds() - start);
+
+    wxExplorerBrowserThumbnail found;
+    size_t hits = 0;
+
+    start = GetMilliseconds();
+    for ( size_t i = 0; i < count; ++i )
+        hits += store.Lookup(keys[(i * 7919) % count], found);
+    printf("%zu lookups (%zu hits) in %.1f ms, %.1f us each\n", count, hits, GetMilliseconds() - start,
+           (GetMilliseconds() - start) * 1000 / count);
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        bench_trigramindex.cpp
+// Purpose:     Benchmark of wxExplorerBrowserTrigramIndex against scanning
+//              the names, and of updating it against building it again
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+using wxExplorerBrowserTesting::GetMilliseconds;
+
+// usage: bench_trigramindex [items]
+int main(int argc, char** argv)
+{
+    const size_t count = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 100000;
+    wxExplorerBrowserItem::List items(count, wxExplorerBrowserItem(wxExplorerBrowserItem::File));
+
+    static const char* const words[] = { "Project", "Report", "invoice", "IMG", "backup", "Budget", "notes",
+                                         "draft", "final", "meeting", "Scan", "photo" };
+    static const char* const extensions[] = { ".xlsx", ".docx", ".jpg", ".pdf", ".txt", ".zip" };
+
+    srand(1);
+    for ( size_t i = 0; i < count; ++i )
+    {
+        items[i].SetPath(wxString(wxS("C:\\Data\\")) + wxString(words[rand() % 12]) + wxS("_")
+                         + wxString(words[rand() % 12]) + wxString::Format(wxS("_%zu"), i)
+                         + wxString(extensions[rand() % 6]));
+    }
+
+    wxExplorerBrowserTrigramIndex index;
+    double start = GetMilliseconds();
+
+    index.SetItems(items);
+
+    const double building = GetMilliseconds() - start;
+
+    printf("%zu names indexed in %.1f ms, %zu kB\n", index.GetCount(), building, index.GetMemoryUsage() / 1024);
+
+    // typed one character after another, as in a search box
+    const wxString typed[] = { wxS("final_4217"), wxS("meeting_scan"), wxS("zzzz"), wxS(".pdf"), wxS("_99") };
+    wxExplorerBrowserTrigramIndex::IdList ids;
+    std::vector<wxString> upperNames;
+    wxString name;
+
+    for ( const auto& item : items )
+    {
+        wxExplorerBrowserMaskMatcher::GetItemName(item, name);
+        upperNames.push_back(name.Upper());
+    }
+
+    // the strings shorter than a trigram are scanned by Find() too
+    for ( const auto& text : typed )
+    {
+        double found = 0, scanned = 0;
+        size_t scannedCount = 0;
+
+        for ( size_t length = 3; length <= text.length(); ++length )
+        {
+            const wxString str = text.substr(0, length);
+
+            start = GetMilliseconds();
+            index.Find(str, ids);
+            found += GetMilliseconds() - start;
+
+            start = GetMilliseconds();
+
+            const wxString upperStr = str.Upper();
+
+            scannedCount = 0;
+            for ( const auto& upperName : upperNames )
+                scannedCount += upperName.find(upperStr) != wxString::npos;
+            scanned += GetMilliseconds() - start;
+        }
+
+        const size_t keys = text.length() - 2;
+
+        printf("\"%s\" typed from 3 characters: Find() %.3f ms per key, scanning %.2f ms per key, %zu/%zu found\n",
+               static_cast<const char*>(text.utf8_str()), found / keys, scanned / keys, ids.size(), scannedCount);
+    }
+
+    // a burst of changes reported by the change notifications, applied to the index,
+    // against building it again as when the shell reports only that the folder changed
+    const size_t changes = 1000;
+
+    start = GetMilliseconds();
+    for ( size_t i = 0; i < changes; ++i )
+    {
+        index.Remove(wxString::Format(wxS("renamed_%zu.txt"), i - 1));
+        index.Add(wxString::Format(wxS("renamed_%zu.txt"), i));
+    }
+
+    printf("%zu renames applied: %.2f ms, %.2f us each; building the index again: %.1f ms\n",
+           changes, GetMilliseconds() - start, (GetMilliseconds() - start) * 1000 / changes, building);
+
+    return 0;
+}
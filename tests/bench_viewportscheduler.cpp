@@ -0,0 +1,101 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        bench_viewportscheduler.cpp
+// Purpose:     Benchmark of wxExplorerBrowserViewportScheduler ordering the work
+//              for a scrolled view
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+using wxExplorerBrowserTesting::GetMilliseconds;
+
+namespace {
+
+const size_t VisibleCount = 40;
+
+// the number of items done before all the visible ones are, in the index order
+// and in the order of the scheduler, for the view scrolled to the middle
+void CompareOrders(size_t count)
+{
+    const size_t first = count / 2;
+    wxExplorerBrowserViewportScheduler scheduler;
+    size_t index, done = 0, visibleLeft = VisibleCount;
+
+    scheduler.SetViewport(first, VisibleCount);
+
+    double start = GetMilliseconds();
+
+    scheduler.AddRange(0, count);
+    while ( visibleLeft && scheduler.Next(index) )
+    {
+        ++done;
+        if ( scheduler.GetDistance(index) == 0 )
+            --visibleLeft;
+    }
+
+    printf("%zu items, the visible ones are done after %zu items in the index order, after %zu scheduled\n",
+           count, first + VisibleCount, done);
+
+    while ( scheduler.Next(index) )
+        ++done;
+
+    printf("adding and taking %zu items: %.1f ms, %.0f ns per item\n",
+           done, GetMilliseconds() - start, (GetMilliseconds() - start) * 1e6 / done);
+}
+
+// scrolls the view by a few items at a time, keeping the items within
+// the distance queued and doing some work between the scrolls, as the
+// thumbnail prefetching of wxExplorerBrowser does
+void Scroll(size_t count)
+{
+    const size_t distance = 4 * VisibleCount;
+    const size_t workPerStep = 8;
+    wxExplorerBrowserViewportScheduler scheduler;
+    std::vector<wxUint8> requested(count, 0);
+    size_t steps = 0, done = 0, dropped = 0, maxPending = 0, index;
+
+    scheduler.SetDistances(0, distance);
+
+    const double start = GetMilliseconds();
+
+    for ( size_t first = 0; first + VisibleCount < count; first += 3, ++steps )
+    {
+        dropped += scheduler.SetViewport(first, VisibleCount);
+
+        const size_t end = std::min(first + VisibleCount + distance, count);
+
+        for ( size_t i = first > distance ? first - distance : 0; i < end; ++i )
+        {
+            if ( !requested[i] )
+                scheduler.Add(i);
+        }
+
+        maxPending = std::max(maxPending, scheduler.GetPendingCount());
+
+        for ( size_t i = 0; i < workPerStep && scheduler.Next(index); ++i, ++done )
+            requested[index] = 1;
+    }
+
+    const double elapsed = GetMilliseconds() - start;
+
+    printf("%zu scrolls: %.1f ms, %.2f us per scroll, %zu items done, %zu dropped, at most %zu pending (%zu kB)\n",
+           steps, elapsed, elapsed * 1000 / steps, done, dropped, maxPending,
+           maxPending * (4 * sizeof(void*) + sizeof(size_t)) / 1024);
+}
+
+} // unnamed namespace
+
+// usage: bench_viewportscheduler [items]
+int main(int argc, char** argv)
+{
+    const size_t count = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 100000;
+
+    CompareOrders(count);
+    Scroll(count);
+
+    return 0;
+}
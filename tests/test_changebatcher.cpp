@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_changebatcher.cpp
+// Purpose:     Tests of wxExplorerBrowserChangeBatcher
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <initializer_list>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+namespace {
+
+typedef wxExplorerBrowserItemChange Change;
+
+// returns the type of the single change left after merging the given ones, None if none is left
+Change::Type Merge(std::initializer_list<Change::Type> types)
+{
+    wxExplorerBrowserChangeBatcher batcher;
+    Change::List changes;
+
+    for ( Change::Type type : types )
+        batcher.Add(type, wxS("/item"), 0);
+
+    WXEB_CHECK(!batcher.Flush(changes));
+    WXEB_CHECK(changes.size() <= 1);
+
+    return changes.empty() ? Change::None : changes[0].type;
+}
+
+void TestMerge()
+{
+    WXEB_CHECK_EQUAL(Merge({Change::Created}), Change::Created);
+    WXEB_CHECK_EQUAL(Merge({Change::Created, Change::Updated}), Change::Created);
+    WXEB_CHECK_EQUAL(Merge({Change::Created, Change::Deleted}), Change::None);
+    WXEB_CHECK_EQUAL(Merge({Change::Created, Change::Deleted, Change::Deleted}), Change::None);
+    WXEB_CHECK_EQUAL(Merge({Change::Created, Change::Deleted, Change::Created}), Change::Created);
+    WXEB_CHECK_EQUAL(Merge({Change::Created, Change::Deleted, Change::Updated}), Change::Created);
+    WXEB_CHECK_EQUAL(Merge({Change::Created, Change::Deleted, Change::Updated, Change::Updated}), Change::Created);
+
+    WXEB_CHECK_EQUAL(Merge({Change::Deleted}), Change::Deleted);
+    WXEB_CHECK_EQUAL(Merge({Change::Deleted, Change::Created}), Change::Updated);
+    WXEB_CHECK_EQUAL(Merge({Change::Deleted, Change::Created, Change::Deleted}), Change::Deleted);
+
+    WXEB_CHECK_EQUAL(Merge({Change::Updated}), Change::Updated);
+    WXEB_CHECK_EQUAL(Merge({Change::Updated, Change::Updated}), Change::Updated);
+    WXEB_CHECK_EQUAL(Merge({Change::Updated, Change::Deleted}), Change::Deleted);
+    WXEB_CHECK_EQUAL(Merge({Change::Updated, Change::Deleted, Change::Created}), Change::Updated);
+}
+
+void TestBatch()
+{
+    wxExplorerBrowserChangeBatcher batcher;
+    Change::List changes;
+    wxUint64 deadline;
+
+    batcher.SetLimits(100, 10);
+    WXEB_CHECK(!batcher.GetDeadline(deadline));
+
+    WXEB_CHECK(batcher.Add(Change::Created, wxS("/b"), 1000));
+    WXEB_CHECK(!batcher.Add(Change::Created, wxS("/a"), 1050));
+    WXEB_CHECK(!batcher.Add(Change::Updated, wxS("/b"), 1060));
+    WXEB_CHECK(!batcher.Add(Change::Created, wxS("/c"), 1070));
+    WXEB_CHECK(!batcher.Add(Change::Deleted, wxS("/c"), 1080));
+    WXEB_CHECK_EQUAL(batcher.GetPendingCount(), 3u);
+
+    // the deadline does not move with the later changes
+    WXEB_CHECK(batcher.GetDeadline(deadline));
+    WXEB_CHECK_EQUAL(deadline, 1100u);
+
+    // in the order the items first changed, without the cancelled out ones
+    WXEB_CHECK(!batcher.Flush(changes));
+    WXEB_CHECK_EQUAL(changes.size(), 2u);
+    if ( changes.size() == 2 )
+    {
+        WXEB_CHECK(changes[0].path == wxS("/b"));
+        WXEB_CHECK(changes[1].path == wxS("/a"));
+    }
+
+    WXEB_CHECK(!batcher.HasPending());
+    WXEB_CHECK(batcher.Add(Change::Deleted, wxS("/b"), 2000));
+}
+
+void TestOverflow()
+{
+    wxExplorerBrowserChangeBatcher batcher;
+    Change::List changes;
+
+    batcher.SetLimits(100, 2);
+    batcher.Add(Change::Created, wxS("/a"), 0);
+    batcher.Add(Change::Created, wxS("/b"), 0);
+    batcher.Add(Change::Updated, wxS("/a"), 0);
+    WXEB_CHECK_EQUAL(batcher.GetPendingCount(), 2u);
+
+    batcher.Add(Change::Created, wxS("/c"), 0);
+    batcher.Add(Change::Created, wxS("/d"), 0);
+    WXEB_CHECK_EQUAL(batcher.GetPendingCount(), 0u);
+    WXEB_CHECK(batcher.Flush(changes));
+    WXEB_CHECK(changes.empty());
+
+    WXEB_CHECK(batcher.AddFolderChange(0));
+    WXEB_CHECK(!batcher.AddFolderChange(0));
+    WXEB_CHECK(batcher.Flush(changes));
+    WXEB_CHECK(!batcher.Flush(changes));
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestMerge();
+    TestBatch();
+    TestOverflow();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
@@ -0,0 +1,379 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_directorywalker.cpp
+// Purpose:     Tests of wxExplorerBrowserDirectoryWalker and wxExplorerBrowserFolderSizer
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <map>
+
+#ifdef __LINUX__
+#include <unistd.h>
+#endif
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+using wxExplorerBrowserTesting::TempDirectory;
+
+namespace {
+
+typedef wxExplorerBrowserDirectoryWalker Walker;
+
+struct Visited
+{
+    unsigned depth;
+    bool     isDirectory;
+    bool     isLink;
+    wxUint64 size;
+};
+
+// the entries found in the tree of @a root, by their path relative to it
+class Collector
+{
+public:
+    explicit Collector(const wxString& root) : m_root(root) {}
+
+    Walker::Visitor GetVisitor(const wxString& skippedName = wxString())
+    {
+        return [this, skippedName](unsigned WXUNUSED(threadIndex), const Walker::Entry& entry)
+            {
+                const wxString path = entry.GetPath();
+                const Visited visited { entry.depth, entry.isDirectory, entry.isLink, entry.size };
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                m_entries[path.substr(m_root.length() + 1)] = visited;
+                return entry.GetName() != skippedName;
+            };
+    }
+
+    const std::map<wxString, Visited>& GetEntries() const { return m_entries; }
+
+    bool Has(const char* relativePath) const
+    {
+        wxString path;
+
+        for ( const char* s = relativePath; *s; ++s )
+            path += *s == '/' ? wxFILE_SEP_PATH : static_cast<wxChar>(*s);
+
+        return m_entries.find(path) != m_entries.end();
+    }
+
+    const Visited& Get(const char* relativePath) const
+    {
+        static const Visited none { 0, false, false, 0 };
+        wxString path;
+
+        for ( const char* s = relativePath; *s; ++s )
+            path += *s == '/' ? wxFILE_SEP_PATH : static_cast<wxChar>(*s);
+
+        const auto it = m_entries.find(path);
+
+        return it != m_entries.end() ? it->second : none;
+    }
+
+private:
+    const wxString m_root;
+    std::mutex m_mutex;
+    std::map<wxString, Visited> m_entries;
+};
+
+bool CreateTree(const TempDirectory& dir)
+{
+    return dir.AddFile("a.txt", "abc")
+           && dir.AddFile("sub/b.txt", "bcdef")
+           && dir.AddFile("sub/deeper/c.txt", "cdefghi")
+           && dir.AddDirectory("empty");
+}
+
+void TestWalk()
+{
+    TempDirectory dir("walker_tree");
+    Walker walker(4);
+    Collector collector(dir.GetPath());
+    wxArrayString roots;
+
+    WXEB_CHECK(CreateTree(dir));
+    roots.push_back(dir.GetPath());
+
+    WXEB_CHECK_EQUAL(walker.GetThreadCount(), 4u);
+    WXEB_CHECK(walker.Walk(roots, collector.GetVisitor()));
+    WXEB_CHECK_EQUAL(collector.GetEntries().size(), 6u);
+    WXEB_CHECK_EQUAL(walker.GetDirectoryCount(), 4u);
+    WXEB_CHECK_EQUAL(walker.GetErrorCount(), 0u);
+
+    WXEB_CHECK(!collector.Get("a.txt").isDirectory);
+    WXEB_CHECK_EQUAL(collector.Get("a.txt").depth, 1u);
+    WXEB_CHECK_EQUAL(collector.Get("a.txt").size, 3u);
+    WXEB_CHECK(collector.Get("sub").isDirectory);
+    WXEB_CHECK_EQUAL(collector.Get("sub").size, 0u);
+    WXEB_CHECK_EQUAL(collector.Get("sub/b.txt").depth, 2u);
+    WXEB_CHECK_EQUAL(collector.Get("sub/b.txt").size, 5u);
+    WXEB_CHECK(collector.Get("sub/deeper").isDirectory);
+    WXEB_CHECK_EQUAL(collector.Get("sub/deeper/c.txt").depth, 3u);
+    WXEB_CHECK_EQUAL(collector.Get("sub/deeper/c.txt").size, 7u);
+    WXEB_CHECK(collector.Get("empty").isDirectory);
+
+    // the walker can be reused
+    Collector again(dir.GetPath());
+
+    WXEB_CHECK(walker.Walk(roots, again.GetVisitor()));
+    WXEB_CHECK_EQUAL(again.GetEntries().size(), 6u);
+    WXEB_CHECK_EQUAL(walker.GetDirectoryCount(), 4u);
+}
+
+void TestDepthAndPruning()
+{
+    TempDirectory dir("walker_depth");
+    Walker walker(2);
+    wxArrayString roots;
+
+    WXEB_CHECK(CreateTree(dir));
+    roots.push_back(dir.GetPath());
+
+    // only the entries of the root
+    Collector roots1(dir.GetPath());
+
+    walker.SetMaxDepth(1);
+    WXEB_CHECK(walker.Walk(roots, roots1.GetVisitor()));
+    WXEB_CHECK_EQUAL(roots1.GetEntries().size(), 3u);
+    WXEB_CHECK(roots1.Has("sub"));
+    WXEB_CHECK(!roots1.Has("sub/b.txt"));
+
+    Collector roots2(dir.GetPath());
+
+    walker.SetMaxDepth(2);
+    WXEB_CHECK(walker.Walk(roots, roots2.GetVisitor()));
+    WXEB_CHECK_EQUAL(roots2.GetEntries().size(), 5u);
+    WXEB_CHECK(roots2.Has("sub/deeper"));
+    WXEB_CHECK(!roots2.Has("sub/deeper/c.txt"));
+
+    // the visitor returning false for a directory
+    Collector pruned(dir.GetPath());
+
+    walker.SetMaxDepth(0);
+    WXEB_CHECK(walker.Walk(roots, pruned.GetVisitor(wxS("sub"))));
+    WXEB_CHECK(pruned.Has("sub"));
+    WXEB_CHECK(!pruned.Has("sub/b.txt"));
+    WXEB_CHECK_EQUAL(pruned.GetEntries().size(), 3u);
+}
+
+void TestRoots()
+{
+    TempDirectory dir("walker_roots");
+    Walker walker(3);
+    wxArrayString roots;
+
+    WXEB_CHECK(CreateTree(dir));
+
+    // a missing root is an error, the others are still walked
+    roots.push_back(dir.GetPath("sub"));
+    roots.push_back(dir.GetPath("missing"));
+    roots.push_back(dir.GetPath("empty"));
+
+    Collector collector(dir.GetPath());
+
+    WXEB_CHECK(walker.Walk(roots, collector.GetVisitor()));
+    WXEB_CHECK_EQUAL(walker.GetErrorCount(), 1u);
+    WXEB_CHECK_EQUAL(walker.GetDirectoryCount(), 3u);
+    WXEB_CHECK(collector.Has("sub/deeper/c.txt"));
+    WXEB_CHECK_EQUAL(collector.Get("sub/b.txt").depth, 1u);
+    WXEB_CHECK_EQUAL(collector.GetEntries().size(), 3u);
+
+    // the separator is appended only when missing
+    WXEB_CHECK(Walker::ToNative(wxS("x")) == Walker::ToNative(wxString(wxS("x")) + wxFILE_SEP_PATH));
+}
+
+void TestCancel()
+{
+    TempDirectory dir("walker_cancel");
+    Walker walker(2);
+    Walker::CancelFlag cancel {false};
+    wxArrayString roots;
+
+    for ( int i = 0; i < 20; ++i )
+        WXEB_CHECK(dir.AddFile(wxString::Format(wxS("d%d/f.txt"), i).utf8_str()));
+    roots.push_back(dir.GetPath());
+
+    std::atomic<int> visited {0};
+
+    // cancelled by the first entry, the directories already taken are finished
+    WXEB_CHECK(!walker.Walk(roots, [&cancel, &visited](unsigned WXUNUSED(threadIndex), const Walker::Entry&)
+        {
+            cancel = true;
+            ++visited;
+            return true;
+        }, &cancel));
+
+    WXEB_CHECK(visited < 40);
+}
+
+#ifdef __LINUX__
+void TestLinks()
+{
+    TempDirectory dir("walker_links");
+    Walker walker(2);
+    Collector collector(dir.GetPath());
+    wxArrayString roots;
+
+    WXEB_CHECK(CreateTree(dir));
+    WXEB_CHECK(::symlink(dir.GetPath("sub").fn_str(), dir.GetPath("link").fn_str()) == 0);
+    roots.push_back(dir.GetPath());
+
+    // reported but not followed
+    WXEB_CHECK(walker.Walk(roots, collector.GetVisitor()));
+    WXEB_CHECK(collector.Get("link").isLink);
+    WXEB_CHECK(!collector.Has("link/b.txt"));
+    WXEB_CHECK_EQUAL(collector.GetEntries().size(), 7u);
+}
+#endif // __LINUX__
+
+void TestFolderSizer()
+{
+    TempDirectory dir("foldersizer");
+    wxExplorerBrowserFolderSizer sizer(4);
+    wxArrayString folders;
+
+    WXEB_CHECK(CreateTree(dir));
+    folders.push_back(dir.GetPath("sub"));
+    folders.push_back(dir.GetPath("empty"));
+    folders.push_back(dir.GetPath("missing"));
+
+    WXEB_CHECK(!sizer.IsRunning());
+    WXEB_CHECK(sizer.Start(folders));
+    sizer.Wait();
+    WXEB_CHECK(!sizer.IsRunning());
+    WXEB_CHECK(!sizer.IsCancelled());
+
+    wxExplorerBrowserFolderSizer::Totals totals = sizer.GetTotals();
+
+    WXEB_CHECK_EQUAL(totals.size, 12u);
+    WXEB_CHECK_EQUAL(totals.fileCount, 2u);
+    WXEB_CHECK_EQUAL(totals.folderCount, 1u);
+    WXEB_CHECK_EQUAL(totals.errorCount, 1u);
+
+    // the totals are reset when started again
+    folders.clear();
+    folders.push_back(dir.GetPath());
+    WXEB_CHECK(sizer.Start(folders));
+    sizer.Wait();
+    totals = sizer.GetTotals();
+    WXEB_CHECK_EQUAL(totals.size, 15u);
+    WXEB_CHECK_EQUAL(totals.fileCount, 3u);
+    WXEB_CHECK_EQUAL(totals.folderCount, 3u);
+    WXEB_CHECK_EQUAL(totals.errorCount, 0u);
+}
+
+void TestFolderSizerCancel()
+{
+    TempDirectory dir("foldersizer_cancel");
+    wxArrayString folders;
+
+    for ( int i = 0; i < 200; ++i )
+        WXEB_CHECK(dir.AddFile(wxString::Format(wxS("d%d/e/f.txt"), i).utf8_str(), "x"));
+    folders.push_back(dir.GetPath());
+
+    {
+        wxExplorerBrowserFolderSizer sizer(2);
+
+        WXEB_CHECK(sizer.Start(folders));
+        sizer.Cancel();
+        sizer.Wait();
+        WXEB_CHECK(!sizer.IsRunning());
+        WXEB_CHECK(sizer.IsCancelled());
+        WXEB_CHECK(sizer.GetTotals().fileCount <= 200u);
+
+        // not cancelled any more when started again
+        WXEB_CHECK(sizer.Start(folders));
+        WXEB_CHECK(!sizer.IsCancelled());
+        sizer.Wait();
+        WXEB_CHECK_EQUAL(sizer.GetTotals().fileCount, 200u);
+        WXEB_CHECK_EQUAL(sizer.GetTotals().folderCount, 400u);
+    }
+
+    // destroyed while running, as wxExplorerBrowser does when cancelling,
+    // the calling thread does not wait for the walk but Shutdown() does
+    wxExplorerBrowserReaper reaper;
+    std::unique_ptr<wxExplorerBrowserFolderSizer> sizer(new wxExplorerBrowserFolderSizer(2));
+
+    WXEB_CHECK(sizer->Start(folders));
+    sizer->Cancel();
+    reaper.Destroy(std::move(sizer));
+    WXEB_CHECK(!sizer);
+    reaper.Shutdown();
+    WXEB_CHECK_EQUAL(reaper.GetPendingCount(), 0u);
+}
+
+// its destructor waits for the gate to open
+class Blocker
+{
+public:
+    Blocker(std::mutex& mutex, std::condition_variable& condition, bool& open, bool& destroyed)
+        : m_mutex(mutex), m_condition(condition), m_open(open), m_destroyed(destroyed) {}
+
+    ~Blocker()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_condition.wait(lock, [this]() { return m_open; });
+        m_destroyed = true;
+        m_condition.notify_all();
+    }
+
+private:
+    std::mutex& m_mutex;
+    std::condition_variable& m_condition;
+    bool& m_open;
+    bool& m_destroyed;
+};
+
+void TestReaper()
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool open = false, destroyed = false;
+    wxExplorerBrowserReaper reaper;
+
+    // returns while the destructor is blocked
+    reaper.Destroy(std::unique_ptr<Blocker>(new Blocker(mutex, condition, open, destroyed)));
+    WXEB_CHECK_EQUAL(reaper.GetPendingCount(), 1u);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        WXEB_CHECK(!destroyed);
+        open = true;
+        condition.notify_all();
+    }
+
+    // waits for the destructor
+    reaper.Shutdown();
+    WXEB_CHECK(destroyed);
+    WXEB_CHECK_EQUAL(reaper.GetPendingCount(), 0u);
+
+    // destroyed in the calling thread after the shutdown
+    destroyed = false;
+    reaper.Destroy(std::unique_ptr<Blocker>(new Blocker(mutex, condition, open, destroyed)));
+    WXEB_CHECK(destroyed);
+
+    // nothing to do for a null pointer
+    reaper.Destroy(std::unique_ptr<Blocker>());
+    WXEB_CHECK_EQUAL(reaper.GetPendingCount(), 0u);
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestWalk();
+    TestDepthAndPruning();
+    TestRoots();
+    TestCancel();
+#ifdef __LINUX__
+    TestLinks();
+#endif
+    TestFolderSizer();
+    TestFolderSizerCancel();
+    TestReaper();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
@@ -0,0 +1,205 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_fuzzymatcher.cpp
+// Purpose:     Tests of wxExplorerBrowserFuzzyMatcher
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+namespace {
+
+typedef wxExplorerBrowserFuzzyMatcher Matcher;
+
+wxString Repeat(wxChar c, size_t count)
+{
+    wxString s;
+
+    for ( size_t i = 0; i < count; ++i )
+        s += c;
+
+    return s;
+}
+
+void TestScore()
+{
+    WXEB_CHECK(Matcher::Score(wxS("prjrpt23"), wxS("Project_Report_2023.xlsx")) > 0);
+    WXEB_CHECK(Matcher::Score(wxS("PRJ"), wxS("project")) > 0);
+    WXEB_CHECK_EQUAL(Matcher::Score(wxS("xyz"), wxS("Project")), -1);
+    WXEB_CHECK_EQUAL(Matcher::Score(wxS(""), wxS("Project")), -1);
+    WXEB_CHECK_EQUAL(Matcher::Score(wxS("abc"), wxS("")), -1);
+
+    // in the same order only
+    WXEB_CHECK(Matcher::Score(wxS("pt"), wxS("top")) < 0);
+    WXEB_CHECK(Matcher::Score(wxS("tp"), wxS("top")) >= 0);
+
+    // the repeated characters of the pattern need as many in the name
+    WXEB_CHECK(Matcher::Score(wxS("aa"), wxS("bab")) < 0);
+    WXEB_CHECK(Matcher::Score(wxS("aa"), wxS("baba")) >= 0);
+
+    // the characters outside ASCII
+    WXEB_CHECK(Matcher::Score(wxS("m\u00fcl"), wxS("M\u00fcller.txt")) > 0);
+    WXEB_CHECK(Matcher::Score(wxS("mul"), wxS("M\u00fcller.txt")) < 0);
+}
+
+void TestRanking()
+{
+    // the start of a word
+    WXEB_CHECK(Matcher::Score(wxS("rep"), wxS("Report.txt")) > Matcher::Score(wxS("rep"), wxS("prepare.txt")));
+    WXEB_CHECK(Matcher::Score(wxS("rep"), wxS("my-report.txt")) > Matcher::Score(wxS("rep"), wxS("prepare.txt")));
+
+    // a camel-case hump and a number
+    WXEB_CHECK(Matcher::Score(wxS("fb"), wxS("FooBar")) > Matcher::Score(wxS("fb"), wxS("fobbar")));
+    WXEB_CHECK(Matcher::Score(wxS("f2"), wxS("file2")) > Matcher::Score(wxS("f2"), wxS("f12")));
+
+    // a run rather than the characters spread
+    WXEB_CHECK(Matcher::Score(wxS("abc"), wxS("abc_x")) > Matcher::Score(wxS("abc"), wxS("a_b_c")));
+    WXEB_CHECK(Matcher::Score(wxS("abc"), wxS("axbxc")) > Matcher::Score(wxS("abc"), wxS("axxxxbxxxxc")));
+
+    // only the shortest window of the match is scored
+    WXEB_CHECK_EQUAL(Matcher::Score(wxS("abc"), wxS("a-------abc")), Matcher::Score(wxS("abc"), wxS("x-------abc")));
+
+    // long gaps do not make the score negative
+    WXEB_CHECK_EQUAL(Matcher::Score(wxS("az"), wxS("a") + Repeat(wxS('x'), 60) + wxS("z")), 0);
+
+    // the patterns of the maximum length
+    WXEB_CHECK(Matcher::Score(Repeat(wxS('a'), 64), Repeat(wxS('a'), 100)) > 0);
+    WXEB_CHECK(Matcher::Score(Repeat(wxS('a'), 64), Repeat(wxS('a'), 63)) < 0);
+}
+
+void TestFind()
+{
+    Matcher matcher;
+    Matcher::Matches matches;
+
+    WXEB_CHECK_EQUAL(matcher.GetCount(), 0u);
+    WXEB_CHECK_EQUAL(matcher.Find(wxS("a"), 10, matches), 0u);
+
+    const wxString names[] = { wxS("prepare.txt"), wxS("Report.txt"), wxS("Report.docx"), wxS("readme.md"),
+                               wxS("Report.doc"), wxS("other.txt") };
+
+    for ( const auto& name : names )
+        matcher.AddName(name);
+
+    WXEB_CHECK_EQUAL(matcher.GetCount(), 6u);
+
+    // the best first, then the shorter names, then in the order of the names
+    WXEB_CHECK_EQUAL(matcher.Find(wxS("rep"), 10, matches), 4u);
+    WXEB_CHECK_EQUAL(matches.size(), 4u);
+    WXEB_CHECK_EQUAL(matches[0].index, 1u);
+    WXEB_CHECK_EQUAL(matches[1].index, 4u);
+    WXEB_CHECK_EQUAL(matches[2].index, 2u);
+    WXEB_CHECK_EQUAL(matches[3].index, 0u);
+    WXEB_CHECK_EQUAL(matches[0].score, matches[2].score);
+    WXEB_CHECK(matches[2].score > matches[3].score);
+    WXEB_CHECK_EQUAL(matches[0].score, Matcher::Score(wxS("rep"), names[1]));
+
+    // only the best ones
+    WXEB_CHECK_EQUAL(matcher.Find(wxS("rep"), 2, matches), 2u);
+    WXEB_CHECK_EQUAL(matches[0].index, 1u);
+    WXEB_CHECK_EQUAL(matches[1].index, 4u);
+
+    WXEB_CHECK_EQUAL(matcher.Find(wxS("rep"), 0, matches), 0u);
+    WXEB_CHECK(matches.empty());
+    WXEB_CHECK_EQUAL(matcher.Find(wxS("zzz"), 10, matches), 0u);
+    WXEB_CHECK_EQUAL(matcher.Find(wxS(""), 10, matches), 0u);
+
+    // the characters after MaxPatternLength are ignored
+    matcher.AddName(Repeat(wxS('a'), 100));
+    WXEB_CHECK_EQUAL(matcher.Find(Repeat(wxS('a'), 64) + wxS("zzz"), 10, matches), 1u);
+    WXEB_CHECK_EQUAL(matches[0].index, 6u);
+
+    // the display names of the items
+    wxExplorerBrowserItem::List items(2, wxExplorerBrowserItem(wxExplorerBrowserItem::File));
+
+    items[0].SetDisplayName(wxS("Budget 2024.xlsx"));
+    items[1].SetDisplayName(wxS("notes.txt"));
+    matcher.SetItems(items);
+
+    WXEB_CHECK_EQUAL(matcher.GetCount(), 2u);
+    WXEB_CHECK_EQUAL(matcher.Find(wxS("b24"), 10, matches), 1u);
+    WXEB_CHECK_EQUAL(matches[0].index, 0u);
+    WXEB_CHECK(matcher.GetMemoryUsage() >= 25 * sizeof(wxChar));
+
+    matcher.Clear();
+    WXEB_CHECK_EQUAL(matcher.GetCount(), 0u);
+}
+
+// the names found are exactly those containing the pattern as a subsequence
+bool IsSubsequence(const wxString& pattern, const wxString& name)
+{
+    size_t k = 0;
+
+    for ( size_t i = 0; i < name.length() && k < pattern.length(); ++i )
+    {
+        if ( wxTolower(name[i]) == wxTolower(pattern[k]) )
+            ++k;
+    }
+
+    return k == pattern.length();
+}
+
+void TestAgainstSubsequence()
+{
+    const wxChar alphabet[] = wxS("abcAB_.1");
+    Matcher matcher;
+    std::vector<wxString> names;
+
+    srand(42);
+    for ( int i = 0; i < 2000; ++i )
+    {
+        wxString name;
+
+        for ( int length = rand() % 12; length > 0; --length )
+            name += alphabet[rand() % 8];
+        names.push_back(name);
+        matcher.AddName(name);
+    }
+
+    Matcher::Matches matches;
+
+    for ( int i = 0; i < 200; ++i )
+    {
+        wxString pattern;
+
+        for ( int length = 1 + rand() % 4; length > 0; --length )
+            pattern += alphabet[rand() % 8];
+
+        matcher.Find(pattern, names.size(), matches);
+
+        std::vector<bool> found(names.size(), false);
+        bool sorted = true;
+
+        for ( size_t m = 0; m < matches.size(); ++m )
+        {
+            found[matches[m].index] = true;
+            if ( m > 0 && matches[m].score > matches[m - 1].score )
+                sorted = false;
+        }
+
+        size_t mismatches = 0;
+
+        for ( size_t n = 0; n < names.size(); ++n )
+        {
+            if ( found[n] != IsSubsequence(pattern, names[n]) )
+                ++mismatches;
+        }
+
+        WXEB_CHECK_EQUAL(mismatches, 0u);
+        WXEB_CHECK(sorted);
+    }
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestScore();
+    TestRanking();
+    TestFind();
+    TestAgainstSubsequence();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
@@ -0,0 +1,193 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_ignorerules.cpp
+// Purpose:     Tests of wxExplorerBrowserIgnoreRules
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+using wxExplorerBrowserTesting::TempDirectory;
+
+namespace {
+
+typedef wxExplorerBrowserIgnoreRules::DirectoryRules DirectoryRules;
+
+bool CreateTree(const TempDirectory& dir)
+{
+    return dir.AddFile(".gitignore", "# comment\n"
+                                     "*.log\n"
+                                     "!keep.log\n"
+                                     "build/\n"
+                                     "/root-only.txt\n"
+                                     "docs/**/*.tmp\n"
+                                     "data[0-9].bin\n"
+                                     "c?che\n")
+           && dir.AddFile("sub/.gitignore", "!*.log\n"
+                                            "secret*\n")
+           && dir.AddFile("ignored/.gitignore", "!*\n")
+           && dir.AddDirectory("docs/a/b")
+           && dir.AddDirectory("ignored/inner");
+}
+
+void TestPatterns()
+{
+    TempDirectory dir("ignorerules_patterns");
+
+    WXEB_CHECK(CreateTree(dir));
+
+    wxExplorerBrowserIgnoreRules rules;
+
+    rules.Set(dir.GetPath());
+
+    WXEB_CHECK(!rules.IsEmpty());
+    WXEB_CHECK(rules.IsIgnored(dir.GetPath("a.log"), false));
+    WXEB_CHECK(rules.IsIgnored(dir.GetPath("A.LOG"), false));
+    WXEB_CHECK(!rules.IsIgnored(dir.GetPath("keep.log"), false));
+    WXEB_CHECK(!rules.IsIgnored(dir.GetPath("a.txt"), false));
+
+    // only directories
+    WXEB_CHECK(rules.IsIgnored(dir.GetPath("build"), true));
+    WXEB_CHECK(!rules.IsIgnored(dir.GetPath("build"), false));
+
+    // anchored to the directory of the file
+    WXEB_CHECK(rules.IsIgnored(dir.GetPath("root-only.txt"), false));
+    WXEB_CHECK(!rules.IsIgnored(dir.GetPath("sub/root-only.txt"), false));
+
+    // "**" matching also no directories
+    WXEB_CHECK(rules.IsIgnored(dir.GetPath("docs/x.tmp"), false));
+    WXEB_CHECK(rules.IsIgnored(dir.GetPath("docs/a/b/x.tmp"), false));
+    WXEB_CHECK(!rules.IsIgnored(dir.GetPath("x.tmp"), false));
+
+    // the wild-cards
+    WXEB_CHECK(rules.IsIgnored(dir.GetPath("data7.bin"), false));
+    WXEB_CHECK(!rules.IsIgnored(dir.GetPath("dataX.bin"), false));
+    WXEB_CHECK(rules.IsIgnored(dir.GetPath("cache"), true));
+    WXEB_CHECK(!rules.IsIgnored(dir.GetPath("caache"), true));
+
+    // a deeper file overrides its ancestors
+    WXEB_CHECK(!rules.IsIgnored(dir.GetPath("sub/a.log"), false));
+    WXEB_CHECK(rules.IsIgnored(dir.GetPath("sub/secret.txt"), false));
+    WXEB_CHECK(!rules.IsIgnored(dir.GetPath("secret.txt"), false));
+
+    // but nothing in an ignored directory can be re-included
+    WXEB_CHECK(rules.IsIgnored(dir.GetPath("sub/build/a.txt"), false));
+
+    // outside the tree
+    WXEB_CHECK(!rules.IsIgnored(dir.GetPath() + wxS("-other/a.log"), false));
+    WXEB_CHECK(!rules.GetDirectoryRules(dir.GetPath() + wxS("-other")));
+
+    rules.Clear();
+    WXEB_CHECK(rules.IsEmpty());
+    WXEB_CHECK(!rules.IsIgnored(dir.GetPath("a.log"), false));
+}
+
+void TestGlobalRules()
+{
+    TempDirectory dir("ignorerules_global");
+
+    WXEB_CHECK(CreateTree(dir));
+
+    wxExplorerBrowserIgnoreRules rules;
+
+    // with a lower priority than the file in the root
+    rules.Set(dir.GetPath(), wxS(".gitignore"), wxS("*.bak\nkeep.txt\n*.log\n"));
+
+    WXEB_CHECK(rules.IsIgnored(dir.GetPath("a.bak"), false));
+    WXEB_CHECK(rules.IsIgnored(dir.GetPath("sub/deeper/a.bak"), false));
+    WXEB_CHECK(rules.IsIgnored(dir.GetPath("keep.txt"), false));
+    WXEB_CHECK(!rules.IsIgnored(dir.GetPath("keep.log"), false));
+
+    // another file name
+    rules.Set(dir.GetPath(), wxS(".missing"));
+    WXEB_CHECK(!rules.IsIgnored(dir.GetPath("a.log"), false));
+}
+
+// the rules of a directory, as got when the view navigates to it, are
+// matched against its items without reading the ignore files again
+void TestDirectoryRules()
+{
+    TempDirectory dir("ignorerules_directory");
+
+    WXEB_CHECK(CreateTree(dir));
+
+    wxExplorerBrowserIgnoreRules rules;
+
+    rules.Set(dir.GetPath());
+
+    const wxExplorerBrowserIgnoreRules::DirectoryRulesPtr root = rules.GetDirectoryRules(dir.GetPath());
+    const wxExplorerBrowserIgnoreRules::DirectoryRulesPtr sub = rules.GetDirectoryRules(dir.GetPath("sub"));
+    const wxExplorerBrowserIgnoreRules::DirectoryRulesPtr build = rules.GetDirectoryRules(dir.GetPath("build"));
+    const wxExplorerBrowserIgnoreRules::DirectoryRulesPtr inner = rules.GetDirectoryRules(dir.GetPath("ignored/inner"));
+
+    WXEB_CHECK(root && sub && build && inner);
+    WXEB_CHECK(!root->IsExcluded());
+    WXEB_CHECK(build->IsExcluded());
+    WXEB_CHECK(!inner->IsExcluded());
+
+    // the files are not read anymore
+    WXEB_CHECK(dir.AddFile(".gitignore", "*.txt\n"));
+    WXEB_CHECK(dir.AddFile("sub/.gitignore", "*.txt\n"));
+
+    DirectoryRules::Buffer buffer;
+
+    WXEB_CHECK(root->IsIgnored(wxS("a.log"), false, buffer));
+    WXEB_CHECK(!root->IsIgnored(wxS("keep.log"), false, buffer));
+    WXEB_CHECK(!root->IsIgnored(wxS("a.txt"), false, buffer));
+    WXEB_CHECK(root->IsIgnored(wxS("data1.bin"), false, buffer));
+    WXEB_CHECK(!sub->IsIgnored(wxS("a.log"), false, buffer));
+    WXEB_CHECK(sub->IsIgnored(wxS("Secret.doc"), false, buffer));
+    WXEB_CHECK(build->IsIgnored(wxS("anything"), false, buffer));
+    WXEB_CHECK(!inner->IsIgnored(wxS("a.log"), false, buffer));
+
+    // the cache of the compiled rules, not the files, until the rules are set again
+    WXEB_CHECK(!rules.IsIgnored(dir.GetPath("a.txt"), false));
+
+    rules.Set(dir.GetPath());
+    WXEB_CHECK(rules.IsIgnored(dir.GetPath("a.txt"), false));
+
+    // the rules got before are not changed
+    WXEB_CHECK(!root->IsIgnored(wxS("a.txt"), false, buffer));
+    WXEB_CHECK(root->GetMemoryUsage() > sizeof(DirectoryRules));
+}
+
+// more patterns than the bits of a word, and the names longer than the buffer
+// of the previous ones
+void TestManyPatterns()
+{
+    TempDirectory dir("ignorerules_many");
+    std::string contents;
+
+    for ( int i = 0; i < 100; ++i )
+        contents += wxString::Format(wxS("*.e%d\n"), i).utf8_str().data();
+    contents += "*middle*\n";
+
+    WXEB_CHECK(dir.AddFile(".gitignore", contents));
+
+    wxExplorerBrowserIgnoreRules rules;
+
+    rules.Set(dir.GetPath());
+
+    const wxExplorerBrowserIgnoreRules::DirectoryRulesPtr root = rules.GetDirectoryRules(dir.GetPath());
+    DirectoryRules::Buffer buffer;
+
+    WXEB_CHECK(root);
+    WXEB_CHECK(root->IsIgnored(wxS("a.e0"), false, buffer));
+    WXEB_CHECK(root->IsIgnored(wxS("a.e99"), false, buffer));
+    WXEB_CHECK(!root->IsIgnored(wxS("a.e100"), false, buffer));
+    WXEB_CHECK(root->IsIgnored(wxS("a very long name with the word middle in it.txt"), false, buffer));
+    WXEB_CHECK(!root->IsIgnored(wxS("a very long name without the word in it.txt"), false, buffer));
+    WXEB_CHECK(root->IsIgnored(wxS("x.E42"), false, buffer));
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestPatterns();
+    TestGlobalRules();
+    TestDirectoryRules();
+    TestManyPatterns();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
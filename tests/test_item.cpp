@@ -0,0 +1,152 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_item.cpp
+// Purpose:     Tests of wxExplorerBrowserItem and the hashes
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <unordered_set>
+#include <vector>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+namespace {
+
+typedef wxExplorerBrowserItem Item;
+
+void TestHashes()
+{
+    WXEB_CHECK_EQUAL(wxExplorerBrowserHashString(wxString()), Item::EmptyStringHash);
+    WXEB_CHECK(wxExplorerBrowserHashString(wxS("a")) != wxExplorerBrowserHashString(wxS("b")));
+    WXEB_CHECK(wxExplorerBrowserHashString(wxS("ab")) != wxExplorerBrowserHashString(wxS("ba")));
+
+    // chaining with the seed
+    const wxUint64 ab = wxExplorerBrowserHashString(wxS("ab"));
+    WXEB_CHECK_EQUAL(wxExplorerBrowserHashString(wxS("b"), wxExplorerBrowserHashString(wxS("a"))), ab);
+
+    const char bytes[] = { 1, 2, 3 };
+    WXEB_CHECK(wxExplorerBrowserMakeItemId(bytes, sizeof(bytes)) != 0);
+    WXEB_CHECK_EQUAL(wxExplorerBrowserMakeItemId(bytes, sizeof(bytes)), wxExplorerBrowserMakeItemId(bytes, sizeof(bytes)));
+    WXEB_CHECK(wxExplorerBrowserMakeItemId(bytes, 2) != wxExplorerBrowserMakeItemId(bytes, 3));
+
+    // the id of a parsing name depends only on the name, not on where it is stored
+    const wxString name = wxS("C:\\Users\\Public\\Documents\\report.docx");
+    const wxString copy = wxString(name.wx_str());
+
+    WXEB_CHECK(wxExplorerBrowserMakeItemId(name.wx_str()) != 0);
+    WXEB_CHECK_EQUAL(wxExplorerBrowserMakeItemId(name.wx_str()), wxExplorerBrowserMakeItemId(copy.wx_str()));
+    WXEB_CHECK(wxExplorerBrowserMakeItemId(name.wx_str())
+               != wxExplorerBrowserMakeItemId(wxS("C:\\Users\\Public\\Documents\\report.doc")));
+    WXEB_CHECK(wxExplorerBrowserMakeItemId(wxS("")) != 0);
+
+    // chained to the id of the folder
+    const wxUint64 folder = wxExplorerBrowserMakeItemId(wxS("C:\\Data"));
+
+    WXEB_CHECK(wxExplorerBrowserMakeItemId(bytes, sizeof(bytes), folder) != wxExplorerBrowserMakeItemId(bytes, sizeof(bytes)));
+    WXEB_CHECK_EQUAL(wxExplorerBrowserMakeItemId(bytes, sizeof(bytes), folder),
+                     wxExplorerBrowserMakeItemId(bytes, sizeof(bytes), wxExplorerBrowserMakeItemId(wxS("C:\\Data"))));
+}
+
+// the ids of the items, the last IDs of similar ID lists in many folders, do not collide
+void TestIdCollisions()
+{
+    std::unordered_set<wxUint64> ids;
+    size_t count = 0;
+
+    for ( int folder = 0; folder < 100; ++folder )
+    {
+        const wxString folderName = wxString::Format(wxS("C:\\Data\\Folder%d"), folder);
+        const wxUint64 folderId = wxExplorerBrowserMakeItemId(folderName.wx_str());
+
+        for ( int file = 0; file < 2000; ++file )
+        {
+            // like the ID of a file: its size, time and name, differing only in a few bytes
+            const wxString name = wxString::Format(wxS("file%04d.txt"), file);
+            std::vector<unsigned char> id(16, 0);
+
+            id[2] = static_cast<unsigned char>(file % 7);
+            id[8] = 0x5a;
+            for ( size_t i = 0; i < name.length(); ++i )
+                id.push_back(static_cast<unsigned char>(name[i]));
+
+            ids.insert(wxExplorerBrowserMakeItemId(id.data(), id.size(), folderId));
+            ++count;
+        }
+    }
+
+    WXEB_CHECK_EQUAL(ids.size(), count);
+}
+
+void TestItem()
+{
+    Item item;
+
+    WXEB_CHECK_EQUAL(item.GetType(), Item::Unknown);
+    WXEB_CHECK(item.GetPath().empty() && item.GetDisplayName().empty());
+    WXEB_CHECK_EQUAL(item.GetPathHash(), Item::EmptyStringHash);
+    WXEB_CHECK_EQUAL(item.GetDisplayNameHash(), Item::EmptyStringHash);
+    WXEB_CHECK(!item.HasId());
+
+    // both setters keep the hashes up to date
+    item.SetPath(wxString(wxS("/dir/file.txt")));
+    WXEB_CHECK_EQUAL(item.GetPathHash(), wxExplorerBrowserHashString(wxS("/dir/file.txt")));
+    item.SetPath(wxS("/dir/other.txt"));
+    WXEB_CHECK_EQUAL(item.GetPathHash(), wxExplorerBrowserHashString(wxS("/dir/other.txt")));
+    item.SetDisplayName(wxString(wxS("other")));
+    WXEB_CHECK_EQUAL(item.GetDisplayNameHash(), wxExplorerBrowserHashString(wxS("other")));
+    item.SetDisplayName(wxS(""));
+    WXEB_CHECK_EQUAL(item.GetDisplayNameHash(), Item::EmptyStringHash);
+
+    // the copy is independent
+    Item copy = item;
+    copy.SetPath(wxS("/dir/copy.txt"));
+    WXEB_CHECK(item.GetPath() == wxS("/dir/other.txt"));
+    WXEB_CHECK(copy.GetPathHash() != item.GetPathHash());
+}
+
+void TestFlags()
+{
+    Item item(Item::File);
+
+    WXEB_CHECK(item.IsFile() && item.IsFileSystem());
+    WXEB_CHECK(!item.IsFolder() && !item.IsVirtualZipDirectory() && !item.IsShortcut());
+
+    item.SetSFGAO(0x20000000 | 0x00010000); // SFGAO_FOLDER | SFGAO_LINK
+    WXEB_CHECK(item.IsFolder() && item.IsVirtualZipDirectory() && item.IsShortcut());
+
+    item.SetType(Item::Directory);
+    WXEB_CHECK(item.IsDirectory() && item.IsFileSystem() && !item.IsVirtualZipDirectory());
+
+    item.SetType(Item::Other);
+    WXEB_CHECK(!item.IsFileSystem());
+}
+
+void TestIds()
+{
+    std::unordered_set<Item, Item::IdHash, Item::IdEqual> items;
+    Item item(Item::File);
+
+    item.SetId(42);
+    WXEB_CHECK(item.HasId());
+    items.insert(item);
+
+    // the same id with a different path is the same item
+    item.SetPath(wxS("/renamed"));
+    WXEB_CHECK(!items.insert(item).second);
+
+    item.SetId(43);
+    WXEB_CHECK(items.insert(item).second);
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestHashes();
+    TestIdCollisions();
+    TestItem();
+    TestFlags();
+    TestIds();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
@@ -0,0 +1,152 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_itemcache.cpp
+// Purpose:     Tests of wxExplorerBrowserItemCache
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+namespace {
+
+typedef wxExplorerBrowserItemCache Cache;
+
+wxExplorerBrowserItem MakeItem(wxUint64 key)
+{
+    wxExplorerBrowserItem item(wxExplorerBrowserItem::File);
+    const wxString name = wxString::Format(wxS("item%08llu"), static_cast<unsigned long long>(key));
+
+    item.SetPath(wxS("/folder/") + name);
+    item.SetDisplayName(name);
+    return item;
+}
+
+void TestLookup()
+{
+    Cache cache;
+    wxExplorerBrowserItem item;
+
+    WXEB_CHECK(!cache.Lookup(1, item));
+    cache.Insert(1, 100, MakeItem(1));
+    cache.Insert(2, 100, MakeItem(2));
+    cache.Insert(3, 200, MakeItem(3));
+    WXEB_CHECK_EQUAL(cache.GetCount(), 3u);
+    WXEB_CHECK_EQUAL(cache.GetMemoryUsage(), 3 * Cache::GetItemMemory(MakeItem(1)));
+
+    WXEB_CHECK(cache.Lookup(2, item));
+    WXEB_CHECK(item.GetPath() == MakeItem(2).GetPath());
+    WXEB_CHECK_EQUAL(cache.GetHitCount(), 1u);
+    WXEB_CHECK_EQUAL(cache.GetMissCount(), 1u);
+
+    // replacing
+    wxExplorerBrowserItem renamed = MakeItem(2);
+    renamed.SetDisplayName(wxS("renamed"));
+    cache.Insert(2, 100, renamed);
+    WXEB_CHECK_EQUAL(cache.GetCount(), 3u);
+    WXEB_CHECK(cache.Lookup(2, item));
+    WXEB_CHECK(item.GetDisplayName() == wxS("renamed"));
+
+    // the items of the invalidated folder become stale, those cached later are valid
+    cache.InvalidateFolder(100);
+    WXEB_CHECK(!cache.Lookup(1, item));
+    WXEB_CHECK(!cache.Lookup(2, item));
+    WXEB_CHECK(cache.Lookup(3, item));
+    cache.Insert(1, 100, MakeItem(1));
+    WXEB_CHECK(cache.Lookup(1, item));
+
+    cache.Clear();
+    WXEB_CHECK_EQUAL(cache.GetCount(), 0u);
+    WXEB_CHECK_EQUAL(cache.GetMemoryUsage(), 0u);
+}
+
+void TestEviction()
+{
+    const size_t itemMemory = Cache::GetItemMemory(MakeItem(0));
+    // keys differing by a multiple of the shard count are in the same shard
+    const wxUint64 shardStride = 32;
+    // each shard has room for two items
+    Cache cache(32 * (2 * itemMemory + itemMemory / 2));
+    wxExplorerBrowserItem item;
+
+    cache.Insert(0, 1, MakeItem(0));
+    cache.Insert(shardStride, 1, MakeItem(shardStride));
+    WXEB_CHECK(cache.Lookup(0, item)); // now the most recently used
+    cache.Insert(2 * shardStride, 1, MakeItem(2 * shardStride));
+    WXEB_CHECK_EQUAL(cache.GetCount(), 2u);
+    WXEB_CHECK(cache.Lookup(0, item));
+    WXEB_CHECK(!cache.Lookup(shardStride, item));
+    WXEB_CHECK(cache.Lookup(2 * shardStride, item));
+
+    // the other shards are not affected
+    cache.Insert(1, 1, MakeItem(1));
+    WXEB_CHECK_EQUAL(cache.GetCount(), 3u);
+
+    cache.Shrink(0);
+    WXEB_CHECK_EQUAL(cache.GetCount(), 0u);
+    WXEB_CHECK_EQUAL(cache.GetMaxMemory(), 32 * (2 * itemMemory + itemMemory / 2));
+
+    // an item larger than a shard is not cached at all
+    cache.SetMaxMemory(32 * itemMemory / 2);
+    cache.Insert(0, 1, MakeItem(0));
+    WXEB_CHECK_EQUAL(cache.GetCount(), 0u);
+}
+
+// several threads inserting, looking up and invalidating the same keys
+void TestStress()
+{
+    const size_t threadCount = 8;
+    const wxUint64 keyCount = 2000;
+    const size_t iterations = 20000;
+    Cache cache(256 * 1024);
+    std::atomic<size_t> wrongItems(0);
+    std::vector<std::thread> threads;
+
+    for ( size_t t = 0; t < threadCount; ++t )
+    {
+        threads.push_back(std::thread([&cache, &wrongItems, t, keyCount, iterations]()
+        {
+            wxExplorerBrowserItem item;
+            wxUint64 random = 0x9E3779B97F4A7C15ULL * (t + 1);
+
+            for ( size_t i = 0; i < iterations; ++i )
+            {
+                random ^= random << 13;
+                random ^= random >> 7;
+                random ^= random << 17;
+
+                const wxUint64 key = (random >> 32) % keyCount;
+
+                if ( random % 5 == 0 )
+                    cache.Insert(key, key % 10, MakeItem(key));
+                else
+                if ( random % 97 == 0 )
+                    cache.InvalidateFolder(key % 10);
+                else
+                if ( cache.Lookup(key, item) && item.GetPath() != MakeItem(key).GetPath() )
+                    ++wrongItems;
+            }
+        }));
+    }
+
+    for ( auto& thread : threads )
+        thread.join();
+
+    WXEB_CHECK_EQUAL(wrongItems.load(), 0u);
+    WXEB_CHECK(cache.GetMemoryUsage() <= cache.GetMaxMemory());
+    WXEB_CHECK(cache.GetHitCount() > 0);
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestLookup();
+    TestEviction();
+    TestStress();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
@@ -0,0 +1,159 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_itempool.cpp
+// Purpose:     Tests of wxExplorerBrowserItemPool and wxExplorerBrowserBlockPool
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+namespace {
+
+typedef wxExplorerBrowserItemPool ItemPool;
+
+wxExplorerBrowserItem MakeItem(size_t i)
+{
+    wxExplorerBrowserItem item(wxExplorerBrowserItem::File);
+
+    item.SetPath(wxString::Format(wxS("/folder/item%zu"), i));
+    return item;
+}
+
+void TestReuse()
+{
+    ItemPool pool(2);
+    ItemPool::ItemPtr item = pool.Acquire(MakeItem(1));
+    const wxExplorerBrowserItem* const address = item.get();
+
+    WXEB_CHECK(item->GetPath() == wxS("/folder/item1"));
+    WXEB_CHECK_EQUAL(pool.GetCount(), 0u);
+
+    // a copy keeps the item referenced
+    ItemPool::ItemPtr copy = item;
+    item.reset();
+    WXEB_CHECK_EQUAL(pool.GetCount(), 0u);
+    copy.reset();
+    WXEB_CHECK_EQUAL(pool.GetCount(), 1u);
+
+    item = pool.Acquire(MakeItem(2));
+    WXEB_CHECK(item.get() == address);
+    WXEB_CHECK(item->GetPath() == wxS("/folder/item2"));
+    WXEB_CHECK_EQUAL(item->GetPathHash(), MakeItem(2).GetPathHash());
+
+    // at most two released items are kept
+    std::vector<ItemPool::ItemPtr> items;
+    for ( size_t i = 0; i < 5; ++i )
+        items.push_back(pool.Acquire(MakeItem(i)));
+    items.clear();
+    WXEB_CHECK_EQUAL(pool.GetCount(), 2u);
+}
+
+void TestOutlivingPool()
+{
+    ItemPool::ItemPtr item;
+
+    {
+        ItemPool pool;
+
+        item = pool.Acquire(MakeItem(1));
+    }
+
+    WXEB_CHECK(item->GetPath() == wxS("/folder/item1"));
+    item.reset();
+}
+
+// the items are acquired in one thread and released in others, as when the
+// items of the events are handed over to worker threads
+void TestThreads()
+{
+    const size_t threadCount = 4;
+    const size_t itemCount = 20000;
+    ItemPool pool(8);
+    std::vector<ItemPool::ItemPtr> slots(threadCount);
+    std::vector<std::atomic<bool>> full(threadCount);
+    std::atomic<bool> done(false);
+    std::atomic<size_t> wrongItems(0);
+    std::vector<std::thread> threads;
+
+    for ( auto& f : full )
+        f.store(false);
+
+    for ( size_t t = 0; t < threadCount; ++t )
+    {
+        threads.push_back(std::thread([&, t]()
+        {
+            for ( ;; )
+            {
+                if ( full[t].load(std::memory_order_acquire) )
+                {
+                    ItemPool::ItemPtr item = std::move(slots[t]);
+
+                    full[t].store(false, std::memory_order_release);
+                    if ( item->GetPathHash() != wxExplorerBrowserHashString(item->GetPath()) )
+                        ++wrongItems;
+                }
+                else
+                if ( done.load(std::memory_order_acquire) )
+                {
+                    break;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+
+    for ( size_t i = 0; i < itemCount; ++i )
+    {
+        const size_t t = i % threadCount;
+
+        while ( full[t].load(std::memory_order_acquire) )
+            std::this_thread::yield();
+
+        slots[t] = pool.Acquire(MakeItem(i));
+        full[t].store(true, std::memory_order_release);
+    }
+
+    done.store(true, std::memory_order_release);
+    for ( auto& thread : threads )
+        thread.join();
+
+    WXEB_CHECK_EQUAL(wrongItems.load(), 0u);
+    WXEB_CHECK(pool.GetCount() <= 8);
+}
+
+void TestBlockPool()
+{
+    wxExplorerBrowserBlockPool pool(64, 2);
+    void* blocks[3];
+
+    WXEB_CHECK_EQUAL(pool.GetBlockSize(), 64u);
+    for ( auto& block : blocks )
+        block = pool.Allocate();
+
+    pool.Free(blocks[0]);
+    pool.Free(blocks[1]);
+    pool.Free(blocks[2]); // over the limit, deleted
+
+    void* const block = pool.Allocate();
+    WXEB_CHECK(block == blocks[0] || block == blocks[1]);
+    pool.Free(block);
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestReuse();
+    TestOutlivingPool();
+    TestThreads();
+    TestBlockPool();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
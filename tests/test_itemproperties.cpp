@@ -0,0 +1,183 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_itemproperties.cpp
+// Purpose:     Tests of wxExplorerBrowserItemProperties filled in parallel
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+namespace {
+
+typedef wxExplorerBrowserItemProperties Properties;
+
+void TestReset()
+{
+    Properties properties;
+
+    WXEB_CHECK_EQUAL(properties.GetCount(), 0u);
+    WXEB_CHECK_EQUAL(properties.GetProperties(), 0u);
+
+    properties.Reset(10, Properties::Property_Size | Properties::Property_TypeName);
+    WXEB_CHECK_EQUAL(properties.GetCount(), 10u);
+    WXEB_CHECK_EQUAL(properties.GetProperties(), static_cast<wxUint32>(Properties::Property_Size | Properties::Property_TypeName));
+
+    // only the requested columns are used
+    WXEB_CHECK_EQUAL(properties.GetSizes().size(), 10u);
+    WXEB_CHECK_EQUAL(properties.GetTypeNames().size(), 10u);
+    WXEB_CHECK(properties.GetModificationTimes().empty());
+    WXEB_CHECK(properties.GetCreationTimes().empty());
+    WXEB_CHECK(properties.GetAttributes().empty());
+
+    properties.GetSizes()[3] = 1234;
+    properties.GetTypeNames()[3] = wxS("Text Document");
+    properties.SetFetched(3, Properties::Property_Size | Properties::Property_TypeName);
+    WXEB_CHECK_EQUAL(properties.GetFetched(3), static_cast<wxUint32>(Properties::Property_Size | Properties::Property_TypeName));
+    WXEB_CHECK_EQUAL(properties.GetFetched(4), 0u);
+
+    const size_t usage = properties.GetMemoryUsage();
+
+    WXEB_CHECK(usage >= 10 * (1 + sizeof(wxUint64) + sizeof(wxString)));
+
+    // resetting zeroes the columns, but keeps their memory for the next fetch
+    const wxUint64* sizes = properties.GetSizes().data();
+
+    properties.Reset(8, Properties::Property_All);
+    WXEB_CHECK(properties.GetSizes().data() == sizes);
+    WXEB_CHECK_EQUAL(properties.GetSizes()[3], 0u);
+    WXEB_CHECK(properties.GetTypeNames()[3].empty());
+    WXEB_CHECK_EQUAL(properties.GetFetched(3), 0u);
+    WXEB_CHECK_EQUAL(properties.GetAttributes().size(), 8u);
+    WXEB_CHECK_EQUAL(properties.GetCreationTimes().size(), 8u);
+
+    properties.Clear();
+    WXEB_CHECK_EQUAL(properties.GetCount(), 0u);
+    WXEB_CHECK(properties.GetSizes().empty());
+}
+
+// as wxExplorerBrowser::GetItemProperties() does, with made-up properties
+void FetchChunk(size_t begin, size_t end, Properties& properties)
+{
+    for ( size_t i = begin; i < end; ++i )
+    {
+        wxUint32 fetched = Properties::Property_Size | Properties::Property_ModificationTime;
+
+        properties.GetSizes()[i] = i * 10;
+        properties.GetModificationTimes()[i] = 132000000000000000ULL + i;
+
+        // some items do not have all the properties
+        if ( i % 3 )
+        {
+            properties.GetTypeNames()[i] = wxString::Format(wxS("Type %zu"), i % 7);
+            fetched |= Properties::Property_TypeName;
+        }
+
+        properties.SetFetched(i, fetched);
+    }
+}
+
+void TestParallelFill()
+{
+    const size_t count = 20000;
+    Properties properties;
+
+    for ( unsigned threadCount : { 1u, 4u, 0u } )
+    {
+        properties.Reset(count, Properties::Property_Size | Properties::Property_ModificationTime
+                                | Properties::Property_TypeName);
+
+        std::atomic<size_t> chunks(0);
+
+        wxExplorerBrowserParallelForChunks(count, 64, [&properties, &chunks](size_t begin, size_t end)
+            {
+                WXEB_CHECK(end - begin <= 64);
+                FetchChunk(begin, end, properties);
+                ++chunks;
+            }, threadCount);
+
+        WXEB_CHECK_EQUAL(chunks.load(), (count + 63) / 64);
+
+        size_t missing = 0;
+
+        for ( size_t i = 0; i < count; ++i )
+        {
+            const wxUint32 fetched = properties.GetFetched(i);
+
+            if ( properties.GetSizes()[i] != i * 10 || !(fetched & Properties::Property_Size) )
+                ++missing;
+            if ( ((fetched & Properties::Property_TypeName) != 0) != (i % 3 != 0) )
+                ++missing;
+            if ( i % 3 && properties.GetTypeNames()[i] != wxString::Format(wxS("Type %zu"), i % 7) )
+                ++missing;
+        }
+
+        WXEB_CHECK_EQUAL(missing, 0u);
+    }
+}
+
+void TestBackgroundFill()
+{
+    // as wxExplorerBrowser::RequestItemProperties() does: the caller is not blocked,
+    // a background thread fills the properties with the help of the thread pool
+    const size_t count = 5000;
+    Properties properties;
+    std::atomic<bool> cancelled(false);
+    std::atomic<size_t> filled(0);
+
+    properties.Reset(count, Properties::Property_Size | Properties::Property_ModificationTime
+                            | Properties::Property_TypeName);
+
+    std::thread thread([&]()
+    {
+        wxExplorerBrowserParallelForChunks(count, 64, [&](size_t begin, size_t end)
+            {
+                if ( cancelled )
+                    return;
+
+                FetchChunk(begin, end, properties);
+                filled += end - begin;
+            });
+    });
+
+    thread.join();
+    WXEB_CHECK_EQUAL(filled.load(), count);
+
+    // once cancelled, the remaining chunks are skipped
+    properties.Reset(count, Properties::Property_Size | Properties::Property_ModificationTime
+                            | Properties::Property_TypeName);
+    filled = 0;
+
+    std::thread cancelling([&]()
+    {
+        wxExplorerBrowserParallelForChunks(count, 64, [&](size_t begin, size_t end)
+            {
+                if ( cancelled )
+                    return;
+
+                FetchChunk(begin, end, properties);
+                if ( (filled += end - begin) >= 640 )
+                    cancelled = true;
+            }, 1);
+    });
+
+    cancelling.join();
+    WXEB_CHECK_EQUAL(filled.load(), 640u);
+    WXEB_CHECK_EQUAL(properties.GetFetched(639), static_cast<wxUint32>(Properties::Property_Size
+                                                                       | Properties::Property_ModificationTime));
+    WXEB_CHECK_EQUAL(properties.GetFetched(640), 0u);
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestReset();
+    TestParallelFill();
+    TestBackgroundFill();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
@@ -0,0 +1,137 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_listingdelta.cpp
+// Purpose:     Tests of wxExplorerBrowserListingFingerprint
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+namespace {
+
+wxExplorerBrowserItem MakeItem(const wxString& path, const wxString& displayName,
+                               wxExplorerBrowserItem::Type type = wxExplorerBrowserItem::File)
+{
+    wxExplorerBrowserItem item(type);
+
+    item.SetPath(path);
+    item.SetDisplayName(displayName);
+    return item;
+}
+
+bool Contains(const wxExplorerBrowserItem::List& items, const wxString& displayName)
+{
+    for ( const auto& item : items )
+    {
+        if ( item.GetDisplayName() == displayName )
+            return true;
+    }
+
+    return false;
+}
+
+void TestFirstUpdate()
+{
+    wxExplorerBrowserListingFingerprint fingerprint;
+    wxExplorerBrowserListingDelta delta;
+    wxExplorerBrowserItem::List items;
+
+    items.push_back(MakeItem(wxS("/a"), wxS("a")));
+    items.push_back(MakeItem(wxS("/b"), wxS("b")));
+
+    fingerprint.Update(items, &delta);
+    WXEB_CHECK_EQUAL(delta.added.size(), 2u);
+    WXEB_CHECK(delta.removed.empty() && delta.changed.empty());
+    WXEB_CHECK_EQUAL(fingerprint.GetCount(), 2u);
+
+    fingerprint.Update(items, &delta);
+    WXEB_CHECK(delta.IsEmpty());
+
+    fingerprint.Clear();
+    WXEB_CHECK_EQUAL(fingerprint.GetCount(), 0u);
+    fingerprint.Update(items, &delta);
+    WXEB_CHECK_EQUAL(delta.added.size(), 2u);
+}
+
+void TestChanges()
+{
+    wxExplorerBrowserListingFingerprint fingerprint;
+    wxExplorerBrowserListingDelta delta;
+    wxExplorerBrowserItem::List items;
+
+    items.push_back(MakeItem(wxS("/kept"), wxS("kept")));
+    items.push_back(MakeItem(wxS("/removed"), wxS("removed")));
+    items.push_back(MakeItem(wxS("/renamed"), wxS("renamed")));
+    items.push_back(MakeItem(wxS("/retyped"), wxS("retyped")));
+    fingerprint.Update(items, nullptr);
+
+    items.erase(items.begin() + 1);
+    items[1].SetDisplayName(wxS("renamed2"));
+    items[2].SetType(wxExplorerBrowserItem::Directory);
+    items.push_back(MakeItem(wxS("/added"), wxS("added")));
+
+    fingerprint.Update(std::move(items), &delta);
+    WXEB_CHECK_EQUAL(delta.added.size(), 1u);
+    WXEB_CHECK(Contains(delta.added, wxS("added")));
+    WXEB_CHECK_EQUAL(delta.removed.size(), 1u);
+    WXEB_CHECK(Contains(delta.removed, wxS("removed")));
+    WXEB_CHECK_EQUAL(delta.changed.size(), 2u);
+    WXEB_CHECK(Contains(delta.changed, wxS("renamed2")));
+    WXEB_CHECK(Contains(delta.changed, wxS("retyped")));
+    WXEB_CHECK_EQUAL(fingerprint.GetCount(), 4u);
+    WXEB_CHECK(fingerprint.GetItems()[3].GetPath() == wxS("/added"));
+}
+
+void TestIdentity()
+{
+    wxExplorerBrowserListingFingerprint fingerprint;
+    wxExplorerBrowserListingDelta delta;
+    wxExplorerBrowserItem::List items;
+
+    // a virtual item without a path must not be taken for a file with a path equal to its name
+    items.push_back(MakeItem(wxString(), wxS("/x"), wxExplorerBrowserItem::Other));
+    items.push_back(MakeItem(wxS("/x"), wxS("x")));
+    WXEB_CHECK(!wxExplorerBrowserListingFingerprint::IsSameItem(items[0], items[1]));
+    WXEB_CHECK(wxExplorerBrowserListingFingerprint::IsSameItem(items[1], MakeItem(wxS("/x"), wxS("y"))));
+
+    fingerprint.Update(items, &delta);
+    WXEB_CHECK_EQUAL(delta.added.size(), 2u);
+
+    items.erase(items.begin());
+    fingerprint.Update(items, &delta);
+    WXEB_CHECK_EQUAL(delta.removed.size(), 1u);
+    WXEB_CHECK(delta.added.empty() && delta.changed.empty());
+    WXEB_CHECK(Contains(delta.removed, wxS("/x")));
+}
+
+void TestDuplicates()
+{
+    wxExplorerBrowserListingFingerprint fingerprint;
+    wxExplorerBrowserListingDelta delta;
+    wxExplorerBrowserItem::List items;
+
+    // only the last of the items with the same path is tracked
+    items.push_back(MakeItem(wxS("/dup"), wxS("first")));
+    items.push_back(MakeItem(wxS("/dup"), wxS("last")));
+
+    fingerprint.Update(items, &delta);
+    WXEB_CHECK_EQUAL(delta.added.size(), 1u);
+    WXEB_CHECK(Contains(delta.added, wxS("last")));
+
+    items.pop_back();
+    fingerprint.Update(items, &delta);
+    WXEB_CHECK(delta.added.empty() && delta.removed.empty());
+    WXEB_CHECK_EQUAL(delta.changed.size(), 1u);
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestFirstUpdate();
+    TestChanges();
+    TestIdentity();
+    TestDuplicates();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
@@ -0,0 +1,129 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_maskmatcher.cpp
+// Purpose:     Tests of wxExplorerBrowserMaskMatcher
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+namespace {
+
+typedef wxExplorerBrowserItem Item;
+
+Item MakeItem(Item::Type type, const wxString& path, const wxString& displayName)
+{
+    Item item(type);
+
+    item.SetPath(path);
+    item.SetDisplayName(displayName);
+    return item;
+}
+
+wxArrayString MakeMasks(const wxString& mask1, const wxString& mask2 = wxString())
+{
+    wxArrayString masks;
+
+    masks.push_back(mask1);
+    if ( !mask2.empty() )
+        masks.push_back(mask2);
+    return masks;
+}
+
+void TestNames()
+{
+    wxString name;
+
+    // the filename part of the path for the filesystem items
+    wxExplorerBrowserMaskMatcher::GetItemName(MakeItem(Item::File, wxS("C:\\Docs\\Report.docx"), wxS("Report")), name);
+    WXEB_CHECK(name == wxS("Report.docx"));
+
+    wxExplorerBrowserMaskMatcher::GetItemName(MakeItem(Item::Directory, wxS("/home/user/src"), wxS("Source")), name);
+    WXEB_CHECK(name == wxS("src"));
+
+    wxExplorerBrowserMaskMatcher::GetItemName(MakeItem(Item::File, wxS("relative.txt"), wxString()), name);
+    WXEB_CHECK(name == wxS("relative.txt"));
+
+    // the display name for the others
+    wxExplorerBrowserMaskMatcher::GetItemName(MakeItem(Item::Other, wxString(), wxS("Control Panel")), name);
+    WXEB_CHECK(name == wxS("Control Panel"));
+
+    wxExplorerBrowserMaskMatcher::GetMatchName(MakeItem(Item::File, wxS("C:\\Docs\\Report.docx"), wxString()), name);
+    WXEB_CHECK(name == wxS("REPORT.DOCX"));
+}
+
+void TestMatching()
+{
+    wxExplorerBrowserMaskMatcher matcher(MakeMasks(wxS("*.doc*"), wxS("budget201?.*")), Item::File);
+    wxString buffer;
+
+    WXEB_CHECK(!matcher.IsEmpty());
+    WXEB_CHECK_EQUAL(matcher.GetMasks().size(), 2u);
+    WXEB_CHECK(matcher.GetMasks()[0] == wxS("*.DOC*"));
+    WXEB_CHECK(matcher.AppliesTo(Item::File));
+    WXEB_CHECK(!matcher.AppliesTo(Item::Directory));
+    WXEB_CHECK(!matcher.AppliesTo(Item::Other));
+
+    // case-insensitive
+    WXEB_CHECK(matcher.MatchesName(MakeItem(Item::File, wxS("C:\\a\\Letter.DOCX"), wxString()), buffer));
+    WXEB_CHECK(matcher.MatchesName(MakeItem(Item::File, wxS("C:\\a\\letter.doc"), wxString()), buffer));
+    WXEB_CHECK(matcher.MatchesName(MakeItem(Item::File, wxS("C:\\a\\Budget2019.xlsx"), wxString()), buffer));
+    WXEB_CHECK(!matcher.MatchesName(MakeItem(Item::File, wxS("C:\\a\\Budget2020x.xlsx"), wxString()), buffer));
+    WXEB_CHECK(!matcher.MatchesName(MakeItem(Item::File, wxS("C:\\a\\letter.txt"), wxString()), buffer));
+
+    // the folders in the path do not matter
+    WXEB_CHECK(!matcher.MatchesName(MakeItem(Item::File, wxS("C:\\x.doc\\letter.txt"), wxString()), buffer));
+
+    WXEB_CHECK(matcher.MatchesFileName(wxS("notes.Doc"), buffer));
+    WXEB_CHECK(!matcher.MatchesFileName(wxS("notes.txt"), buffer));
+
+    // virtual items are matched by their display name
+    wxExplorerBrowserMaskMatcher others(MakeMasks(wxS("control*")), Item::Other);
+
+    WXEB_CHECK(others.MatchesName(MakeItem(Item::Other, wxString(), wxS("Control Panel")), buffer));
+    WXEB_CHECK(!others.MatchesName(MakeItem(Item::Other, wxS("C:\\control.txt"), wxS("Network")), buffer));
+}
+
+void TestSetAndAdd()
+{
+    wxExplorerBrowserMaskMatcher matcher;
+    wxString buffer;
+
+    WXEB_CHECK(matcher.IsEmpty());
+    WXEB_CHECK_EQUAL(matcher.GetItemTypes(), 0u);
+    WXEB_CHECK(!matcher.MatchesFileName(wxS("a.txt"), buffer));
+
+    // adding keeps the masks added before, like wxExplorerBrowser::SetFilter()
+    matcher.Add(MakeMasks(wxS("*.txt")), Item::File);
+    matcher.Add(MakeMasks(wxS("*.md")), Item::File | Item::Directory);
+    WXEB_CHECK_EQUAL(matcher.GetMasks().size(), 2u);
+    WXEB_CHECK_EQUAL(matcher.GetItemTypes(), static_cast<wxUint32>(Item::File | Item::Directory));
+    WXEB_CHECK(matcher.MatchesFileName(wxS("a.txt"), buffer));
+    WXEB_CHECK(matcher.MatchesFileName(wxS("ReadMe.md"), buffer));
+
+    const size_t usage = matcher.GetMemoryUsage();
+
+    WXEB_CHECK(usage > 0);
+
+    // setting replaces them
+    matcher.Set(MakeMasks(wxS("*.cpp")), Item::File);
+    WXEB_CHECK_EQUAL(matcher.GetMasks().size(), 1u);
+    WXEB_CHECK(!matcher.MatchesFileName(wxS("a.txt"), buffer));
+    WXEB_CHECK(matcher.MatchesFileName(wxS("a.CPP"), buffer));
+
+    matcher.Clear();
+    WXEB_CHECK(matcher.IsEmpty());
+    WXEB_CHECK_EQUAL(matcher.GetItemTypes(), 0u);
+    WXEB_CHECK(!matcher.MatchesFileName(wxS("a.cpp"), buffer));
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestNames();
+    TestMatching();
+    TestSetAndAdd();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
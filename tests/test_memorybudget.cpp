@@ -0,0 +1,88 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_memorybudget.cpp
+// Purpose:     Tests of wxExplorerBrowserMemoryBudget and the memory usage estimates
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+namespace {
+
+typedef wxExplorerBrowserMemoryBudget Budget;
+
+void TestBudget()
+{
+    Budget budget;
+
+    WXEB_CHECK(!budget.IsEnabled());
+    WXEB_CHECK_EQUAL(budget.GetLevel(size_t(-1)), Budget::Level_Normal);
+    WXEB_CHECK_EQUAL(budget.GetExcess(size_t(-1)), 0u);
+
+    budget.SetLimits(1000, 2000);
+    WXEB_CHECK(budget.IsEnabled());
+    WXEB_CHECK_EQUAL(budget.GetLevel(1000), Budget::Level_Normal);
+    WXEB_CHECK_EQUAL(budget.GetLevel(1001), Budget::Level_Soft);
+    WXEB_CHECK_EQUAL(budget.GetLevel(2001), Budget::Level_Hard);
+    WXEB_CHECK_EQUAL(budget.GetExcess(900), 0u);
+    WXEB_CHECK_EQUAL(budget.GetExcess(2500), 1500u);
+
+    // without the soft limit, the excess is over the hard one
+    budget.SetLimits(0, 2000);
+    WXEB_CHECK_EQUAL(budget.GetLevel(1500), Budget::Level_Normal);
+    WXEB_CHECK_EQUAL(budget.GetLevel(2001), Budget::Level_Hard);
+    WXEB_CHECK_EQUAL(budget.GetExcess(2500), 500u);
+}
+
+void TestUsage()
+{
+    wxExplorerBrowserMemoryUsage usage;
+
+    usage.itemLists = 1;
+    usage.cachedConversions = 2;
+    usage.filters = 4;
+    usage.pendingEvents = 8;
+    usage.sharedItemCache = 1000;
+
+    // the shared cache is charged to no control
+    WXEB_CHECK_EQUAL(usage.GetTotal(), 15u);
+}
+
+void TestEstimates()
+{
+    const wxString shortString = wxS("a");
+    const wxString longString(1000, wxS('x'));
+
+    WXEB_CHECK(wxExplorerBrowserGetMemoryUsage(shortString) >= sizeof(wxString));
+    WXEB_CHECK(wxExplorerBrowserGetMemoryUsage(longString) >= sizeof(wxString) + 1000);
+
+    wxArrayString strings;
+    const size_t emptyArray = wxExplorerBrowserGetMemoryUsage(strings);
+
+    strings.push_back(longString);
+    WXEB_CHECK(wxExplorerBrowserGetMemoryUsage(strings) >= emptyArray + 1000);
+
+    wxExplorerBrowserItem item(wxExplorerBrowserItem::File);
+    const size_t emptyItem = wxExplorerBrowserGetMemoryUsage(item);
+
+    WXEB_CHECK(emptyItem >= sizeof(item));
+    item.SetPath(longString);
+    WXEB_CHECK(wxExplorerBrowserGetMemoryUsage(item) >= emptyItem + 1000);
+
+    wxExplorerBrowserItem::List items;
+
+    items.reserve(10);
+    items.push_back(item);
+    WXEB_CHECK(wxExplorerBrowserGetMemoryUsage(items) >= 10 * sizeof(item) + 1000);
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestBudget();
+    TestUsage();
+    TestEstimates();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
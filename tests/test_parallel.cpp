@@ -0,0 +1,269 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_parallel.cpp
+// Purpose:     Tests of the thread pool, the worker thread and the parallel algorithms
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+namespace {
+
+void TestThreadPool()
+{
+    {
+        wxExplorerBrowserThreadPool pool(3);
+        std::vector<std::atomic<int>> calls(1000);
+
+        WXEB_CHECK_EQUAL(pool.GetWorkerCount(), 3u);
+
+        for ( auto& c : calls )
+            c = 0;
+
+        pool.Run(calls.size(), [&calls](size_t task) { ++calls[task]; });
+        WXEB_CHECK(std::all_of(calls.begin(), calls.end(), [](const std::atomic<int>& c) { return c == 1; }));
+
+        // no tasks and no workers
+        pool.Run(0, [](size_t) { WXEB_CHECK(!"called without tasks"); });
+
+        size_t sum = 0;
+
+        pool.Run(10, [&sum](size_t task) { sum += task; }, 0);
+        WXEB_CHECK_EQUAL(sum, 45u);
+
+        // a task running another job, also when all the workers are busy with this one
+        std::atomic<size_t> nested(0);
+
+        pool.Run(8, [&pool, &nested](size_t)
+            {
+                pool.Run(100, [&nested](size_t) { ++nested; });
+            });
+        WXEB_CHECK_EQUAL(nested.load(), 800u);
+    } // the destructor stops the workers
+
+    // the same pool serves many calls
+    wxExplorerBrowserThreadPool& pool = wxExplorerBrowserThreadPool::Get();
+
+    WXEB_CHECK(&pool == &wxExplorerBrowserThreadPool::Get());
+
+    std::atomic<size_t> total(0);
+
+    for ( size_t i = 0; i < 1000; ++i )
+        pool.Run(4, [&total](size_t task) { total += task; });
+    WXEB_CHECK_EQUAL(total.load(), 6000u);
+}
+
+void TestWorkerThread()
+{
+    wxExplorerBrowserWorkerThread worker;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<int> order;
+    bool open = false;
+
+    WXEB_CHECK(worker.IsIdle());
+
+    // the tasks are run in the order they were posted
+    worker.Post([&]()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            condition.wait(lock, [&open]() { return open; });
+            order.push_back(0);
+        });
+    for ( int i = 1; i < 10; ++i )
+        worker.Post([&order, i]() { order.push_back(i); });
+    WXEB_CHECK(!worker.IsIdle());
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        open = true;
+        condition.notify_all();
+    }
+
+    worker.Post([&]()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            condition.notify_all();
+        });
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        condition.wait(lock, [&order]() { return order.size() == 10; });
+    }
+
+    worker.Stop();
+    WXEB_CHECK(worker.IsIdle());
+    for ( int i = 0; i < 10; ++i )
+        WXEB_CHECK_EQUAL(order[i], i);
+
+    // Stop() waits for the running task and drops the others
+    std::atomic<int> started(0), finished(0);
+
+    open = false;
+    worker.Post([&]()
+        {
+            ++started;
+            std::unique_lock<std::mutex> lock(mutex);
+
+            condition.wait(lock, [&open]() { return open; });
+            ++finished;
+        });
+    worker.Post([&finished]() { finished += 100; });
+
+    while ( !started )
+        std::this_thread::yield();
+
+    // the gate is opened after Stop() dropped the second task
+    std::thread opener([&]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+            std::lock_guard<std::mutex> lock(mutex);
+
+            open = true;
+            condition.notify_all();
+        });
+
+    worker.Stop();
+    opener.join();
+    WXEB_CHECK_EQUAL(finished.load(), 1);
+
+    // started again by the next task, the destructor joins it
+    worker.Post([&finished]() { ++finished; });
+    while ( finished != 2 )
+        std::this_thread::yield();
+    WXEB_CHECK_EQUAL(finished.load(), 2);
+}
+
+void TestParallelFor()
+{
+    for ( unsigned threadCount : { 0u, 1u, 2u, 5u, 64u } )
+    {
+        for ( size_t count : { 0u, 1u, 7u, 1000u, 100003u } )
+        {
+            std::vector<std::atomic<int>> calls(count);
+            std::atomic<size_t> rangeCount(0);
+
+            for ( auto& c : calls )
+                c = 0;
+
+            wxExplorerBrowserParallelFor(count, [&calls, &rangeCount](size_t begin, size_t end)
+                {
+                    WXEB_CHECK(begin < end);
+                    for ( size_t i = begin; i < end; ++i )
+                        ++calls[i];
+                    ++rangeCount;
+                }, threadCount, 100);
+
+            WXEB_CHECK(std::all_of(calls.begin(), calls.end(), [](const std::atomic<int>& c) { return c == 1; }));
+            if ( threadCount )
+                WXEB_CHECK(rangeCount <= threadCount);
+        }
+    }
+
+    // ranges smaller than the minimum are not split
+    size_t rangeCount = 0;
+
+    wxExplorerBrowserParallelFor(1000, [&rangeCount](size_t begin, size_t end)
+        {
+            WXEB_CHECK_EQUAL(begin, 0u);
+            WXEB_CHECK_EQUAL(end, 1000u);
+            ++rangeCount;
+        }, 8, 1000);
+    WXEB_CHECK_EQUAL(rangeCount, 1u);
+}
+
+void TestParallelForChunks()
+{
+    for ( unsigned threadCount : { 0u, 1u, 3u } )
+    {
+        for ( size_t chunkSize : { 0u, 1u, 10u, 4096u } )
+        {
+            const size_t count = 10007;
+            std::vector<std::atomic<int>> calls(count);
+
+            for ( auto& c : calls )
+                c = 0;
+
+            wxExplorerBrowserParallelForChunks(count, chunkSize, [&calls, chunkSize](size_t begin, size_t end)
+                {
+                    WXEB_CHECK(begin < end);
+                    WXEB_CHECK(end - begin <= std::max<size_t>(chunkSize, 1));
+                    for ( size_t i = begin; i < end; ++i )
+                        ++calls[i];
+                }, threadCount);
+
+            WXEB_CHECK(std::all_of(calls.begin(), calls.end(), [](const std::atomic<int>& c) { return c == 1; }));
+        }
+    }
+}
+
+void TestParallelSort()
+{
+    std::mt19937 random(38);
+
+    for ( unsigned threadCount : { 1u, 2u, 3u, 8u } )
+    {
+        for ( size_t count : { 0u, 1u, 100u, 54321u } )
+        {
+            // a few keys repeated many times, like the types of the items
+            std::vector<int> values(count), expected;
+
+            for ( auto& value : values )
+                value = static_cast<int>(random() % 100);
+
+            expected = values;
+            std::sort(expected.begin(), expected.end());
+
+            wxExplorerBrowserParallelSort(values.begin(), values.end(), std::less<int>(), threadCount, 1000);
+
+            WXEB_CHECK(values == expected);
+        }
+    }
+}
+
+void TestItemSorter()
+{
+    wxExplorerBrowserItem::List items;
+
+    for ( size_t i = 0; i < 20000; ++i )
+    {
+        wxExplorerBrowserItem item(wxExplorerBrowserItem::File);
+
+        item.SetDisplayName(wxString::Format(wxS("File %zu"), (i * 7919) % 20000));
+        items.push_back(item);
+    }
+
+    wxExplorerBrowserItemSorter::Sort(items, wxExplorerBrowserItemSorter::Order_Natural, 4);
+
+    for ( size_t i = 0; i < items.size(); ++i )
+        WXEB_CHECK(items[i].GetDisplayName() == wxString::Format(wxS("File %zu"), i));
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestThreadPool();
+    TestWorkerThread();
+    TestParallelFor();
+    TestParallelForChunks();
+    TestParallelSort();
+    TestItemSorter();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
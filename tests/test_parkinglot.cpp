@@ -0,0 +1,86 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_parkinglot.cpp
+// Purpose:     Tests of wxExplorerBrowserParkingLot
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+namespace {
+
+typedef wxExplorerBrowserParkingLot ParkingLot;
+
+// the views are only compared, any distinct addresses will do
+const int g_views[5] = { 0 };
+
+ParkingLot::ViewId View(size_t i) { return &g_views[i]; }
+
+void TestMaxViews()
+{
+    ParkingLot lot(2);
+    ParkingLot::ViewIdList evicted;
+
+    lot.Park(View(0), 0, evicted);
+    lot.Park(View(1), 0, evicted);
+    WXEB_CHECK(evicted.empty());
+    WXEB_CHECK_EQUAL(lot.GetCount(), 2u);
+
+    // parking again makes the view the most recently parked one
+    lot.Park(View(0), 0, evicted);
+    lot.Park(View(2), 0, evicted);
+    WXEB_CHECK_EQUAL(evicted.size(), 1u);
+    WXEB_CHECK(!evicted.empty() && evicted[0] == View(1));
+    WXEB_CHECK(!lot.IsParked(View(1)));
+    WXEB_CHECK(lot.IsParked(View(0)) && lot.IsParked(View(2)));
+
+    WXEB_CHECK(lot.Unpark(View(0)));
+    WXEB_CHECK(!lot.Unpark(View(0)));
+    WXEB_CHECK(!lot.Unpark(View(1)));
+    WXEB_CHECK_EQUAL(lot.GetCount(), 1u);
+
+    // lowering the budget evicts the views over it
+    evicted.clear();
+    lot.Park(View(3), 0, evicted);
+    lot.SetBudget(1, 0, evicted);
+    WXEB_CHECK_EQUAL(evicted.size(), 1u);
+    WXEB_CHECK(!evicted.empty() && evicted[0] == View(2));
+    WXEB_CHECK_EQUAL(lot.GetMaxViews(), 1u);
+}
+
+void TestMaxMemory()
+{
+    ParkingLot lot(0, 1000);
+    ParkingLot::ViewIdList evicted;
+
+    lot.Park(View(0), 400, evicted);
+    lot.Park(View(1), 400, evicted);
+    WXEB_CHECK_EQUAL(lot.GetMemory(), 800u);
+
+    lot.Park(View(2), 300, evicted);
+    WXEB_CHECK_EQUAL(evicted.size(), 1u);
+    WXEB_CHECK_EQUAL(lot.GetMemory(), 700u);
+
+    // re-parking updates the memory of the view
+    evicted.clear();
+    lot.Park(View(1), 100, evicted);
+    WXEB_CHECK(evicted.empty());
+    WXEB_CHECK_EQUAL(lot.GetMemory(), 400u);
+
+    // a view over the whole budget evicts everything including itself
+    lot.Park(View(3), 2000, evicted);
+    WXEB_CHECK_EQUAL(evicted.size(), 3u);
+    WXEB_CHECK(!evicted.empty() && evicted.back() == View(3));
+    WXEB_CHECK_EQUAL(lot.GetCount(), 0u);
+    WXEB_CHECK_EQUAL(lot.GetMemory(), 0u);
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestMaxViews();
+    TestMaxMemory();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
@@ -0,0 +1,199 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_recursiveenumerator.cpp
+// Purpose:     Tests of wxExplorerBrowserRecursiveEnumerator
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <set>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+using wxExplorerBrowserTesting::TempDirectory;
+
+namespace {
+
+typedef wxExplorerBrowserRecursiveEnumerator Enumerator;
+
+const wxUint32 AllTypes = wxExplorerBrowserItem::File | wxExplorerBrowserItem::Directory;
+
+bool CreateTree(const TempDirectory& dir)
+{
+    return dir.AddFile("a.txt")
+           && dir.AddFile("b.log")
+           && dir.AddFile("sub/c.txt")
+           && dir.AddFile("sub/deeper/d.TXT")
+           && dir.AddDirectory("empty");
+}
+
+// the display names of the items
+std::set<wxString> GetNames(const wxExplorerBrowserItem::List& items)
+{
+    std::set<wxString> names;
+
+    for ( const auto& item : items )
+        names.insert(item.GetDisplayName());
+
+    return names;
+}
+
+wxExplorerBrowserItem::List Enumerate(const wxString& root, wxUint32 itemTypes,
+                                      const wxExplorerBrowserMaskMatcher& filter, unsigned maxDepth = 0)
+{
+    Enumerator enumerator(2);
+    wxExplorerBrowserItem::List items;
+
+    WXEB_CHECK(enumerator.Start(root, itemTypes, filter, maxDepth));
+    enumerator.Wait();
+    WXEB_CHECK(!enumerator.IsRunning());
+    WXEB_CHECK(!enumerator.IsCancelled());
+    enumerator.TakeItems(items);
+    WXEB_CHECK_EQUAL(enumerator.GetFoundCount(), items.size());
+
+    return items;
+}
+
+void TestEnumerate()
+{
+    TempDirectory dir("enumerator_tree");
+
+    WXEB_CHECK(CreateTree(dir));
+
+    const wxExplorerBrowserItem::List items = Enumerate(dir.GetPath(), AllTypes, wxExplorerBrowserMaskMatcher());
+
+    WXEB_CHECK_EQUAL(items.size(), 7u);
+    WXEB_CHECK(GetNames(items) == std::set<wxString>({ wxS("a.txt"), wxS("b.log"), wxS("sub"), wxS("c.txt"),
+                                                        wxS("deeper"), wxS("d.TXT"), wxS("empty") }));
+
+    for ( const auto& item : items )
+    {
+        WXEB_CHECK(item.GetPath().StartsWith(dir.GetPath()));
+        WXEB_CHECK(item.GetPath().EndsWith(item.GetDisplayName()));
+        WXEB_CHECK_EQUAL(item.GetId(), 0u);
+
+        if ( item.GetDisplayName() == wxS("sub") )
+        {
+            WXEB_CHECK_EQUAL(item.GetType(), wxExplorerBrowserItem::Directory);
+            WXEB_CHECK_EQUAL(item.GetSFGAO(), 0x60000000u);
+        }
+        else if ( item.GetDisplayName() == wxS("c.txt") )
+        {
+            WXEB_CHECK_EQUAL(item.GetType(), wxExplorerBrowserItem::File);
+            WXEB_CHECK_EQUAL(item.GetSFGAO(), 0x40400000u);
+            WXEB_CHECK(item.GetPath() == dir.GetPath("sub/c.txt"));
+        }
+    }
+
+    // only the files, to the depth of 2
+    const wxExplorerBrowserItem::List files = Enumerate(dir.GetPath(), wxExplorerBrowserItem::File,
+                                                        wxExplorerBrowserMaskMatcher(), 2);
+
+    WXEB_CHECK(GetNames(files) == std::set<wxString>({ wxS("a.txt"), wxS("b.log"), wxS("c.txt") }));
+}
+
+void TestFilter()
+{
+    TempDirectory dir("enumerator_filter");
+    wxArrayString masks;
+
+    WXEB_CHECK(CreateTree(dir));
+    masks.push_back(wxS("*.txt"));
+
+    // the directories are walked even if they do not match
+    const wxExplorerBrowserMaskMatcher filesOnly(masks, wxExplorerBrowserItem::File);
+
+    WXEB_CHECK(GetNames(Enumerate(dir.GetPath(), AllTypes, filesOnly))
+               == std::set<wxString>({ wxS("a.txt"), wxS("sub"), wxS("c.txt"), wxS("deeper"),
+                                       wxS("d.TXT"), wxS("empty") }));
+
+    // and also when the filter applies to them
+    const wxExplorerBrowserMaskMatcher both(masks, AllTypes);
+
+    WXEB_CHECK(GetNames(Enumerate(dir.GetPath(), AllTypes, both))
+               == std::set<wxString>({ wxS("a.txt"), wxS("c.txt"), wxS("d.TXT") }));
+}
+
+void TestBatches()
+{
+    TempDirectory dir("enumerator_batches");
+    const size_t count = 400;
+
+    for ( size_t i = 0; i < count; ++i )
+        WXEB_CHECK(dir.AddFile(wxString::Format(wxS("d%zu/f%zu.txt"), i % 40, i).utf8_str()));
+
+    // full batches of one item and the incomplete batches of any age
+    // are taken while the workers add to them, none is lost or taken twice
+    for ( const size_t batchSize : { size_t(1), size_t(1000000) } )
+    {
+        Enumerator enumerator(4);
+        wxExplorerBrowserItem::List items;
+        std::set<wxString> paths;
+
+        WXEB_CHECK(enumerator.Start(dir.GetPath(), wxExplorerBrowserItem::File, wxExplorerBrowserMaskMatcher(),
+                                    0, batchSize, 0));
+        while ( enumerator.IsRunning() )
+            enumerator.TakeItems(items);
+        enumerator.TakeItems(items);
+
+        for ( const auto& item : items )
+            paths.insert(item.GetPath());
+
+        WXEB_CHECK_EQUAL(items.size(), count);
+        WXEB_CHECK_EQUAL(paths.size(), count);
+        WXEB_CHECK_EQUAL(enumerator.GetFoundCount(), count);
+        WXEB_CHECK_EQUAL(enumerator.GetDirectoryCount(), 41u);
+        WXEB_CHECK(!enumerator.TakeItems(items));
+    }
+}
+
+void TestRunning()
+{
+    TempDirectory dir("enumerator_running");
+    Enumerator enumerator(2);
+    wxExplorerBrowserItem::List items;
+
+    WXEB_CHECK(CreateTree(dir));
+
+    // running as soon as started
+    WXEB_CHECK(enumerator.Start(dir.GetPath(), AllTypes, wxExplorerBrowserMaskMatcher()));
+    WXEB_CHECK(!enumerator.Start(dir.GetPath(), AllTypes, wxExplorerBrowserMaskMatcher()));
+    enumerator.Cancel();
+    enumerator.Wait();
+    WXEB_CHECK(enumerator.IsCancelled());
+    enumerator.TakeItems(items);
+    WXEB_CHECK(items.size() <= 7u);
+
+    // the items not taken are dropped when started again
+    items.clear();
+    WXEB_CHECK(enumerator.Start(dir.GetPath(), wxExplorerBrowserItem::Directory, wxExplorerBrowserMaskMatcher()));
+    WXEB_CHECK(!enumerator.IsCancelled());
+    enumerator.Wait();
+    WXEB_CHECK(enumerator.Start(dir.GetPath(), AllTypes, wxExplorerBrowserMaskMatcher()));
+    enumerator.Wait();
+    WXEB_CHECK(enumerator.TakeItems(items));
+    WXEB_CHECK_EQUAL(items.size(), 7u);
+
+    // appended to the items passed
+    WXEB_CHECK(enumerator.Start(dir.GetPath(), wxExplorerBrowserItem::Directory, wxExplorerBrowserMaskMatcher()));
+    enumerator.Wait();
+    WXEB_CHECK(enumerator.TakeItems(items));
+    WXEB_CHECK_EQUAL(items.size(), 10u);
+
+    // a missing root
+    WXEB_CHECK(enumerator.Start(dir.GetPath("missing"), AllTypes, wxExplorerBrowserMaskMatcher()));
+    enumerator.Wait();
+    WXEB_CHECK_EQUAL(enumerator.GetErrorCount(), 1u);
+    WXEB_CHECK_EQUAL(enumerator.GetFoundCount(), 0u);
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestEnumerate();
+    TestFilter();
+    TestBatches();
+    TestRunning();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
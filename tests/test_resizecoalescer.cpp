@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_resizecoalescer.cpp
+// Purpose:     Tests of wxExplorerBrowserResizeCoalescer
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+namespace {
+
+void TestNotCoalescing()
+{
+    wxExplorerBrowserResizeCoalescer coalescer;
+    wxUint64 deadline;
+
+    WXEB_CHECK(!coalescer.IsCoalescing());
+    WXEB_CHECK(coalescer.OnSizeChanged(wxSize(100, 100), 0));
+    WXEB_CHECK(coalescer.GetPendingSize() == wxSize(100, 100));
+    coalescer.OnApplied(0);
+    WXEB_CHECK(!coalescer.HasPendingSize());
+    WXEB_CHECK(!coalescer.GetDeadline(deadline));
+}
+
+void TestSettleDelay()
+{
+    wxExplorerBrowserResizeCoalescer coalescer;
+    wxUint64 deadline = 0;
+
+    coalescer.SetPolicy(true, 0, 100);
+
+    // the changes only move the deadline
+    WXEB_CHECK(!coalescer.OnSizeChanged(wxSize(100, 100), 1000));
+    WXEB_CHECK(!coalescer.OnSizeChanged(wxSize(110, 100), 1050));
+    WXEB_CHECK(coalescer.GetDeadline(deadline));
+    WXEB_CHECK_EQUAL(deadline, 1150u);
+    WXEB_CHECK(!coalescer.OnTimer(1149));
+    WXEB_CHECK(coalescer.OnTimer(1150));
+    WXEB_CHECK(coalescer.GetPendingSize() == wxSize(110, 100));
+
+    coalescer.OnApplied(1150);
+    WXEB_CHECK(!coalescer.GetDeadline(deadline));
+    WXEB_CHECK(!coalescer.OnTimer(2000));
+}
+
+void TestInteractive()
+{
+    wxExplorerBrowserResizeCoalescer coalescer;
+    wxUint64 deadline;
+
+    coalescer.SetPolicy(true, 0, 100);
+    coalescer.BeginInteractive();
+    WXEB_CHECK(coalescer.IsInteractive());
+
+    // no deadline while the border is dragged, however long it takes
+    WXEB_CHECK(!coalescer.OnSizeChanged(wxSize(200, 200), 0));
+    WXEB_CHECK(!coalescer.GetDeadline(deadline));
+    WXEB_CHECK(!coalescer.OnTimer(100000));
+
+    WXEB_CHECK(coalescer.EndInteractive(100001));
+    WXEB_CHECK(!coalescer.IsInteractive());
+    coalescer.OnApplied(100001);
+
+    // nothing to apply when the size did not change
+    coalescer.BeginInteractive();
+    WXEB_CHECK(!coalescer.EndInteractive(100002));
+}
+
+void TestMaxUpdateInterval()
+{
+    wxExplorerBrowserResizeCoalescer coalescer;
+    wxUint64 deadline;
+
+    coalescer.SetPolicy(true, 50, 100);
+    coalescer.BeginInteractive();
+
+    // the first change is applied at once, then at most every 50 ms
+    WXEB_CHECK(coalescer.OnSizeChanged(wxSize(100, 100), 0));
+    coalescer.OnApplied(0);
+    WXEB_CHECK(!coalescer.OnSizeChanged(wxSize(101, 100), 10));
+    WXEB_CHECK(coalescer.GetDeadline(deadline));
+    WXEB_CHECK_EQUAL(deadline, 50u);
+    WXEB_CHECK(!coalescer.OnTimer(49));
+    WXEB_CHECK(coalescer.OnSizeChanged(wxSize(102, 100), 60));
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestNotCoalescing();
+    TestSettleDelay();
+    TestInteractive();
+    TestMaxUpdateInterval();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
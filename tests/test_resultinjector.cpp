@@ -0,0 +1,175 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_resultinjector.cpp
+// Purpose:     Tests of wxExplorerBrowserResultInjector
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+namespace {
+
+typedef wxExplorerBrowserResultInjector Injector;
+
+wxArrayString MakePaths(size_t count, const wxString& prefix = wxS("C:\\results\\file"))
+{
+    wxArrayString paths;
+
+    for ( size_t i = 0; i < count; ++i )
+        paths.push_back(prefix + wxString::Format(wxS("%zu"), i));
+    return paths;
+}
+
+// a clock advancing by @a step milliseconds on every call
+Injector::Clock MakeClock(wxUint64& now, wxUint64 step)
+{
+    return [&now, step]() { const wxUint64 time = now; now += step; return time; };
+}
+
+void TestIDListValidation()
+{
+    WXEB_CHECK(Injector::IsValidIDList(Injector::IDList{ 0, 0 }));                 // the desktop
+    WXEB_CHECK(Injector::IsValidIDList(Injector::IDList{ 4, 0, 7, 8, 0, 0 }));
+    WXEB_CHECK(Injector::IsValidIDList(Injector::IDList{ 3, 0, 9, 2, 0, 0, 0 }));
+
+    WXEB_CHECK(!Injector::IsValidIDList(Injector::IDList()));
+    WXEB_CHECK(!Injector::IsValidIDList(Injector::IDList{ 0 }));
+    WXEB_CHECK(!Injector::IsValidIDList(Injector::IDList{ 4, 0, 7, 8 }));           // no terminator
+    WXEB_CHECK(!Injector::IsValidIDList(Injector::IDList{ 9, 0, 7, 8, 0, 0 }));     // item past the end
+    WXEB_CHECK(!Injector::IsValidIDList(Injector::IDList{ 1, 0, 0, 0 }));           // item smaller than its size
+    WXEB_CHECK(!Injector::IsValidIDList(Injector::IDList{ 2, 0, 0, 0, 5 }));        // bytes after the terminator
+}
+
+void TestBatches()
+{
+    Injector injector;
+    wxUint64 now = 1000;
+    wxUint64 deadline = 0;
+    wxArrayString received;
+    const auto sink = [&received](const Injector::Entry& entry)
+        {
+            WXEB_CHECK(!entry.IsIDList());
+            received.push_back(entry.path);
+            return true;
+        };
+
+    injector.SetLimits(10, 30);
+    WXEB_CHECK(!injector.GetDeadline(deadline));
+    WXEB_CHECK_EQUAL(injector.ProcessBatch(sink, MakeClock(now, 1)), 0u);
+
+    injector.AddPaths(MakePaths(25), now);
+    WXEB_CHECK(injector.HasPending());
+    WXEB_CHECK_EQUAL(injector.GetPendingCount(), 25u);
+    WXEB_CHECK_EQUAL(injector.GetTotal(), 25u);
+
+    // the first batch is due immediately
+    WXEB_CHECK(injector.GetDeadline(deadline));
+    WXEB_CHECK_EQUAL(deadline, now);
+
+    // each item takes 1 ms, so a batch of 10 ms takes 10 items
+    WXEB_CHECK_EQUAL(injector.ProcessBatch(sink, MakeClock(now, 1)), 10u);
+    WXEB_CHECK_EQUAL(injector.GetProcessed(), 10u);
+    WXEB_CHECK(injector.GetDeadline(deadline));
+    WXEB_CHECK_EQUAL(deadline, now - 1 + 30);
+
+    // items queued while injecting are added to the same run
+    injector.AddPaths(MakePaths(5, wxS("D:\\more")), now);
+    WXEB_CHECK_EQUAL(injector.GetTotal(), 30u);
+
+    WXEB_CHECK_EQUAL(injector.ProcessBatch(sink, MakeClock(now, 1)), 10u);
+    WXEB_CHECK_EQUAL(injector.ProcessBatch(sink, MakeClock(now, 1)), 10u);
+    WXEB_CHECK(!injector.HasPending());
+    WXEB_CHECK(!injector.GetDeadline(deadline));
+    WXEB_CHECK_EQUAL(injector.GetProcessed(), 30u);
+    WXEB_CHECK_EQUAL(injector.GetFailed(), 0u);
+
+    // in the order they were queued
+    WXEB_CHECK_EQUAL(received.size(), 30u);
+    WXEB_CHECK(received[0] == wxS("C:\\results\\file0"));
+    WXEB_CHECK(received[24] == wxS("C:\\results\\file24"));
+    WXEB_CHECK(received[25] == wxS("D:\\more0"));
+
+    // a slow item still makes progress, one per batch
+    injector.AddPaths(MakePaths(2), now);
+    WXEB_CHECK_EQUAL(injector.GetTotal(), 2u); // a new run
+    WXEB_CHECK_EQUAL(injector.GetProcessed(), 0u);
+    WXEB_CHECK_EQUAL(injector.ProcessBatch(sink, MakeClock(now, 100)), 1u);
+    WXEB_CHECK_EQUAL(injector.ProcessBatch(sink, MakeClock(now, 100)), 1u);
+    WXEB_CHECK_EQUAL(injector.GetMemoryUsage(), 0u);
+}
+
+void TestFailuresAndIDLists()
+{
+    Injector injector;
+    wxUint64 now = 0;
+    std::vector<Injector::IDList> idLists;
+
+    idLists.push_back(Injector::IDList{ 4, 0, 1, 2, 0, 0 });
+    idLists.push_back(Injector::IDList{ 4, 0, 3, 4, 0, 0 });
+    idLists.push_back(Injector::IDList{ 4, 0, 5, 6, 0, 0 });
+
+    injector.AddIDLists(idLists, now);
+    injector.AddPaths(MakePaths(1), now);
+
+    size_t idListCount = 0;
+    const size_t processed = injector.ProcessBatch([&idListCount](const Injector::Entry& entry)
+        {
+            if ( !entry.IsIDList() )
+                return true;
+
+            // the odd ones cannot be added
+            return entry.idList[2] != 3 && ++idListCount;
+        }, MakeClock(now, 0));
+
+    WXEB_CHECK_EQUAL(processed, 4u);
+    WXEB_CHECK_EQUAL(idListCount, 2u);
+    WXEB_CHECK_EQUAL(injector.GetProcessed(), 4u);
+    WXEB_CHECK_EQUAL(injector.GetFailed(), 1u);
+    WXEB_CHECK_EQUAL(injector.GetTotal(), 4u);
+
+    // nothing is queued for empty lists
+    injector.AddPaths(wxArrayString(), now);
+    injector.AddIDLists(std::vector<Injector::IDList>(), now);
+    WXEB_CHECK(!injector.HasPending());
+    WXEB_CHECK_EQUAL(injector.GetTotal(), 4u);
+}
+
+void TestCancel()
+{
+    Injector injector;
+    wxUint64 now = 0;
+
+    WXEB_CHECK_EQUAL(injector.Cancel(), 0u);
+
+    injector.SetLimits(5, 30);
+    injector.AddPaths(MakePaths(100), now);
+
+    const size_t emptyUsage = Injector().GetMemoryUsage();
+
+    WXEB_CHECK(injector.GetMemoryUsage() > emptyUsage);
+    WXEB_CHECK_EQUAL(injector.ProcessBatch([](const Injector::Entry&) { return true; }, MakeClock(now, 1)), 5u);
+
+    WXEB_CHECK_EQUAL(injector.Cancel(), 95u);
+    WXEB_CHECK(!injector.HasPending());
+    WXEB_CHECK_EQUAL(injector.GetMemoryUsage(), 0u);
+
+    // the counters stay for the results event until the next run
+    WXEB_CHECK_EQUAL(injector.GetProcessed(), 5u);
+    WXEB_CHECK_EQUAL(injector.GetTotal(), 100u);
+
+    injector.AddPaths(MakePaths(3), now);
+    WXEB_CHECK_EQUAL(injector.GetProcessed(), 0u);
+    WXEB_CHECK_EQUAL(injector.GetTotal(), 3u);
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestIDListValidation();
+    TestBatches();
+    TestFailuresAndIDLists();
+    TestCancel();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
@@ -0,0 +1,154 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_searchscheduler.cpp
+// Purpose:     Tests of wxExplorerBrowserSearchScheduler
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <vector>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+namespace {
+
+typedef wxExplorerBrowserSearchScheduler Scheduler;
+
+// a search backend finding one result per 10 ms for @a resultCount results,
+// driven by the scheduler the way wxExplorerBrowser drives FilterView()
+class MockSearch
+{
+public:
+    explicit MockSearch(Scheduler& scheduler, size_t resultCount = 5)
+        : m_scheduler(scheduler), m_resultCount(resultCount) {}
+
+    void Type(const char* text)
+    {
+        wxString query;
+
+        for ( const char* c = text; *c; ++c )
+        {
+            query += static_cast<wxChar>(*c);
+            if ( m_scheduler.Submit(query, m_now, &m_cancelled) )
+                m_cancels.push_back(m_cancelled);
+            RunUntil(m_now + 50);
+        }
+    }
+
+    // calls OnTimer() at every deadline until @a time
+    void RunUntil(wxUint64 time)
+    {
+        wxUint64 deadline;
+
+        while ( m_scheduler.GetDeadline(deadline) && deadline <= time )
+        {
+            m_now = deadline;
+
+            switch ( m_scheduler.OnTimer(m_now) )
+            {
+                case Scheduler::Action_Start:
+                    m_started.push_back(m_scheduler.GetInFlightQuery());
+                    m_startTime = m_now;
+                    break;
+
+                case Scheduler::Action_Poll:
+                    m_scheduler.UpdateProgress(std::min(m_resultCount, size_t(m_now - m_startTime) / 10), m_now);
+                    break;
+
+                case Scheduler::Action_Complete:
+                    m_completed.push_back(m_scheduler.GetInFlightQuery());
+                    break;
+
+                case Scheduler::Action_None:
+                    break;
+            }
+        }
+
+        m_now = time;
+    }
+
+    wxUint64 GetNow() const { return m_now; }
+
+    std::vector<wxString> m_started;
+    std::vector<wxString> m_completed;
+    std::vector<wxString> m_cancels;
+
+private:
+    Scheduler& m_scheduler;
+    size_t     m_resultCount;
+    wxUint64   m_now {0};
+    wxUint64   m_startTime {0};
+    wxString   m_cancelled;
+};
+
+void TestDebounce()
+{
+    Scheduler scheduler;
+    MockSearch search(scheduler);
+
+    scheduler.SetDelays(250, 100, 500);
+
+    // typed faster than the debounce delay, only the final query is started
+    search.Type("report");
+    search.RunUntil(10000);
+    WXEB_CHECK_EQUAL(search.m_started.size(), 1u);
+    WXEB_CHECK(search.m_started[0] == wxS("report"));
+    WXEB_CHECK_EQUAL(search.m_completed.size(), 1u);
+    WXEB_CHECK(search.m_cancels.empty());
+    WXEB_CHECK_EQUAL(scheduler.GetResultCount(), 5u);
+    WXEB_CHECK(!scheduler.IsInFlight() && !scheduler.HasPending());
+
+    // the completed query is not started again
+    scheduler.Submit(wxS("report"), search.GetNow());
+    search.RunUntil(20000);
+    WXEB_CHECK_EQUAL(search.m_started.size(), 1u);
+
+    wxUint64 deadline;
+    WXEB_CHECK(!scheduler.GetDeadline(deadline));
+}
+
+void TestCancel()
+{
+    Scheduler scheduler;
+    MockSearch search(scheduler, 100);
+
+    scheduler.SetDelays(20, 100, 500);
+
+    search.Type("ab");
+    WXEB_CHECK_EQUAL(search.m_started.size(), 2u);
+    WXEB_CHECK_EQUAL(search.m_cancels.size(), 1u);
+    WXEB_CHECK(search.m_cancels[0] == wxS("a"));
+    WXEB_CHECK(scheduler.IsInFlight());
+
+    // the same query as in flight does not cancel it
+    WXEB_CHECK(!scheduler.Submit(wxS("ab"), search.GetNow()));
+    search.RunUntil(search.GetNow() + 50);
+    WXEB_CHECK_EQUAL(search.m_started.size(), 2u);
+
+    // the count keeps changing for 1 s, then it settles for the settle delay
+    search.RunUntil(search.GetNow() + 10000);
+    WXEB_CHECK_EQUAL(search.m_completed.size(), 1u);
+    WXEB_CHECK_EQUAL(scheduler.GetResultCount(), 100u);
+
+    // completed manually
+    scheduler.Submit(wxS("abc"), search.GetNow());
+    search.RunUntil(search.GetNow() + 20);
+    WXEB_CHECK(scheduler.IsInFlight());
+    scheduler.Complete();
+    WXEB_CHECK(!scheduler.IsInFlight());
+
+    scheduler.Submit(wxS("abcd"), search.GetNow());
+    scheduler.Reset();
+    WXEB_CHECK(!scheduler.HasPending() && !scheduler.IsInFlight());
+    WXEB_CHECK(scheduler.GetInFlightQuery().empty());
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestDebounce();
+    TestCancel();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
@@ -0,0 +1,189 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_snapshot.cpp
+// Purpose:     Tests of wxExplorerBrowserMappedFile and wxExplorerBrowserSnapshot
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+using wxExplorerBrowserTesting::TempDirectory;
+
+namespace {
+
+wxUint32 ReadUint32(const wxUint8* data)
+{
+    return data[0] | (data[1] << 8) | (data[2] << 16) | (wxUint32(data[3]) << 24);
+}
+
+void WriteUint32(wxUint8* data, wxUint32 value)
+{
+    for ( size_t i = 0; i < 4; ++i )
+        data[i] = static_cast<wxUint8>(value >> (i * 8));
+}
+
+wxExplorerBrowserItem::List MakeItems()
+{
+    wxExplorerBrowserItem::List items;
+    wxExplorerBrowserItem item;
+
+    item.SetType(wxExplorerBrowserItem::Directory);
+    item.SetPath(wxS("/folder/sub"));
+    item.SetDisplayName(wxS("sub"));
+    item.SetSFGAO(0x20000000);
+    items.push_back(item);
+
+    item.SetType(wxExplorerBrowserItem::File);
+    item.SetPath(wxS("/folder/file.txt"));
+    item.SetDisplayName(wxS("file.txt"));
+    item.SetSFGAO(0);
+    items.push_back(item);
+
+    item.SetPath(wxS("/folder/empty"));
+    item.SetDisplayName(wxString());
+    items.push_back(item);
+
+    return items;
+}
+
+void TestMappedFile()
+{
+    TempDirectory dir("mappedfile");
+    const wxString fileName = dir.GetPath("mapped.bin");
+    wxExplorerBrowserMappedFile file;
+
+    // an empty file cannot be mapped
+    WXEB_CHECK(dir.AddFile("empty.bin"));
+    WXEB_CHECK(!file.Open(dir.GetPath("empty.bin")));
+    WXEB_CHECK(!file.Open(dir.GetPath("missing.bin")));
+    WXEB_CHECK(!file.IsOpened());
+
+    if ( !file.Open(fileName, wxExplorerBrowserMappedFile::Mode_ReadWrite, 16) )
+    {
+        WXEB_CHECK(!"could not create the file");
+        return;
+    }
+
+    WXEB_CHECK(file.IsWritable());
+    WXEB_CHECK_EQUAL(file.GetSize(), 16u);
+    WXEB_CHECK_EQUAL(file.GetData()[15], 0);
+
+    memcpy(file.GetWritableData(), "0123456789abcdef", 16);
+    WXEB_CHECK(file.Resize(32));
+    WXEB_CHECK_EQUAL(file.GetSize(), 32u);
+    WXEB_CHECK(memcmp(file.GetData(), "0123456789abcdef", 16) == 0);
+    WXEB_CHECK_EQUAL(file.GetData()[31], 0);
+    WXEB_CHECK(file.Resize(8));
+    WXEB_CHECK(file.Flush());
+    file.Close();
+    WXEB_CHECK(!file.IsOpened());
+
+    WXEB_CHECK(file.Open(fileName));
+    WXEB_CHECK(!file.IsWritable());
+    WXEB_CHECK(file.GetWritableData() == nullptr);
+    WXEB_CHECK_EQUAL(file.GetSize(), 8u);
+    WXEB_CHECK(memcmp(file.GetData(), "01234567", 8) == 0);
+    WXEB_CHECK(!file.Resize(16));
+}
+
+void TestRoundTrip()
+{
+    TempDirectory dir("snapshot");
+    const wxString fileName = dir.GetPath("listing.snapshot");
+    const wxExplorerBrowserItem::List items = MakeItems();
+    const wxString folderPath = wxS("/folder");
+
+    WXEB_CHECK(wxExplorerBrowserSnapshot::Write(fileName, folderPath, items));
+
+    wxExplorerBrowserSnapshot snapshot;
+    wxExplorerBrowserSnapshot::Item item;
+
+    WXEB_CHECK(snapshot.Open(fileName));
+    WXEB_CHECK(snapshot.GetFolderPath() == folderPath);
+    WXEB_CHECK_EQUAL(snapshot.GetCount(), items.size());
+
+    for ( size_t i = 0; i < items.size(); ++i )
+    {
+        if ( !snapshot.GetItem(i, item) )
+        {
+            WXEB_CHECK(!"could not read the item");
+            continue;
+        }
+
+        WXEB_CHECK_EQUAL(item.type, items[i].GetType());
+        WXEB_CHECK_EQUAL(item.SFGAO, items[i].GetSFGAO());
+        WXEB_CHECK(item.GetPath() == items[i].GetPath());
+        WXEB_CHECK_EQUAL(item.pathLength, strlen(item.path));
+
+        const wxExplorerBrowserItem restored = item.ToItem();
+
+        WXEB_CHECK(restored.GetDisplayName() == items[i].GetDisplayName());
+        WXEB_CHECK_EQUAL(restored.GetPathHash(), items[i].GetPathHash());
+    }
+
+    WXEB_CHECK(!snapshot.GetItem(items.size(), item));
+
+    // an empty listing is valid too
+    WXEB_CHECK(wxExplorerBrowserSnapshot::Write(fileName, folderPath, wxExplorerBrowserItem::List()));
+    WXEB_CHECK(snapshot.Open(fileName));
+    WXEB_CHECK_EQUAL(snapshot.GetCount(), 0u);
+    snapshot.Close();
+    WXEB_CHECK(!snapshot.IsOpened());
+}
+
+void TestCorrupted()
+{
+    TempDirectory dir("snapshot_corrupted");
+    const wxString fileName = dir.GetPath("listing.snapshot");
+    wxExplorerBrowserSnapshot snapshot;
+    wxExplorerBrowserSnapshot::Item item;
+    wxExplorerBrowserMappedFile file;
+
+    WXEB_CHECK(dir.AddFile("text.snapshot", "this is not a snapshot, just some text long enough"));
+    WXEB_CHECK(!snapshot.Open(dir.GetPath("text.snapshot")));
+
+    // the string arena cut off
+    WXEB_CHECK(wxExplorerBrowserSnapshot::Write(fileName, wxS("/folder"), MakeItems()));
+    WXEB_CHECK(file.Open(fileName, wxExplorerBrowserMappedFile::Mode_ReadWrite));
+    const size_t size = file.GetSize();
+    WXEB_CHECK(file.Resize(size - 4));
+    file.Close();
+    WXEB_CHECK(!snapshot.Open(fileName));
+
+    // the records cut off
+    WXEB_CHECK(file.Open(fileName, wxExplorerBrowserMappedFile::Mode_ReadWrite));
+    const wxUint32 headerSize = ReadUint32(file.GetData() + 12);
+    WXEB_CHECK(file.Resize(headerSize + 8));
+    file.Close();
+    WXEB_CHECK(!snapshot.Open(fileName));
+
+    // a newer version
+    WXEB_CHECK(wxExplorerBrowserSnapshot::Write(fileName, wxS("/folder"), MakeItems()));
+    WXEB_CHECK(file.Open(fileName, wxExplorerBrowserMappedFile::Mode_ReadWrite));
+    WriteUint32(file.GetWritableData() + 8, wxExplorerBrowserSnapshot::Version + 1);
+    file.Close();
+    WXEB_CHECK(!snapshot.Open(fileName));
+
+    // the path length of the first item pointing out of the arena
+    WXEB_CHECK(wxExplorerBrowserSnapshot::Write(fileName, wxS("/folder"), MakeItems()));
+    WXEB_CHECK(file.Open(fileName, wxExplorerBrowserMappedFile::Mode_ReadWrite));
+    WriteUint32(file.GetWritableData() + ReadUint32(file.GetData() + 32) + 24, 0xFFFFFFF0);
+    file.Close();
+    WXEB_CHECK(snapshot.Open(fileName));
+    WXEB_CHECK(!snapshot.GetItem(0, item));
+    WXEB_CHECK(snapshot.GetItem(1, item));
+    WXEB_CHECK(item.GetPath() == wxS("/folder/file.txt"));
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestMappedFile();
+    TestRoundTrip();
+    TestCorrupted();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
@@ -0,0 +1,296 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_thumbnailservice.cpp
+// Purpose:     Tests of wxExplorerBrowserThumbnailService
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+namespace {
+
+typedef wxExplorerBrowserThumbnailService Service;
+
+wxExplorerBrowserItem MakeItem(size_t i)
+{
+    wxExplorerBrowserItem item(wxExplorerBrowserItem::File);
+
+    item.SetPath(wxString::Format(wxS("C:\\pictures\\image%zu.jpg"), i));
+    return item;
+}
+
+// the decoder and the callback of the service, the decoder
+// blocks until the test opens the gate
+class Recorder
+{
+public:
+    bool Decode(const wxExplorerBrowserItem& item, unsigned size, wxExplorerBrowserThumbnail& thumbnail)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_decoded.push_back(item.GetPath());
+        m_changed.notify_all();
+        m_changed.wait(lock, [this]() { return m_open; });
+
+        if ( item.GetPath().find(wxS("broken")) != wxString::npos )
+            return false;
+
+        thumbnail.width = size;
+        thumbnail.height = size / 2;
+        thumbnail.pixels.assign(static_cast<size_t>(thumbnail.width) * thumbnail.height * 4, 0x80);
+        return true;
+    }
+
+    void OnReady(const wxExplorerBrowserItem& item, unsigned size, const wxExplorerBrowserThumbnail::Ptr& thumbnail)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_ready.push_back(Ready{ item.GetPath(), size, thumbnail != nullptr });
+        m_changed.notify_all();
+    }
+
+    void Open()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_open = true;
+        m_changed.notify_all();
+    }
+
+    // returns false after a few seconds, so that a failing test does not hang
+    bool WaitForDecoded(size_t count) { return WaitFor([this, count]() { return m_decoded.size() >= count; }); }
+    bool WaitForReady(size_t count) { return WaitFor([this, count]() { return m_ready.size() >= count; }); }
+
+    struct Ready
+    {
+        wxString path;
+        unsigned size;
+        bool ok;
+    };
+
+    std::vector<wxString> GetDecoded() { std::lock_guard<std::mutex> lock(m_mutex); return m_decoded; }
+    std::vector<Ready> GetReady() { std::lock_guard<std::mutex> lock(m_mutex); return m_ready; }
+
+    Service::Decoder MakeDecoder()
+    {
+        return [this](const wxExplorerBrowserItem& item, unsigned size, wxExplorerBrowserThumbnail& thumbnail)
+            { return Decode(item, size, thumbnail); };
+    }
+
+    Service::ReadyCallback MakeCallback()
+    {
+        return [this](const wxExplorerBrowserItem& item, unsigned size, const wxExplorerBrowserThumbnail::Ptr& thumbnail)
+            { OnReady(item, size, thumbnail); };
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    bool m_open {false};
+    std::vector<wxString> m_decoded;
+    std::vector<Ready> m_ready;
+
+    template <typename Predicate>
+    bool WaitFor(Predicate predicate)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        return m_changed.wait_for(lock, std::chrono::seconds(10), predicate);
+    }
+};
+
+void TestKeys()
+{
+    wxExplorerBrowserItem item = MakeItem(1);
+
+    // by the path without an id
+    WXEB_CHECK(Service::MakeKey(item, 96) == Service::MakeKey(MakeItem(1), 96));
+    WXEB_CHECK(!(Service::MakeKey(item, 96) == Service::MakeKey(MakeItem(2), 96)));
+    WXEB_CHECK(!(Service::MakeKey(item, 96) == Service::MakeKey(item, 256)));
+
+    item.SetId(42);
+    WXEB_CHECK_EQUAL(Service::MakeKey(item, 96).itemId, 42u);
+    WXEB_CHECK_EQUAL(Service::MakeKey(item, 96).size, 96u);
+}
+
+void TestRequests()
+{
+    Recorder recorder;
+    Service service(recorder.MakeDecoder(), recorder.MakeCallback(), Service::DefaultMaxMemory, 1);
+    wxExplorerBrowserThumbnail::Ptr thumbnail;
+
+    WXEB_CHECK_EQUAL(service.GetThreadCount(), 1u);
+    WXEB_CHECK(!service.Request(MakeItem(0), 64, thumbnail));
+    WXEB_CHECK(recorder.WaitForDecoded(1));
+
+    // the worker is busy with the first one, the rest is queued, the repeated ones only once
+    for ( size_t i = 1; i <= 3; ++i )
+    {
+        WXEB_CHECK(!service.Request(MakeItem(i), 64, thumbnail));
+        WXEB_CHECK(!service.Request(MakeItem(i), 64, thumbnail));
+    }
+
+    wxExplorerBrowserItem broken(wxExplorerBrowserItem::File);
+
+    broken.SetPath(wxS("C:\\pictures\\broken.jpg"));
+    WXEB_CHECK(!service.Request(broken, 64, thumbnail));
+
+    WXEB_CHECK_EQUAL(service.GetPendingCount(), 4u);
+    WXEB_CHECK_EQUAL(service.GetInFlightCount(), 5u);
+    WXEB_CHECK(!service.Lookup(Service::MakeKey(MakeItem(0), 64), thumbnail));
+
+    recorder.Open();
+    if ( !recorder.WaitForReady(5) )
+    {
+        WXEB_CHECK(!"the thumbnails were not extracted");
+        return;
+    }
+
+    // the most recent request first
+    const std::vector<wxString> decoded = recorder.GetDecoded();
+
+    WXEB_CHECK_EQUAL(decoded.size(), 5u);
+    WXEB_CHECK(decoded[1] == broken.GetPath());
+    WXEB_CHECK(decoded[2] == MakeItem(3).GetPath());
+    WXEB_CHECK(decoded[4] == MakeItem(1).GetPath());
+
+    // the failed one is reported, but not cached
+    const std::vector<Recorder::Ready> ready = recorder.GetReady();
+
+    WXEB_CHECK(!ready[1].ok);
+    WXEB_CHECK(ready[0].ok && ready[0].size == 64);
+    WXEB_CHECK_EQUAL(service.GetInFlightCount(), 0u);
+    WXEB_CHECK_EQUAL(service.GetCount(), 4u);
+
+    // the cached ones are returned right away
+    WXEB_CHECK(service.Request(MakeItem(2), 64, thumbnail));
+    WXEB_CHECK(thumbnail && thumbnail->width == 64 && thumbnail->height == 32);
+    WXEB_CHECK(service.Lookup(Service::MakeKey(MakeItem(0), 64), thumbnail));
+    WXEB_CHECK(!service.Lookup(Service::MakeKey(MakeItem(0), 128), thumbnail));
+    WXEB_CHECK_EQUAL(service.GetMemoryUsage(), 4 * thumbnail->GetMemoryUsage());
+
+    service.Clear();
+    WXEB_CHECK_EQUAL(service.GetCount(), 0u);
+    WXEB_CHECK_EQUAL(service.GetMemoryUsage(), 0u);
+}
+
+void TestCancel()
+{
+    Recorder recorder;
+    Service service(recorder.MakeDecoder(), recorder.MakeCallback(), Service::DefaultMaxMemory, 1);
+    wxExplorerBrowserThumbnail::Ptr thumbnail;
+
+    WXEB_CHECK(!service.Request(MakeItem(0), 32, thumbnail));
+    WXEB_CHECK(recorder.WaitForDecoded(1));
+
+    for ( size_t i = 1; i < 10; ++i )
+        service.Request(MakeItem(i), 32, thumbnail);
+
+    WXEB_CHECK_EQUAL(service.CancelPending(), 9u);
+    WXEB_CHECK_EQUAL(service.GetPendingCount(), 0u);
+    WXEB_CHECK_EQUAL(service.GetInFlightCount(), 1u); // the running one is not affected
+
+    // a cancelled one can be requested again
+    WXEB_CHECK(!service.Request(MakeItem(5), 32, thumbnail));
+    WXEB_CHECK_EQUAL(service.GetPendingCount(), 1u);
+
+    recorder.Open();
+    WXEB_CHECK(recorder.WaitForReady(2));
+    WXEB_CHECK_EQUAL(recorder.GetDecoded().size(), 2u);
+}
+
+void TestMemoryLimit()
+{
+    Recorder recorder;
+
+    recorder.Open();
+
+    // each 16x8 thumbnail takes 512 bytes of pixels
+    const size_t thumbnailMemory = sizeof(wxExplorerBrowserThumbnail) + 16 * 8 * 4;
+    Service service(recorder.MakeDecoder(), recorder.MakeCallback(), 3 * thumbnailMemory, 2);
+    wxExplorerBrowserThumbnail::Ptr thumbnail;
+
+    for ( size_t i = 0; i < 3; ++i )
+    {
+        service.Request(MakeItem(i), 16, thumbnail);
+        WXEB_CHECK(recorder.WaitForReady(i + 1));
+    }
+
+    WXEB_CHECK_EQUAL(service.GetCount(), 3u);
+    WXEB_CHECK_EQUAL(service.GetMemoryUsage(), 3 * thumbnailMemory);
+
+    // the first one used recently, so the second one is evicted
+    WXEB_CHECK(service.Lookup(Service::MakeKey(MakeItem(0), 16), thumbnail));
+    service.Request(MakeItem(3), 16, thumbnail);
+    WXEB_CHECK(recorder.WaitForReady(4));
+    WXEB_CHECK_EQUAL(service.GetCount(), 3u);
+    WXEB_CHECK(service.Lookup(Service::MakeKey(MakeItem(0), 16), thumbnail));
+    WXEB_CHECK(!service.Lookup(Service::MakeKey(MakeItem(1), 16), thumbnail));
+
+    service.Shrink(thumbnailMemory);
+    WXEB_CHECK_EQUAL(service.GetCount(), 1u);
+    WXEB_CHECK_EQUAL(service.GetMaxMemory(), 3 * thumbnailMemory);
+
+    // a thumbnail larger than the limit is delivered, but not cached
+    service.SetMaxMemory(thumbnailMemory / 2);
+    WXEB_CHECK_EQUAL(service.GetCount(), 0u);
+    service.Request(MakeItem(4), 16, thumbnail);
+    WXEB_CHECK(recorder.WaitForReady(5));
+    WXEB_CHECK(recorder.GetReady()[4].ok);
+    WXEB_CHECK_EQUAL(service.GetCount(), 0u);
+}
+
+void TestManyThreads()
+{
+    Recorder recorder;
+
+    recorder.Open();
+
+    Service service(recorder.MakeDecoder(), recorder.MakeCallback(), Service::DefaultMaxMemory, 4);
+    std::vector<std::thread> threads;
+
+    // several panes requesting overlapping thumbnails
+    for ( size_t t = 0; t < 4; ++t )
+    {
+        threads.push_back(std::thread([&service, t]()
+        {
+            wxExplorerBrowserThumbnail::Ptr thumbnail;
+
+            for ( size_t i = 0; i < 200; ++i )
+                service.Request(MakeItem((i + t * 50) % 300), 24, thumbnail);
+        }));
+    }
+
+    for ( auto& thread : threads )
+        thread.join();
+
+    // every thumbnail extracted exactly once
+    WXEB_CHECK(recorder.WaitForReady(300));
+
+    const std::vector<wxString> decoded = recorder.GetDecoded();
+
+    WXEB_CHECK_EQUAL(decoded.size(), 300u);
+    WXEB_CHECK_EQUAL(std::set<wxString>(decoded.begin(), decoded.end()).size(), 300u);
+    WXEB_CHECK_EQUAL(service.GetCount(), 300u);
+    WXEB_CHECK_EQUAL(service.GetInFlightCount(), 0u);
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestKeys();
+    TestRequests();
+    TestCancel();
+    TestMemoryLimit();
+    TestManyThreads();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
@@ -0,0 +1,304 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_thumbnailstore.cpp
+// Purpose:     Tests of wxExplorerBrowserThumbnailStore
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+using wxExplorerBrowserTesting::TempDirectory;
+
+namespace {
+
+typedef wxExplorerBrowserThumbnailStore Store;
+
+const size_t HeaderSize = 32;
+const size_t RecordHeaderSize = 80;
+
+wxExplorerBrowserItem MakeItem(const wxString& path)
+{
+    wxExplorerBrowserItem item(wxExplorerBrowserItem::File);
+
+    item.SetPath(path);
+    return item;
+}
+
+wxExplorerBrowserThumbnail MakeThumbnail(unsigned width, unsigned height, wxUint8 value)
+{
+    wxExplorerBrowserThumbnail thumbnail;
+
+    thumbnail.width = width;
+    thumbnail.height = height;
+    thumbnail.pixels.assign(static_cast<size_t>(width) * height * 4, value);
+    return thumbnail;
+}
+
+// the size of the record of a thumbnail of @a width x @a height
+size_t GetRecordSize(unsigned width, unsigned height)
+{
+    return (RecordHeaderSize + static_cast<size_t>(width) * height * 4 + 7) & ~static_cast<size_t>(7);
+}
+
+bool HasThumbnail(Store& store, const Store::Key& key, wxUint8 value)
+{
+    wxExplorerBrowserThumbnail thumbnail;
+
+    return store.Lookup(key, thumbnail) && !thumbnail.pixels.empty() && thumbnail.pixels[0] == value;
+}
+
+void TestKeys()
+{
+    const Store::Key key = Store::MakeKey(MakeItem(wxS("C:\\a.jpg")), 100, 96);
+
+    WXEB_CHECK(key == Store::MakeKey(MakeItem(wxS("C:\\a.jpg")), 100, 96));
+    WXEB_CHECK(!(key == Store::MakeKey(MakeItem(wxS("C:\\b.jpg")), 100, 96)));
+    WXEB_CHECK(!(key == Store::MakeKey(MakeItem(wxS("C:\\a.jpg")), 101, 96)));
+    WXEB_CHECK(!(key == Store::MakeKey(MakeItem(wxS("C:\\a.jpg")), 100, 256)));
+
+    // the item check is not derived from the item key
+    const Store::Key other = Store::MakeKey(MakeItem(wxS("C:\\b.jpg")), 100, 96);
+
+    WXEB_CHECK(key.itemKey != other.itemKey);
+    WXEB_CHECK(key.itemCheck != other.itemCheck);
+    WXEB_CHECK(key.itemCheck != key.itemKey);
+}
+
+void TestRoundTrip()
+{
+    TempDirectory dir("thumbnailstore_roundtrip");
+    const wxString fileName = dir.GetPath("thumbnails.db");
+    const Store::Key key1 = Store::MakeKey(MakeItem(wxS("C:\\1.jpg")), 1, 32);
+    const Store::Key key2 = Store::MakeKey(MakeItem(wxS("C:\\2.jpg")), 1, 32);
+
+    {
+        Store store;
+
+        WXEB_CHECK(store.Open(fileName));
+        WXEB_CHECK(store.IsOpened());
+        WXEB_CHECK_EQUAL(store.GetCount(), 0u);
+        WXEB_CHECK(!HasThumbnail(store, key1, 1));
+
+        WXEB_CHECK(store.Insert(key1, MakeThumbnail(4, 3, 1)));
+        WXEB_CHECK(store.Insert(key2, MakeThumbnail(5, 5, 2)));
+        WXEB_CHECK_EQUAL(store.GetCount(), 2u);
+
+        // a replaced one takes space until compacted
+        WXEB_CHECK(store.Insert(key1, MakeThumbnail(4, 3, 3)));
+        WXEB_CHECK_EQUAL(store.GetCount(), 2u);
+        WXEB_CHECK_EQUAL(store.GetUsedSize(), HeaderSize + 2 * GetRecordSize(4, 3) + GetRecordSize(5, 5));
+        WXEB_CHECK(HasThumbnail(store, key1, 3));
+
+        // invalid thumbnails are refused
+        WXEB_CHECK(!store.Insert(key1, MakeThumbnail(0, 3, 1)));
+        wxExplorerBrowserThumbnail small = MakeThumbnail(4, 4, 1);
+        small.pixels.resize(10);
+        WXEB_CHECK(!store.Insert(key1, small));
+    }
+
+    Store store;
+
+    WXEB_CHECK(store.Open(fileName));
+    WXEB_CHECK_EQUAL(store.GetCount(), 2u);
+
+    wxExplorerBrowserThumbnail thumbnail;
+
+    WXEB_CHECK(store.Lookup(key2, thumbnail));
+    WXEB_CHECK_EQUAL(thumbnail.width, 5u);
+    WXEB_CHECK_EQUAL(thumbnail.height, 5u);
+    WXEB_CHECK_EQUAL(thumbnail.pixels.size(), 100u);
+    WXEB_CHECK(HasThumbnail(store, key1, 3));
+
+    // compacting drops the replaced record
+    WXEB_CHECK(store.Compact(Store::DefaultMaxSize));
+    WXEB_CHECK_EQUAL(store.GetUsedSize(), HeaderSize + GetRecordSize(4, 3) + GetRecordSize(5, 5));
+    WXEB_CHECK(HasThumbnail(store, key1, 3));
+    WXEB_CHECK(HasThumbnail(store, key2, 2));
+}
+
+void TestKeyCollision()
+{
+    TempDirectory dir("thumbnailstore_collision");
+    const wxString fileName = dir.GetPath("thumbnails.db");
+    Store store;
+
+    WXEB_CHECK(store.Open(fileName));
+
+    // another item with the same item key, as if the path hashes collided
+    const Store::Key key = Store::MakeKey(MakeItem(wxS("C:\\photo.jpg")), 7, 64);
+    Store::Key colliding = Store::MakeKey(MakeItem(wxS("C:\\other.jpg")), 7, 64);
+
+    colliding.itemKey = key.itemKey;
+
+    WXEB_CHECK(store.Insert(key, MakeThumbnail(2, 2, 10)));
+    WXEB_CHECK(!HasThumbnail(store, colliding, 10));
+
+    // both can be stored, also after reopening
+    WXEB_CHECK(store.Insert(colliding, MakeThumbnail(2, 2, 20)));
+    store.Close();
+    WXEB_CHECK(store.Open(fileName));
+    WXEB_CHECK_EQUAL(store.GetCount(), 2u);
+    WXEB_CHECK(HasThumbnail(store, key, 10));
+    WXEB_CHECK(HasThumbnail(store, colliding, 20));
+}
+
+void TestCrashConsistency()
+{
+    TempDirectory dir("thumbnailstore_crash");
+    const wxString fileName = dir.GetPath("thumbnails.db");
+    Store::Key keys[3];
+    size_t recordEnd = 0;
+
+    {
+        Store store;
+
+        WXEB_CHECK(store.Open(fileName));
+        for ( size_t i = 0; i < 3; ++i )
+        {
+            keys[i] = Store::MakeKey(MakeItem(wxString::Format(wxS("C:\\%zu.jpg"), i)), 1, 16);
+            WXEB_CHECK(store.Insert(keys[i], MakeThumbnail(8, 8, static_cast<wxUint8>(i + 1))));
+        }
+        recordEnd = store.GetUsedSize();
+    }
+
+    const size_t recordSize = GetRecordSize(8, 8);
+    wxExplorerBrowserMappedFile file;
+
+    // the last record torn by a crash while it was written: its pixels only partially written
+    if ( !file.Open(fileName, wxExplorerBrowserMappedFile::Mode_ReadWrite) )
+    {
+        WXEB_CHECK(!"could not open the store");
+        return;
+    }
+
+    WXEB_CHECK(file.GetSize() >= recordEnd);
+    memset(file.GetWritableData() + recordEnd - 40, 0, 40);
+    file.Close();
+
+    {
+        Store store;
+
+        WXEB_CHECK(store.Open(fileName));
+        WXEB_CHECK(HasThumbnail(store, keys[0], 1));
+        WXEB_CHECK(HasThumbnail(store, keys[1], 2));
+        WXEB_CHECK(!HasThumbnail(store, keys[2], 3));
+        WXEB_CHECK_EQUAL(store.GetCount(), 2u);
+    }
+
+    // the header of the second record torn: it and everything after it are ignored
+    WXEB_CHECK(file.Open(fileName, wxExplorerBrowserMappedFile::Mode_ReadWrite));
+    file.GetWritableData()[HeaderSize + recordSize + 20] ^= 0xFF;
+    file.Close();
+
+    {
+        Store store;
+
+        WXEB_CHECK(store.Open(fileName));
+        WXEB_CHECK_EQUAL(store.GetCount(), 1u);
+        WXEB_CHECK_EQUAL(store.GetUsedSize(), HeaderSize + recordSize);
+        WXEB_CHECK(HasThumbnail(store, keys[0], 1));
+
+        // the garbage after the valid records was cleared, so the new records are not mixed with it
+        WXEB_CHECK(store.Insert(keys[2], MakeThumbnail(2, 2, 7)));
+    }
+
+    {
+        Store store;
+
+        WXEB_CHECK(store.Open(fileName));
+        WXEB_CHECK_EQUAL(store.GetCount(), 2u);
+        WXEB_CHECK(HasThumbnail(store, keys[2], 7));
+        WXEB_CHECK(!HasThumbnail(store, keys[1], 2));
+    }
+
+    // a file which is not a store, or of another version, is replaced
+    WXEB_CHECK(dir.AddFile("other.db", "this is not a thumbnail store, just some text"));
+
+    Store store;
+
+    WXEB_CHECK(store.Open(dir.GetPath("other.db")));
+    WXEB_CHECK_EQUAL(store.GetCount(), 0u);
+    WXEB_CHECK(store.Insert(keys[0], MakeThumbnail(2, 2, 1)));
+    store.Close();
+
+    WXEB_CHECK(file.Open(dir.GetPath("other.db"), wxExplorerBrowserMappedFile::Mode_ReadWrite));
+    file.GetWritableData()[8] = Store::Version + 1;
+    file.Close();
+    WXEB_CHECK(store.Open(dir.GetPath("other.db")));
+    WXEB_CHECK_EQUAL(store.GetCount(), 0u);
+}
+
+void TestCorruptedPixels()
+{
+    TempDirectory dir("thumbnailstore_pixels");
+    const wxString fileName = dir.GetPath("thumbnails.db");
+    const Store::Key key = Store::MakeKey(MakeItem(wxS("C:\\bitrot.jpg")), 1, 16);
+    Store store;
+
+    WXEB_CHECK(store.Open(fileName));
+    WXEB_CHECK(store.Insert(key, MakeThumbnail(4, 4, 5)));
+    store.Close();
+
+    wxExplorerBrowserMappedFile file;
+
+    WXEB_CHECK(file.Open(fileName, wxExplorerBrowserMappedFile::Mode_ReadWrite));
+    file.GetWritableData()[HeaderSize + RecordHeaderSize + 3] ^= 1;
+    file.Close();
+
+    // the record is indexed, the pixels are verified when looked up
+    WXEB_CHECK(store.Open(fileName));
+    WXEB_CHECK_EQUAL(store.GetCount(), 1u);
+    WXEB_CHECK(!HasThumbnail(store, key, 5));
+    WXEB_CHECK_EQUAL(store.GetCount(), 0u);
+}
+
+void TestMaxSize()
+{
+    TempDirectory dir("thumbnailstore_maxsize");
+    const size_t recordSize = GetRecordSize(16, 16);
+    const size_t maxSize = HeaderSize + 20 * recordSize;
+    Store store;
+
+    WXEB_CHECK(store.Open(dir.GetPath("thumbnails.db"), maxSize));
+
+    // larger than half of the file
+    WXEB_CHECK(!store.Insert(Store::MakeKey(MakeItem(wxS("C:\\huge.jpg")), 1, 256), MakeThumbnail(64, 64, 1)));
+
+    Store::Key first = Store::MakeKey(MakeItem(wxS("C:\\first.jpg")), 1, 16);
+
+    WXEB_CHECK(store.Insert(first, MakeThumbnail(16, 16, 9)));
+
+    for ( size_t i = 0; i < 50; ++i )
+    {
+        // the first one is used all the time, so it is kept
+        WXEB_CHECK(HasThumbnail(store, first, 9));
+        WXEB_CHECK(store.Insert(Store::MakeKey(MakeItem(wxString::Format(wxS("C:\\%zu.jpg"), i)), 1, 16),
+                                MakeThumbnail(16, 16, 1)));
+        WXEB_CHECK(store.GetUsedSize() <= maxSize);
+    }
+
+    WXEB_CHECK(store.GetCount() < 20);
+    WXEB_CHECK(HasThumbnail(store, first, 9));
+    WXEB_CHECK(HasThumbnail(store, Store::MakeKey(MakeItem(wxS("C:\\49.jpg")), 1, 16), 1));
+    WXEB_CHECK(!HasThumbnail(store, Store::MakeKey(MakeItem(wxS("C:\\0.jpg")), 1, 16), 1));
+
+    WXEB_CHECK(store.SetMaxSize(HeaderSize + 4 * recordSize));
+    WXEB_CHECK(store.GetCount() <= 3);
+    WXEB_CHECK(HasThumbnail(store, first, 9));
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestKeys();
+    TestRoundTrip();
+    TestKeyCollision();
+    TestCrashConsistency();
+    TestCorruptedPixels();
+    TestMaxSize();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
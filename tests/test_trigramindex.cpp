@@ -0,0 +1,215 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_trigramindex.cpp
+// Purpose:     Tests of wxExplorerBrowserTrigramIndex
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+namespace {
+
+typedef wxExplorerBrowserTrigramIndex Index;
+
+// the names of the ids found for str
+std::vector<wxString> FindNames(const Index& index, const wxString& str)
+{
+    Index::IdList ids;
+    std::vector<wxString> names;
+
+    index.Find(str, ids);
+    for ( const auto id : ids )
+        names.push_back(index.GetName(id));
+
+    return names;
+}
+
+void TestAddRemove()
+{
+    Index index;
+
+    WXEB_CHECK_EQUAL(index.GetCount(), 0u);
+    WXEB_CHECK(index.Add(wxS("Report.docx")));
+    WXEB_CHECK(index.Add(wxS("readme.md")));
+    WXEB_CHECK(index.Add(wxS("a")));
+
+    // the names are unique case-insensitively
+    WXEB_CHECK(!index.Add(wxS("REPORT.DOCX")));
+    WXEB_CHECK_EQUAL(index.GetCount(), 3u);
+    WXEB_CHECK(index.Contains(wxS("report.DOCX")));
+    WXEB_CHECK(!index.Contains(wxS("report")));
+
+    WXEB_CHECK(index.Remove(wxS("README.md")));
+    WXEB_CHECK(!index.Remove(wxS("readme.md")));
+    WXEB_CHECK(!index.Contains(wxS("readme.md")));
+    WXEB_CHECK_EQUAL(index.GetCount(), 2u);
+    WXEB_CHECK(FindNames(index, wxS("read")).empty());
+    WXEB_CHECK(FindNames(index, wxS("e")) == std::vector<wxString>({ wxS("Report.docx") }));
+
+    // added again after being removed
+    WXEB_CHECK(index.Add(wxS("ReadMe.md")));
+    WXEB_CHECK(FindNames(index, wxS("readme")) == std::vector<wxString>({ wxS("ReadMe.md") }));
+
+    index.Clear();
+    WXEB_CHECK_EQUAL(index.GetCount(), 0u);
+    WXEB_CHECK(FindNames(index, wxS("a")).empty());
+}
+
+void TestFind()
+{
+    Index index;
+    const wxString names[] = { wxS("Project_Report_2023.xlsx"), wxS("report.pdf"), wxS("Photos"), wxS("rep"),
+                               wxS("\u00c9t\u00e9 2023.jpg"), wxS("abcabc"),
+                               wxS("xabcy-zbcdw") };
+
+    for ( const auto& name : names )
+        WXEB_CHECK(index.Add(name));
+
+    // the ids in increasing order, the original names
+    Index::IdList ids;
+
+    index.Find(wxS("REPORT"), ids);
+    WXEB_CHECK_EQUAL(ids.size(), 2u);
+    WXEB_CHECK(ids[0] < ids[1]);
+    WXEB_CHECK(index.GetName(ids[0]) == wxS("Project_Report_2023.xlsx"));
+    WXEB_CHECK(index.GetUpperName(ids[0]) == wxS("PROJECT_REPORT_2023.XLSX"));
+
+    // shorter than a trigram
+    WXEB_CHECK_EQUAL(FindNames(index, wxS("re")).size(), 3u);
+    WXEB_CHECK_EQUAL(FindNames(index, wxS("x")).size(), 2u);
+
+    // exactly a trigram, and the whole name
+    WXEB_CHECK_EQUAL(FindNames(index, wxS("rep")).size(), 3u);
+    WXEB_CHECK(FindNames(index, wxS("report.pdf")) == std::vector<wxString>({ wxS("report.pdf") }));
+
+    // all the trigrams, but not in this order
+    WXEB_CHECK(FindNames(index, wxS("abcd")).empty());
+    WXEB_CHECK(FindNames(index, wxS("bcab")) == std::vector<wxString>({ wxS("abcabc") }));
+
+    // the repeated trigrams, the characters outside ASCII
+    WXEB_CHECK(FindNames(index, wxS("abcab")) == std::vector<wxString>({ wxS("abcabc") }));
+    WXEB_CHECK_EQUAL(FindNames(index, wxS("t\u00e9 2")).size(), 1u);
+
+    WXEB_CHECK(FindNames(index, wxS("")).empty());
+    WXEB_CHECK(FindNames(index, wxS("zzz")).empty());
+    WXEB_CHECK(FindNames(index, wxS("report.pdf.txt")).empty());
+}
+
+void TestSetItems()
+{
+    wxExplorerBrowserItem::List items(3, wxExplorerBrowserItem(wxExplorerBrowserItem::File));
+
+    items[0].SetPath(wxS("C:\\Data\\Budget.xlsx"));
+    items[0].SetDisplayName(wxS("Budget"));
+    items[1] = wxExplorerBrowserItem(wxExplorerBrowserItem::Directory);
+    items[1].SetPath(wxS("C:\\Data\\Archive"));
+    items[2] = wxExplorerBrowserItem(wxExplorerBrowserItem::Other);
+    items[2].SetDisplayName(wxS("This PC"));
+
+    Index index;
+
+    index.Add(wxS("stale"));
+    index.SetItems(items);
+
+    // the filenames of the files and directories, the display names of the others
+    WXEB_CHECK_EQUAL(index.GetCount(), 3u);
+    WXEB_CHECK(index.Contains(wxS("budget.xlsx")));
+    WXEB_CHECK(index.Contains(wxS("archive")));
+    WXEB_CHECK(index.Contains(wxS("this pc")));
+    WXEB_CHECK(!index.Contains(wxS("stale")));
+    WXEB_CHECK(FindNames(index, wxS("data")).empty());
+}
+
+// the ids are renumbered once most names were removed, the finds are not affected
+void TestCompact()
+{
+    Index index;
+
+    for ( int i = 0; i < 3000; ++i )
+        index.Add(wxString::Format(wxS("file%04d.txt"), i));
+
+    const size_t memory = index.GetMemoryUsage();
+
+    for ( int i = 0; i < 3000; ++i )
+    {
+        if ( i % 10 != 0 )
+            WXEB_CHECK(index.Remove(wxString::Format(wxS("file%04d.txt"), i)));
+    }
+
+    WXEB_CHECK_EQUAL(index.GetCount(), 300u);
+    WXEB_CHECK(index.GetMemoryUsage() < memory);
+
+    const std::vector<wxString> names = FindNames(index, wxS("file01"));
+
+    WXEB_CHECK_EQUAL(names.size(), 10u);
+    WXEB_CHECK(names.front() == wxS("file0100.txt"));
+    WXEB_CHECK(names.back() == wxS("file0190.txt"));
+    WXEB_CHECK(FindNames(index, wxS("file0101")).empty());
+    WXEB_CHECK_EQUAL(FindNames(index, wxS(".txt")).size(), 300u);
+}
+
+// the names found are exactly those containing the string
+void TestAgainstSubstring()
+{
+    const wxChar alphabet[] = wxS("abcAB. ");
+    Index index;
+    std::vector<wxString> names;
+
+    srand(7);
+    while ( names.size() < 1500 )
+    {
+        wxString name;
+
+        for ( int length = 1 + rand() % 10; length > 0; --length )
+            name += alphabet[rand() % 7];
+        if ( index.Add(name) )
+            names.push_back(name);
+    }
+
+    // some removed, so that the ids have gaps
+    for ( size_t i = 0; i < names.size(); i += 3 )
+        index.Remove(names[i]);
+
+    Index::IdList ids;
+
+    for ( int i = 0; i < 300; ++i )
+    {
+        wxString str;
+
+        for ( int length = 1 + rand() % 5; length > 0; --length )
+            str += alphabet[rand() % 7];
+
+        index.Find(str, ids);
+
+        size_t expected = 0;
+
+        for ( size_t n = 0; n < names.size(); ++n )
+        {
+            if ( n % 3 != 0 && names[n].Upper().find(str.Upper()) != wxString::npos )
+                ++expected;
+        }
+
+        bool found = true;
+
+        for ( const auto id : ids )
+            found = found && index.GetUpperName(id).find(str.Upper()) != wxString::npos;
+
+        WXEB_CHECK_EQUAL(ids.size(), expected);
+        WXEB_CHECK(found);
+    }
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestAddRemove();
+    TestFind();
+    TestSetItems();
+    TestCompact();
+    TestAgainstSubstring();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
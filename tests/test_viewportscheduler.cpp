@@ -0,0 +1,204 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        test_viewportscheduler.cpp
+// Purpose:     Tests of wxExplorerBrowserViewportScheduler
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <limits>
+
+#include "wxExplorerBrowserCore.h"
+#include "testing.h"
+
+namespace {
+
+typedef wxExplorerBrowserViewportScheduler Scheduler;
+
+std::vector<size_t> TakeNext(Scheduler& scheduler, size_t count)
+{
+    std::vector<size_t> indices;
+    size_t index;
+
+    while ( indices.size() < count && scheduler.Next(index) )
+        indices.push_back(index);
+
+    return indices;
+}
+
+void TestOrder()
+{
+    Scheduler scheduler;
+
+    scheduler.SetViewport(10, 5);
+    scheduler.AddRange(0, 30);
+    WXEB_CHECK_EQUAL(scheduler.GetPendingCount(), 30u);
+
+    // the visible items from the top, then the others alternating
+    // around the visible range, the closest first
+    const std::vector<size_t> expected { 10, 11, 12, 13, 14, 15, 9, 16, 8, 17, 7 };
+
+    WXEB_CHECK(TakeNext(scheduler, expected.size()) == expected);
+    WXEB_CHECK_EQUAL(scheduler.GetPendingCount(), 30u - expected.size());
+
+    // only the items after the visible range are left
+    scheduler.Clear();
+    scheduler.AddRange(20, 3);
+    WXEB_CHECK(TakeNext(scheduler, 10) == std::vector<size_t>({ 20, 21, 22 }));
+
+    // and before it
+    scheduler.AddRange(0, 3);
+    WXEB_CHECK(TakeNext(scheduler, 10) == std::vector<size_t>({ 2, 1, 0 }));
+
+    size_t index = 42;
+
+    WXEB_CHECK(!scheduler.Next(index));
+    WXEB_CHECK_EQUAL(index, 42u);
+    WXEB_CHECK(!scheduler.HasPending());
+}
+
+void TestScroll()
+{
+    Scheduler scheduler;
+
+    scheduler.SetViewport(0, 10);
+    scheduler.AddRange(0, 100);
+    WXEB_CHECK(TakeNext(scheduler, 3) == std::vector<size_t>({ 0, 1, 2 }));
+
+    // scrolled down, the items now visible come first and the ones
+    // still pending at the top are behind the ones close to the new range
+    scheduler.SetViewport(50, 10);
+    WXEB_CHECK(TakeNext(scheduler, 12) == std::vector<size_t>({ 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 49 }));
+    WXEB_CHECK_EQUAL(scheduler.GetViewportFirst(), 50u);
+    WXEB_CHECK_EQUAL(scheduler.GetViewportCount(), 10u);
+}
+
+void TestDistances()
+{
+    Scheduler scheduler;
+
+    scheduler.SetViewport(100, 10);
+    WXEB_CHECK_EQUAL(scheduler.GetDistance(100), 0u);
+    WXEB_CHECK_EQUAL(scheduler.GetDistance(109), 0u);
+    WXEB_CHECK_EQUAL(scheduler.GetDistance(110), 1u);
+    WXEB_CHECK_EQUAL(scheduler.GetDistance(99), 1u);
+    WXEB_CHECK_EQUAL(scheduler.GetDistance(0), 100u);
+
+    // the nearby distance is the size of the visible range by default
+    WXEB_CHECK_EQUAL(scheduler.GetPriority(105), Scheduler::Priority_Visible);
+    WXEB_CHECK_EQUAL(scheduler.GetPriority(119), Scheduler::Priority_Nearby);
+    WXEB_CHECK_EQUAL(scheduler.GetPriority(90), Scheduler::Priority_Nearby);
+    WXEB_CHECK_EQUAL(scheduler.GetPriority(120), Scheduler::Priority_Far);
+    WXEB_CHECK_EQUAL(scheduler.GetPriority(89), Scheduler::Priority_Far);
+
+    scheduler.SetDistances(3, 0);
+    WXEB_CHECK_EQUAL(scheduler.GetPriority(112), Scheduler::Priority_Nearby);
+    WXEB_CHECK_EQUAL(scheduler.GetPriority(113), Scheduler::Priority_Far);
+
+    // nothing is visible, e.g., in an empty folder
+    scheduler.SetViewport(0, 0);
+    WXEB_CHECK_EQUAL(scheduler.GetDistance(0), 0u);
+    WXEB_CHECK_EQUAL(scheduler.GetDistance(5), 5u);
+}
+
+void TestCancel()
+{
+    Scheduler scheduler;
+    std::vector<size_t> cancelled;
+
+    scheduler.AddRange(0, 100);
+
+    // no cancel distance, nothing is dropped
+    WXEB_CHECK_EQUAL(scheduler.SetViewport(50, 10, &cancelled), 0u);
+    WXEB_CHECK(cancelled.empty());
+
+    scheduler.SetDistances(0, 5);
+    WXEB_CHECK_EQUAL(scheduler.SetViewport(50, 10, &cancelled), 80u);
+    WXEB_CHECK_EQUAL(cancelled.size(), 80u);
+    WXEB_CHECK_EQUAL(scheduler.GetPendingCount(), 20u);
+    WXEB_CHECK(!scheduler.IsPending(44));
+    WXEB_CHECK(scheduler.IsPending(45));
+    WXEB_CHECK(scheduler.IsPending(64));
+    WXEB_CHECK(!scheduler.IsPending(65));
+    WXEB_CHECK_EQUAL(cancelled.front(), 0u);
+    WXEB_CHECK_EQUAL(cancelled.back(), 99u);
+
+    // without collecting them
+    WXEB_CHECK_EQUAL(scheduler.SetViewport(40, 10), 10u);
+    WXEB_CHECK_EQUAL(scheduler.GetPendingCount(), 10u);
+    WXEB_CHECK(scheduler.IsPending(54));
+
+    // the range at the end of the indices
+    const size_t last = std::numeric_limits<size_t>::max();
+
+    scheduler.Add(last);
+    scheduler.Add(last - 20);
+    WXEB_CHECK_EQUAL(scheduler.SetViewport(last - 1, 1), 11u);
+    WXEB_CHECK(scheduler.IsPending(last));
+    WXEB_CHECK_EQUAL(scheduler.GetPendingCount(), 1u);
+}
+
+void TestAddRemove()
+{
+    Scheduler scheduler;
+
+    WXEB_CHECK(scheduler.Add(5));
+    WXEB_CHECK(!scheduler.Add(5));
+    WXEB_CHECK(scheduler.IsPending(5));
+    WXEB_CHECK(scheduler.Remove(5));
+    WXEB_CHECK(!scheduler.Remove(5));
+    WXEB_CHECK(!scheduler.HasPending());
+
+    scheduler.AddRange(0, 10);
+    scheduler.AddRange(5, 10);
+    WXEB_CHECK_EQUAL(scheduler.GetPendingCount(), 15u);
+    WXEB_CHECK(scheduler.GetMemoryUsage() >= 15 * sizeof(size_t));
+
+    scheduler.Clear();
+    WXEB_CHECK_EQUAL(scheduler.GetMemoryUsage(), 0u);
+}
+
+void TestTakeAll()
+{
+    Scheduler scheduler;
+    Scheduler copy;
+    std::vector<size_t> indices { 1000 };
+
+    scheduler.SetViewport(7, 3);
+    scheduler.AddRange(0, 20);
+    copy.SetViewport(7, 3);
+    copy.AddRange(0, 20);
+
+    // appended in the order of Next()
+    WXEB_CHECK_EQUAL(scheduler.TakeAll(indices), 3u);
+    WXEB_CHECK_EQUAL(indices.size(), 21u);
+    WXEB_CHECK_EQUAL(indices[0], 1000u);
+    indices.erase(indices.begin());
+    WXEB_CHECK(indices == TakeNext(copy, 100));
+    WXEB_CHECK(!scheduler.HasPending());
+
+    // the chunks of RequestItemProperties(), visible items in the chunks 2 and 3
+    Scheduler chunks;
+
+    indices.clear();
+    chunks.SetViewport(2, 2);
+    chunks.AddRange(0, 6);
+    WXEB_CHECK_EQUAL(chunks.TakeAll(indices), 2u);
+    WXEB_CHECK(indices == std::vector<size_t>({ 2, 3, 4, 1, 5, 0 }));
+
+    indices.clear();
+    WXEB_CHECK_EQUAL(chunks.TakeAll(indices), 0u);
+    WXEB_CHECK(indices.empty());
+}
+
+} // unnamed namespace
+
+int main()
+{
+    TestOrder();
+    TestScroll();
+    TestDistances();
+    TestCancel();
+    TestAddRemove();
+    TestTakeAll();
+
+    return wxExplorerBrowserTesting::GetResult();
+}
@@ -0,0 +1,127 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        testing.h
+// Purpose:     Minimal checks for the tests of wxExplorerBrowserCore
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef WX_EXPLORER_BROWSER_TESTING_H_DEFINED
+#define WX_EXPLORER_BROWSER_TESTING_H_DEFINED
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include <wx/file.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/string.h>
+
+namespace wxExplorerBrowserTesting {
+
+inline int& GetFailureCount()
+{
+    static int s_failureCount = 0;
+
+    return s_failureCount;
+}
+
+inline void ReportFailure(const char* file, int line, const char* expression)
+{
+    std::fprintf(stderr, "%s(%d): check failed: %s\n", file, line, expression);
+    ++GetFailureCount();
+}
+
+// the value returned by main()
+inline int GetResult()
+{
+    if ( GetFailureCount() )
+        std::fprintf(stderr, "%d check(s) failed\n", GetFailureCount());
+
+    return GetFailureCount() != 0 ? 1 : 0;
+}
+
+// milliseconds since an unspecified moment, for the benchmarks
+inline double GetMilliseconds()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// a new empty directory in the working directory, removed when the object is destroyed
+class TempDirectory
+{
+public:
+    explicit TempDirectory(const char* name);
+    ~TempDirectory();
+
+    const wxString& GetPath() const { return m_path; }
+
+    // the full path of a file or directory in the directory, "/" separates the subdirectories
+    wxString GetPath(const char* relativePath) const;
+
+    // creates a file with the contents, and the missing directories on the way
+    bool AddFile(const char* relativePath, const std::string& contents = std::string()) const;
+    bool AddDirectory(const char* relativePath) const;
+
+private:
+    wxString m_path;
+
+    TempDirectory(const TempDirectory&) = delete;
+    TempDirectory& operator=(const TempDirectory&) = delete;
+};
+
+inline TempDirectory::TempDirectory(const char* name)
+{
+    m_path = wxFileName::GetCwd();
+    m_path += wxFILE_SEP_PATH;
+    m_path += wxString::FromUTF8(name);
+
+    // left over by a crashed run
+    if ( wxFileName::DirExists(m_path) )
+        wxFileName::Rmdir(m_path, wxPATH_RMDIR_RECURSIVE);
+
+    wxFileName::Mkdir(m_path, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+}
+
+inline TempDirectory::~TempDirectory()
+{
+    wxFileName::Rmdir(m_path, wxPATH_RMDIR_RECURSIVE);
+}
+
+inline wxString TempDirectory::GetPath(const char* relativePath) const
+{
+    wxString path = m_path;
+
+    path += wxFILE_SEP_PATH;
+    for ( const char* s = relativePath; *s; ++s )
+        path += *s == '/' ? wxFILE_SEP_PATH : static_cast<wxChar>(*s);
+
+    return path;
+}
+
+inline bool TempDirectory::AddFile(const char* relativePath, const std::string& contents) const
+{
+    const wxString path = GetPath(relativePath);
+    const size_t pos = path.find_last_of(wxFILE_SEP_PATH);
+
+    if ( !wxFileName::Mkdir(path.substr(0, pos), wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL) )
+        return false;
+
+    wxFile file;
+
+    return file.Create(path, true) && (contents.empty() || file.Write(contents.data(), contents.size()));
+}
+
+inline bool TempDirectory::AddDirectory(const char* relativePath) const
+{
+    return wxFileName::Mkdir(GetPath(relativePath), wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+}
+
+} // namespace wxExplorerBrowserTesting
+
+#define WXEB_CHECK(expression) \
+    do { if ( !(expression) ) wxExplorerBrowserTesting::ReportFailure(__FILE__, __LINE__, #expression); } while ( 0 )
+
+#define WXEB_CHECK_EQUAL(actual, expected) \
+    WXEB_CHECK((actual) == (expected))
+
+#endif //ifndef WX_EXPLORER_BROWSER_TESTING_H_DEFINED
@@ -1,186 +1,459 @@
-////////////////////////////////////////////////////////////////////////////////////
-//
-//  Name:        wxExplorerBrowser.cpp
-//  Purpose:     Implements wxExplorerBrowser, a class for hosting
-//               IExplorerBrowser in wxWidgets applications
-//  Author:      PB
-//  Copyright:   (c) 2018 PB <pbfordev@gmail.com>
-//  Licence:     wxWindows licence
-//
-////////////////////////////////////////////////////////////////////////////////////
-
-#include "wxExplorerBrowser.h"
-
-// @TODO
-// no items in Control Panel
-// select items
-
-#if  !defined(__WXMSW__) || !wxUSE_OLE || !wxUSE_DYNLIB_CLASS
-    #error wxExplorerBrowser requires wxWidgets to be built for MS Windows with support for OLE and DLLs
-#endif
-
-#if !wxCHECK_VERSION(3, 1, 0)
-    #error wxExplorerBrowser requires wxWidgets version 3.1 or higher
-#endif
-
-#include <wx/filename.h>
-#include <wx/dcclient.h>
-#include <wx/dynlib.h>
-
-#include <wx/msw/private.h>
-#include <wx/msw/private/comptr.h>
-#include <wx/msw/wrapshl.h>
-#include <wx/msw/winundef.h>
-
-#define STRICT_TYPED_ITEMIDS
-#include <shlwapi.h>
-#include <shobjidl.h>
-#include <shldisp.h>
-
-#if !defined(_WIN32_WINNT) || (_WIN32_WINNT < 0x0600)
-    #error wxExplorerBrowser requires Windows SDK targetting Windows Vista or newer
-#endif
-
-
-// The code in this file took many things from the article (and comments on it)
-// at https://www.codeproject.com/Articles/17809/Host-Windows-Explorer-in-your-applications-using-t
-// and from the ExplorerBrowserHost sample by chrisg originally published on ShellRevealed.com
-
-// For some reason ICommDlgBrowser::OnStateChange is called twice with CDBOSC_SELCHANGE
-// for the same item.
-// If WX_EXPLORER_BROWSER_PREVENT_DOUBLED_CHANGESEL_EVENTS is defined,
-// the workaround code will be compiled-in which will try preventing that.
-#define WX_EXPLORER_BROWSER_PREVENT_DOUBLED_CHANGESEL_EVENTS 1
-
-namespace {
-
-/***************************************************************************
-
-    class wxExplorerBrowserImplHelper
-    ---------------------------------
-    implements several COM interfaces,
-    does the actual item filtering and contains
-    utility functions such as converting
-    pidl/IShellItem to ExplorerBrowserItem
-
-*****************************************************************************/
-
-class wxExplorerBrowserImplHelper :
-    public IServiceProvider,
-    public ICommDlgBrowser3,
-    public IExplorerBrowserEvents,
-    public IFolderFilter,
-    public IExplorerPaneVisibility
-{
-public:
-    wxExplorerBrowserImplHelper(wxWindow* host, IExplorerBrowser* explorerBrowser)
-        : m_host{host}, m_explorerBrowser{explorerBrowser} {}
-
-    // IUnknown methods implemented from scratch.
-    // For some reason the code kept crashing when using COM interface
-    // implementation helper macros from <wx/msw/ole/comimpl.h>
-    // and IUnknown_SetSite()
+////////////////////////////////////////////////////////////////////////////////////
+//
+//  Name:        wxExplorerBrowser.cpp
+//  Purpose:     Implements wxExplorerBrowser, a class for hosting
+//               IExplorerBrowser in wxWidgets applications
+//  Author:      PB
+//  Copyright:   (c) 2018 PB <pbfordev@gmail.com>
+//  Licence:     wxWindows licence
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#include "wxExplorerBrowser.h"
+#include "wxExplorerBrowserCore.h"
+
+// @TODO
+// no items in Control Panel
+// select items
+
+#if  !defined(__WXMSW__) || !wxUSE_OLE || !wxUSE_DYNLIB_CLASS
+    #error wxExplorerBrowser requires wxWidgets to be built for MS Windows with support for OLE and DLLs
+#endif
+
+#if !wxCHECK_VERSION(3, 1, 0)
+    #error wxExplorerBrowser requires wxWidgets version 3.1 or higher
+#endif
+
+#include <wx/dcclient.h>
+#include <wx/dynlib.h>
+#include <deque>
+#include <functional>
+#include <wx/timer.h>
+#include <wx/toplevel.h>
+#include <wx/app.h>
+#include <wx/image.h>
+#include <wx/module.h>
+
+#include <wx/msw/private.h>
+#include <wx/msw/private/comptr.h>
+#include <wx/msw/wrapshl.h>
+#include <wx/msw/winundef.h>
+
+#define STRICT_TYPED_ITEMIDS
+#include <shlwapi.h>
+#include <shobjidl.h>
+#include <shldisp.h>
+#include <exdispid.h>
+
+#if !defined(_WIN32_WINNT) || (_WIN32_WINNT < 0x0600)
+    #error wxExplorerBrowser requires Windows SDK targetting Windows Vista or newer
+#endif
+
+
+// The code in this file took many things from the article (and comments on it)
+// at https://www.codeproject.com/Articles/17809/Host-Windows-Explorer-in-your-applications-using-t
+// and from the ExplorerBrowserHost sample by chrisg originally published on ShellRevealed.com
+
+// For some reason ICommDlgBrowser::OnStateChange is called twice with CDBOSC_SELCHANGE
+// for the same item.
+// If WX_EXPLORER_BROWSER_PREVENT_DOUBLED_CHANGESEL_EVENTS is defined,
+// the workaround code will be compiled-in which will try preventing that.
+#define WX_EXPLORER_BROWSER_PREVENT_DOUBLED_CHANGESEL_EVENTS 1
+
+namespace {
+
+// destroys the cancelled background walks, which can take long to stop
+wxExplorerBrowserReaper& GetReaper()
+{
+    // never destroyed, its thread is joined by wxExplorerBrowserModule
+    static wxExplorerBrowserReaper* s_reaper = new wxExplorerBrowserReaper();
+
+    return *s_reaper;
+}
+
+} // unnamed namespace
+
+// joins the thread of the reaper when wxWidgets is cleaned up,
+// so that no walk is still running when the program or the DLL unloads
+class wxExplorerBrowserModule : public wxModule
+{
+public:
+    bool OnInit() override { return true; }
+    void OnExit() override { GetReaper().Shutdown(); }
+
+private:
+    wxDECLARE_DYNAMIC_CLASS(wxExplorerBrowserModule);
+};
+
+wxIMPLEMENT_DYNAMIC_CLASS(wxExplorerBrowserModule, wxModule);
+
+namespace {
+
+// a compact record of a non-vetoable wxExplorerBrowserEvent
+// waiting in the queue to be sent
+struct QueuedEvent
+{
+    wxEventType type {wxEVT_NULL};
+    PIDLIST_ABSOLUTE pidl {nullptr}; // owned, converted to the item when the event is sent
+    wxExplorerBrowserItemPool::ItemPtr item; // used when there is no pidl
+};
+
+// a bounded queue of the events; the shell calls the callbacks in the main
+// thread which also sends the events when idle, so it is not synchronized
+class QueuedEvents
+{
+public:
+    explicit QueuedEvents(size_t capacity) : m_capacity(capacity) {}
+    ~QueuedEvents()
+    {
+        for ( const auto& event : m_events )
+            ::CoTaskMemFree(event.pidl);
+    }
+
+    size_t GetCapacity() const { return m_capacity; }
+    bool IsEmpty() const { return m_events.empty(); }
+
+    // takes the ownership of the pidl only if it returns true
+    bool TryPush(const QueuedEvent& event)
+    {
+        if ( m_events.size() >= m_capacity )
+            return false;
+
+        m_events.push_back(event);
+        return true;
+    }
+
+    // the caller takes the ownership of the pidl
+    bool TryPop(QueuedEvent& event)
+    {
+        if ( m_events.empty() )
+            return false;
+
+        event = std::move(m_events.front());
+        m_events.pop_front();
+        return true;
+    }
+
+private:
+    const size_t m_capacity;
+    std::deque<QueuedEvent> m_events;
+
+    wxDECLARE_NO_COPY_CLASS(QueuedEvents);
+};
+
+// the listing prepared for wxExplorerBrowser::QuickFind(), kept for all
+// the keystrokes of a search until the view changes, as getting the items
+// from the view takes much longer than matching them
+class QuickFinder
+{
+public:
+    QuickFinder() {}
+
+    // true if the listing was prepared for these types and this state of the view
+    bool IsPrepared(wxUint32 itemTypes, int viewCount, wxUint64 viewGeneration) const
+    {
+        return itemTypes == m_types && viewCount == m_viewCount && viewGeneration == m_viewGeneration;
+    }
+
+    // filled by the caller before calling Prepare()
+    wxExplorerBrowserItem::List& GetListing() { return m_listing; }
+
+    void Prepare(wxUint32 itemTypes, int viewCount, wxUint64 viewGeneration)
+    {
+        m_matcher.SetItems(m_listing);
+        m_types = itemTypes;
+        m_viewCount = viewCount;
+        m_viewGeneration = viewGeneration;
+    }
+
+    void Find(const wxString& pattern, size_t maxResults,
+              wxExplorerBrowserItem::List& items, std::vector<int>* scores)
+    {
+        m_matcher.Find(pattern, maxResults, m_matches);
+
+        items.clear();
+        items.reserve(m_matches.size());
+        if ( scores )
+            scores->clear();
+
+        for ( const auto& match : m_matches )
+        {
+            items.push_back(m_listing[match.index]);
+            if ( scores )
+                scores->push_back(match.score);
+        }
+    }
+
+    void Reset()
+    {
+        m_matcher.Clear();
+        m_listing.clear();
+        m_types = 0;
+        m_viewCount = -1;
+    }
+
+    size_t GetMemoryUsage() const
+    {
+        return wxExplorerBrowserGetMemoryUsage(m_listing) + m_matcher.GetMemoryUsage()
+               + m_matches.capacity() * sizeof(wxExplorerBrowserFuzzyMatcher::Match);
+    }
+
+private:
+    wxExplorerBrowserFuzzyMatcher m_matcher;
+    wxExplorerBrowserItem::List m_listing;
+    wxExplorerBrowserFuzzyMatcher::Matches m_matches;
+    wxUint32 m_types {0};
+    int m_viewCount {-1};
+    wxUint64 m_viewGeneration {0}; // of the view contents, see _GetViewContentsGeneration()
+
+    wxDECLARE_NO_COPY_CLASS(QuickFinder);
+};
+
+/***************************************************************************
+
+    class wxExplorerBrowserImplHelper
+    ---------------------------------
+    implements several COM interfaces,
+    does the actual item filtering and contains
+    utility functions such as converting
+    pidl/IShellItem to ExplorerBrowserItem
+
+*****************************************************************************/
+
+class wxExplorerBrowserImplHelper :
+    public IServiceProvider,
+    public ICommDlgBrowser3,
+    public IExplorerBrowserEvents,
+    public IFolderFilter,
+    public IExplorerPaneVisibility,
+    public IDispatch
+{
+public:
+    wxExplorerBrowserImplHelper(wxWindow* host, IExplorerBrowser* explorerBrowser)
+        : m_host{host}, m_explorerBrowser{explorerBrowser} {}
+    ~wxExplorerBrowserImplHelper();
+
+    // IUnknown methods implemented from scratch.
+    // For some reason the code kept crashing when using COM interface
+    // implementation helper macros from <wx/msw/ole/comimpl.h>
+    // and IUnknown_SetSite()
     STDMETHODIMP_(ULONG) AddRef() override;
-    STDMETHODIMP_(ULONG) Release() override;
-    STDMETHODIMP QueryInterface(REFIID riid, void** ppv) override;
-
-    // IServiceProvider method
-    STDMETHODIMP QueryService(REFGUID guidService, REFIID riid, void** ppv) override;
-
-    // ICommDlgBrowser methods
-    STDMETHODIMP OnDefaultCommand(IShellView* ppshv) override;
-    STDMETHODIMP OnStateChange(IShellView* ppshv, ULONG uChange) override;
-    STDMETHODIMP IncludeObject(IShellView* ppshv, PCUITEMID_CHILD pidl) override;
-
-    // ICommDlgBrowser2 methods
-    STDMETHODIMP Notify(IShellView* ppshv, DWORD dwNotifyType) override;
-    STDMETHODIMP GetDefaultMenuText(IShellView* ppshv, LPWSTR pszText, int cchMax) override;
-    STDMETHODIMP GetViewFlags(DWORD* pdwFlags) override;
-
-    // ICommDlgBrowser3 methods
-    STDMETHODIMP GetCurrentFilter(LPWSTR pszFileSpec, int cchFileSpec) override;
-    STDMETHODIMP OnColumnClicked(IShellView*ppshv, int iColumn) override;
-    STDMETHODIMP OnPreViewCreated(IShellView* ppshv) override;
-
-    // IExplorerBrowserEvents methods
-    STDMETHODIMP OnNavigationPending(PCIDLIST_ABSOLUTE pidlFolder) override;
-    STDMETHODIMP OnViewCreated(IShellView* psv) override;
-    STDMETHODIMP OnNavigationComplete(PCIDLIST_ABSOLUTE pidlFolder) override;
-    STDMETHODIMP OnNavigationFailed(PCIDLIST_ABSOLUTE pidlFolder) override;
-
-    // IFolderFilter methods
-    STDMETHODIMP GetEnumFlags(IShellFolder*psf, PCIDLIST_ABSOLUTE pidlFolder, HWND* phwnd, DWORD* pgrfFlags) override;
-    STDMETHODIMP ShouldShow(IShellFolder* psf, PCIDLIST_ABSOLUTE pidlFolder, PCUITEMID_CHILD pidlItem) override;
-
-    // IExplorerPaneVisibility method
-    STDMETHODIMP GetPaneState(REFEXPLORERPANE ep, EXPLORERPANESTATE *peps) override;
-
-    // Names of all helper methods, i.e., those not implementing a COM interface,
-    // start with an underscore
-
-    bool _SetFilter(const wxArrayString& fileMasks, wxUint32 itemTypes);
-    bool _RemoveFilter();
-
-    bool _SetPaneSettings(const wxExplorerBrowser::PaneSettings& settings);
-
-    static wxExplorerBrowserItem::Type _SFGAO2wxExplorerBrowserItemType(SFGAOF attr);
-    static bool _IShellItem2wxExplorerBrowserItem(IShellItem* item, wxExplorerBrowserItem& ebi);
-    static bool _PPIDL2wxExplorerBrowserItem(PCIDLIST_ABSOLUTE pidl, wxExplorerBrowserItem& ebi);
-
-private:
-    LONG              m_refCount {1};
-    wxWindow*         m_host {nullptr};
-    IExplorerBrowser* m_explorerBrowser {nullptr};
-
-    wxArrayString     m_filterMasks; // list of filter masks, such as *.JPG
-    wxUint32          m_filterTypes {0}; // flags for item types, such as File, Directory
-
-    wxExplorerBrowser::PaneSettings m_paneSettings;
-
-    bool _SendNotifyEvent(wxEventType command, PCIDLIST_ABSOLUTE list) const;
-    bool _SendNotifyEvent(wxEventType command, const wxExplorerBrowserItem& ebi) const;
-
-    bool _GetSelectedItem(wxExplorerBrowserItem& ebi);
-
-#ifdef WX_EXPLORER_BROWSER_PREVENT_DOUBLED_CHANGESEL_EVENTS
-    class ChangeSelEventData
-    {
-    public:
-        ChangeSelEventData() {}
-
-        void SetItem(const wxExplorerBrowserItem& item)
-        {
-            m_item = item;
-        }
-
-        bool IsDoubled(const ChangeSelEventData& previous) const
-        {
-            // If the difference between the two events is <=
-            // the doubledTime and the item contains the same data,
-            // then the event is considered a doubled event.
-            static const ULONGLONG doubledTime = 50; // in milliseconds
-
-            return
-                m_timeCreated - previous.m_timeCreated <= doubledTime
-                && m_item.GetSFGAO() == previous.m_item.GetSFGAO()
-                && m_item.GetPath() == previous.m_item.GetPath()
-                && m_item.GetDisplayName() == previous.m_item.GetDisplayName();
-        }
-    private:
-        ULONGLONG m_timeCreated {::GetTickCount64()};
-        wxExplorerBrowserItem m_item;
-    };
-
-    ChangeSelEventData m_prevChangeSelEventData;
-#endif // #ifdef WX_EXPLORER_BROWSER_PREVENT_DOUBLED_CHANGESEL_EVENTS
-
-    wxDECLARE_NO_COPY_CLASS(wxExplorerBrowserImplHelper);
-};
-
-// IUnknown_SetSite is not available on MinGW
-// so it we must be load dynamically
-HRESULT Call_IUnknown_SetSite(IUnknown* punk, IUnknown* punkSite)
-{
+    STDMETHODIMP_(ULONG) Release() override;
+    STDMETHODIMP QueryInterface(REFIID riid, void** ppv) override;
+
+    // IServiceProvider method
+    STDMETHODIMP QueryService(REFGUID guidService, REFIID riid, void** ppv) override;
+
+    // ICommDlgBrowser methods
+    STDMETHODIMP OnDefaultCommand(IShellView* ppshv) override;
+    STDMETHODIMP OnStateChange(IShellView* ppshv, ULONG uChange) override;
+    STDMETHODIMP IncludeObject(IShellView* ppshv, PCUITEMID_CHILD pidl) override;
+
+    // ICommDlgBrowser2 methods
+    STDMETHODIMP Notify(IShellView* ppshv, DWORD dwNotifyType) override;
+    STDMETHODIMP GetDefaultMenuText(IShellView* ppshv, LPWSTR pszText, int cchMax) override;
+    STDMETHODIMP GetViewFlags(DWORD* pdwFlags) override;
+
+    // ICommDlgBrowser3 methods
+    STDMETHODIMP GetCurrentFilter(LPWSTR pszFileSpec, int cchFileSpec) override;
+    STDMETHODIMP OnColumnClicked(IShellView*ppshv, int iColumn) override;
+    STDMETHODIMP OnPreViewCreated(IShellView* ppshv) override;
+
+    // IExplorerBrowserEvents methods
+    STDMETHODIMP OnNavigationPending(PCIDLIST_ABSOLUTE pidlFolder) override;
+    STDMETHODIMP OnViewCreated(IShellView* psv) override;
+    STDMETHODIMP OnNavigationComplete(PCIDLIST_ABSOLUTE pidlFolder) override;
+    STDMETHODIMP OnNavigationFailed(PCIDLIST_ABSOLUTE pidlFolder) override;
+
+    // IFolderFilter methods
+    STDMETHODIMP GetEnumFlags(IShellFolder*psf, PCIDLIST_ABSOLUTE pidlFolder, HWND* phwnd, DWORD* pgrfFlags) override;
+    STDMETHODIMP ShouldShow(IShellFolder* psf, PCIDLIST_ABSOLUTE pidlFolder, PCUITEMID_CHILD pidlItem) override;
+
+    // IExplorerPaneVisibility method
+    STDMETHODIMP GetPaneState(REFEXPLORERPANE ep, EXPLORERPANESTATE *peps) override;
+
+    // IDispatch methods, only Invoke() is implemented for receiving DShellFolderViewEvents
+    STDMETHODIMP GetTypeInfoCount(UINT* pctinfo) override;
+    STDMETHODIMP GetTypeInfo(UINT iTInfo, LCID lcid, ITypeInfo** ppTInfo) override;
+    STDMETHODIMP GetIDsOfNames(REFIID riid, LPOLESTR* rgszNames, UINT cNames, LCID lcid, DISPID* rgDispId) override;
+    STDMETHODIMP Invoke(DISPID dispIdMember, REFIID riid, LCID lcid, WORD wFlags, DISPPARAMS* pDispParams,
+                        VARIANT* pVarResult, EXCEPINFO* pExcepInfo, UINT* puArgErr) override;
+
+    // Names of all helper methods, i.e., those not implementing a COM interface,
+    // start with an underscore
+
+    bool _SetFilter(const wxArrayString& fileMasks, wxUint32 itemTypes);
+    bool _RemoveFilter();
+    // the rules of currentFolder, if not null, are loaded at once
+    bool _SetIgnoreRules(const wxString& root, const wxString& fileName, const wxString& globalRules,
+                         PCIDLIST_ABSOLUTE currentFolder);
+    bool _RemoveIgnoreRules();
+    size_t _GetFilterMemoryUsage() const;
+
+    // uppercase names, see wxExplorerBrowserMaskMatcher::GetMatchName()
+    typedef std::unordered_set<wxString, wxStringHash, wxStringEqual> NameSet;
+
+    // only the items with the names are shown in the folder
+    void _SetVisibleNames(PCIDLIST_ABSOLUTE folder, NameSet&& names);
+    void _RemoveVisibleNames();
+    const wxExplorerBrowserMaskMatcher& _GetFilter() const { return m_filter; }
+
+    // the rules loaded for the folder when navigating to it, null if there are none
+    wxExplorerBrowserIgnoreRules::DirectoryRulesPtr _GetIgnoreRules(PCIDLIST_ABSOLUTE folder) const;
+
+    // true if the item is hidden by the ignore rules of its folder or by the filter,
+    // buffer is used for its name
+    bool _IsFilteredOut(const wxExplorerBrowserItem& ebi,
+                        const wxExplorerBrowserIgnoreRules::DirectoryRulesPtr& ignoreRules,
+                        wxString& buffer) const;
+
+    bool _SetPaneSettings(const wxExplorerBrowser::PaneSettings& settings);
+
+    static wxExplorerBrowserItem::Type _SFGAO2wxExplorerBrowserItemType(SFGAOF attr);
+    // if cache is not null, the item is looked up in it first and added to it when not found,
+    // if pidl is not null, it is set to the ID list of the item, which the caller must free
+    static bool _IShellItem2wxExplorerBrowserItem(IShellItem* item, wxExplorerBrowserItem& ebi,
+                                                  wxExplorerBrowserItemCache* cache = nullptr,
+                                                  PIDLIST_ABSOLUTE* pidlOut = nullptr);
+    static bool _PPIDL2wxExplorerBrowserItem(PCIDLIST_ABSOLUTE pidl, wxExplorerBrowserItem& ebi,
+                                             wxExplorerBrowserItemCache* cache = nullptr);
+
+    // ids of the item and its parent folder, also their keys in wxExplorerBrowserItemCache
+    static wxUint64 _GetIDListKey(PCIDLIST_ABSOLUTE pidl);
+    // the key of the folder by which its items are invalidated in the cache
+    static wxUint64 _GetFolderKey(PCIDLIST_ABSOLUTE pidl);
+    static wxUint64 _GetParentIDListKey(PCIDLIST_ABSOLUTE pidl);
+
+    // compares the bytes first, the shell only when they differ
+    static bool _IsSameIDList(PCIDLIST_ABSOLUTE pidl1, PCIDLIST_ABSOLUTE pidl2);
+
+    void _SetItemCache(wxExplorerBrowserItemCache* cache) { m_itemCache = cache; }
+
+    // the non-vetoable events are pushed to the queue instead of being sent, if it is not null
+    void _SetEventQueue(const std::shared_ptr<QueuedEvents>& queue) { m_eventQueue = queue; }
+    const std::shared_ptr<QueuedEvents>& _GetEventQueue() const { return m_eventQueue; }
+
+    // sends at most maxCount events from the queue, the event handlers may replace the queue
+    void _SendQueuedEvents(QueuedEvents& queue, size_t maxCount) const;
+
+    // used when the ExplorerBrowser is recreated after being torn down while parked
+    void _SetExplorerBrowser(IExplorerBrowser* explorerBrowser) { m_explorerBrowser = explorerBrowser; }
+
+    // changed whenever items are added to, removed from or renamed in the view,
+    // and when a new view is created
+    wxUint64 _GetViewContentsGeneration() const { return m_viewContentsGeneration; }
+    // must be called before destroying the ExplorerBrowser, the view keeps a reference to us
+    void _UnadviseViewEvents();
+
+private:
+    LONG              m_refCount {1};
+    wxWindow*         m_host {nullptr};
+    IExplorerBrowser* m_explorerBrowser {nullptr};
+
+    wxExplorerBrowserMaskMatcher m_filter; // masks such as *.JPG and the item types they apply to
+    wxExplorerBrowserIgnoreRules m_ignoreRules; // such as those of .gitignore files
+
+    // the compiled ignore rules for the items of a folder, loaded when navigating to it,
+    // so that ShouldShow() neither reads the ignore files nor changes m_ignoreRules
+    struct IgnoreRulesFolder
+    {
+        PIDLIST_ABSOLUTE pidl {nullptr};
+        wxExplorerBrowserIgnoreRules::DirectoryRulesPtr rules;
+    };
+
+    enum
+    {
+        IgnoreRules_Shown,
+        IgnoreRules_Pending, // the folder being navigated to
+        IgnoreRules_Max
+    };
+
+    IgnoreRulesFolder m_ignoreRulesFolders[IgnoreRules_Max];
+
+    void _LoadIgnoreRules(PCIDLIST_ABSOLUTE folder, size_t index);
+
+    // the names found by wxExplorerBrowser::SearchIndex(), immutable once published
+    struct VisibleNames
+    {
+        PIDLIST_ABSOLUTE folder {nullptr};
+        NameSet names;
+
+        ~VisibleNames() { ::CoTaskMemFree(folder); }
+    };
+    typedef std::shared_ptr<const VisibleNames> VisibleNamesPtr;
+
+    VisibleNamesPtr m_visibleNames; // null when all names are shown
+
+    // ShouldShow() may be called by the enumeration thread of the view, so it
+    // takes the pointers to the ignore rules and the visible names under the lock
+    mutable std::mutex m_folderFilterLock;
+
+    VisibleNamesPtr _GetVisibleNames() const;
+
+    wxExplorerBrowser::PaneSettings m_paneSettings;
+
+    wxExplorerBrowserItemCache* m_itemCache {nullptr};
+
+    static bool _ShellItem2wxExplorerBrowserItem(IShellItem* item, wxExplorerBrowserItem& ebi);
+
+    mutable wxExplorerBrowserItemPool m_eventItemPool; // for the items of wxExplorerBrowserEvents
+    std::shared_ptr<QueuedEvents> m_eventQueue;
+
+    bool _SendNotifyEvent(wxEventType command, PCIDLIST_ABSOLUTE list) const;
+    bool _SendNotifyEvent(wxEventType command, const wxExplorerBrowserItem& ebi) const;
+    static bool _IsVetoable(wxEventType command);
+    // returns false if the queue was full, the event must be sent right away then
+    bool _QueueEvent(const QueuedEvent& queued) const;
+    bool _ProcessNotifyEvent(wxEventType command, const wxExplorerBrowserItem& ebi) const;
+
+    bool _GetSelectedItem(wxExplorerBrowserItem& ebi);
+
+#ifdef WX_EXPLORER_BROWSER_PREVENT_DOUBLED_CHANGESEL_EVENTS
+    class ChangeSelEventData
+    {
+    public:
+        ChangeSelEventData() {}
+
+        void SetItem(const wxExplorerBrowserItem& item)
+        {
+            m_item = item;
+        }
+
+        bool IsDoubled(const ChangeSelEventData& previous) const
+        {
+            // If the difference between the two events is <=
+            // the doubledTime and the item contains the same data,
+            // then the event is considered a doubled event.
+            static const ULONGLONG doubledTime = 50; // in milliseconds
+
+            return
+                m_timeCreated - previous.m_timeCreated <= doubledTime
+                && m_item.GetSFGAO() == previous.m_item.GetSFGAO()
+                && m_item.GetPath() == previous.m_item.GetPath()
+                && m_item.GetDisplayName() == previous.m_item.GetDisplayName();
+        }
+    private:
+        ULONGLONG m_timeCreated {::GetTickCount64()};
+        wxExplorerBrowserItem m_item;
+    };
+
+    ChangeSelEventData m_prevChangeSelEventData;
+#endif // #ifdef WX_EXPLORER_BROWSER_PREVENT_DOUBLED_CHANGESEL_EVENTS
+
+    // DShellFolderViewEvents of the current view
+    wxCOMPtr<IConnectionPoint> m_viewEventsPoint;
+    DWORD m_viewEventsCookie {0};
+    wxUint64 m_viewContentsGeneration {0};
+
+    void _AdviseViewEvents(IShellView* view);
+
+    wxDECLARE_NO_COPY_CLASS(wxExplorerBrowserImplHelper);
+};
+
+// IUnknown_SetSite is not available on MinGW
+// so it we must be load dynamically
+HRESULT Call_IUnknown_SetSite(IUnknown* punk, IUnknown* punkSite)
+{
     typedef HRESULT (WINAPI *IUnknown_SetSite_t)(IUnknown*, IUnknown*);
     static IUnknown_SetSite_t s_pfnIUnknown_SetSite = nullptr;
 
@@ -195,1440 +468,5163 @@ HRESULT Call_IUnknown_SetSite(IUnknown* punk, IUnknown* punkSite)
     if ( s_pfnIUnknown_SetSite )
         return s_pfnIUnknown_SetSite(punk, punkSite);
     else
-        return E_FAIL;
-}
-
+        return E_FAIL;
+}
+
+// shared by all parked wxExplorerBrowser instances
+wxExplorerBrowserParkingLot& GetParkingLot()
+{
+    static wxExplorerBrowserParkingLot s_parkingLot;
+
+    return s_parkingLot;
+}
+
+// the message the shell change notifications are sent with
+UINT GetChangeNotifyMessage()
+{
+    static const UINT s_message = ::RegisterWindowMessageW(L"wxExplorerBrowserChangeNotify");
+
+    return s_message;
+}
+
+// initializes COM for the lifetime of a thread not created by wxWidgets,
+// in the multithreaded apartment: the worker threads block waiting for work
+// without pumping messages, which a single-threaded apartment requires, and
+// COM creates the apartment-threaded shell extensions in a host STA instead
+class ThreadCOMInitializer
+{
+public:
+    ThreadCOMInitializer() : m_hr(::CoInitializeEx(nullptr, COINIT_MULTITHREADED | COINIT_DISABLE_OLE1DDE)) {}
+    ~ThreadCOMInitializer()
+    {
+        if ( SUCCEEDED(m_hr) )
+            ::CoUninitialize();
+    }
+
+    bool IsOk() const { return SUCCEEDED(m_hr) || m_hr == RPC_E_CHANGED_MODE; }
+private:
+    HRESULT m_hr;
+};
+
+// must be called before using COM on a thread not created by wxWidgets,
+// on a thread which already uses COM, e.g. the UI thread, it does nothing
+bool InitializeCOMForThread()
+{
+    static thread_local ThreadCOMInitializer s_comInitializer;
+
+    return s_comInitializer.IsOk();
+}
+
+// the decoder of wxExplorerBrowserThumbnailService, called on its worker threads
+bool ExtractThumbnail(const wxExplorerBrowserItem& item, unsigned size, wxExplorerBrowserThumbnail& thumbnail)
+{
+    if ( !InitializeCOMForThread() || item.GetPath().empty() )
+        return false;
+
+    HRESULT hr;
+    wxCOMPtr<IShellItemImageFactory> imageFactory;
+    HBITMAP hBitmap = nullptr;
+    const SIZE imageSize = { static_cast<LONG>(size), static_cast<LONG>(size) };
+
+    hr = ::SHCreateItemFromParsingName(item.GetPath().wc_str(), nullptr,
+                                       wxIID_PPV_ARGS(IShellItemImageFactory, &imageFactory));
+    if ( SUCCEEDED(hr) )
+        hr = imageFactory->GetImage(imageSize, SIIGBF_RESIZETOFIT, &hBitmap);
+    if ( FAILED(hr) )
+        return false; // not logged, failing for some items is expected and we are not on the main thread
+
+    BITMAP bitmap;
+    bool ok = false;
+
+    if ( ::GetObject(hBitmap, sizeof(bitmap), &bitmap) && bitmap.bmWidth > 0 && bitmap.bmHeight > 0 )
+    {
+        BITMAPINFO bmi = {};
+
+        bmi.bmiHeader.biSize = sizeof(bmi.bmiHeader);
+        bmi.bmiHeader.biWidth = bitmap.bmWidth;
+        bmi.bmiHeader.biHeight = -bitmap.bmHeight; // top-down
+        bmi.bmiHeader.biPlanes = 1;
+        bmi.bmiHeader.biBitCount = 32;
+        bmi.bmiHeader.biCompression = BI_RGB;
+
+        thumbnail.width = static_cast<unsigned>(bitmap.bmWidth);
+        thumbnail.height = static_cast<unsigned>(bitmap.bmHeight);
+        thumbnail.pixels.resize(static_cast<size_t>(thumbnail.width) * thumbnail.height * 4);
+
+        HDC hDC = ::GetDC(nullptr);
+
+        ok = ::GetDIBits(hDC, hBitmap, 0, bitmap.bmHeight, thumbnail.pixels.data(), &bmi, DIB_RGB_COLORS)
+                == bitmap.bmHeight;
+        ::ReleaseDC(nullptr, hDC);
+    }
+
+    ::DeleteObject(hBitmap);
+
+    if ( !ok )
+        return false;
+
+    // the alpha of the images without transparency is zero
+    bool hasAlpha = false;
+
+    if ( bitmap.bmBitsPixel == 32 )
+    {
+        for ( size_t i = 3; i < thumbnail.pixels.size() && !hasAlpha; i += 4 )
+            hasAlpha = thumbnail.pixels[i] != 0;
+    }
+
+    // premultiplied BGRA to RGBA
+    for ( size_t i = 0; i < thumbnail.pixels.size(); i += 4 )
+    {
+        wxUint8* pixel = &thumbnail.pixels[i];
+        const unsigned alpha = hasAlpha ? pixel[3] : 255;
+
+        std::swap(pixel[0], pixel[2]);
+        if ( alpha && alpha != 255 )
+        {
+            for ( size_t j = 0; j < 3; ++j )
+                pixel[j] = static_cast<wxUint8>(std::min(255u, (pixel[j] * 255u + alpha / 2) / alpha));
+        }
+        pixel[3] = static_cast<wxUint8>(alpha);
+    }
+
+    return true;
+}
+
+// the storage property keys, defined here so that propsys.lib is not needed
+const GUID FMTID_StorageProperties = { 0xB725F130, 0x47EF, 0x101A, { 0xA5, 0xF1, 0x02, 0x60, 0x8C, 0x9E, 0xEB, 0xAC } };
+const PROPERTYKEY PropertyKey_ItemTypeText     = { FMTID_StorageProperties, 4 };
+const PROPERTYKEY PropertyKey_Size             = { FMTID_StorageProperties, 12 };
+const PROPERTYKEY PropertyKey_FileAttributes   = { FMTID_StorageProperties, 13 };
+const PROPERTYKEY PropertyKey_DateModified     = { FMTID_StorageProperties, 14 };
+const PROPERTYKEY PropertyKey_DateCreated      = { FMTID_StorageProperties, 15 };
+
+wxUint64 FileTimeToUint64(const FILETIME& fileTime)
+{
+    return (static_cast<wxUint64>(fileTime.dwHighDateTime) << 32) | fileTime.dwLowDateTime;
+}
+
+// the time needed for an item varies a lot, e.g., for network or cloud files,
+// so the threads fetch the properties of small chunks of items at a time
+const size_t PropertiesChunkSize = 64;
+
+// maps the range of @a count items starting at @a first in the view to the range in
+// a list of some of the items of the view, given their indices in the view
+void MapViewRange(const std::vector<size_t>& viewIndices, size_t& first, size_t& count)
+{
+    const auto begin = std::lower_bound(viewIndices.begin(), viewIndices.end(), first);
+    const auto end = std::lower_bound(begin, viewIndices.end(), first + count);
+
+    first = static_cast<size_t>(begin - viewIndices.begin());
+    count = static_cast<size_t>(end - begin);
+}
+
+// fills the properties of the items in [begin, end), can be called on any thread
+void FetchItemProperties(const std::vector<PIDLIST_ABSOLUTE>& pidls, size_t begin, size_t end,
+                         wxExplorerBrowserItemProperties& properties)
+{
+    if ( !InitializeCOMForThread() )
+        return;
+
+    typedef wxExplorerBrowserItemProperties Properties;
+
+    const wxUint32 requested = properties.GetProperties();
+
+    for ( size_t i = begin; i < end; ++i )
+    {
+        wxCOMPtr<IShellItem2> si;
+
+        // the shell items cannot be shared between the threads, unlike the ID lists
+        if ( !pidls[i] || FAILED(::SHCreateItemFromIDList(pidls[i], wxIID_PPV_ARGS(IShellItem2, &si))) )
+            continue;
+
+        wxUint32 fetched = 0;
+
+        if ( requested & Properties::Property_Size )
+        {
+            ULONGLONG size;
+
+            if ( SUCCEEDED(si->GetUInt64(PropertyKey_Size, &size)) )
+            {
+                properties.GetSizes()[i] = size;
+                fetched |= Properties::Property_Size;
+            }
+        }
+
+        if ( requested & Properties::Property_ModificationTime )
+        {
+            FILETIME time;
+
+            if ( SUCCEEDED(si->GetFileTime(PropertyKey_DateModified, &time)) )
+            {
+                properties.GetModificationTimes()[i] = FileTimeToUint64(time);
+                fetched |= Properties::Property_ModificationTime;
+            }
+        }
+
+        if ( requested & Properties::Property_CreationTime )
+        {
+            FILETIME time;
+
+            if ( SUCCEEDED(si->GetFileTime(PropertyKey_DateCreated, &time)) )
+            {
+                properties.GetCreationTimes()[i] = FileTimeToUint64(time);
+                fetched |= Properties::Property_CreationTime;
+            }
+        }
+
+        if ( requested & Properties::Property_Attributes )
+        {
+            ULONG attributes;
+
+            if ( SUCCEEDED(si->GetUInt32(PropertyKey_FileAttributes, &attributes)) )
+            {
+                properties.GetAttributes()[i] = attributes;
+                fetched |= Properties::Property_Attributes;
+            }
+        }
+
+        if ( requested & Properties::Property_TypeName )
+        {
+            LPWSTR typeName = nullptr;
+
+            if ( SUCCEEDED(si->GetString(PropertyKey_ItemTypeText, &typeName)) )
+            {
+                properties.GetTypeNames()[i] = typeName;
+                ::CoTaskMemFree(typeName);
+                fetched |= Properties::Property_TypeName;
+            }
+        }
+
+        properties.SetFetched(i, fetched);
+    }
+}
+
 ULONG wxExplorerBrowserImplHelper::AddRef()
 {
     return ::InterlockedIncrement(&m_refCount);
 }
-
-ULONG wxExplorerBrowserImplHelper::Release()
-{
-    LONG refCount = ::InterlockedDecrement(&m_refCount);
-
-    if ( refCount == 0 )
-        delete this;
-
-    return refCount;
-}
-
-HRESULT wxExplorerBrowserImplHelper::QueryInterface(REFIID riid, void** ppv)
-{
-    if ( riid == IID_IUnknown )
-        *ppv = static_cast<IUnknown*>(static_cast<IServiceProvider*>(this));
-    else
-    if ( riid == IID_IServiceProvider )
-        *ppv = static_cast<IServiceProvider*>(this);
-    else
-    if ( riid == IID_ICommDlgBrowser
-         || riid == IID_ICommDlgBrowser2
-         || riid == IID_ICommDlgBrowser3
-        )
-        *ppv = static_cast<ICommDlgBrowser3*>(this);
-    else
-    if ( riid == IID_IExplorerBrowserEvents )
-        *ppv = static_cast<IExplorerBrowserEvents*>(this);
-    else
-    if ( riid == IID_IFolderFilter )
-        *ppv = static_cast<IFolderFilter*>(this);
-    else
-    if ( riid == IID_IExplorerPaneVisibility )
-        *ppv = static_cast<IExplorerPaneVisibility*>(this);
-    else
-    {
-        *ppv = nullptr;
-        return E_NOINTERFACE;
-    }
-
-    AddRef();
-    return S_OK;
-}
-
-HRESULT wxExplorerBrowserImplHelper::QueryService(REFGUID guidService, REFIID riid, void** ppv)
-{
-    if ( guidService == SID_SExplorerBrowserFrame
-         || guidService == SID_ExplorerPaneVisibility
-        )
-        return QueryInterface(riid, ppv);
-
-    *ppv = nullptr;
-    return E_NOINTERFACE;
-}
-
-HRESULT wxExplorerBrowserImplHelper::OnDefaultCommand(IShellView* WXUNUSED(ppshv))
-{
-    wxExplorerBrowserItem ebi;
-
-    if ( _GetSelectedItem(ebi) )
-    {
-        if ( !_SendNotifyEvent(wxEVT_EXPLORER_BROWSER_DEFAULT_COMMAND, ebi) )
-            return S_OK; // event was vetoed, no default action will happen
-    }
-
-    return S_FALSE;
-}
-
- HRESULT wxExplorerBrowserImplHelper::OnStateChange(IShellView* WXUNUSED(ppshv), ULONG uChange)
-{
-     if ( uChange == CDBOSC_SELCHANGE )
-    {
-        wxExplorerBrowserItem ebi;
-
-        _GetSelectedItem(ebi);
-
-#ifdef WX_EXPLORER_BROWSER_PREVENT_DOUBLED_CHANGESEL_EVENTS
-        ChangeSelEventData csed;
-
-        csed.SetItem(ebi);
-        if ( csed.IsDoubled(m_prevChangeSelEventData) )
-            return S_OK; // do not send the same event
-
-        m_prevChangeSelEventData = csed;
-#endif // #ifdef WX_EXPLORER_BROWSER_PREVENT_DOUBLED_CHANGESEL_EVENTS
-
-        _SendNotifyEvent(wxEVT_EXPLORER_BROWSER_SELECTION_CHANGED, ebi);
-    }
-
-    return S_OK;
-}
-
-
- // ShouldShow() is used to actually filter the items
-HRESULT wxExplorerBrowserImplHelper::IncludeObject(IShellView* WXUNUSED(ppshv), PCUITEMID_CHILD WXUNUSED(pidl))
-{
-      return S_OK;
-}
-
-HRESULT wxExplorerBrowserImplHelper::Notify(IShellView* WXUNUSED(ppshv), DWORD dwNotifyType)
-{
-    if ( dwNotifyType == CDB2N_CONTEXTMENU_START )
-    {
-        wxExplorerBrowserItem ebi;
-
-        if ( _GetSelectedItem(ebi) )
-        {
-            if ( !_SendNotifyEvent(wxEVT_EXPLORER_BROWSER_CONTEXTMENU_START, ebi) )
-                return S_OK; // event was vetoed, context menu will not be shown
-        }
-    }
-
-    return S_FALSE;
-}
-
-HRESULT wxExplorerBrowserImplHelper::GetDefaultMenuText(IShellView* WXUNUSED(ppshv),
-                                                        LPWSTR WXUNUSED(pszText),
-                                                        int WXUNUSED(cchMax))
-{
-    return S_FALSE;
-}
-
-HRESULT wxExplorerBrowserImplHelper::GetViewFlags(DWORD* pdwFlags)
-{
-    *pdwFlags = CDB2GVF_NOSELECTVERB;
-
-    // if this flag is not set, neither IncludeObject nor ShouldShow are called
-    if ( m_filterMasks.empty() )
-        *pdwFlags |= CDB2GVF_NOINCLUDEITEM;
-
-    return S_OK;
-}
-
-/* Never gets called?! */
-HRESULT wxExplorerBrowserImplHelper::GetCurrentFilter(LPWSTR WXUNUSED(pszFileSpec), int WXUNUSED(cchFileSpec))
-{
-    return E_NOTIMPL;
-}
-
-/* Never gets called?! */
-HRESULT wxExplorerBrowserImplHelper::OnColumnClicked(IShellView* WXUNUSED(ppshv), int WXUNUSED(iColumn))
-{
-    return S_OK;
-}
-
-HRESULT wxExplorerBrowserImplHelper::OnPreViewCreated(IShellView* WXUNUSED(ppshv))
-{
-    return S_OK;
-}
-
-HRESULT wxExplorerBrowserImplHelper::OnNavigationPending(PCIDLIST_ABSOLUTE pidlFolder)
-{
-    if ( _SendNotifyEvent(wxEVT_EXPLORER_BROWSER_NAVIGATING, pidlFolder) )
-        return S_OK;
-    else
-        return E_FAIL;
-}
-
-HRESULT wxExplorerBrowserImplHelper::OnViewCreated(IShellView* psv)
-{
-    HRESULT hr;
-    wxCOMPtr<IFolderView> fv;
-
-    hr = psv->QueryInterface(wxIID_PPV_ARGS(IFolderView, &fv));
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IShellView::QueryInterface(IFolderView)"), hr);
-        return E_FAIL;
-    }
-
-    wxCOMPtr<IPersistFolder2> pf2;
-
-    hr = fv->GetFolder(wxIID_PPV_ARGS(IPersistFolder2, &pf2));
-    if  ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IFolderView::GetFolder()"), hr);
-        return E_FAIL;
-    }
-
-    PIDLIST_ABSOLUTE pidl = nullptr;
-
-    hr = pf2->GetCurFolder(&pidl);
-    if  ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IPersistFolder2::GetCurFolder()"), hr);
-        return E_FAIL;
-    }
-
-    _SendNotifyEvent(wxEVT_EXPLORER_BROWSER_VIEW_CREATED, pidl);
-    ::CoTaskMemFree(pidl);
-
-    return S_OK;
-}
-
-HRESULT wxExplorerBrowserImplHelper::OnNavigationComplete(PCIDLIST_ABSOLUTE pidlFolder)
-{
-    _SendNotifyEvent(wxEVT_EXPLORER_BROWSER_NAVIGATION_COMPLETE, pidlFolder);
-    return S_OK;
-}
-
-HRESULT wxExplorerBrowserImplHelper::OnNavigationFailed(PCIDLIST_ABSOLUTE pidlFolder)
-{
-    _SendNotifyEvent(wxEVT_EXPLORER_BROWSER_NAVIGATION_FAILED, pidlFolder);
-    return S_OK;
-}
-
-HRESULT wxExplorerBrowserImplHelper::GetEnumFlags(IShellFolder* WXUNUSED(psf),
-                                                  PCIDLIST_ABSOLUTE WXUNUSED(pidlFolder),
-                                                  HWND* WXUNUSED(phwnd),
-                                                  DWORD* WXUNUSED(pgrfFlags))
-{
-    return S_OK;
-}
-
-
-HRESULT wxExplorerBrowserImplHelper::ShouldShow(IShellFolder* psf,
-                                                PCIDLIST_ABSOLUTE WXUNUSED(pidlFolder),
-                                                PCUITEMID_CHILD pidlItem)
-{
-    if ( m_filterMasks.empty() )
-        return S_OK;
-
-    HRESULT hr;
-    wxCOMPtr<IShellItem> si;
-
-    hr = ::SHCreateItemWithParent(nullptr, psf, pidlItem, wxIID_PPV_ARGS(IShellItem, &si));
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("::SHCreateItemWithParent()"), hr);
-        return E_FAIL;
-    }
-
-    wxExplorerBrowserItem ebi;
-
-    if ( !_IShellItem2wxExplorerBrowserItem(si, ebi)
-          || ebi.GetType() == wxExplorerBrowserItem::Unknown )
-        return E_FAIL;
-
-    if (  !(ebi.GetType() & m_filterTypes) )
-        return S_OK; // do not filter this item type
-
-    wxString name;
-
-    if ( ebi.GetType() == wxExplorerBrowserItem::Other )
-    {
-        name = ebi.GetDisplayName();
-    }
-    else
-    {
-        // Since the path for directories does not end with a slash,
-        // wxFileName::GetFullName here will also return the parent-relative
-        // directory name because it thinks it is a file
-        name = wxFileName(ebi.GetPath()).GetFullName();
-    }
-
-    // wxMatchWild() is surprisingly case sensitive even on MSW
-    name.MakeUpper();
-
-    for ( const auto& mask : m_filterMasks )
-    {
-        if ( wxMatchWild(mask, name, false) )
-            return S_OK;
-    }
-
-    return S_FALSE;
-}
-
-STDMETHODIMP wxExplorerBrowserImplHelper::GetPaneState(REFEXPLORERPANE ep, EXPLORERPANESTATE *peps)
-{
-    if ( ep == EP_NavPane )
-        *peps = m_paneSettings.GetFlags(wxExplorerBrowser::EP_NavPane);
-    else
-    if ( ep == EP_Commands )
-        *peps = m_paneSettings.GetFlags(wxExplorerBrowser::EP_Commands);
-    else
-    if ( ep == EP_Commands_Organize )
-        *peps = m_paneSettings.GetFlags(wxExplorerBrowser::EP_Commands_Organize);
-    else
-    if ( ep == EP_Commands_View )
-        *peps = m_paneSettings.GetFlags(wxExplorerBrowser::EP_Commands_View);
-    else
-    if ( ep == EP_DetailsPane )
-        *peps = m_paneSettings.GetFlags(wxExplorerBrowser::EP_DetailsPane);
-    else
-    if ( ep == EP_PreviewPane )
-        *peps = m_paneSettings.GetFlags(wxExplorerBrowser::EP_PreviewPane);
-    else
-    if ( ep == EP_QueryPane )
-        *peps = m_paneSettings.GetFlags(wxExplorerBrowser::EP_QueryPane);
-    else
-    if ( ep == EP_AdvQueryPane )
-        *peps = m_paneSettings.GetFlags(wxExplorerBrowser::EP_AdvQueryPane);
-    else
-    if ( ep == EP_StatusBar )
-        *peps = m_paneSettings.GetFlags(wxExplorerBrowser::EP_StatusBar);
-    else
-    if ( ep == EP_Ribbon )
-        *peps = m_paneSettings.GetFlags(wxExplorerBrowser::EP_Ribbon);
-    else
-        return E_INVALIDARG;
-
-    return S_OK;
-}
-
-// Filtering does not work for query-backed views such as libraries or search results.
-// Neither ICommDlgBrowser::IncludeObject() nor IFolderFilter::ShouldShow() are called for those, see e.g.
-// https://social.msdn.microsoft.com/Forums/windowsdesktop/en-US/252a9c82-617c-4126-8347-56dcedb4342f
-// ICommDlgBrowser3::GetFilter() is never called for any folder at all...
-bool wxExplorerBrowserImplHelper::_SetFilter(const wxArrayString& fileMasks, wxUint32 itemTypes)
-{
-    m_filterMasks.reserve(fileMasks.size());
-
-    // we do not want case-sensitive filtering
-    for ( const auto& mask : fileMasks )
-        m_filterMasks.push_back(mask.Upper());
-
-    m_filterTypes = itemTypes;
-
-    return true;
-}
-
-bool wxExplorerBrowserImplHelper::_RemoveFilter()
-{
-    m_filterMasks.clear();
-    return true;
-}
-
-bool wxExplorerBrowserImplHelper::_SetPaneSettings(const wxExplorerBrowser::PaneSettings& settings)
-{
-    m_paneSettings = settings;
-    return true;
-}
-
-wxExplorerBrowserItem::Type wxExplorerBrowserImplHelper::_SFGAO2wxExplorerBrowserItemType(SFGAOF attr)
-{
-    static const SFGAOF FileSystemFile = SFGAO_FILESYSTEM | SFGAO_STREAM;
-    static const SFGAOF FileSystemDirectory = SFGAO_FILESYSTEM | SFGAO_FOLDER;
-    static const SFGAOF VirtualZipDirectory = SFGAO_FILESYSTEM | SFGAO_FOLDER | SFGAO_STREAM;
-
-    // remove the the attributes we are not interested in
-    attr &= (SFGAO_FILESYSTEM | SFGAO_FOLDER | SFGAO_STREAM);
-
-    switch ( attr )
-    {
-        case 0:
-            return wxExplorerBrowserItem::Unknown;
-        case FileSystemFile:
-        case VirtualZipDirectory:
-            return wxExplorerBrowserItem::File;
-        case FileSystemDirectory:
-            return wxExplorerBrowserItem::Directory;
-        default:
-            return wxExplorerBrowserItem::Other;
-    }
-}
-
-bool wxExplorerBrowserImplHelper::_IShellItem2wxExplorerBrowserItem(IShellItem* item, wxExplorerBrowserItem& ebi)
-{
-    wxCHECK(item, false);
-
-    static const SFGAOF mask = SFGAO_FILESYSTEM | SFGAO_FOLDER | SFGAO_STREAM | SFGAO_LINK;
-
-    HRESULT hr;
-    SFGAOF attr;
-
-    hr = item->GetAttributes(mask, &attr);
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("(IShellItem::GetAttributesOf()"), hr);
-        return false;
-    }
-
-    PWSTR name = nullptr;
-    wxString path, displayName;
-
-    // will fail for non-filesystem items
-    if ( SUCCEEDED(item->GetDisplayName(SIGDN_FILESYSPATH, &name)) )
-    {
-        path = name;
-        ::CoTaskMemFree(name);
-    }
-
-    hr = item->GetDisplayName(SIGDN_NORMALDISPLAY, &name);
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IShellItem::GetDisplayName(SIGDN_NORMALDISPLAY)"), hr);
-        return false;
-    }
-    else
-    {
-        displayName = name;
-        ::CoTaskMemFree(name);
-    }
-
-    ebi.SetType(_SFGAO2wxExplorerBrowserItemType(attr));
-    ebi.SetPath(path);
-    ebi.SetDisplayName(displayName);
-    ebi.SetSFGAO(attr);
-
-    return true;
-}
-
-bool wxExplorerBrowserImplHelper::_PPIDL2wxExplorerBrowserItem(PCIDLIST_ABSOLUTE pidl, wxExplorerBrowserItem& ebi)
-{
-    wxCHECK(pidl, false);
-
-    HRESULT hr;
-    wxCOMPtr<IShellItem> si;
-
-    hr = ::SHCreateItemFromIDList(pidl, wxIID_PPV_ARGS(IShellItem, &si));
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("SHCreateItemFromIDList"), hr);
-        return false;
-    }
-
-    return _IShellItem2wxExplorerBrowserItem(si, ebi);
-}
-
-
-bool wxExplorerBrowserImplHelper::_SendNotifyEvent(wxEventType command, PCIDLIST_ABSOLUTE list) const
-{
-    wxExplorerBrowserItem ebi;
-
-    if ( _PPIDL2wxExplorerBrowserItem(list, ebi) )
-        return _SendNotifyEvent(command, ebi);
-
-    return false;
-}
-
-bool wxExplorerBrowserImplHelper::_SendNotifyEvent(wxEventType command,
-                                                   const wxExplorerBrowserItem& ebi) const
-{
-    wxExplorerBrowserEvent evt(command, m_host->GetId());
-
-    evt.SetEventObject(m_host);
-    evt.SetItem(ebi);
-
-    if ( m_host->ProcessWindowEvent(evt) )
-        return evt.IsAllowed();
-
-    return true;
-}
-
-bool wxExplorerBrowserImplHelper::_GetSelectedItem(wxExplorerBrowserItem& ebi)
-{
-    HRESULT hr;
-    wxCOMPtr<IFolderView2> fv2;
-
-    hr = m_explorerBrowser->GetCurrentView(wxIID_PPV_ARGS(IFolderView2, &fv2));
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IExplorerBrowser::GetCurrentView()"), hr);
-        return false;
-    }
-
-    int selected;
-
-    if ( fv2->GetSelectedItem(-1, &selected) != S_OK )
-    {
-        // no selected items
-        return false;
-    }
-
-    wxCOMPtr<IShellItem> si;
-
-    hr = fv2->GetItem(selected, wxIID_PPV_ARGS(IShellItem, &si));
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IFolderView2::GetItem()"), hr);
-        return false;
-    }
-
-    return _IShellItem2wxExplorerBrowserItem(si, ebi);
-}
-
-} // unnamed namespace
-
-/***************************************************************************
-
-    class wxExplorerBrowserImpl
-    ---------------------------------
-    actual implemention of wxExplorerBrowser methods
-
-*****************************************************************************/
-
-class wxExplorerBrowser::wxExplorerBrowserImpl
-{
-public:
-    wxExplorerBrowserImpl(wxWindow* host) : m_host{host} {}
-    ~wxExplorerBrowserImpl();
-
-    bool Create(const CreateStruct& createStruct, const wxString& path);
-
-    bool SetFolderSettings(const FolderSettings& folderSettings);
-    bool GetOptions(wxUint32& options);
-    bool SetOptions(wxUint32 options);
-    bool SetEmptyText(const wxString& text);
-    bool SetPropertyBag(const wxString& bag);
-    bool BrowseTo(const wxString& item, bool keepWordWheelText);
-    bool BrowseTo(BrowseTarget target, bool keepWordWheelText);
-
-    bool Refresh();
-
-    bool SearchFolder(const wxString& str);
-    bool RemoveAll();
-
-    bool SelectItems(const wxExplorerBrowserItem::List& items, bool notTakeFocus);
-    bool DeselectAllItems(bool notTakeFocus);
-    bool GetSelectedItems(wxExplorerBrowserItem::List& items, wxUint32 itemTypes);
-
-    bool GetAllItems(wxExplorerBrowserItem::List& items, wxUint32 itemTypes);
-
-    bool GetFolder(wxExplorerBrowserItem& item);
-
-    bool SetFilter(const wxArrayString& fileMasks, wxUint32 itemTypes);
-    bool RemoveFilter();
-
-    bool SetPaneSettings(const PaneSettings& settings);
-
-    void SetSize(const wxSize& size);
-    bool TranslateMessage(WXMSG* msg);
-
-    IExplorerBrowser* GetIExplorerBrowser() { return m_explorerBrowser.get(); }
-private:
-    wxWindow* m_host {nullptr};;
-    wxCOMPtr<IExplorerBrowser> m_explorerBrowser;
-    wxCOMPtr<wxExplorerBrowserImplHelper> m_explorerBrowserHelper;
-    DWORD m_adviseCookie {0};
-
-    bool GetCurrentView(wxCOMPtr<IShellView>& sv);
-    bool GetCurrentView(wxCOMPtr<IFolderView2>& sv);
-
-    static bool ShellItemArrayToExplorerBrowserItemList(wxCOMPtr<IShellItemArray> shellItems,
-                                                        wxExplorerBrowserItem::List& items, wxUint32 itemTypes);
-};
-
-wxExplorerBrowser::wxExplorerBrowserImpl::~wxExplorerBrowserImpl()
-{
-    if ( m_explorerBrowser )
-    {
-        HRESULT hr;
-
-        if ( m_explorerBrowserHelper )
-        {
-            hr = Call_IUnknown_SetSite(m_explorerBrowser, nullptr);
-            if ( FAILED(hr) )
-                wxLogApiError(wxS("Call_IUnknown_SetSite()"), hr);
-
-            hr = m_explorerBrowser->Unadvise(m_adviseCookie);
-            if ( FAILED(hr) )
-                wxLogApiError(wxS("IExplorerBrowser::Unadvise()"), hr);
-
-            wxCOMPtr<IFolderFilterSite> ffs;
-
-            hr = m_explorerBrowser->QueryInterface(wxIID_PPV_ARGS(IFolderFilterSite, &ffs));
-            if ( SUCCEEDED(hr) )
-            {
-                hr = ffs->SetFilter(nullptr);
-                if ( FAILED(hr) )
-                    wxLogApiError(wxS("IFolderFilterSite::SetFilter(nullptr)"), hr);
-            }
-            else
-                wxLogApiError(wxS("IExplorerBrowser::QueryInterface(IFolderFilterSite)"), hr);
-        }
-
-        hr = m_explorerBrowser->Destroy();
-        if ( FAILED(hr) )
-            wxLogApiError(wxS("IExplorerBrowser::Destroy()"), hr);
-    }
-}
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::Create(const CreateStruct& createStruct,
-                                                      const wxString& path)
-{
-    wxCHECK(m_host, false); // the host window must be already created
-    wxCHECK(!m_explorerBrowser, false); // prevent attempted multiple calls to Create()
-
-    HRESULT hr;
-
-    hr = ::CoCreateInstance(CLSID_ExplorerBrowser, nullptr, CLSCTX_INPROC,
-                wxIID_PPV_ARGS(IExplorerBrowser, &m_explorerBrowser));
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("CoCreateInstance(CLSID_ExplorerBrowser)"), hr);
-        return false;
-    }
-
-    m_explorerBrowserHelper = new wxExplorerBrowserImplHelper(m_host, m_explorerBrowser.get());
-
-    // new wxExplorerBrowserImplHelper() creates the object with refcount = 1.
-    // wxCOMPtr lacks an attach-like method, assigning its value with operator=
-    // increases the refcount of the contained object to 2, which is wrong here,
-    // so we have to work around it and decrease the count back by calling Release()
-    // otherwise the owned object would never get destroyed.
-    m_explorerBrowserHelper->Release();
-
-    m_explorerBrowserHelper->_SetPaneSettings(createStruct.paneSettings);
-
-    hr = m_explorerBrowser->SetOptions(static_cast<::EXPLORER_BROWSER_OPTIONS>(createStruct.options));
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IExplorerBrowser::SetOptions()"), hr);
-        return false;
-    }
-
-    hr = Call_IUnknown_SetSite(m_explorerBrowser,
-        static_cast<IUnknown*>(static_cast<IServiceProvider*>(m_explorerBrowserHelper)));
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("Call_IUnknown_SetSite()"), hr);
-        return false;
-    }
-
-    wxCOMPtr<IFolderFilterSite> ffs;
-
-    hr = m_explorerBrowser->QueryInterface(wxIID_PPV_ARGS(IFolderFilterSite, &ffs));
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IExplorerBrowser::QueryInterface(IFolderFilterSite)"), hr);
-        return false;
-    }
-
-    hr = ffs->SetFilter(static_cast<IUnknown*>(static_cast<IServiceProvider*>(m_explorerBrowserHelper)));
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IFolderFilterSite::SetFilter()"), hr);
-        return false;
-    }
-
-    RECT r = {0};
-    FOLDERSETTINGS fs = {0};
-
-    fs.ViewMode = createStruct.folderSettings.m_viewMode;
-    fs.fFlags = createStruct.folderSettings.m_flags;
-
-    hr = m_explorerBrowser->Initialize(m_host->GetHWND(), &r, &fs);
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IExplorerBrowser::Initialize()"), hr);
-        return false;
-    }
-
-    hr = m_explorerBrowser->Advise(m_explorerBrowserHelper, &m_adviseCookie);
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IExplorerBrowser::Advise()"), hr);
-        return false;
-    }
-
-    return BrowseTo(path, false);
-}
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::SetFolderSettings(const FolderSettings& folderSettings)
-{
-    wxCHECK(m_explorerBrowser, false);
-
-    HRESULT hr;
-    FOLDERSETTINGS fs = {0};
-
-    fs.ViewMode = folderSettings.m_viewMode;
-    fs.fFlags = folderSettings.m_flags;
-
-    hr = m_explorerBrowser->SetFolderSettings(&fs);
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IExplorerBrowser::SetFolderSettings()"), hr);
-        return false;
-    }
-
-    return true;
-}
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::SetPropertyBag(const wxString& bag)
-{
-    wxCHECK(m_explorerBrowser, false);
-
-    HRESULT hr;
-
-    hr = m_explorerBrowser->SetPropertyBag(bag.wc_str());
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IExplorerBrowser::SetPropertyBag()"), hr);
-        return false;
-    }
-
-    return true;
-}
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::GetOptions(wxUint32& options)
-{
-    wxCHECK(m_explorerBrowser, false);
-
-    HRESULT hr;
-    ::EXPLORER_BROWSER_OPTIONS ebo = static_cast<::EXPLORER_BROWSER_OPTIONS>(options);
-
-    hr = m_explorerBrowser->GetOptions(&ebo);
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IExplorerBrowser::GetOptions()"), hr);
-        return false;
-    }
-
-    options = ebo;
-    return true;
-}
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::SetOptions(wxUint32 options)
-{
-    wxCHECK(m_explorerBrowser, false);
-
-    HRESULT hr;
-
-    hr = m_explorerBrowser->SetOptions(static_cast<::EXPLORER_BROWSER_OPTIONS>(options));
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IExplorerBrowser::SetOptions()"), hr);
-        return false;
-    }
-
-    return true;
-}
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::SetEmptyText(const wxString& text)
-{
-    wxCHECK(m_explorerBrowser, false);
-
-    HRESULT hr;
-
-    hr = m_explorerBrowser->SetEmptyText(text.wc_str());
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IExplorerBrowser::()"), hr);
-        return false;
-    }
-
-    return true;
-}
-
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::BrowseTo(const wxString& item, bool keepWordWheelText)
-{
-    wxCHECK(m_explorerBrowser, false);
-
-    HRESULT hr;
-    PIDLIST_ABSOLUTE pidl = nullptr;
-
-    hr = ::SHParseDisplayName(PCWSTR(item.wc_str()), nullptr, &pidl, 0, nullptr);
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("SHParseDisplayName()"), hr);
-        return false;
-    }
-
-    UINT flags = 0;
-
-    if ( keepWordWheelText )
-        flags |= SBSP_KEEPWORDWHEELTEXT;
-
-
-    hr = m_explorerBrowser->BrowseToIDList(pidl, flags);
-    ::CoTaskMemFree(pidl);
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IExplorerBrowser::BrowseToIDList()"), hr);
-        return false;
-    }
-
-    return true;
-}
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::BrowseTo(BrowseTarget target, bool keepWordWheelText)
-{
-    wxCHECK(m_explorerBrowser, false);
-
-    UINT flags;
-
-    switch ( target )
-    {
-        case Parent:
-            flags = SBSP_PARENT;
-            break;
-        case HistoryBack:
-            flags = SBSP_NAVIGATEBACK;
-            break;
-        case HistoryForward:
-            flags = SBSP_NAVIGATEFORWARD;
-            break;
-        default:
-            wxFAIL_MSG(wxS("Invalid item value"));
-            return false;
-    }
-
-    if ( keepWordWheelText )
-        flags |= SBSP_KEEPWORDWHEELTEXT;
-
-    HRESULT hr;
-
-    hr = m_explorerBrowser->BrowseToIDList(nullptr, flags);
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IExplorerBrowser::BrowseToIDList()"), hr);
-        return false;
-    }
-
-    return true;
-}
-
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::Refresh()
-{
-    wxCHECK(m_explorerBrowser, false);
-
-    HRESULT hr;
-    wxCOMPtr<IShellView> sv;
-
-    if ( !GetCurrentView(sv) )
-        return false;
-
-    hr = sv->Refresh();
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IShellView::Refresh()"), hr);
-        return false;
-    }
-    return true;
-}
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::SearchFolder(const wxString& str)
-{
-    wxCHECK(m_explorerBrowser, false);
-
-    HRESULT hr;
-    wxCOMPtr<IShellView> sv;
-
-    if ( !GetCurrentView(sv) )
-        return false;
-
-    wxCOMPtr<IDispatch> d;
-    wxCOMPtr<IShellFolderViewDual3> sfvd3;
-
-    hr = sv->GetItemObject(SVGIO_BACKGROUND, wxIID_PPV_ARGS(IDispatch, &d));
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IShellView::GetItemObject(SVGIO_BACKGROUND)"), hr);
-        return false;
-    }
-
-    hr = d->QueryInterface(wxIID_PPV_ARGS(IShellFolderViewDual3, &sfvd3));
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IDispatch::QueryInterface(IShellFolderViewDual3)"), hr);
-        return false;
-    }
-
-    hr = sfvd3->FilterView(BSTR(str.wc_str()));
-    if  ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IShellFolderViewDual3::FilterView()"), hr);
-        return false;
-    }
-
-    return true;
-}
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::RemoveAll()
-{
-    wxCHECK(m_explorerBrowser, false);
-
-    HRESULT hr;
-
-    hr = m_explorerBrowser->RemoveAll();
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IExplorerBrowser::RemoveAll()"), hr);
-        return false;
-    }
-
-    return true;
-}
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::SelectItems(const wxExplorerBrowserItem::List& items, bool notTakeFocus)
-{
-    wxCHECK(m_explorerBrowser, false);
-
-    HRESULT hr;
-    wxCOMPtr<IShellView> sv;
-    wxCOMPtr<IFolderView2> fv2;
-
-    if ( !GetCurrentView(sv) )
-        return false;
-
-    if ( !GetCurrentView(fv2) )
-        return false;
-
-    wxCOMPtr<IShellFolder> sf;
-
-    hr = fv2->GetFolder(wxIID_PPV_ARGS(IShellFolder, &sf));
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IFolderView2::GetFolder()"), hr);
-        return false;
-    }
-
-
-    PIDLIST_RELATIVE pidl = nullptr;
-    wxString name;
-
-    for ( const auto& item : items )
-    {
-        name = item.GetPath();
-        if ( name.empty() )
-            name = item.GetDisplayName();
-
-        hr = sf->ParseDisplayName(nullptr, nullptr, LPWSTR(name.wc_str()), nullptr, &pidl, nullptr);
-        if ( FAILED(hr) )
-        {
-            wxLogApiError(wxS("IShellFolder::ParseDisplayName()"), hr);
-            return false;
-        }
-
-        UINT flags = SVSI_SELECT;
-
-        if ( notTakeFocus )
-            flags |= SVSI_NOTAKEFOCUS;
-
-        hr = sv->SelectItem(pidl, flags);
-        ::CoTaskMemFree(pidl);
-        if ( FAILED(hr) )
-        {
-            wxLogApiError(wxS("IShellView::SelectItem()"), hr);
-            return false;
-        }
-    }
-
-    return true;
-}
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::DeselectAllItems(bool notTakeFocus)
-{
-    wxCHECK(m_explorerBrowser, false);
-
-    wxCOMPtr<IShellView> sv;
-
-    if ( !GetCurrentView(sv) )
-        return false;
-
-    HRESULT hr;
-    UINT flags = SVSI_DESELECTOTHERS;
-
-    if ( notTakeFocus )
-        flags |= SVSI_NOTAKEFOCUS;
-
-    hr = sv->SelectItem(nullptr, flags);
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IShellView::SelectItem()"), hr);
-        return false;
-    }
-
-    return true;
-}
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::GetSelectedItems(wxExplorerBrowserItem::List& items,
-                                                                wxUint32 itemTypes)
-{
-    wxCHECK(m_explorerBrowser, false);
-
-    HRESULT hr;
-    wxCOMPtr<IFolderView2> fv2;
-
-    if ( !GetCurrentView(fv2) )
-        return false;
-
-    wxCOMPtr<IShellItemArray> sia;
-
-    hr = fv2->GetSelection(FALSE, &sia);
-    if ( FAILED(hr) ) // no items selected
-    {
-        return true;
-    }
-
-    return ShellItemArrayToExplorerBrowserItemList(sia, items, itemTypes);
-}
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::GetAllItems(wxExplorerBrowserItem::List& items,
-                                                           wxUint32 itemTypes)
-{
-    wxCHECK(m_explorerBrowser, false);
-
-    HRESULT hr;
-    wxCOMPtr<IFolderView2> fv2;
-
-    if ( !GetCurrentView(fv2) )
-        return false;
-
-    wxCOMPtr<IShellItemArray> sia;
-
-    hr = fv2->Items(SVGIO_ALLVIEW | SVGIO_FLAG_VIEWORDER, wxIID_PPV_ARGS(IShellItemArray, &sia));
-    if ( FAILED(hr) ) // no items
-    {
-        wxLogApiError(wxS("IFolderView2::Items()"), hr);
-        return false;
-    }
-
-    return ShellItemArrayToExplorerBrowserItemList(sia, items, itemTypes);
-}
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::GetFolder(wxExplorerBrowserItem& item)
-{
-    wxCHECK(m_explorerBrowser, false);
-
-    HRESULT hr;
-    wxCOMPtr<IFolderView2> fv2;
-
-    if ( !GetCurrentView(fv2) )
-        return false;
-
-    wxCOMPtr<IPersistFolder2> pf2;
-
-    hr = fv2->GetFolder(wxIID_PPV_ARGS(IPersistFolder2, &pf2));
-    if  ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IFolderView2::GetFolder()"), hr);
-        return false;
-    }
-
-    PIDLIST_ABSOLUTE pidl = nullptr;
-
-    hr = pf2->GetCurFolder(&pidl);
-    if  ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IPersistFolder2::GetCurFolder()"), hr);
-        return false;
-    }
-
-    const bool result = wxExplorerBrowserImplHelper::_PPIDL2wxExplorerBrowserItem(pidl, item);
-    ::CoTaskMemFree(pidl);
-
-    return result;
-}
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::SetFilter(const wxArrayString& fileMasks, wxUint32 itemTypes)
-{
-    wxCHECK(m_explorerBrowserHelper, false);
-
-    return m_explorerBrowserHelper->_SetFilter(fileMasks, itemTypes);
-}
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::RemoveFilter()
-{
-    wxCHECK(m_explorerBrowserHelper, false);
-
-    return m_explorerBrowserHelper->_RemoveFilter();
-}
-
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::SetPaneSettings(const PaneSettings& settings)
-{
-    wxCHECK(m_explorerBrowserHelper, false);
-
-    return m_explorerBrowserHelper->_SetPaneSettings(settings);
-}
-
-void wxExplorerBrowser::wxExplorerBrowserImpl::SetSize(const wxSize& size)
-{
-    if ( !m_explorerBrowser )
-        return;
-
-    RECT rect = {0};
-
-    rect.right = size.GetWidth();
-    rect.bottom = size.GetHeight();
-    m_explorerBrowser->SetRect(nullptr, rect);
-}
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::TranslateMessage(WXMSG* msg)
+
+wxExplorerBrowserImplHelper::~wxExplorerBrowserImplHelper()
 {
-    if ( m_explorerBrowser && WM_KEYFIRST <= msg->message && msg->message <= WM_KEYLAST )
-    {
-        wxCOMPtr<IInputObject> io;
-
-        if ( SUCCEEDED(m_explorerBrowser->QueryInterface(wxIID_PPV_ARGS(IInputObject, &io))) )
-        {
-            if ( io->HasFocusIO() == S_OK )
-            {
-                if ( io->TranslateAcceleratorIO(msg) == S_OK )
-                    return true;
-            }
-        }
-    }
+    for ( auto& ignoreRulesFolder : m_ignoreRulesFolders )
+        ::CoTaskMemFree(ignoreRulesFolder.pidl);
+}
 
-    return false;
-}
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::GetCurrentView(wxCOMPtr<IShellView>& sv)
-{
-    HRESULT hr = m_explorerBrowser->GetCurrentView(wxIID_PPV_ARGS(IShellView, &sv));
-
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IExplorerBrowser::GetCurrentView(IShellView)"), hr);
-        return false;
-    }
-
-    return true;
-}
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::GetCurrentView(wxCOMPtr<IFolderView2>& sv)
-{
-    HRESULT hr = m_explorerBrowser->GetCurrentView(wxIID_PPV_ARGS(IFolderView2, &sv));
-
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IExplorerBrowser::GetCurrentView(IFolderView2)"), hr);
-        return false;
-    }
-
-    return true;
-}
-
-bool wxExplorerBrowser::wxExplorerBrowserImpl::ShellItemArrayToExplorerBrowserItemList(wxCOMPtr<IShellItemArray> shellItems,
-                                                wxExplorerBrowserItem::List& items, wxUint32 itemTypes)
-{
-    HRESULT hr;
-    DWORD count = 0;
-
-    hr = shellItems->GetCount(&count);
-    if ( FAILED(hr) )
-    {
-        wxLogApiError(wxS("IShellItemArray::GetCount()"), hr);
-        return false;
-    }
-
-    wxExplorerBrowserItem::List tmpItems;
-
-    tmpItems.reserve(static_cast<size_t>(count));
-
-    for ( DWORD i = 0; i < count; ++i )
-    {
-        wxCOMPtr<IShellItem> si;
-        wxExplorerBrowserItem ebi;
-
-        hr = shellItems->GetItemAt(i, &si);
-        if ( FAILED(hr) )
-        {
-            wxLogApiError(wxS("IShellItemArray::GetItemAt()"), hr);
-            return false;
-        }
-
-        if ( !wxExplorerBrowserImplHelper::_IShellItem2wxExplorerBrowserItem(si, ebi) )
-            return false;
-
-        if ( (itemTypes & ebi.GetType()) )
-            tmpItems.push_back(ebi);
-    }
-
-    items = std::move(tmpItems);
-    return true;
-}
-
-/***************************************************************************
-
-    class wxExplorerBrowser
-    ---------------------------------
-    methods just call the actual implemention in wxExplorerBrowserImpl
-
-*****************************************************************************/
-
-const char wxExplorerBrowserNameStr[] = "wxExplorerBrowser";
-
-wxIMPLEMENT_DYNAMIC_CLASS(wxExplorerBrowser, wxPanel);
-
-wxExplorerBrowser::wxExplorerBrowser(wxWindow* parent,
-                                     const CreateStruct& createStruct,
-                                     const wxString& path,
-                                     wxWindowID id,
-                                     const wxPoint& pos, const wxSize& size,
-                                     const wxString& name)
-{
-    Create(parent, createStruct, path, id, pos, size, name);
-}
-
-wxExplorerBrowser::~wxExplorerBrowser()
-{
-    if ( m_impl )
-        delete m_impl;
-}
-
-
-bool wxExplorerBrowser::Create(wxWindow* parent,
-                               const CreateStruct& createStruct,
-                               const wxString& path,
-                               wxWindowID id,
-                               const wxPoint& pos, const wxSize& size,
-                               const wxString& name)
-{
-    if ( !wxPanel::Create(parent, id, pos, size,
-            wxBORDER_NONE | wxWANTS_CHARS | wxCLIP_CHILDREN | wxCLIP_SIBLINGS,
-            name ) )
-    {
-        return false;
-    }
-
-    // when the ExplorerBrowser was hosted directly, there was an issue
-    // with its wxButton sibling, where upon a wxButton
-    // having focus and user clicking on an ExplorerBrowser item
-    // resulted in the application being stuck in an infinite
-    // loop in the window procedure.
-    // Thus we create a wxWindow which will actually host the browser
-    // as the only child of wxExplorerBrowser
-    m_host = new wxWindow(this, wxID_ANY, wxDefaultPosition, wxDefaultSize,
-        wxBORDER_NONE | wxWANTS_CHARS | wxCLIP_CHILDREN | wxCLIP_SIBLINGS,
-        wxS("wxExplorerBrowserWindow"));
-#if wxCHECK_VERSION(3, 3, 0)
-    m_host->MSWDisableComposited();
-#endif // #if wxCHECK_VERSION(3, 3, 0)
-
-    m_impl = new wxExplorerBrowserImpl(m_host);
-
-    if ( m_impl->Create(createStruct, path) )
-    {
-        Bind(wxEVT_SIZE, &wxExplorerBrowser::OnSize, this);
-
-        // the following four lines are just
-        // to suppress needless window background erasing
-        SetBackgroundStyle(wxBG_STYLE_PAINT);
-        Bind(wxEVT_PAINT, &wxExplorerBrowser::OnPaint, this);
-        m_host->SetBackgroundStyle(wxBG_STYLE_PAINT);
-        m_host->Bind(wxEVT_PAINT, &wxExplorerBrowser::OnPaint, this);
-
-        return true;
-    }
-
-    return false;
-}
-
-bool wxExplorerBrowser::SetFolderSettings(const FolderSettings& folderSettings)
-{
-    wxCHECK(m_impl, false);
-
-    return m_impl->SetFolderSettings(folderSettings);
-}
-
-bool wxExplorerBrowser::GetOptions(wxUint32& options)
-{
-    wxCHECK(m_impl, false);
-
-    return m_impl->GetOptions(options);
-}
-bool wxExplorerBrowser::SetOptions(wxUint32 options)
-{
-    wxCHECK(m_impl, false);
-
-    return m_impl->SetOptions(options);
-}
-
-bool wxExplorerBrowser::SetEmptyText(const wxString& text)
-{
-    wxCHECK(m_impl, false);
-
-    return m_impl->SetEmptyText(text);
-}
-
-bool wxExplorerBrowser::SetPropertyBag(const wxString& bag)
-{
-    wxCHECK(m_impl, false);
-
-    return m_impl->SetPropertyBag(bag);
-}
-
-bool wxExplorerBrowser::BrowseTo(const wxString& item, bool keepWordWheelText)
-{
-    wxCHECK(m_impl, false);
-
-    return m_impl->BrowseTo(item, keepWordWheelText);
-}
-
-bool wxExplorerBrowser::BrowseTo(BrowseTarget target, bool keepWordWheelText)
-{
-    wxCHECK(m_impl, false);
-
-    return m_impl->BrowseTo(target, keepWordWheelText);
-}
-
-bool wxExplorerBrowser::Refresh()
-{
-    wxCHECK(m_impl, false);
-
-    return m_impl->Refresh();
-}
-
-bool wxExplorerBrowser::SearchFolder(const wxString& str)
-{
-    wxCHECK(m_impl, false);
-
-    return m_impl->SearchFolder(str);
-}
-
-bool wxExplorerBrowser::RemoveAll()
-{
-    wxCHECK(m_impl, false);
-
-    return m_impl->RemoveAll();
-}
-
-bool wxExplorerBrowser::SelectItems(const wxExplorerBrowserItem::List& items, bool notTakeFocus)
-{
-    wxCHECK(m_impl, false);
-
-    return m_impl->SelectItems(items, notTakeFocus);
-}
-
-bool wxExplorerBrowser::DeselectAllItems(bool notTakeFocus)
-{
-    wxCHECK(m_impl, false);
-
-    return m_impl->DeselectAllItems(notTakeFocus);
-}
-bool wxExplorerBrowser::GetSelectedItems(wxExplorerBrowserItem::List& items, wxUint32 itemTypes)
-{
-    wxCHECK(m_impl, false);
-    wxCHECK_MSG(itemTypes, false, wxS("At least one item type must be specified"));
-
-    return m_impl->GetSelectedItems(items, itemTypes);
-}
-
-bool wxExplorerBrowser::GetAllItems(wxExplorerBrowserItem::List& items, wxUint32 itemTypes)
-{
-    wxCHECK(m_impl, false);
-    wxCHECK_MSG(itemTypes, false, wxS("At least one item type must be specified"));
-
-    return m_impl->GetAllItems(items, itemTypes);
-}
-
-bool wxExplorerBrowser::GetFolder(wxExplorerBrowserItem& item)
-{
-    wxCHECK(m_impl, false);
-
-    return m_impl->GetFolder(item);
-}
-
-bool wxExplorerBrowser::SetFilter(const wxArrayString& fileMasks, wxUint32 itemTypes)
-{
-    wxCHECK(m_impl, false);
-    wxCHECK_MSG(itemTypes, false, wxS("At least one item type must be specified"));
-
-    if ( m_impl->SetFilter(fileMasks, itemTypes) )
-    {
-        Refresh();
-        return true;
-    }
-
-    return false;
-}
-
-bool wxExplorerBrowser::RemoveFilter()
-{
-    wxCHECK(m_impl, false);
-
-    if ( m_impl->RemoveFilter() )
-    {
-        Refresh();
-        return true;
-    }
-
-    return false;
-}
-
-bool wxExplorerBrowser::SetPaneSettings(const PaneSettings& settings)
-{
-    wxCHECK(m_impl, false);
-
-    return m_impl->SetPaneSettings(settings);
-}
-
-void* wxExplorerBrowser::GetIExplorerBrowser()
-{
-    wxCHECK(m_impl, nullptr);
-
-    return m_impl->GetIExplorerBrowser();
-}
-
-bool wxExplorerBrowser::MSWTranslateMessage(WXMSG* msg)
-{
-    if ( m_impl && m_impl->TranslateMessage(msg) )
-        return true;
-
-    return wxPanel::MSWTranslateMessage(msg);
-}
-
-void wxExplorerBrowser::OnSize(wxSizeEvent& evt)
-{
-    const wxSize size = GetClientSize();
-
-    m_host->SetSize(size);
-    m_impl->SetSize(size);
-    evt.Skip();
-}
-
-void wxExplorerBrowser::OnPaint(wxPaintEvent& evt)
-{
-    wxWindow* w = static_cast<wxWindow*>(evt.GetEventObject());
-
-    if ( w )
-    {
-        wxPaintDC pdc(w);
-        // do nothing here, the window is covered by the ExplorerBrowser,
-        // this paint handler exists solely to prevent useless background
-        // erasing
-    }
-}
-
-/***************************************************************************
-
-    class wxExplorerBrowserEvent
-    ---------------------------------
-    just some definitions through wxWidgets macros,
-    the methods are implemented inline in the header
-
-*****************************************************************************/
-
-wxIMPLEMENT_DYNAMIC_CLASS(wxExplorerBrowserEvent, wxNotifyEvent);
-
-wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_DEFAULT_COMMAND, wxExplorerBrowserEvent);
-wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_SELECTION_CHANGED, wxExplorerBrowserEvent);
-wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_CONTEXTMENU_START, wxExplorerBrowserEvent);
-wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_NAVIGATING, wxExplorerBrowserEvent);
-wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_NAVIGATION_COMPLETE, wxExplorerBrowserEvent);
-wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_NAVIGATION_FAILED, wxExplorerBrowserEvent);
-wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_VIEW_CREATED, wxExplorerBrowserEvent);
+ULONG wxExplorerBrowserImplHelper::Release()
+{
+    LONG refCount = ::InterlockedDecrement(&m_refCount);
+
+    if ( refCount == 0 )
+        delete this;
+
+    return refCount;
+}
+
+HRESULT wxExplorerBrowserImplHelper::QueryInterface(REFIID riid, void** ppv)
+{
+    if ( riid == IID_IUnknown )
+        *ppv = static_cast<IUnknown*>(static_cast<IServiceProvider*>(this));
+    else
+    if ( riid == IID_IServiceProvider )
+        *ppv = static_cast<IServiceProvider*>(this);
+    else
+    if ( riid == IID_ICommDlgBrowser
+         || riid == IID_ICommDlgBrowser2
+         || riid == IID_ICommDlgBrowser3
+        )
+        *ppv = static_cast<ICommDlgBrowser3*>(this);
+    else
+    if ( riid == IID_IExplorerBrowserEvents )
+        *ppv = static_cast<IExplorerBrowserEvents*>(this);
+    else
+    if ( riid == IID_IFolderFilter )
+        *ppv = static_cast<IFolderFilter*>(this);
+    else
+    if ( riid == IID_IExplorerPaneVisibility )
+        *ppv = static_cast<IExplorerPaneVisibility*>(this);
+    else
+    if ( riid == IID_IDispatch || riid == DIID_DShellFolderViewEvents )
+        *ppv = static_cast<IDispatch*>(this);
+    else
+    {
+        *ppv = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    AddRef();
+    return S_OK;
+}
+
+HRESULT wxExplorerBrowserImplHelper::QueryService(REFGUID guidService, REFIID riid, void** ppv)
+{
+    if ( guidService == SID_SExplorerBrowserFrame
+         || guidService == SID_ExplorerPaneVisibility
+        )
+        return QueryInterface(riid, ppv);
+
+    *ppv = nullptr;
+    return E_NOINTERFACE;
+}
+
+HRESULT wxExplorerBrowserImplHelper::OnDefaultCommand(IShellView* WXUNUSED(ppshv))
+{
+    wxExplorerBrowserItem ebi;
+
+    if ( _GetSelectedItem(ebi) )
+    {
+        if ( !_SendNotifyEvent(wxEVT_EXPLORER_BROWSER_DEFAULT_COMMAND, ebi) )
+            return S_OK; // event was vetoed, no default action will happen
+    }
+
+    return S_FALSE;
+}
+
+ HRESULT wxExplorerBrowserImplHelper::OnStateChange(IShellView* WXUNUSED(ppshv), ULONG uChange)
+{
+     if ( uChange == CDBOSC_SELCHANGE )
+    {
+        wxExplorerBrowserItem ebi;
+
+        _GetSelectedItem(ebi);
+
+#ifdef WX_EXPLORER_BROWSER_PREVENT_DOUBLED_CHANGESEL_EVENTS
+        ChangeSelEventData csed;
+
+        csed.SetItem(ebi);
+        if ( csed.IsDoubled(m_prevChangeSelEventData) )
+            return S_OK; // do not send the same event
+
+        m_prevChangeSelEventData = csed;
+#endif // #ifdef WX_EXPLORER_BROWSER_PREVENT_DOUBLED_CHANGESEL_EVENTS
+
+        _SendNotifyEvent(wxEVT_EXPLORER_BROWSER_SELECTION_CHANGED, ebi);
+    }
+
+    return S_OK;
+}
+
+
+ // ShouldShow() is used to actually filter the items
+HRESULT wxExplorerBrowserImplHelper::IncludeObject(IShellView* WXUNUSED(ppshv), PCUITEMID_CHILD WXUNUSED(pidl))
+{
+      return S_OK;
+}
+
+HRESULT wxExplorerBrowserImplHelper::Notify(IShellView* WXUNUSED(ppshv), DWORD dwNotifyType)
+{
+    if ( dwNotifyType == CDB2N_CONTEXTMENU_START )
+    {
+        wxExplorerBrowserItem ebi;
+
+        if ( _GetSelectedItem(ebi) )
+        {
+            if ( !_SendNotifyEvent(wxEVT_EXPLORER_BROWSER_CONTEXTMENU_START, ebi) )
+                return S_OK; // event was vetoed, context menu will not be shown
+        }
+    }
+
+    return S_FALSE;
+}
+
+HRESULT wxExplorerBrowserImplHelper::GetDefaultMenuText(IShellView* WXUNUSED(ppshv),
+                                                        LPWSTR WXUNUSED(pszText),
+                                                        int WXUNUSED(cchMax))
+{
+    return S_FALSE;
+}
+
+HRESULT wxExplorerBrowserImplHelper::GetViewFlags(DWORD* pdwFlags)
+{
+    *pdwFlags = CDB2GVF_NOSELECTVERB;
+
+    // if this flag is not set, neither IncludeObject nor ShouldShow are called
+    if ( m_filter.IsEmpty() && m_ignoreRules.IsEmpty() && !_GetVisibleNames() )
+        *pdwFlags |= CDB2GVF_NOINCLUDEITEM;
+
+    return S_OK;
+}
+
+/* Never gets called?! */
+HRESULT wxExplorerBrowserImplHelper::GetCurrentFilter(LPWSTR WXUNUSED(pszFileSpec), int WXUNUSED(cchFileSpec))
+{
+    return E_NOTIMPL;
+}
+
+/* Never gets called?! */
+HRESULT wxExplorerBrowserImplHelper::OnColumnClicked(IShellView* WXUNUSED(ppshv), int WXUNUSED(iColumn))
+{
+    return S_OK;
+}
+
+HRESULT wxExplorerBrowserImplHelper::OnPreViewCreated(IShellView* WXUNUSED(ppshv))
+{
+    return S_OK;
+}
+
+HRESULT wxExplorerBrowserImplHelper::OnNavigationPending(PCIDLIST_ABSOLUTE pidlFolder)
+{
+    if ( !_SendNotifyEvent(wxEVT_EXPLORER_BROWSER_NAVIGATING, pidlFolder) )
+        return E_FAIL;
+
+    // the view may filter the items of the folder before the navigation completes
+    _LoadIgnoreRules(pidlFolder, IgnoreRules_Pending);
+    return S_OK;
+}
+
+HRESULT wxExplorerBrowserImplHelper::OnViewCreated(IShellView* psv)
+{
+    HRESULT hr;
+    wxCOMPtr<IFolderView> fv;
+
+    hr = psv->QueryInterface(wxIID_PPV_ARGS(IFolderView, &fv));
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IShellView::QueryInterface(IFolderView)"), hr);
+        return E_FAIL;
+    }
+
+    wxCOMPtr<IPersistFolder2> pf2;
+
+    hr = fv->GetFolder(wxIID_PPV_ARGS(IPersistFolder2, &pf2));
+    if  ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IFolderView::GetFolder()"), hr);
+        return E_FAIL;
+    }
+
+    PIDLIST_ABSOLUTE pidl = nullptr;
+
+    hr = pf2->GetCurFolder(&pidl);
+    if  ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IPersistFolder2::GetCurFolder()"), hr);
+        return E_FAIL;
+    }
+
+    _AdviseViewEvents(psv);
+
+    _SendNotifyEvent(wxEVT_EXPLORER_BROWSER_VIEW_CREATED, pidl);
+    ::CoTaskMemFree(pidl);
+
+    return S_OK;
+}
+
+HRESULT wxExplorerBrowserImplHelper::OnNavigationComplete(PCIDLIST_ABSOLUTE pidlFolder)
+{
+    // compiled when pending, so taken from the cache of m_ignoreRules
+    _LoadIgnoreRules(pidlFolder, IgnoreRules_Shown);
+    _LoadIgnoreRules(nullptr, IgnoreRules_Pending);
+
+    _SendNotifyEvent(wxEVT_EXPLORER_BROWSER_NAVIGATION_COMPLETE, pidlFolder);
+    return S_OK;
+}
+
+HRESULT wxExplorerBrowserImplHelper::OnNavigationFailed(PCIDLIST_ABSOLUTE pidlFolder)
+{
+    _LoadIgnoreRules(nullptr, IgnoreRules_Pending);
+
+    _SendNotifyEvent(wxEVT_EXPLORER_BROWSER_NAVIGATION_FAILED, pidlFolder);
+    return S_OK;
+}
+
+HRESULT wxExplorerBrowserImplHelper::GetEnumFlags(IShellFolder* WXUNUSED(psf),
+                                                  PCIDLIST_ABSOLUTE WXUNUSED(pidlFolder),
+                                                  HWND* WXUNUSED(phwnd),
+                                                  DWORD* WXUNUSED(pgrfFlags))
+{
+    return S_OK;
+}
+
+
+HRESULT wxExplorerBrowserImplHelper::ShouldShow(IShellFolder* psf,
+                                                PCIDLIST_ABSOLUTE pidlFolder,
+                                                PCUITEMID_CHILD pidlItem)
+{
+    const wxExplorerBrowserIgnoreRules::DirectoryRulesPtr ignoreRules = _GetIgnoreRules(pidlFolder);
+    // one snapshot for the item, the UI thread can publish new names meanwhile
+    const VisibleNamesPtr visibleNames = _GetVisibleNames();
+
+    if ( m_filter.IsEmpty() && !ignoreRules && !visibleNames )
+        return S_OK;
+
+    HRESULT hr;
+    wxCOMPtr<IShellItem> si;
+
+    hr = ::SHCreateItemWithParent(nullptr, psf, pidlItem, wxIID_PPV_ARGS(IShellItem, &si));
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("::SHCreateItemWithParent()"), hr);
+        return E_FAIL;
+    }
+
+    wxExplorerBrowserItem ebi;
+
+    if ( !_IShellItem2wxExplorerBrowserItem(si, ebi)
+          || ebi.GetType() == wxExplorerBrowserItem::Unknown )
+        return E_FAIL;
+
+    // reused for the items, so that matching them does not allocate
+    static thread_local wxString s_name;
+
+    if ( _IsFilteredOut(ebi, ignoreRules, s_name) )
+        return S_FALSE;
+
+    // the names found by wxExplorerBrowser::SearchIndex() are those of a single folder
+    if ( visibleNames && pidlFolder && _IsSameIDList(pidlFolder, visibleNames->folder) )
+    {
+        wxExplorerBrowserMaskMatcher::GetMatchName(ebi, s_name);
+        if ( visibleNames->names.find(s_name) == visibleNames->names.end() )
+            return S_FALSE;
+    }
+
+    return S_OK;
+}
+
+bool wxExplorerBrowserImplHelper::_IsFilteredOut(const wxExplorerBrowserItem& ebi,
+                                                 const wxExplorerBrowserIgnoreRules::DirectoryRulesPtr& ignoreRules,
+                                                 wxString& buffer) const
+{
+    if ( ignoreRules && !ebi.GetPath().empty()
+         && (ebi.GetType() == wxExplorerBrowserItem::File || ebi.GetType() == wxExplorerBrowserItem::Directory) )
+    {
+        static thread_local wxExplorerBrowserIgnoreRules::DirectoryRules::Buffer s_ignoreBuffer;
+
+        const wxString& path = ebi.GetPath();
+
+        buffer.assign(path, path.find_last_of(wxS("\\/")) + 1, wxString::npos);
+        if ( ignoreRules->IsIgnored(buffer, ebi.GetType() == wxExplorerBrowserItem::Directory, s_ignoreBuffer) )
+            return true;
+    }
+
+    if ( m_filter.IsEmpty() || !m_filter.AppliesTo(ebi.GetType()) )
+        return false; // do not filter this item type
+
+    return !m_filter.MatchesName(ebi, buffer);
+}
+
+STDMETHODIMP wxExplorerBrowserImplHelper::GetTypeInfoCount(UINT* pctinfo)
+{
+    *pctinfo = 0;
+    return S_OK;
+}
+
+STDMETHODIMP wxExplorerBrowserImplHelper::GetTypeInfo(UINT WXUNUSED(iTInfo), LCID WXUNUSED(lcid),
+                                                      ITypeInfo** ppTInfo)
+{
+    *ppTInfo = nullptr;
+    return E_NOTIMPL;
+}
+
+STDMETHODIMP wxExplorerBrowserImplHelper::GetIDsOfNames(REFIID WXUNUSED(riid), LPOLESTR* WXUNUSED(rgszNames),
+                                                        UINT WXUNUSED(cNames), LCID WXUNUSED(lcid),
+                                                        DISPID* WXUNUSED(rgDispId))
+{
+    return E_NOTIMPL;
+}
+
+STDMETHODIMP wxExplorerBrowserImplHelper::Invoke(DISPID dispIdMember, REFIID WXUNUSED(riid), LCID WXUNUSED(lcid),
+                                                 WORD WXUNUSED(wFlags), DISPPARAMS* WXUNUSED(pDispParams),
+                                                 VARIANT* WXUNUSED(pVarResult), EXCEPINFO* WXUNUSED(pExcepInfo),
+                                                 UINT* WXUNUSED(puArgErr))
+{
+    // sent by the view also for the changes the change notifications
+    // are not enabled for, and when it finished enumerating the items
+    if ( dispIdMember == DISPID_CONTENTSCHANGED || dispIdMember == DISPID_FILELISTENUMDONE )
+        ++m_viewContentsGeneration;
+
+    return S_OK;
+}
+
+void wxExplorerBrowserImplHelper::_AdviseViewEvents(IShellView* view)
+{
+    _UnadviseViewEvents();
+    ++m_viewContentsGeneration;
+
+    HRESULT hr;
+    wxCOMPtr<IDispatch> d;
+    wxCOMPtr<IConnectionPointContainer> cpc;
+    wxCOMPtr<IConnectionPoint> cp;
+
+    hr = view->GetItemObject(SVGIO_BACKGROUND, wxIID_PPV_ARGS(IDispatch, &d));
+    if ( FAILED(hr) )
+    {
+        // e.g. the views of some namespace extensions
+        wxLogDebug(wxS("IShellView::GetItemObject(SVGIO_BACKGROUND) failed with 0x%08lx."),
+                   static_cast<unsigned long>(hr));
+        return;
+    }
+
+    hr = d->QueryInterface(wxIID_PPV_ARGS(IConnectionPointContainer, &cpc));
+    if ( SUCCEEDED(hr) )
+        hr = cpc->FindConnectionPoint(DIID_DShellFolderViewEvents, &cp);
+    if ( SUCCEEDED(hr) )
+        hr = cp->Advise(static_cast<IDispatch*>(this), &m_viewEventsCookie);
+    if ( FAILED(hr) )
+    {
+        wxLogDebug(wxS("Advising DShellFolderViewEvents failed with 0x%08lx."), static_cast<unsigned long>(hr));
+        return;
+    }
+
+    m_viewEventsPoint = cp;
+}
+
+void wxExplorerBrowserImplHelper::_UnadviseViewEvents()
+{
+    if ( !m_viewEventsPoint )
+        return;
+
+    // fails harmlessly when the view was already destroyed
+    m_viewEventsPoint->Unadvise(m_viewEventsCookie);
+    m_viewEventsPoint.reset();
+    m_viewEventsCookie = 0;
+}
+
+STDMETHODIMP wxExplorerBrowserImplHelper::GetPaneState(REFEXPLORERPANE ep, EXPLORERPANESTATE *peps)
+{
+    if ( ep == EP_NavPane )
+        *peps = m_paneSettings.GetFlags(wxExplorerBrowser::EP_NavPane);
+    else
+    if ( ep == EP_Commands )
+        *peps = m_paneSettings.GetFlags(wxExplorerBrowser::EP_Commands);
+    else
+    if ( ep == EP_Commands_Organize )
+        *peps = m_paneSettings.GetFlags(wxExplorerBrowser::EP_Commands_Organize);
+    else
+    if ( ep == EP_Commands_View )
+        *peps = m_paneSettings.GetFlags(wxExplorerBrowser::EP_Commands_View);
+    else
+    if ( ep == EP_DetailsPane )
+        *peps = m_paneSettings.GetFlags(wxExplorerBrowser::EP_DetailsPane);
+    else
+    if ( ep == EP_PreviewPane )
+        *peps = m_paneSettings.GetFlags(wxExplorerBrowser::EP_PreviewPane);
+    else
+    if ( ep == EP_QueryPane )
+        *peps = m_paneSettings.GetFlags(wxExplorerBrowser::EP_QueryPane);
+    else
+    if ( ep == EP_AdvQueryPane )
+        *peps = m_paneSettings.GetFlags(wxExplorerBrowser::EP_AdvQueryPane);
+    else
+    if ( ep == EP_StatusBar )
+        *peps = m_paneSettings.GetFlags(wxExplorerBrowser::EP_StatusBar);
+    else
+    if ( ep == EP_Ribbon )
+        *peps = m_paneSettings.GetFlags(wxExplorerBrowser::EP_Ribbon);
+    else
+        return E_INVALIDARG;
+
+    return S_OK;
+}
+
+// Filtering does not work for query-backed views such as libraries or search results.
+// Neither ICommDlgBrowser::IncludeObject() nor IFolderFilter::ShouldShow() are called for those, see e.g.
+// https://social.msdn.microsoft.com/Forums/windowsdesktop/en-US/252a9c82-617c-4126-8347-56dcedb4342f
+// ICommDlgBrowser3::GetFilter() is never called for any folder at all...
+bool wxExplorerBrowserImplHelper::_SetFilter(const wxArrayString& fileMasks, wxUint32 itemTypes)
+{
+    m_filter.Add(fileMasks, itemTypes);
+    return true;
+}
+
+bool wxExplorerBrowserImplHelper::_RemoveFilter()
+{
+    m_filter.Clear();
+    return true;
+}
+
+bool wxExplorerBrowserImplHelper::_SetIgnoreRules(const wxString& root, const wxString& fileName,
+                                                  const wxString& globalRules, PCIDLIST_ABSOLUTE currentFolder)
+{
+    m_ignoreRules.Set(root, fileName, globalRules);
+    _LoadIgnoreRules(currentFolder, IgnoreRules_Shown);
+    _LoadIgnoreRules(nullptr, IgnoreRules_Pending);
+    return true;
+}
+
+bool wxExplorerBrowserImplHelper::_RemoveIgnoreRules()
+{
+    m_ignoreRules.Clear();
+    _LoadIgnoreRules(nullptr, IgnoreRules_Shown);
+    _LoadIgnoreRules(nullptr, IgnoreRules_Pending);
+    return true;
+}
+
+// reads the ignore files for the folder, if it is in the tree of the rules, and clears
+// the rules with the index if it is not, called only by the thread of the window
+void wxExplorerBrowserImplHelper::_LoadIgnoreRules(PCIDLIST_ABSOLUTE folder, size_t index)
+{
+    wxExplorerBrowserIgnoreRules::DirectoryRulesPtr rules;
+    PIDLIST_ABSOLUTE pidl = nullptr;
+
+    if ( folder && !m_ignoreRules.IsEmpty() )
+    {
+        PWSTR path = nullptr;
+
+        // the virtual folders have no path and no ignore files
+        if ( SUCCEEDED(::SHGetNameFromIDList(folder, SIGDN_FILESYSPATH, &path)) )
+        {
+            rules = m_ignoreRules.GetDirectoryRules(path);
+            ::CoTaskMemFree(path);
+        }
+
+        if ( rules )
+            pidl = ::ILCloneFull(folder);
+    }
+
+    std::lock_guard<std::mutex> lock(m_folderFilterLock);
+    IgnoreRulesFolder& ignoreRulesFolder = m_ignoreRulesFolders[index];
+
+    ::CoTaskMemFree(ignoreRulesFolder.pidl);
+    ignoreRulesFolder.pidl = pidl;
+    ignoreRulesFolder.rules = std::move(rules);
+}
+
+wxExplorerBrowserIgnoreRules::DirectoryRulesPtr wxExplorerBrowserImplHelper::_GetIgnoreRules(PCIDLIST_ABSOLUTE folder) const
+{
+    if ( !folder )
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(m_folderFilterLock);
+
+    for ( const auto& ignoreRulesFolder : m_ignoreRulesFolders )
+    {
+        if ( ignoreRulesFolder.pidl && _IsSameIDList(ignoreRulesFolder.pidl, folder) )
+            return ignoreRulesFolder.rules;
+    }
+
+    return nullptr;
+}
+
+size_t wxExplorerBrowserImplHelper::_GetFilterMemoryUsage() const
+{
+    size_t usage = m_filter.GetMemoryUsage() + m_ignoreRules.GetMemoryUsage();
+    const VisibleNamesPtr visibleNames = _GetVisibleNames();
+
+    if ( !visibleNames )
+        return usage;
+
+    for ( const auto& name : visibleNames->names )
+        usage += wxExplorerBrowserGetMemoryUsage(name) + 2 * sizeof(void*);
+
+    return usage + visibleNames->names.bucket_count() * sizeof(void*) + ::ILGetSize(visibleNames->folder);
+}
+
+void wxExplorerBrowserImplHelper::_SetVisibleNames(PCIDLIST_ABSOLUTE folder, NameSet&& names)
+{
+    wxCHECK_RET(folder, wxS("The folder must be specified"));
+
+    // built completely before being published, the enumeration thread
+    // of the view may still be using the previous names
+    std::shared_ptr<VisibleNames> visibleNames = std::make_shared<VisibleNames>();
+
+    visibleNames->folder = ::ILCloneFull(folder);
+    if ( !visibleNames->folder )
+        return;
+    visibleNames->names = std::move(names);
+
+    VisibleNamesPtr published(std::move(visibleNames));
+
+    {
+        std::lock_guard<std::mutex> lock(m_folderFilterLock);
+
+        m_visibleNames.swap(published);
+    }
+
+    // the previous names are freed outside of the lock, unless ShouldShow() still uses them
+}
+
+void wxExplorerBrowserImplHelper::_RemoveVisibleNames()
+{
+    VisibleNamesPtr visibleNames;
+
+    {
+        std::lock_guard<std::mutex> lock(m_folderFilterLock);
+
+        visibleNames.swap(m_visibleNames);
+    }
+}
+
+wxExplorerBrowserImplHelper::VisibleNamesPtr wxExplorerBrowserImplHelper::_GetVisibleNames() const
+{
+    std::lock_guard<std::mutex> lock(m_folderFilterLock);
+
+    return m_visibleNames;
+}
+
+bool wxExplorerBrowserImplHelper::_SetPaneSettings(const wxExplorerBrowser::PaneSettings& settings)
+{
+    m_paneSettings = settings;
+    return true;
+}
+
+wxExplorerBrowserItem::Type wxExplorerBrowserImplHelper::_SFGAO2wxExplorerBrowserItemType(SFGAOF attr)
+{
+    static const SFGAOF FileSystemFile = SFGAO_FILESYSTEM | SFGAO_STREAM;
+    static const SFGAOF FileSystemDirectory = SFGAO_FILESYSTEM | SFGAO_FOLDER;
+    static const SFGAOF VirtualZipDirectory = SFGAO_FILESYSTEM | SFGAO_FOLDER | SFGAO_STREAM;
+
+    // remove the the attributes we are not interested in
+    attr &= (SFGAO_FILESYSTEM | SFGAO_FOLDER | SFGAO_STREAM);
+
+    switch ( attr )
+    {
+        case 0:
+            return wxExplorerBrowserItem::Unknown;
+        case FileSystemFile:
+        case VirtualZipDirectory:
+            return wxExplorerBrowserItem::File;
+        case FileSystemDirectory:
+            return wxExplorerBrowserItem::Directory;
+        default:
+            return wxExplorerBrowserItem::Other;
+    }
+}
+
+bool wxExplorerBrowserImplHelper::_IShellItem2wxExplorerBrowserItem(IShellItem* item, wxExplorerBrowserItem& ebi,
+                                                                    wxExplorerBrowserItemCache* cache,
+                                                                    PIDLIST_ABSOLUTE* pidlOut)
+{
+    wxCHECK(item, false);
+
+    HRESULT hr;
+    PIDLIST_ABSOLUTE pidl = nullptr;
+
+    hr = ::SHGetIDListFromObject(item, &pidl);
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("SHGetIDListFromObject()"), hr);
+        return false;
+    }
+
+    // the item id is also its key in the cache
+    const wxUint64 id = _GetIDListKey(pidl);
+    bool result = true;
+
+    if ( !cache || !cache->Lookup(id, ebi) )
+    {
+        result = _ShellItem2wxExplorerBrowserItem(item, ebi);
+        if ( result )
+        {
+            ebi.SetId(id);
+            if ( cache )
+                cache->Insert(id, _GetParentIDListKey(pidl), ebi);
+        }
+    }
+
+    if ( result && pidlOut )
+        *pidlOut = pidl;
+    else
+        ::CoTaskMemFree(pidl);
+
+    return result;
+}
+
+bool wxExplorerBrowserImplHelper::_ShellItem2wxExplorerBrowserItem(IShellItem* item, wxExplorerBrowserItem& ebi)
+{
+    static const SFGAOF mask = SFGAO_FILESYSTEM | SFGAO_FOLDER | SFGAO_STREAM | SFGAO_LINK;
+
+    HRESULT hr;
+    SFGAOF attr;
+
+    hr = item->GetAttributes(mask, &attr);
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("(IShellItem::GetAttributesOf()"), hr);
+        return false;
+    }
+
+    // the names are assigned to ebi directly, without temporary
+    // wxStrings, so that its string buffers can be reused
+    PWSTR name = nullptr;
+
+    hr = item->GetDisplayName(SIGDN_NORMALDISPLAY, &name);
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IShellItem::GetDisplayName(SIGDN_NORMALDISPLAY)"), hr);
+        return false;
+    }
+    else
+    {
+        ebi.SetDisplayName(name);
+        ::CoTaskMemFree(name);
+    }
+
+    // will fail for non-filesystem items
+    if ( SUCCEEDED(item->GetDisplayName(SIGDN_FILESYSPATH, &name)) )
+    {
+        ebi.SetPath(name);
+        ::CoTaskMemFree(name);
+    }
+    else
+        ebi.SetPath(wxEmptyString);
+
+    ebi.SetType(_SFGAO2wxExplorerBrowserItemType(attr));
+    ebi.SetSFGAO(attr);
+
+    return true;
+}
+
+bool wxExplorerBrowserImplHelper::_PPIDL2wxExplorerBrowserItem(PCIDLIST_ABSOLUTE pidl, wxExplorerBrowserItem& ebi,
+                                                               wxExplorerBrowserItemCache* cache)
+{
+    wxCHECK(pidl, false);
+
+    const wxUint64 id = _GetIDListKey(pidl);
+
+    if ( cache && cache->Lookup(id, ebi) )
+        return true;
+
+    HRESULT hr;
+    wxCOMPtr<IShellItem> si;
+
+    hr = ::SHCreateItemFromIDList(pidl, wxIID_PPV_ARGS(IShellItem, &si));
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("SHCreateItemFromIDList"), hr);
+        return false;
+    }
+
+    if ( !_ShellItem2wxExplorerBrowserItem(si, ebi) )
+        return false;
+
+    ebi.SetId(id);
+    if ( cache )
+        cache->Insert(id, _GetParentIDListKey(pidl), ebi);
+
+    return true;
+}
+
+wxUint64 wxExplorerBrowserImplHelper::_GetIDListKey(PCIDLIST_ABSOLUTE pidl)
+{
+    wxCHECK(pidl, 0);
+
+    if ( ::ILIsEmpty(pidl) )
+        return _GetFolderKey(pidl);
+
+    // only the key of the folder is got from the shell, once per folder,
+    // the bytes of the last ID are hashed without any shell call
+    PCUITEMID_CHILD child = ::ILFindLastID(pidl);
+
+    return wxExplorerBrowserMakeItemId(child, child->mkid.cb, _GetParentIDListKey(pidl));
+}
+
+wxUint64 wxExplorerBrowserImplHelper::_GetFolderKey(PCIDLIST_ABSOLUTE pidl)
+{
+    wxCHECK(pidl, 0);
+
+    // the ID lists of filesystem folders contain also their time, which changes
+    // with their contents, so the key is derived from the parsing name
+    HRESULT hr;
+    PWSTR name = nullptr;
+
+    hr = ::SHGetNameFromIDList(pidl, SIGDN_DESKTOPABSOLUTEPARSING, &name);
+    if ( FAILED(hr) )
+    {
+        wxLogDebug(wxS("SHGetNameFromIDList(SIGDN_DESKTOPABSOLUTEPARSING) failed with 0x%08lx, using the ID list."),
+                   static_cast<unsigned long>(hr));
+        return wxExplorerBrowserMakeItemId(pidl, ::ILGetSize(pidl) - sizeof(USHORT));
+    }
+
+    const wxUint64 key = wxExplorerBrowserMakeItemId(name);
+
+    ::CoTaskMemFree(name);
+    return key;
+}
+
+bool wxExplorerBrowserImplHelper::_IsSameIDList(PCIDLIST_ABSOLUTE pidl1, PCIDLIST_ABSOLUTE pidl2)
+{
+    wxCHECK(pidl1 && pidl2, false);
+
+    // the view passes the same ID list for all the items of a folder
+    const UINT size = ::ILGetSize(pidl1);
+
+    if ( size == ::ILGetSize(pidl2) && memcmp(pidl1, pidl2, size) == 0 )
+        return true;
+
+    return ::ILIsEqual(pidl1, pidl2) != FALSE;
+}
+
+wxUint64 wxExplorerBrowserImplHelper::_GetParentIDListKey(PCIDLIST_ABSOLUTE pidl)
+{
+    wxCHECK(pidl, 0);
+
+    // the items are mostly converted folder by folder, so the key
+    // of the last parent is kept, its bytes identify it exactly
+    struct ParentKey
+    {
+        std::vector<BYTE> idList;
+        wxUint64 key {0};
+    };
+    static thread_local ParentKey s_last;
+
+    const BYTE* first = reinterpret_cast<const BYTE*>(pidl);
+    const BYTE* last  = reinterpret_cast<const BYTE*>(::ILFindLastID(pidl));
+
+    if ( s_last.key && s_last.idList.size() == static_cast<size_t>(last - first)
+         && std::equal(first, last, s_last.idList.begin()) )
+        return s_last.key;
+
+    PIDLIST_ABSOLUTE parent = ::ILClone(pidl);
+
+    if ( !parent )
+        return 0;
+
+    ::ILRemoveLastID(parent);
+    s_last.key = _GetFolderKey(parent);
+    s_last.idList.assign(first, last);
+    ::CoTaskMemFree(parent);
+
+    return s_last.key;
+}
+
+
+bool wxExplorerBrowserImplHelper::_SendNotifyEvent(wxEventType command, PCIDLIST_ABSOLUTE list) const
+{
+    if ( m_eventQueue && !_IsVetoable(command) )
+    {
+        QueuedEvent queued;
+
+        // the item is created only when the event is sent,
+        // so that the shell callback returns right away
+        queued.type = command;
+        queued.pidl = ::ILCloneFull(list);
+        if ( queued.pidl && _QueueEvent(queued) )
+            return true;
+
+        ::CoTaskMemFree(queued.pidl);
+    }
+
+    wxExplorerBrowserItem ebi;
+
+    if ( _PPIDL2wxExplorerBrowserItem(list, ebi, m_itemCache) )
+        return _ProcessNotifyEvent(command, ebi);
+
+    return false;
+}
+
+bool wxExplorerBrowserImplHelper::_SendNotifyEvent(wxEventType command,
+                                                   const wxExplorerBrowserItem& ebi) const
+{
+    if ( m_eventQueue && !_IsVetoable(command) )
+    {
+        QueuedEvent queued;
+
+        queued.type = command;
+        queued.item = m_eventItemPool.Acquire(ebi);
+        if ( _QueueEvent(queued) )
+            return true;
+    }
+
+    return _ProcessNotifyEvent(command, ebi);
+}
+
+bool wxExplorerBrowserImplHelper::_IsVetoable(wxEventType command)
+{
+    return command == wxEVT_EXPLORER_BROWSER_DEFAULT_COMMAND
+           || command == wxEVT_EXPLORER_BROWSER_CONTEXTMENU_START
+           || command == wxEVT_EXPLORER_BROWSER_NAVIGATING;
+}
+
+bool wxExplorerBrowserImplHelper::_QueueEvent(const QueuedEvent& queued) const
+{
+    // kept alive even if an event handler disables the queued events
+    const std::shared_ptr<QueuedEvents> queue = m_eventQueue;
+
+    if ( queue->TryPush(queued) )
+    {
+        ::wxWakeUpIdle();
+        return true;
+    }
+
+    // when the queue is full, the event is sent right away by the caller,
+    // but only after the events already waiting, so that the order is kept
+    _SendQueuedEvents(*queue, queue->GetCapacity());
+    return false;
+}
+
+bool wxExplorerBrowserImplHelper::_ProcessNotifyEvent(wxEventType command,
+                                                      const wxExplorerBrowserItem& ebi) const
+{
+    wxExplorerBrowserEvent evt(command, m_host->GetId());
+
+    evt.SetEventObject(m_host);
+    evt.SetItem(m_eventItemPool.Acquire(ebi));
+
+    if ( m_host->ProcessWindowEvent(evt) )
+        return evt.IsAllowed();
+
+    return true;
+}
+
+void wxExplorerBrowserImplHelper::_SendQueuedEvents(QueuedEvents& queue, size_t maxCount) const
+{
+    QueuedEvent queued;
+
+    // the caller keeps the queue alive, if a handler disables or re-enables
+    // the queued events, the remaining events are sent from the nested call
+    // doing that and the queue is found empty here
+    for ( size_t i = 0; i < maxCount && queue.TryPop(queued); ++i )
+    {
+        if ( queued.pidl )
+        {
+            wxExplorerBrowserItem ebi;
+            const bool converted = _PPIDL2wxExplorerBrowserItem(queued.pidl, ebi, m_itemCache);
+
+            ::CoTaskMemFree(queued.pidl);
+            if ( !converted )
+                continue;
+
+            queued.item = m_eventItemPool.Acquire(ebi);
+        }
+
+        wxExplorerBrowserEvent evt(queued.type, m_host->GetId());
+
+        evt.SetEventObject(m_host);
+        evt.SetItem(std::move(queued.item));
+        m_host->ProcessWindowEvent(evt);
+    }
+}
+
+bool wxExplorerBrowserImplHelper::_GetSelectedItem(wxExplorerBrowserItem& ebi)
+{
+    HRESULT hr;
+    wxCOMPtr<IFolderView2> fv2;
+
+    hr = m_explorerBrowser->GetCurrentView(wxIID_PPV_ARGS(IFolderView2, &fv2));
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IExplorerBrowser::GetCurrentView()"), hr);
+        return false;
+    }
+
+    int selected;
+
+    if ( fv2->GetSelectedItem(-1, &selected) != S_OK )
+    {
+        // no selected items
+        return false;
+    }
+
+    wxCOMPtr<IShellItem> si;
+
+    hr = fv2->GetItem(selected, wxIID_PPV_ARGS(IShellItem, &si));
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IFolderView2::GetItem()"), hr);
+        return false;
+    }
+
+    return _IShellItem2wxExplorerBrowserItem(si, ebi, m_itemCache);
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserHostWindow
+    ---------------------------------
+    the window ExplorerBrowser is created in,
+    allows wxExplorerBrowserImpl to process
+    window messages it registered for
+
+*****************************************************************************/
+
+class wxExplorerBrowserHostWindow : public wxWindow
+{
+public:
+    // returns true if the message was processed
+    typedef std::function<bool (WXUINT, WXWPARAM, WXLPARAM)> MessageHandler;
+
+    wxExplorerBrowserHostWindow(wxWindow* parent)
+        : wxWindow(parent, wxID_ANY, wxDefaultPosition, wxDefaultSize,
+                   wxBORDER_NONE | wxWANTS_CHARS | wxCLIP_CHILDREN | wxCLIP_SIBLINGS,
+                   wxS("wxExplorerBrowserWindow"))
+    {}
+
+    void SetMessageHandler(const MessageHandler& handler) { m_messageHandler = handler; }
+
+    WXLRESULT MSWWindowProc(WXUINT nMsg, WXWPARAM wParam, WXLPARAM lParam) override
+    {
+        if ( m_messageHandler && m_messageHandler(nMsg, wParam, lParam) )
+            return 0;
+
+        return wxWindow::MSWWindowProc(nMsg, wParam, lParam);
+    }
+private:
+    MessageHandler m_messageHandler;
+};
+
+// the names in the current folder for wxExplorerBrowser::SearchIndex(), indexed
+// when first searched; filtering the view makes it enumerate the folder again,
+// so the filter function is called only when the searches stop for a while
+class FolderSearchIndex
+{
+public:
+    // filters the view by the found names, shows all of them for an empty string
+    typedef std::function<void (const wxString&)> FilterFunc;
+
+    explicit FolderSearchIndex(const FilterFunc& filter) : m_filter(filter)
+    {
+        m_timer.Bind(wxEVT_TIMER, &FolderSearchIndex::OnTimer, this);
+    }
+    ~FolderSearchIndex() { ::CoTaskMemFree(m_folder); }
+
+    bool IsEnabled() const { return m_enabled; }
+    void Enable(bool enable, wxUint64 filterDelay)
+    {
+        m_enabled = enable;
+        m_scheduler.SetDelays(filterDelay);
+    }
+
+    // only the found names are shown
+    bool IsFiltering() const { return m_filtering; }
+    void SetFiltering(bool filtering) { m_filtering = filtering; }
+
+    PCIDLIST_ABSOLUTE GetFolder() const { return m_folder; }
+
+    // the changes in its folder can be applied to the index
+    bool IsUpToDate() const { return m_folder && !m_stale; }
+
+    // kept up to date by the change notifications, without them the folder is indexed
+    // again when written to; the time of a folder outside the file system is not known,
+    // its index is kept until navigating or refreshing
+    bool IsCurrent(PCIDLIST_ABSOLUTE folder, wxUint64 folderTime, bool notified) const
+    {
+        return IsUpToDate() && wxExplorerBrowserImplHelper::_IsSameIDList(folder, m_folder)
+               && (notified || folderTime == m_folderTime);
+    }
+
+    // takes the ownership of the folder
+    void SetItems(PIDLIST_ABSOLUTE folder, wxUint64 folderTime, const wxExplorerBrowserItem::List& items)
+    {
+        m_index.SetItems(items);
+        ::CoTaskMemFree(m_folder);
+        m_folder = folder;
+        m_folderTime = folderTime;
+        m_stale = false;
+    }
+
+    // the shell did not tell what changed in the folder, it is indexed again by the next search
+    void SetStale() { m_stale = true; }
+
+    void Add(const wxString& name) { m_index.Add(name); }
+    void Remove(const wxString& name) { m_index.Remove(name); }
+
+    void Find(const wxString& str, wxArrayString& names)
+    {
+        m_index.Find(str, m_matches);
+
+        names.clear();
+        names.reserve(m_matches.size());
+        for ( const auto id : m_matches )
+            names.push_back(m_index.GetName(id));
+    }
+
+    void Find(const wxString& str, wxExplorerBrowserImplHelper::NameSet& upperNames)
+    {
+        m_index.Find(str, m_matches);
+
+        upperNames.clear();
+        upperNames.reserve(m_matches.size());
+        for ( const auto id : m_matches )
+            upperNames.insert(m_index.GetUpperName(id));
+    }
+
+    // the view is filtered by @a str after the delay, unless searched again meanwhile
+    void SubmitFilter(const wxString& str)
+    {
+        m_scheduler.Submit(str, ::GetTickCount64());
+        UpdateTimer();
+    }
+
+    // frees the index, which is built again by the next search
+    void Clear()
+    {
+        m_index.Clear();
+        m_matches.clear();
+        m_stale = true;
+    }
+
+    // forgets the folder and the pending filtering, the caller stops filtering the view
+    void Reset()
+    {
+        m_index.Clear();
+        m_matches.clear();
+        ::CoTaskMemFree(m_folder);
+        m_folder = nullptr;
+        m_folderTime = 0;
+        m_stale = false;
+        m_scheduler.Reset();
+        m_timer.Stop();
+    }
+
+    size_t GetIndexMemoryUsage() const
+    {
+        return m_index.GetMemoryUsage() + m_matches.capacity() * sizeof(wxExplorerBrowserTrigramIndex::Id)
+               + (m_folder ? ::ILGetSize(m_folder) : 0);
+    }
+    size_t GetSchedulerMemoryUsage() const { return m_scheduler.GetMemoryUsage(); }
+
+private:
+    FilterFunc m_filter;
+    bool m_enabled {false};
+    bool m_filtering {false};
+    wxExplorerBrowserTrigramIndex m_index;
+    wxExplorerBrowserTrigramIndex::IdList m_matches;
+    PIDLIST_ABSOLUTE m_folder {nullptr}; // null when not indexed
+    wxUint64 m_folderTime {0}; // the last write time of the indexed folder, 0 if unknown
+    bool m_stale {false};
+    wxExplorerBrowserSearchScheduler m_scheduler;
+    wxTimer m_timer;
+
+    void UpdateTimer()
+    {
+        wxUint64 deadline;
+
+        if ( !m_scheduler.GetDeadline(deadline) )
+        {
+            m_timer.Stop();
+            return;
+        }
+
+        const wxUint64 now = ::GetTickCount64();
+        const int delay = deadline > now ? static_cast<int>(deadline - now) : 1;
+
+        m_timer.StartOnce(delay);
+    }
+
+    void OnTimer(wxTimerEvent& WXUNUSED(evt))
+    {
+        // the view is filtered at once, so the query is completed right away
+        if ( m_scheduler.OnTimer(::GetTickCount64()) == wxExplorerBrowserSearchScheduler::Action_Start )
+        {
+            m_filter(m_scheduler.GetInFlightQuery());
+            m_scheduler.Complete();
+        }
+
+        UpdateTimer();
+    }
+
+    wxDECLARE_NO_COPY_CLASS(FolderSearchIndex);
+};
+
+// the thumbnails extracted on worker threads for wxExplorerBrowser::GetThumbnail(),
+// their persistent store and the prefetching of those around the visible range
+class ThumbnailLoader
+{
+public:
+    explicit ThumbnailLoader(wxExplorerBrowserHostWindow* host) : m_host(host) {}
+
+    // null when the thumbnails are not enabled
+    wxExplorerBrowserThumbnailService* GetService() const { return m_service.get(); }
+
+    // the service is created again only if the number of its threads changes
+    void Enable(size_t maxMemory, unsigned threadCount)
+    {
+        if ( m_service && (!threadCount || m_service->GetThreadCount() == threadCount) )
+        {
+            m_service->SetMaxMemory(maxMemory);
+            return;
+        }
+
+        wxExplorerBrowserHostWindow* host = m_host;
+
+        // called on the worker threads, the service is destroyed before the host
+        const auto onReady = [host](const wxExplorerBrowserItem& item, unsigned size,
+                                    const wxExplorerBrowserThumbnail::Ptr& thumbnail)
+        {
+            wxExplorerBrowserThumbnailEvent* evt = new wxExplorerBrowserThumbnailEvent(wxEVT_EXPLORER_BROWSER_THUMBNAIL_READY,
+                                                                                       host->GetId());
+            wxExplorerBrowserItem eventItem(item);
+
+            // the strings must not be shared with the worker thread
+            eventItem.SetPath(item.GetPath().wx_str());
+            eventItem.SetDisplayName(item.GetDisplayName().wx_str());
+
+            evt->SetEventObject(host);
+            evt->SetItem(eventItem);
+            evt->SetSize(static_cast<int>(size));
+            evt->SetThumbnail(thumbnail);
+            host->GetEventHandler()->QueueEvent(evt);
+        };
+
+        m_service.reset(); // before creating the new one, to not exceed the memory
+        m_service.reset(new wxExplorerBrowserThumbnailService(
+            [this](const wxExplorerBrowserItem& item, unsigned size, wxExplorerBrowserThumbnail& thumbnail)
+            { return Decode(item, size, thumbnail); },
+            onReady, maxMemory, threadCount));
+    }
+
+    // waits for the extractions in progress, which may queue events for the host
+    void Disable()
+    {
+        m_service.reset();
+        m_prefetchSize = 0;
+        ClearPrefetch();
+    }
+
+    bool SetStore(const wxString& fileName, size_t maxSize)
+    {
+        std::shared_ptr<wxExplorerBrowserThumbnailStore> store;
+
+        if ( !fileName.empty() )
+        {
+            store = std::make_shared<wxExplorerBrowserThumbnailStore>();
+            if ( !store->Open(fileName, maxSize) )
+                return false;
+        }
+
+        // the previous store is closed when the last worker using it is done
+        std::atomic_store(&m_store, store);
+        return true;
+    }
+
+    bool IsPrefetching() const { return m_prefetchSize && m_service; }
+
+    // 0 stops prefetching
+    void SetPrefetch(unsigned size, size_t distance)
+    {
+        ClearPrefetch();
+        m_prefetchSize = size;
+        m_prefetchDistance = distance;
+    }
+
+    // all the items in the view and their indices in it, filled by the caller
+    // when their number changes, before calling PreparePrefetch()
+    wxExplorerBrowserItem::List& GetPrefetchItems() { return m_prefetchItems; }
+    std::vector<size_t>& GetPrefetchViewIndices() { return m_prefetchViewIndices; }
+
+    void PreparePrefetch() { m_prefetchRequested.assign(m_prefetchItems.size(), 0); }
+
+    // called with the visible range of the view
+    void UpdatePrefetch(size_t first, size_t count)
+    {
+        MapViewRange(m_prefetchViewIndices, first, count);
+
+        const size_t distance = m_prefetchDistance ? m_prefetchDistance : wxMax(count, 1);
+
+        // the items scrolled too far are dropped and those which came
+        // close enough are queued, unless they were requested before
+        m_prefetchScheduler.SetDistances(0, distance);
+        m_prefetchScheduler.SetViewport(first, count);
+
+        const size_t begin = first > distance ? first - distance : 0;
+        const size_t end = wxMin(first + wxMax(count, 1) + distance, m_prefetchItems.size());
+
+        for ( size_t i = begin; i < end; ++i )
+        {
+            if ( !m_prefetchRequested[i] )
+                m_prefetchScheduler.Add(i);
+        }
+
+        RequestPrefetched();
+    }
+
+    // called also when a thumbnail is ready, to keep the service busy
+    void RequestPrefetched()
+    {
+        if ( !IsPrefetching() )
+            return;
+
+        // the queue of the service is kept short, the requests made with GetThumbnail()
+        // are for the items being painted and must not wait for the prefetched ones
+        const size_t maxInFlight = 2 * m_service->GetThreadCount();
+        size_t index;
+
+        while ( m_service->GetInFlightCount() < maxInFlight && m_prefetchScheduler.Next(index) )
+        {
+            wxExplorerBrowserThumbnail::Ptr thumbnail;
+
+            m_prefetchRequested[index] = 1;
+            m_service->Request(m_prefetchItems[index], m_prefetchSize, thumbnail);
+        }
+    }
+
+    void ClearPrefetch()
+    {
+        m_prefetchScheduler.Clear();
+        m_prefetchItems.clear();
+        m_prefetchViewIndices.clear();
+        m_prefetchRequested.clear();
+    }
+
+private:
+    wxExplorerBrowserHostWindow* m_host;
+    std::unique_ptr<wxExplorerBrowserThumbnailService> m_service;
+    // not null when used, accessed atomically as the worker threads use it
+    std::shared_ptr<wxExplorerBrowserThumbnailStore> m_store;
+
+    unsigned m_prefetchSize {0}; // 0 when not prefetching
+    size_t m_prefetchDistance {0};
+    wxExplorerBrowserViewportScheduler m_prefetchScheduler;
+    wxExplorerBrowserItem::List m_prefetchItems;
+    std::vector<size_t> m_prefetchViewIndices; // of each of the items
+    std::vector<wxUint8> m_prefetchRequested;  // for each of the items
+
+    // the decoder of the service, called on its worker threads
+    bool Decode(const wxExplorerBrowserItem& item, unsigned size, wxExplorerBrowserThumbnail& thumbnail)
+    {
+        const std::shared_ptr<wxExplorerBrowserThumbnailStore> store = std::atomic_load(&m_store);
+        wxExplorerBrowserThumbnailStore::Key key;
+        bool useStore = false;
+
+        // only the file system items have the modification time
+        if ( store && item.GetType() != wxExplorerBrowserItem::Other && !item.GetPath().empty() )
+        {
+            WIN32_FILE_ATTRIBUTE_DATA attributes;
+
+            if ( ::GetFileAttributesExW(item.GetPath().wc_str(), GetFileExInfoStandard, &attributes) )
+            {
+                const wxUint64 modificationTime = (static_cast<wxUint64>(attributes.ftLastWriteTime.dwHighDateTime) << 32)
+                                                  | attributes.ftLastWriteTime.dwLowDateTime;
+
+                key = wxExplorerBrowserThumbnailStore::MakeKey(item, modificationTime, size);
+                useStore = true;
+            }
+        }
+
+        if ( useStore && store->Lookup(key, thumbnail) )
+            return true;
+
+        if ( !ExtractThumbnail(item, size, thumbnail) )
+            return false;
+
+        if ( useStore )
+            store->Insert(key, thumbnail);
+
+        return true;
+    }
+
+    wxDECLARE_NO_COPY_CLASS(ThumbnailLoader);
+};
+
+} // unnamed namespace
+
+/***************************************************************************
+
+    class wxExplorerBrowserImpl
+    ---------------------------------
+    actual implemention of wxExplorerBrowser methods
+
+*****************************************************************************/
+
+class wxExplorerBrowser::wxExplorerBrowserImpl
+{
+public:
+    wxExplorerBrowserImpl(wxExplorerBrowserHostWindow* host)
+        : m_host{host},
+          m_thumbnails{host},
+          m_searchIndex{[this](const wxString& str) { FilterViewByIndex(str); }}
+    {
+        m_resizeTimer.Bind(wxEVT_TIMER, &wxExplorerBrowserImpl::OnResizeTimer, this);
+        m_changeTimer.Bind(wxEVT_TIMER, &wxExplorerBrowserImpl::OnChangeTimer, this);
+        m_searchTimer.Bind(wxEVT_TIMER, &wxExplorerBrowserImpl::OnSearchTimer, this);
+        m_resultTimer.Bind(wxEVT_TIMER, &wxExplorerBrowserImpl::OnResultTimer, this);
+        m_viewportTimer.Bind(wxEVT_TIMER, &wxExplorerBrowserImpl::OnViewportTimer, this);
+        m_folderSizeTimer.Bind(wxEVT_TIMER, &wxExplorerBrowserImpl::OnFolderSizeTimer, this);
+        m_enumerationTimer.Bind(wxEVT_TIMER, &wxExplorerBrowserImpl::OnEnumerationTimer, this);
+        m_host->Bind(wxEVT_EXPLORER_BROWSER_NAVIGATION_COMPLETE, &wxExplorerBrowserImpl::OnNavigationComplete, this);
+        m_host->Bind(wxEVT_EXPLORER_BROWSER_ITEM_PROPERTIES, &wxExplorerBrowserImpl::OnItemProperties, this);
+        m_host->Bind(wxEVT_EXPLORER_BROWSER_THUMBNAIL_READY, &wxExplorerBrowserImpl::OnThumbnailReady, this);
+        m_host->SetMessageHandler([this](WXUINT nMsg, WXWPARAM wParam, WXLPARAM lParam)
+                                  { return HandleHostMessage(nMsg, wParam, lParam); });
+    }
+    ~wxExplorerBrowserImpl();
+
+    bool Create(const CreateStruct& createStruct, const wxString& path);
+
+    bool SetFolderSettings(const FolderSettings& folderSettings);
+    bool GetOptions(wxUint32& options);
+    bool SetOptions(wxUint32 options);
+    bool SetEmptyText(const wxString& text);
+    bool SetPropertyBag(const wxString& bag);
+    bool BrowseTo(const wxString& item, bool keepWordWheelText);
+    bool BrowseTo(BrowseTarget target, bool keepWordWheelText);
+
+    bool Refresh();
+
+    bool SearchFolder(const wxString& str);
+    bool EnableSearchPipeline(bool enable, int debounceDelay);
+    bool RemoveAll();
+
+    bool AddResults(const wxArrayString& paths);
+    bool AddResults(const std::vector<wxExplorerBrowserResultInjector::IDList>& idLists);
+    bool CancelAddingResults();
+    bool SetResultBatchLimits(int batchTime, int batchInterval);
+
+    bool SelectItems(const wxExplorerBrowserItem::List& items, bool notTakeFocus);
+    bool SelectWhere(const ItemPredicate& predicate, bool notTakeFocus, size_t* selectedCount);
+    bool DeselectAllItems(bool notTakeFocus);
+    bool GetSelectedItems(wxExplorerBrowserItem::List& items, wxUint32 itemTypes, ItemsFillMode mode);
+
+    bool GetAllItems(wxExplorerBrowserItem::List& items, wxUint32 itemTypes, ItemsFillMode mode);
+    bool GetAllItemsSorted(wxExplorerBrowserItem::List& items, wxExplorerBrowserItemSorter::Order order,
+                           wxUint32 itemTypes);
+    bool GetItemProperties(wxExplorerBrowserItem::List& items, wxExplorerBrowserItemProperties& properties,
+                           wxUint32 propertyFlags, wxUint32 itemTypes);
+    bool RequestItemProperties(wxUint32 propertyFlags, wxUint32 itemTypes);
+    bool CancelItemPropertiesRequest();
+    bool QuickFind(const wxString& pattern, wxExplorerBrowserItem::List& items, size_t maxResults,
+                   std::vector<int>* scores, wxUint32 itemTypes);
+    bool EnableSearchIndex(bool enable, int filterDelay);
+    bool SearchIndex(const wxString& str, bool filterView, wxArrayString* names);
+
+    bool ExportSnapshot(const wxString& fileName, wxUint32 itemTypes);
+
+    bool GetItemChanges(wxExplorerBrowserListingDelta& delta, wxUint32 itemTypes);
+    bool ResetItemChanges();
+
+    bool GetFolder(wxExplorerBrowserItem& item);
+
+    bool SetFilter(const wxArrayString& fileMasks, wxUint32 itemTypes);
+    bool RemoveFilter();
+    bool SetIgnoreRules(const wxString& root, const wxString& fileName, const wxString& globalRules);
+    bool RemoveIgnoreRules();
+
+    bool SetPaneSettings(const PaneSettings& settings);
+
+    bool EnableChangeNotifications(bool enable, int batchDelay, size_t maxQueuedChanges);
+
+    bool UseSharedItemCache(bool use);
+
+    bool EnableQueuedEvents(bool enable, size_t queueCapacity);
+
+    bool EnableThumbnails(bool enable, size_t maxMemory, unsigned threadCount);
+    bool GetThumbnail(const wxExplorerBrowserItem& item, int size, wxBitmap& bitmap);
+    bool CancelThumbnailRequests();
+    bool SetThumbnailStore(const wxString& fileName, size_t maxSize);
+    bool PrefetchThumbnails(int size, size_t distance);
+
+    bool GetVisibleItemRange(size_t& first, size_t& count);
+    bool EnableViewportTracking(bool enable, int pollInterval);
+
+    bool CalculateFolderSize(const wxExplorerBrowserItem::List& items, int progressInterval);
+    bool CancelFolderSizeCalculation();
+
+    bool EnumerateRecursively(wxUint32 itemTypes, unsigned maxDepth, int batchInterval);
+    bool CancelRecursiveEnumeration();
+
+    bool GetMemoryUsage(wxExplorerBrowserMemoryUsage& usage) const;
+    bool SetMemoryBudget(size_t softLimit, size_t hardLimit);
+
+    bool Park(size_t estimatedMemory);
+    bool Unpark();
+    bool IsParked() const { return m_parked; }
+    static void SetParkingBudget(size_t maxParkedViews, size_t maxParkedMemory);
+
+    bool SetResizePolicy(ResizePolicy policy, int maxUpdateInterval);
+    void SetSize(const wxSize& size);
+    bool TranslateMessage(WXMSG* msg);
+
+    IExplorerBrowser* GetIExplorerBrowser() { return m_explorerBrowser.get(); }
+private:
+    wxExplorerBrowserHostWindow* m_host {nullptr};;
+    wxCOMPtr<IExplorerBrowser> m_explorerBrowser;
+    wxCOMPtr<wxExplorerBrowserImplHelper> m_explorerBrowserHelper;
+    DWORD m_adviseCookie {0};
+
+    bool Initialize(const CreateStruct& createStruct);
+    void DestroyExplorerBrowser();
+
+    // the state of the view torn down while parked, restored when it is revived
+    struct ParkedState
+    {
+        PIDLIST_ABSOLUTE folder {nullptr};
+        wxUint32 options {0};
+        FolderSettings folderSettings;
+        int iconSize {0};
+        std::vector<PIDLIST_ABSOLUTE> selection;
+
+        ~ParkedState() { Clear(); }
+        void Clear();
+    };
+
+    bool m_parked {false};
+    bool m_tornDown {false};
+    bool m_restoringParkedView {false}; // until the revived view navigates to the folder
+    ParkedState m_parkedState;
+
+    void TearDown();
+    bool Revive();
+    void RestoreParkedView();
+    static void TearDownParkedViews(const wxExplorerBrowserParkingLot::ViewIdList& views);
+
+    wxExplorerBrowserItemCache* m_itemCache {nullptr}; // not null when the shared cache is used
+
+    void InvalidateCurrentFolderItems();
+
+    // the queue of the events is kept by m_explorerBrowserHelper, which pushes to it
+    void SendQueuedEvents(size_t maxCount);
+    void OnIdle(wxIdleEvent& evt);
+
+    ThumbnailLoader m_thumbnails;
+
+    wxExplorerBrowserMemoryBudget m_memoryBudget;
+
+    void CheckMemoryBudget();
+
+    wxExplorerBrowserListingFingerprint m_listingFingerprint; // for GetItemChanges()
+    wxUint32 m_listingFingerprintTypes {0};
+
+    QuickFinder m_quickFinder; // reset when the view changes
+
+    FolderSearchIndex m_searchIndex; // for SearchIndex()
+
+    bool BuildSearchIndex();
+    bool EnumerateFolder(PCIDLIST_ABSOLUTE folder, wxExplorerBrowserItem::List& items);
+    void ResetSearchIndex();
+    void UpdateSearchIndex(wxExplorerBrowserItemChange::Type type, PCIDLIST_ABSOLUTE pidl);
+    bool FilterViewByIndex(const wxString& str);
+    bool RefreshView();
+
+    bool m_changeNotificationsEnabled {false};
+    ULONG m_changeNotifyId {0}; // returned by SHChangeNotifyRegister()
+    PIDLIST_ABSOLUTE m_changeNotifyFolder {nullptr};
+    wxUint64 m_changeNotifyFolderKey {0}; // got once, for invalidating its items on each notification
+    wxExplorerBrowserChangeBatcher m_changeBatcher;
+    wxTimer m_changeTimer;
+
+    bool RegisterChangeNotify();
+    void UnregisterChangeNotify();
+    void ProcessChangeNotify(LONG event, PIDLIST_ABSOLUTE* pidls);
+    void AddChange(wxExplorerBrowserItemChange::Type type, PCIDLIST_ABSOLUTE pidl);
+    void UpdateChangeTimer();
+    void OnChangeTimer(wxTimerEvent& evt);
+    void OnNavigationComplete(wxExplorerBrowserEvent& evt);
+
+    bool HandleHostMessage(WXUINT nMsg, WXWPARAM wParam, WXLPARAM lParam);
+
+    bool m_searchPipelineEnabled {false};
+    wxExplorerBrowserSearchScheduler m_searchScheduler;
+    wxTimer m_searchTimer;
+
+    bool FilterView(const wxString& str);
+    void UpdateSearchTimer();
+    void OnSearchTimer(wxTimerEvent& evt);
+    void SendSearchEvent(wxEventType command, const wxString& str, bool cancelled = false);
+
+    wxExplorerBrowserResultInjector m_resultInjector;
+    wxTimer m_resultTimer;
+
+    bool GetResultsFolder(wxCOMPtr<IResultsFolder>& rf);
+    bool PrepareResultsFolder();
+    void UpdateResultTimer();
+    void OnResultTimer(wxTimerEvent& evt);
+    void SendResultsEvent(wxEventType command, bool cancelled = false);
+
+    wxTimer m_viewportTimer;
+    // the range sent with the last wxEVT_EXPLORER_BROWSER_VIEWPORT_CHANGED
+    size_t m_viewportFirst {0};
+    size_t m_viewportCount {0};
+    size_t m_viewportItemCount {0};
+    bool m_viewportSent {false}; // cleared when enabled and on navigation, to always send the first one
+
+    void OnViewportTimer(wxTimerEvent& evt);
+
+    void UpdateThumbnailPrefetch(size_t first, size_t count, bool reloadItems);
+    void OnThumbnailReady(wxExplorerBrowserThumbnailEvent& evt);
+
+    // the items whose properties are fetched for RequestItemProperties() on a background thread
+    struct PropertiesRequest
+    {
+        wxExplorerBrowserItem::List items;
+        std::vector<PIDLIST_ABSOLUTE> pidls;
+        wxExplorerBrowserItemProperties properties;
+        std::atomic<bool> cancelled {false};
+
+        // the chunks of the items, those with the visible items first
+        std::vector<size_t> chunkOrder;
+        size_t visibleChunks {0};
+        std::atomic<size_t> visibleChunksLeft {0};
+        // the items visible when requested
+        size_t visibleFirst {0};
+        size_t visibleCount {0};
+
+        ~PropertiesRequest()
+        {
+            for ( auto pidl : pidls )
+                ::CoTaskMemFree(pidl);
+        }
+    };
+
+    // the host for the events queued by the background threads, which can outlive
+    // this object, it is cleared in the destructor under the mutex
+    struct BackgroundEventTarget
+    {
+        std::mutex mutex;
+        wxExplorerBrowserHostWindow* host {nullptr};
+    };
+
+    std::shared_ptr<PropertiesRequest> m_propertiesRequest; // the last one, until its event is sent
+    std::shared_ptr<BackgroundEventTarget> m_backgroundEventTarget; // created when first used
+    // fetching the properties blocks on the file system, so it is done on threads
+    // of its own rather than on the process-wide pool meant for the CPU-bound work
+    std::unique_ptr<wxExplorerBrowserThreadPool> m_propertiesPool; // created when first used
+    wxExplorerBrowserWorkerThread m_propertiesThread; // runs the requests
+
+    wxExplorerBrowserThreadPool& GetPropertiesPool();
+
+    bool CollectItemsWithIDLists(wxExplorerBrowserItem::List& items, std::vector<PIDLIST_ABSOLUTE>& pidls,
+                                 wxUint32 itemTypes, std::vector<size_t>* viewIndices = nullptr);
+    static void QueueItemPropertiesEvent(const std::shared_ptr<PropertiesRequest>& request,
+                                         const std::shared_ptr<BackgroundEventTarget>& target, bool complete);
+    void OnItemProperties(wxExplorerBrowserItemPropertiesEvent& evt);
+
+    // not null from the start of a computation until its completed event is sent
+    std::unique_ptr<wxExplorerBrowserFolderSizer> m_folderSizer;
+    wxTimer m_folderSizeTimer;
+
+    void EndFolderSizeCalculation(bool cancel);
+    void OnFolderSizeTimer(wxTimerEvent& evt);
+    void SendFolderSizeEvent(wxEventType command, const wxExplorerBrowserFolderSizer& folderSizer);
+
+    // not null from the start of an enumeration until its completed event is sent
+    std::unique_ptr<wxExplorerBrowserRecursiveEnumerator> m_recursiveEnumerator;
+    wxTimer m_enumerationTimer;
+
+    void EndRecursiveEnumeration(bool cancel);
+    void OnEnumerationTimer(wxTimerEvent& evt);
+    void SendEnumerationEvent(wxEventType command, const wxExplorerBrowserRecursiveEnumerator& enumerator,
+                              wxExplorerBrowserItem::List* items = nullptr);
+
+    wxExplorerBrowserResizeCoalescer m_resizeCoalescer;
+    wxTimer m_resizeTimer;
+    wxWindow* m_topLevelParent {nullptr}; // its interactive resizing is tracked
+
+    void TrackTopLevelParent(bool track);
+    void ApplyPendingSize();
+    void UpdateResizeTimer();
+    void OnResizeTimer(wxTimerEvent& evt);
+    void OnTopLevelParentMoveStart(wxMoveEvent& evt);
+    void OnTopLevelParentMoveEnd(wxMoveEvent& evt);
+
+    bool GetCurrentView(wxCOMPtr<IShellView>& sv);
+    bool GetCurrentView(wxCOMPtr<IFolderView2>& sv);
+
+    // the returned pidl must be freed with ::CoTaskMemFree()
+    bool GetCurrentFolder(PIDLIST_ABSOLUTE& pidl);
+
+    static bool ShellItemArrayToExplorerBrowserItemList(wxCOMPtr<IShellItemArray> shellItems,
+                                                        wxExplorerBrowserItem::List& items, wxUint32 itemTypes,
+                                                        ItemsFillMode mode = Items_Overwrite,
+                                                        wxExplorerBrowserItemCache* cache = nullptr,
+                                                        std::vector<PIDLIST_ABSOLUTE>* pidls = nullptr,
+                                                        std::vector<size_t>* viewIndices = nullptr);
+};
+
+wxExplorerBrowser::wxExplorerBrowserImpl::~wxExplorerBrowserImpl()
+{
+    // waits for the extractions in progress, which may queue events for m_host
+    m_thumbnails.Disable();
+
+    m_resizeTimer.Stop();
+    TrackTopLevelParent(false);
+
+    m_changeTimer.Stop();
+    UnregisterChangeNotify();
+    m_searchTimer.Stop();
+    m_resultTimer.Stop();
+    m_viewportTimer.Stop();
+    m_folderSizeTimer.Stop();
+    if ( m_folderSizer )
+        m_folderSizer->Cancel();
+    GetReaper().Destroy(std::move(m_folderSizer));
+    m_enumerationTimer.Stop();
+    if ( m_recursiveEnumerator )
+        m_recursiveEnumerator->Cancel();
+    GetReaper().Destroy(std::move(m_recursiveEnumerator));
+
+    // waits only for the chunks being fetched, the others are skipped when cancelled
+    CancelItemPropertiesRequest();
+    m_propertiesThread.Stop();
+    m_propertiesPool.reset();
+    if ( m_backgroundEventTarget )
+    {
+        std::lock_guard<std::mutex> lock(m_backgroundEventTarget->mutex);
+
+        m_backgroundEventTarget->host = nullptr;
+    }
+
+    m_host->SetMessageHandler(wxExplorerBrowserHostWindow::MessageHandler());
+    m_host->Unbind(wxEVT_EXPLORER_BROWSER_NAVIGATION_COMPLETE, &wxExplorerBrowserImpl::OnNavigationComplete, this);
+    m_host->Unbind(wxEVT_EXPLORER_BROWSER_ITEM_PROPERTIES, &wxExplorerBrowserImpl::OnItemProperties, this);
+    m_host->Unbind(wxEVT_EXPLORER_BROWSER_THUMBNAIL_READY, &wxExplorerBrowserImpl::OnThumbnailReady, this);
+
+    if ( m_explorerBrowserHelper && m_explorerBrowserHelper->_GetEventQueue() )
+    {
+        m_host->Unbind(wxEVT_IDLE, &wxExplorerBrowserImpl::OnIdle, this);
+        m_explorerBrowserHelper->_SetEventQueue(nullptr);
+    }
+
+    if ( m_parked )
+        GetParkingLot().Unpark(this);
+
+    DestroyExplorerBrowser();
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::DestroyExplorerBrowser()
+{
+    if ( m_explorerBrowser )
+    {
+        HRESULT hr;
+
+        if ( m_explorerBrowserHelper )
+        {
+            hr = Call_IUnknown_SetSite(m_explorerBrowser, nullptr);
+            if ( FAILED(hr) )
+                wxLogApiError(wxS("Call_IUnknown_SetSite()"), hr);
+
+            hr = m_explorerBrowser->Unadvise(m_adviseCookie);
+            if ( FAILED(hr) )
+                wxLogApiError(wxS("IExplorerBrowser::Unadvise()"), hr);
+
+            m_explorerBrowserHelper->_UnadviseViewEvents();
+
+            wxCOMPtr<IFolderFilterSite> ffs;
+
+            hr = m_explorerBrowser->QueryInterface(wxIID_PPV_ARGS(IFolderFilterSite, &ffs));
+            if ( SUCCEEDED(hr) )
+            {
+                hr = ffs->SetFilter(nullptr);
+                if ( FAILED(hr) )
+                    wxLogApiError(wxS("IFolderFilterSite::SetFilter(nullptr)"), hr);
+            }
+            else
+                wxLogApiError(wxS("IExplorerBrowser::QueryInterface(IFolderFilterSite)"), hr);
+        }
+
+        hr = m_explorerBrowser->Destroy();
+        if ( FAILED(hr) )
+            wxLogApiError(wxS("IExplorerBrowser::Destroy()"), hr);
+
+        m_explorerBrowser.reset();
+    }
+
+    if ( m_explorerBrowserHelper )
+        m_explorerBrowserHelper->_SetExplorerBrowser(nullptr);
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::Create(const CreateStruct& createStruct,
+                                                      const wxString& path)
+{
+    wxCHECK(m_host, false); // the host window must be already created
+    wxCHECK(!m_explorerBrowser, false); // prevent attempted multiple calls to Create()
+
+    if ( !Initialize(createStruct) )
+        return false;
+
+    return BrowseTo(path, false);
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::Initialize(const CreateStruct& createStruct)
+{
+    HRESULT hr;
+
+    hr = ::CoCreateInstance(CLSID_ExplorerBrowser, nullptr, CLSCTX_INPROC,
+                wxIID_PPV_ARGS(IExplorerBrowser, &m_explorerBrowser));
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("CoCreateInstance(CLSID_ExplorerBrowser)"), hr);
+        return false;
+    }
+
+    if ( m_explorerBrowserHelper )
+    {
+        // revived after being torn down while parked,
+        // the helper has kept the filter and pane settings
+        m_explorerBrowserHelper->_SetExplorerBrowser(m_explorerBrowser.get());
+    }
+    else
+    {
+        m_explorerBrowserHelper = new wxExplorerBrowserImplHelper(m_host, m_explorerBrowser.get());
+
+        // new wxExplorerBrowserImplHelper() creates the object with refcount = 1.
+        // wxCOMPtr lacks an attach-like method, assigning its value with operator=
+        // increases the refcount of the contained object to 2, which is wrong here,
+        // so we have to work around it and decrease the count back by calling Release()
+        // otherwise the owned object would never get destroyed.
+        m_explorerBrowserHelper->Release();
+
+        m_explorerBrowserHelper->_SetPaneSettings(createStruct.paneSettings);
+    }
+
+    hr = m_explorerBrowser->SetOptions(static_cast<::EXPLORER_BROWSER_OPTIONS>(createStruct.options));
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IExplorerBrowser::SetOptions()"), hr);
+        return false;
+    }
+
+    hr = Call_IUnknown_SetSite(m_explorerBrowser,
+        static_cast<IUnknown*>(static_cast<IServiceProvider*>(m_explorerBrowserHelper)));
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("Call_IUnknown_SetSite()"), hr);
+        return false;
+    }
+
+    wxCOMPtr<IFolderFilterSite> ffs;
+
+    hr = m_explorerBrowser->QueryInterface(wxIID_PPV_ARGS(IFolderFilterSite, &ffs));
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IExplorerBrowser::QueryInterface(IFolderFilterSite)"), hr);
+        return false;
+    }
+
+    hr = ffs->SetFilter(static_cast<IUnknown*>(static_cast<IServiceProvider*>(m_explorerBrowserHelper)));
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IFolderFilterSite::SetFilter()"), hr);
+        return false;
+    }
+
+    RECT r = {0};
+    FOLDERSETTINGS fs = {0};
+
+    fs.ViewMode = createStruct.folderSettings.m_viewMode;
+    fs.fFlags = createStruct.folderSettings.m_flags;
+
+    hr = m_explorerBrowser->Initialize(m_host->GetHWND(), &r, &fs);
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IExplorerBrowser::Initialize()"), hr);
+        return false;
+    }
+
+    hr = m_explorerBrowser->Advise(m_explorerBrowserHelper, &m_adviseCookie);
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IExplorerBrowser::Advise()"), hr);
+        return false;
+    }
+
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::SetFolderSettings(const FolderSettings& folderSettings)
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    HRESULT hr;
+    FOLDERSETTINGS fs = {0};
+
+    fs.ViewMode = folderSettings.m_viewMode;
+    fs.fFlags = folderSettings.m_flags;
+
+    hr = m_explorerBrowser->SetFolderSettings(&fs);
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IExplorerBrowser::SetFolderSettings()"), hr);
+        return false;
+    }
+
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::SetPropertyBag(const wxString& bag)
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    HRESULT hr;
+
+    hr = m_explorerBrowser->SetPropertyBag(bag.wc_str());
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IExplorerBrowser::SetPropertyBag()"), hr);
+        return false;
+    }
+
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::GetOptions(wxUint32& options)
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    HRESULT hr;
+    ::EXPLORER_BROWSER_OPTIONS ebo = static_cast<::EXPLORER_BROWSER_OPTIONS>(options);
+
+    hr = m_explorerBrowser->GetOptions(&ebo);
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IExplorerBrowser::GetOptions()"), hr);
+        return false;
+    }
+
+    options = ebo;
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::SetOptions(wxUint32 options)
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    HRESULT hr;
+
+    hr = m_explorerBrowser->SetOptions(static_cast<::EXPLORER_BROWSER_OPTIONS>(options));
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IExplorerBrowser::SetOptions()"), hr);
+        return false;
+    }
+
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::SetEmptyText(const wxString& text)
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    HRESULT hr;
+
+    hr = m_explorerBrowser->SetEmptyText(text.wc_str());
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IExplorerBrowser::()"), hr);
+        return false;
+    }
+
+    return true;
+}
+
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::BrowseTo(const wxString& item, bool keepWordWheelText)
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    HRESULT hr;
+    PIDLIST_ABSOLUTE pidl = nullptr;
+
+    hr = ::SHParseDisplayName(PCWSTR(item.wc_str()), nullptr, &pidl, 0, nullptr);
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("SHParseDisplayName()"), hr);
+        return false;
+    }
+
+    UINT flags = 0;
+
+    if ( keepWordWheelText )
+        flags |= SBSP_KEEPWORDWHEELTEXT;
+
+
+    hr = m_explorerBrowser->BrowseToIDList(pidl, flags);
+    ::CoTaskMemFree(pidl);
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IExplorerBrowser::BrowseToIDList()"), hr);
+        return false;
+    }
+
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::BrowseTo(BrowseTarget target, bool keepWordWheelText)
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    UINT flags;
+
+    switch ( target )
+    {
+        case Parent:
+            flags = SBSP_PARENT;
+            break;
+        case HistoryBack:
+            flags = SBSP_NAVIGATEBACK;
+            break;
+        case HistoryForward:
+            flags = SBSP_NAVIGATEFORWARD;
+            break;
+        default:
+            wxFAIL_MSG(wxS("Invalid item value"));
+            return false;
+    }
+
+    if ( keepWordWheelText )
+        flags |= SBSP_KEEPWORDWHEELTEXT;
+
+    HRESULT hr;
+
+    hr = m_explorerBrowser->BrowseToIDList(nullptr, flags);
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IExplorerBrowser::BrowseToIDList()"), hr);
+        return false;
+    }
+
+    return true;
+}
+
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::Refresh()
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    InvalidateCurrentFolderItems();
+    m_quickFinder.Reset();
+    m_searchIndex.SetStale();
+
+    return RefreshView();
+}
+
+// only makes the view enumerate the folder again, the cached items stay valid
+bool wxExplorerBrowser::wxExplorerBrowserImpl::RefreshView()
+{
+    HRESULT hr;
+    wxCOMPtr<IShellView> sv;
+
+    if ( !GetCurrentView(sv) )
+        return false;
+
+    hr = sv->Refresh();
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IShellView::Refresh()"), hr);
+        return false;
+    }
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::SearchFolder(const wxString& str)
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    if ( !m_searchPipelineEnabled )
+        return FilterView(str);
+
+    wxString cancelled;
+
+    if ( m_searchScheduler.Submit(str, ::GetTickCount64(), &cancelled) )
+        SendSearchEvent(wxEVT_EXPLORER_BROWSER_SEARCH_COMPLETED, cancelled, true);
+
+    UpdateSearchTimer();
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::EnableSearchPipeline(bool enable, int debounceDelay)
+{
+    wxCHECK(debounceDelay >= 0, false);
+
+    m_searchPipelineEnabled = enable;
+    m_searchScheduler.SetDelays(static_cast<wxUint64>(debounceDelay));
+
+    if ( !enable )
+    {
+        if ( m_searchScheduler.IsInFlight() )
+            SendSearchEvent(wxEVT_EXPLORER_BROWSER_SEARCH_COMPLETED, m_searchScheduler.GetInFlightQuery(), true);
+        m_searchScheduler.Reset();
+        m_searchTimer.Stop();
+    }
+
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::FilterView(const wxString& str)
+{
+    HRESULT hr;
+    wxCOMPtr<IShellView> sv;
+
+    if ( !GetCurrentView(sv) )
+        return false;
+
+    wxCOMPtr<IDispatch> d;
+    wxCOMPtr<IShellFolderViewDual3> sfvd3;
+
+    hr = sv->GetItemObject(SVGIO_BACKGROUND, wxIID_PPV_ARGS(IDispatch, &d));
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IShellView::GetItemObject(SVGIO_BACKGROUND)"), hr);
+        return false;
+    }
+
+    hr = d->QueryInterface(wxIID_PPV_ARGS(IShellFolderViewDual3, &sfvd3));
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IDispatch::QueryInterface(IShellFolderViewDual3)"), hr);
+        return false;
+    }
+
+    hr = sfvd3->FilterView(BSTR(str.wc_str()));
+    if  ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IShellFolderViewDual3::FilterView()"), hr);
+        return false;
+    }
+
+    return true;
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::UpdateSearchTimer()
+{
+    wxUint64 deadline;
+
+    if ( !m_searchScheduler.GetDeadline(deadline) )
+    {
+        m_searchTimer.Stop();
+        return;
+    }
+
+    const wxUint64 now = ::GetTickCount64();
+    const int delay = deadline > now ? static_cast<int>(deadline - now) : 1;
+
+    m_searchTimer.StartOnce(delay);
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::OnSearchTimer(wxTimerEvent& WXUNUSED(evt))
+{
+    const wxUint64 now = ::GetTickCount64();
+
+    switch ( m_searchScheduler.OnTimer(now) )
+    {
+        case wxExplorerBrowserSearchScheduler::Action_Start:
+        {
+            // copy the query, it can be cancelled while FilterView() runs
+            const wxString query = m_searchScheduler.GetInFlightQuery();
+
+            SendSearchEvent(wxEVT_EXPLORER_BROWSER_SEARCH_PROGRESS, query);
+            if ( !FilterView(query) && m_searchScheduler.IsInFlight()
+                 && m_searchScheduler.GetInFlightQuery() == query )
+            {
+                m_searchScheduler.Complete();
+                SendSearchEvent(wxEVT_EXPLORER_BROWSER_SEARCH_COMPLETED, query, true);
+            }
+            break;
+        }
+
+        case wxExplorerBrowserSearchScheduler::Action_Poll:
+        {
+            wxCOMPtr<IFolderView2> fv2;
+            int count = 0;
+
+            if ( SUCCEEDED(m_explorerBrowser->GetCurrentView(wxIID_PPV_ARGS(IFolderView2, &fv2)))
+                 && SUCCEEDED(fv2->ItemCount(SVGIO_ALLVIEW, &count)) )
+            {
+                if ( m_searchScheduler.UpdateProgress(static_cast<size_t>(count), now) )
+                    SendSearchEvent(wxEVT_EXPLORER_BROWSER_SEARCH_PROGRESS, m_searchScheduler.GetInFlightQuery());
+            }
+            else
+            {
+                // the view is being replaced with the one showing the results
+                m_searchScheduler.UpdateProgress(m_searchScheduler.GetResultCount(), now);
+            }
+            break;
+        }
+
+        case wxExplorerBrowserSearchScheduler::Action_Complete:
+            SendSearchEvent(wxEVT_EXPLORER_BROWSER_SEARCH_COMPLETED, m_searchScheduler.GetInFlightQuery());
+            break;
+
+        case wxExplorerBrowserSearchScheduler::Action_None:
+            break;
+    }
+
+    UpdateSearchTimer();
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::SendSearchEvent(wxEventType command, const wxString& str,
+                                                               bool cancelled)
+{
+    wxExplorerBrowserProgressEvent evt(command, m_host->GetId());
+
+    evt.SetEventObject(m_host);
+    evt.SetString(str);
+    evt.SetProcessed(m_searchScheduler.GetResultCount());
+    evt.SetCancelled(cancelled);
+    m_host->ProcessWindowEvent(evt);
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::RemoveAll()
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    HRESULT hr;
+
+    CancelAddingResults();
+
+    hr = m_explorerBrowser->RemoveAll();
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IExplorerBrowser::RemoveAll()"), hr);
+        return false;
+    }
+
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::AddResults(const wxArrayString& paths)
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    if ( !PrepareResultsFolder() )
+        return false;
+
+    m_resultInjector.AddPaths(paths, ::GetTickCount64());
+    UpdateResultTimer();
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::AddResults(const std::vector<wxExplorerBrowserResultInjector::IDList>& idLists)
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    if ( !PrepareResultsFolder() )
+        return false;
+
+    m_resultInjector.AddIDLists(idLists, ::GetTickCount64());
+    UpdateResultTimer();
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::CancelAddingResults()
+{
+    m_resultTimer.Stop();
+
+    if ( !m_resultInjector.HasPending() )
+        return true;
+
+    m_resultInjector.Cancel();
+    SendResultsEvent(wxEVT_EXPLORER_BROWSER_RESULTS_COMPLETED, true);
+
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::SetResultBatchLimits(int batchTime, int batchInterval)
+{
+    wxCHECK(batchTime > 0, false);
+    wxCHECK(batchInterval >= 0, false);
+
+    m_resultInjector.SetLimits(static_cast<wxUint64>(batchTime), static_cast<wxUint64>(batchInterval));
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::GetResultsFolder(wxCOMPtr<IResultsFolder>& rf)
+{
+    wxCOMPtr<IFolderView2> fv2;
+
+    // failing is expected when the view does not display a results folder,
+    // so no errors are logged here
+    return SUCCEEDED(m_explorerBrowser->GetCurrentView(wxIID_PPV_ARGS(IFolderView2, &fv2)))
+           && SUCCEEDED(fv2->GetFolder(wxIID_PPV_ARGS(IResultsFolder, &rf)));
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::PrepareResultsFolder()
+{
+    wxCOMPtr<IResultsFolder> rf;
+
+    if ( GetResultsFolder(rf) )
+        return true;
+
+    HRESULT hr;
+
+    // displays an empty results folder
+    hr = m_explorerBrowser->FillFromObject(nullptr, EBF_NODROPTARGET);
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IExplorerBrowser::FillFromObject()"), hr);
+        return false;
+    }
+
+    if ( !GetResultsFolder(rf) )
+    {
+        wxLogDebug(wxS("wxExplorerBrowser: the view does not display a results folder"));
+        return false;
+    }
+
+    return true;
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::UpdateResultTimer()
+{
+    wxUint64 deadline;
+
+    if ( !m_resultInjector.GetDeadline(deadline) )
+    {
+        m_resultTimer.Stop();
+        return;
+    }
+
+    const wxUint64 now = ::GetTickCount64();
+    const int delay = deadline > now ? static_cast<int>(deadline - now) : 1;
+
+    m_resultTimer.StartOnce(delay);
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::OnResultTimer(wxTimerEvent& WXUNUSED(evt))
+{
+    wxCOMPtr<IResultsFolder> rf;
+
+    if ( !m_explorerBrowser || !GetResultsFolder(rf) )
+    {
+        // the browser navigated away from the results
+        CancelAddingResults();
+        return;
+    }
+
+    const auto sink = [&rf](const wxExplorerBrowserResultInjector::Entry& entry)
+    {
+        HRESULT hr;
+
+        if ( entry.IsIDList() )
+        {
+            if ( !wxExplorerBrowserResultInjector::IsValidIDList(entry.idList) )
+                return false;
+
+            hr = rf->AddIDList(reinterpret_cast<PCIDLIST_ABSOLUTE>(entry.idList.data()), nullptr);
+        }
+        else
+        {
+            wxCOMPtr<IShellItem> si;
+
+            hr = ::SHCreateItemFromParsingName(entry.path.wc_str(), nullptr, wxIID_PPV_ARGS(IShellItem, &si));
+            if ( SUCCEEDED(hr) )
+                hr = rf->AddItem(si);
+        }
+
+        return SUCCEEDED(hr);
+    };
+
+    m_resultInjector.ProcessBatch(sink, [] { return static_cast<wxUint64>(::GetTickCount64()); });
+
+    if ( m_resultInjector.HasPending() )
+        SendResultsEvent(wxEVT_EXPLORER_BROWSER_RESULTS_PROGRESS);
+    else
+        SendResultsEvent(wxEVT_EXPLORER_BROWSER_RESULTS_COMPLETED);
+
+    // the event handler may have added more results
+    UpdateResultTimer();
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::SendResultsEvent(wxEventType command, bool cancelled)
+{
+    wxExplorerBrowserProgressEvent evt(command, m_host->GetId());
+
+    evt.SetEventObject(m_host);
+    evt.SetProcessed(m_resultInjector.GetProcessed());
+    evt.SetTotal(m_resultInjector.GetTotal());
+    evt.SetFailed(m_resultInjector.GetFailed());
+    evt.SetCancelled(cancelled);
+    m_host->ProcessWindowEvent(evt);
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::SelectItems(const wxExplorerBrowserItem::List& items, bool notTakeFocus)
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    HRESULT hr;
+    wxCOMPtr<IShellView> sv;
+    wxCOMPtr<IFolderView2> fv2;
+
+    if ( !GetCurrentView(sv) )
+        return false;
+
+    if ( !GetCurrentView(fv2) )
+        return false;
+
+    wxCOMPtr<IShellFolder> sf;
+
+    hr = fv2->GetFolder(wxIID_PPV_ARGS(IShellFolder, &sf));
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IFolderView2::GetFolder()"), hr);
+        return false;
+    }
+
+
+    PIDLIST_RELATIVE pidl = nullptr;
+
+    for ( const auto& item : items )
+    {
+        const wxString& name = item.GetPath().empty() ? item.GetDisplayName() : item.GetPath();
+
+        hr = sf->ParseDisplayName(nullptr, nullptr, LPWSTR(name.wc_str()), nullptr, &pidl, nullptr);
+        if ( FAILED(hr) )
+        {
+            wxLogApiError(wxS("IShellFolder::ParseDisplayName()"), hr);
+            return false;
+        }
+
+        UINT flags = SVSI_SELECT;
+
+        if ( notTakeFocus )
+            flags |= SVSI_NOTAKEFOCUS;
+
+        hr = sv->SelectItem(pidl, flags);
+        ::CoTaskMemFree(pidl);
+        if ( FAILED(hr) )
+        {
+            wxLogApiError(wxS("IShellView::SelectItem()"), hr);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::SelectWhere(const ItemPredicate& predicate, bool notTakeFocus,
+                                                           size_t* selectedCount)
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    HRESULT hr;
+    wxCOMPtr<IFolderView2> fv2;
+
+    if ( !GetCurrentView(fv2) )
+        return false;
+
+    int count = 0;
+
+    hr = fv2->ItemCount(SVGIO_ALLVIEW, &count);
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IFolderView2::ItemCount()"), hr);
+        return false;
+    }
+
+    // the same item is used for all items, so its string buffers are reused
+    wxExplorerBrowserItem ebi;
+    std::vector<PITEMID_CHILD> matching;
+    bool ok = true;
+
+    for ( int i = 0; i < count && ok; ++i )
+    {
+        wxCOMPtr<IShellItem> si;
+
+        hr = fv2->GetItem(i, wxIID_PPV_ARGS(IShellItem, &si));
+        if ( FAILED(hr) )
+        {
+            wxLogApiError(wxS("IFolderView2::GetItem()"), hr);
+            ok = false;
+            break;
+        }
+
+        ok = wxExplorerBrowserImplHelper::_IShellItem2wxExplorerBrowserItem(si, ebi, m_itemCache);
+        if ( !ok || !predicate(ebi) )
+            continue;
+
+        PITEMID_CHILD pidl = nullptr;
+
+        hr = fv2->Item(i, &pidl);
+        if ( FAILED(hr) )
+        {
+            wxLogApiError(wxS("IFolderView2::Item()"), hr);
+            ok = false;
+            break;
+        }
+        matching.push_back(pidl);
+    }
+
+    // selecting the items one by one makes the view update
+    // its selection and notify the browser for every item
+    if ( ok && !matching.empty() )
+    {
+        DWORD flags = SVSI_SELECT;
+
+        if ( notTakeFocus )
+            flags |= SVSI_NOTAKEFOCUS;
+
+        hr = fv2->SelectAndPositionItems(static_cast<UINT>(matching.size()),
+                                         reinterpret_cast<PCUITEMID_CHILD_ARRAY>(matching.data()), nullptr, flags);
+        if ( FAILED(hr) )
+        {
+            wxLogApiError(wxS("IFolderView2::SelectAndPositionItems()"), hr);
+            ok = false;
+        }
+    }
+
+    if ( ok && selectedCount )
+        *selectedCount = matching.size();
+
+    for ( auto pidl : matching )
+        ::CoTaskMemFree(pidl);
+
+    return ok;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::DeselectAllItems(bool notTakeFocus)
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    wxCOMPtr<IShellView> sv;
+
+    if ( !GetCurrentView(sv) )
+        return false;
+
+    HRESULT hr;
+    UINT flags = SVSI_DESELECTOTHERS;
+
+    if ( notTakeFocus )
+        flags |= SVSI_NOTAKEFOCUS;
+
+    hr = sv->SelectItem(nullptr, flags);
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IShellView::SelectItem()"), hr);
+        return false;
+    }
+
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::GetSelectedItems(wxExplorerBrowserItem::List& items,
+                                                                wxUint32 itemTypes, ItemsFillMode mode)
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    HRESULT hr;
+    wxCOMPtr<IFolderView2> fv2;
+
+    if ( !GetCurrentView(fv2) )
+        return false;
+
+    wxCOMPtr<IShellItemArray> sia;
+
+    hr = fv2->GetSelection(FALSE, &sia);
+    if ( FAILED(hr) ) // no items selected
+    {
+        return true;
+    }
+
+    if ( !ShellItemArrayToExplorerBrowserItemList(sia, items, itemTypes, mode, m_itemCache) )
+        return false;
+
+    CheckMemoryBudget();
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::GetAllItems(wxExplorerBrowserItem::List& items,
+                                                           wxUint32 itemTypes, ItemsFillMode mode)
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    HRESULT hr;
+    wxCOMPtr<IFolderView2> fv2;
+
+    if ( !GetCurrentView(fv2) )
+        return false;
+
+    wxCOMPtr<IShellItemArray> sia;
+
+    hr = fv2->Items(SVGIO_ALLVIEW | SVGIO_FLAG_VIEWORDER, wxIID_PPV_ARGS(IShellItemArray, &sia));
+    if ( FAILED(hr) ) // no items
+    {
+        wxLogApiError(wxS("IFolderView2::Items()"), hr);
+        return false;
+    }
+
+    if ( !ShellItemArrayToExplorerBrowserItemList(sia, items, itemTypes, mode, m_itemCache) )
+        return false;
+
+    CheckMemoryBudget();
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::GetAllItemsSorted(wxExplorerBrowserItem::List& items,
+                                                                 wxExplorerBrowserItemSorter::Order order,
+                                                                 wxUint32 itemTypes)
+{
+    if ( !GetAllItems(items, itemTypes, Items_Overwrite) )
+        return false;
+
+    wxExplorerBrowserItemSorter::Sort(items, order);
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::CollectItemsWithIDLists(wxExplorerBrowserItem::List& items,
+                                                                       std::vector<PIDLIST_ABSOLUTE>& pidls,
+                                                                       wxUint32 itemTypes,
+                                                                       std::vector<size_t>* viewIndices)
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    HRESULT hr;
+    wxCOMPtr<IFolderView2> fv2;
+
+    if ( !GetCurrentView(fv2) )
+        return false;
+
+    wxCOMPtr<IShellItemArray> sia;
+
+    hr = fv2->Items(SVGIO_ALLVIEW | SVGIO_FLAG_VIEWORDER, wxIID_PPV_ARGS(IShellItemArray, &sia));
+    if ( FAILED(hr) ) // no items
+    {
+        wxLogApiError(wxS("IFolderView2::Items()"), hr);
+        return false;
+    }
+
+    return ShellItemArrayToExplorerBrowserItemList(sia, items, itemTypes, Items_Overwrite, m_itemCache,
+                                                   &pidls, viewIndices);
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::GetItemProperties(wxExplorerBrowserItem::List& items,
+                                                                 wxExplorerBrowserItemProperties& properties,
+                                                                 wxUint32 propertyFlags, wxUint32 itemTypes)
+{
+    std::vector<PIDLIST_ABSOLUTE> pidls;
+    const bool ok = CollectItemsWithIDLists(items, pidls, itemTypes);
+
+    if ( ok )
+    {
+        properties.Reset(items.size(), propertyFlags);
+
+        GetPropertiesPool().Run((items.size() + PropertiesChunkSize - 1) / PropertiesChunkSize,
+                                [&pidls, &properties](size_t chunk)
+                                {
+                                    FetchItemProperties(pidls, chunk * PropertiesChunkSize,
+                                                        wxMin((chunk + 1) * PropertiesChunkSize, pidls.size()),
+                                                        properties);
+                                });
+    }
+
+    for ( auto pidl : pidls )
+        ::CoTaskMemFree(pidl);
+
+    if ( !ok )
+        return false;
+
+    CheckMemoryBudget();
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::RequestItemProperties(wxUint32 propertyFlags, wxUint32 itemTypes)
+{
+    CancelItemPropertiesRequest();
+
+    const std::shared_ptr<PropertiesRequest> request = std::make_shared<PropertiesRequest>();
+    std::vector<size_t> viewIndices;
+
+    // only the items are collected on the UI thread, they are needed
+    // right away as the view can change while the properties are fetched
+    if ( !CollectItemsWithIDLists(request->items, request->pidls, itemTypes, &viewIndices) )
+        return false;
+
+    request->properties.Reset(request->items.size(), propertyFlags);
+
+    // the chunks with the visible items are fetched first, then the others,
+    // the closest to them first, and an event is sent when the visible ones are done
+    const size_t chunkCount = (request->items.size() + PropertiesChunkSize - 1) / PropertiesChunkSize;
+    wxExplorerBrowserViewportScheduler chunks;
+    size_t first = 0, count = 0;
+
+    {
+        wxLogNull noLog;
+
+        if ( GetVisibleItemRange(first, count) )
+            MapViewRange(viewIndices, first, count);
+    }
+
+    if ( count )
+    {
+        const size_t firstChunk = first / PropertiesChunkSize;
+
+        chunks.SetViewport(firstChunk, (first + count - 1) / PropertiesChunkSize - firstChunk + 1);
+        request->visibleFirst = first;
+        request->visibleCount = count;
+    }
+
+    chunks.AddRange(0, chunkCount);
+    request->visibleChunks = chunks.TakeAll(request->chunkOrder);
+    if ( !count || request->visibleChunks == chunkCount )
+        request->visibleChunks = 0; // only the complete event is sent
+    request->visibleChunksLeft = request->visibleChunks;
+
+    if ( !m_backgroundEventTarget )
+    {
+        m_backgroundEventTarget = std::make_shared<BackgroundEventTarget>();
+        m_backgroundEventTarget->host = m_host;
+    }
+
+    const std::shared_ptr<BackgroundEventTarget> target = m_backgroundEventTarget;
+    wxExplorerBrowserThreadPool* pool = &GetPropertiesPool();
+
+    // a cancelled request still running is left to finish its chunks being fetched first
+    m_propertiesThread.Post([request, target, pool]()
+    {
+        // the worker thread takes chunks too, those of the properties pool help it
+        pool->Run(request->chunkOrder.size(), [&request, &target](size_t i)
+            {
+                if ( request->cancelled )
+                    return;
+
+                const size_t chunk = request->chunkOrder[i];
+
+                FetchItemProperties(request->pidls, chunk * PropertiesChunkSize,
+                                    wxMin((chunk + 1) * PropertiesChunkSize, request->pidls.size()),
+                                    request->properties);
+
+                if ( i < request->visibleChunks && --request->visibleChunksLeft == 0 )
+                    QueueItemPropertiesEvent(request, target, false);
+            });
+
+        QueueItemPropertiesEvent(request, target, true);
+    });
+
+    m_propertiesRequest = request;
+    return true;
+}
+
+wxExplorerBrowserThreadPool& wxExplorerBrowser::wxExplorerBrowserImpl::GetPropertiesPool()
+{
+    // with the thread calling Run(), up to four threads wait for the file system
+    if ( !m_propertiesPool )
+        m_propertiesPool.reset(new wxExplorerBrowserThreadPool(3));
+
+    return *m_propertiesPool;
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::QueueItemPropertiesEvent(const std::shared_ptr<PropertiesRequest>& request,
+                                                                        const std::shared_ptr<BackgroundEventTarget>& target,
+                                                                        bool complete)
+{
+    std::lock_guard<std::mutex> lock(target->mutex);
+
+    if ( !target->host || request->cancelled )
+        return;
+
+    wxExplorerBrowserItemPropertiesEvent* evt
+        = new wxExplorerBrowserItemPropertiesEvent(wxEVT_EXPLORER_BROWSER_ITEM_PROPERTIES, target->host->GetId());
+
+    // the event shares the request, so that the results are not copied
+    evt->SetEventObject(target->host);
+    evt->SetItems(std::shared_ptr<const wxExplorerBrowserItem::List>(request, &request->items));
+    evt->SetProperties(std::shared_ptr<const wxExplorerBrowserItemProperties>(request, &request->properties));
+    if ( complete )
+        evt->SetReadyRange(0, request->items.size());
+    else
+        evt->SetReadyRange(request->visibleFirst, request->visibleCount);
+    target->host->GetEventHandler()->QueueEvent(evt);
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::CancelItemPropertiesRequest()
+{
+    if ( !m_propertiesRequest )
+        return false;
+
+    m_propertiesRequest->cancelled = true;
+    m_propertiesRequest.reset();
+    return true;
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::OnItemProperties(wxExplorerBrowserItemPropertiesEvent& evt)
+{
+    // the event of a request cancelled after it was queued is dropped
+    if ( !m_propertiesRequest || &evt.GetItems() != &m_propertiesRequest->items )
+        return;
+
+    if ( evt.IsComplete() )
+        m_propertiesRequest.reset();
+    evt.Skip();
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::QuickFind(const wxString& pattern, wxExplorerBrowserItem::List& items,
+                                                         size_t maxResults, std::vector<int>* scores,
+                                                         wxUint32 itemTypes)
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    HRESULT hr;
+    wxCOMPtr<IFolderView2> fv2;
+
+    if ( !GetCurrentView(fv2) )
+        return false;
+
+    int count = 0;
+
+    hr = fv2->ItemCount(SVGIO_ALLVIEW, &count);
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IFolderView2::ItemCount()"), hr);
+        return false;
+    }
+
+    // the items are taken again when the view reports its contents changed,
+    // e.g. a rename, the count is checked too in case it does not send the events
+    const wxUint64 generation = m_explorerBrowserHelper->_GetViewContentsGeneration();
+
+    if ( !m_quickFinder.IsPrepared(itemTypes, count, generation) )
+    {
+        if ( !GetAllItems(m_quickFinder.GetListing(), itemTypes, Items_Overwrite) )
+        {
+            m_quickFinder.Reset();
+            return false;
+        }
+
+        m_quickFinder.Prepare(itemTypes, count, generation);
+    }
+
+    m_quickFinder.Find(pattern, maxResults, items, scores);
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::EnableSearchIndex(bool enable, int filterDelay)
+{
+    wxCHECK(m_explorerBrowserHelper, false);
+    wxCHECK(filterDelay >= 0, false);
+
+    const bool wasFiltering = m_searchIndex.IsFiltering();
+
+    ResetSearchIndex();
+    m_searchIndex.Enable(enable, static_cast<wxUint64>(filterDelay));
+
+    if ( wasFiltering )
+        return RefreshView();
+
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::SearchIndex(const wxString& str, bool filterView, wxArrayString* names)
+{
+    wxCHECK(m_explorerBrowserHelper, false);
+    wxCHECK_MSG(m_searchIndex.IsEnabled(), false, wxS("The search index is not enabled"));
+
+    if ( !BuildSearchIndex() )
+        return false;
+
+    if ( names )
+        m_searchIndex.Find(str, *names);
+
+    // the found names are returned at once, the view is filtered after the delay
+    if ( filterView )
+        m_searchIndex.SubmitFilter(str);
+
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::FilterViewByIndex(const wxString& str)
+{
+    if ( str.empty() )
+    {
+        if ( !m_searchIndex.IsFiltering() )
+            return true;
+
+        m_explorerBrowserHelper->_RemoveVisibleNames();
+        m_searchIndex.SetFiltering(false);
+        return RefreshView();
+    }
+
+    // the index could have been updated since the search
+    if ( !BuildSearchIndex() )
+        return false;
+
+    wxExplorerBrowserImplHelper::NameSet visibleNames;
+
+    m_searchIndex.Find(str, visibleNames);
+    m_explorerBrowserHelper->_SetVisibleNames(m_searchIndex.GetFolder(), std::move(visibleNames));
+    m_searchIndex.SetFiltering(true);
+
+    // the view enumerates the folder again, but shows only the found items;
+    // unlike Refresh(), the cached items and the index stay valid
+    return RefreshView();
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::BuildSearchIndex()
+{
+    PIDLIST_ABSOLUTE pidl = nullptr;
+
+    if ( !GetCurrentFolder(pidl) )
+        return false;
+
+    // read before enumerating, so that the changes made meanwhile index the folder again
+    wxUint64 folderTime = 0;
+    PWSTR path = nullptr;
+
+    if ( SUCCEEDED(::SHGetNameFromIDList(pidl, SIGDN_FILESYSPATH, &path)) )
+    {
+        WIN32_FILE_ATTRIBUTE_DATA data;
+
+        if ( ::GetFileAttributesExW(path, GetFileExInfoStandard, &data) )
+            folderTime = (static_cast<wxUint64>(data.ftLastWriteTime.dwHighDateTime) << 32)
+                         | data.ftLastWriteTime.dwLowDateTime;
+        ::CoTaskMemFree(path);
+    }
+
+    if ( m_searchIndex.IsCurrent(pidl, folderTime, m_changeNotifyId != 0) )
+    {
+        ::CoTaskMemFree(pidl);
+        return true;
+    }
+
+    wxExplorerBrowserItem::List items;
+
+    if ( !EnumerateFolder(pidl, items) )
+    {
+        ::CoTaskMemFree(pidl);
+        return false;
+    }
+
+    m_searchIndex.SetItems(pidl, folderTime, items);
+
+    CheckMemoryBudget();
+    return true;
+}
+
+// the items of the folder the view would show without SearchIndex() filtering it,
+// enumerated by the shell because the view has only the items found by the last search
+bool wxExplorerBrowser::wxExplorerBrowserImpl::EnumerateFolder(PCIDLIST_ABSOLUTE folder,
+                                                               wxExplorerBrowserItem::List& items)
+{
+    HRESULT hr;
+    wxCOMPtr<IShellFolder> sf;
+
+    hr = ::SHBindToObject(nullptr, folder, nullptr, wxIID_PPV_ARGS(IShellFolder, &sf));
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("SHBindToObject(IShellFolder)"), hr);
+        return false;
+    }
+
+    // the hidden items as the view shows them
+    SHELLSTATE state = {0};
+    SHCONTF flags = SHCONTF_FOLDERS | SHCONTF_NONFOLDERS;
+
+    ::SHGetSetSettings(&state, SSF_SHOWALLOBJECTS, FALSE);
+    if ( state.fShowAllObjects )
+        flags |= SHCONTF_INCLUDEHIDDEN;
+
+    wxCOMPtr<IEnumIDList> enumIDList;
+
+    hr = sf->EnumObjects(m_host->GetHWND(), flags, &enumIDList);
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IShellFolder::EnumObjects()"), hr);
+        return false;
+    }
+
+    items.clear();
+    if ( hr == S_FALSE || !enumIDList ) // no items
+        return true;
+
+    const wxExplorerBrowserIgnoreRules::DirectoryRulesPtr ignoreRules = m_explorerBrowserHelper->_GetIgnoreRules(folder);
+    PITEMID_CHILD child = nullptr;
+    wxString buffer;
+
+    while ( enumIDList->Next(1, &child, nullptr) == S_OK )
+    {
+        wxCOMPtr<IShellItem> si;
+        wxExplorerBrowserItem ebi;
+
+        if ( SUCCEEDED(::SHCreateItemWithParent(nullptr, sf, child, wxIID_PPV_ARGS(IShellItem, &si)))
+             && wxExplorerBrowserImplHelper::_IShellItem2wxExplorerBrowserItem(si, ebi, m_itemCache)
+             && ebi.GetType() != wxExplorerBrowserItem::Unknown
+             && !m_explorerBrowserHelper->_IsFilteredOut(ebi, ignoreRules, buffer) )
+            items.push_back(std::move(ebi));
+
+        ::CoTaskMemFree(child);
+    }
+
+    return true;
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::ResetSearchIndex()
+{
+    m_searchIndex.Reset();
+
+    if ( m_searchIndex.IsFiltering() )
+    {
+        m_explorerBrowserHelper->_RemoveVisibleNames();
+        m_searchIndex.SetFiltering(false);
+    }
+}
+
+// a new item is shown in the filtered view only when found by the next search
+void wxExplorerBrowser::wxExplorerBrowserImpl::UpdateSearchIndex(wxExplorerBrowserItemChange::Type type,
+                                                                 PCIDLIST_ABSOLUTE pidl)
+{
+    if ( type != wxExplorerBrowserItemChange::Created && type != wxExplorerBrowserItemChange::Deleted )
+        return;
+
+    // named as when indexing, i.e. by the display name if it is not a filesystem item
+    wxExplorerBrowserItem ebi;
+
+    {
+        wxLogNull noLog; // a deleted item may be gone for the shell already
+
+        if ( !wxExplorerBrowserImplHelper::_PPIDL2wxExplorerBrowserItem(pidl, ebi, nullptr) )
+        {
+            m_searchIndex.SetStale();
+            return;
+        }
+    }
+
+    wxString name;
+
+    if ( type == wxExplorerBrowserItemChange::Created )
+    {
+        // as in EnumerateFolder()
+        if ( ebi.GetType() == wxExplorerBrowserItem::Unknown
+             || m_explorerBrowserHelper->_IsFilteredOut(ebi,
+                                                        m_explorerBrowserHelper->_GetIgnoreRules(m_searchIndex.GetFolder()),
+                                                        name) )
+            return;
+
+        wxExplorerBrowserMaskMatcher::GetItemName(ebi, name);
+        m_searchIndex.Add(name);
+    }
+    else
+    {
+        wxExplorerBrowserMaskMatcher::GetItemName(ebi, name);
+        m_searchIndex.Remove(name);
+    }
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::ExportSnapshot(const wxString& fileName, wxUint32 itemTypes)
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    wxExplorerBrowserItem folder;
+    wxExplorerBrowserItem::List items;
+
+    if ( !GetFolder(folder) || !GetAllItems(items, itemTypes, Items_Overwrite) )
+        return false;
+
+    // virtual folders do not have a path
+    const wxString folderPath = folder.GetPath().empty() ? folder.GetDisplayName() : folder.GetPath();
+
+    return wxExplorerBrowserSnapshot::Write(fileName, folderPath, items);
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::GetItemChanges(wxExplorerBrowserListingDelta& delta,
+                                                              wxUint32 itemTypes)
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    wxExplorerBrowserItem::List items;
+
+    if ( !GetAllItems(items, itemTypes, Items_Overwrite) )
+        return false;
+
+    if ( itemTypes != m_listingFingerprintTypes )
+    {
+        m_listingFingerprint.Clear();
+        m_listingFingerprintTypes = itemTypes;
+    }
+
+    // the fingerprint takes over the listing, there is no need for another copy of it
+    m_listingFingerprint.Update(std::move(items), &delta);
+    CheckMemoryBudget();
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::ResetItemChanges()
+{
+    m_listingFingerprint.Clear();
+    m_listingFingerprintTypes = 0;
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::GetFolder(wxExplorerBrowserItem& item)
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    PIDLIST_ABSOLUTE pidl = nullptr;
+
+    if ( !GetCurrentFolder(pidl) )
+        return false;
+
+    const bool result = wxExplorerBrowserImplHelper::_PPIDL2wxExplorerBrowserItem(pidl, item);
+    ::CoTaskMemFree(pidl);
+
+    return result;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::SetFilter(const wxArrayString& fileMasks, wxUint32 itemTypes)
+{
+    wxCHECK(m_explorerBrowserHelper, false);
+
+    return m_explorerBrowserHelper->_SetFilter(fileMasks, itemTypes);
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::RemoveFilter()
+{
+    wxCHECK(m_explorerBrowserHelper, false);
+
+    return m_explorerBrowserHelper->_RemoveFilter();
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::SetIgnoreRules(const wxString& root, const wxString& fileName,
+                                                             const wxString& globalRules)
+{
+    wxCHECK(m_explorerBrowserHelper, false);
+
+    PIDLIST_ABSOLUTE pidl = nullptr;
+
+    // there is no folder before the first navigation
+    {
+        wxLogNull noLog;
+
+        GetCurrentFolder(pidl);
+    }
+
+    const bool result = m_explorerBrowserHelper->_SetIgnoreRules(root, fileName, globalRules, pidl);
+
+    ::CoTaskMemFree(pidl);
+    return result;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::RemoveIgnoreRules()
+{
+    wxCHECK(m_explorerBrowserHelper, false);
+
+    return m_explorerBrowserHelper->_RemoveIgnoreRules();
+}
+
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::SetPaneSettings(const PaneSettings& settings)
+{
+    wxCHECK(m_explorerBrowserHelper, false);
+
+    return m_explorerBrowserHelper->_SetPaneSettings(settings);
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::EnableChangeNotifications(bool enable, int batchDelay,
+                                                                         size_t maxQueuedChanges)
+{
+    wxCHECK(m_explorerBrowser, false);
+    wxCHECK(batchDelay >= 0, false);
+
+    m_changeNotificationsEnabled = enable;
+    m_changeBatcher.SetLimits(static_cast<wxUint64>(batchDelay), maxQueuedChanges);
+
+    // the changes made while they were disabled are not in the index
+    m_searchIndex.SetStale();
+
+    if ( !enable )
+    {
+        m_changeTimer.Stop();
+        m_changeBatcher.Clear();
+        UnregisterChangeNotify();
+        return true;
+    }
+
+    return RegisterChangeNotify();
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::RegisterChangeNotify()
+{
+    UnregisterChangeNotify();
+
+    if ( !GetCurrentFolder(m_changeNotifyFolder) )
+        return false;
+
+    m_changeNotifyFolderKey = wxExplorerBrowserImplHelper::_GetFolderKey(m_changeNotifyFolder);
+
+    SHChangeNotifyEntry entry = {0};
+
+    entry.pidl = m_changeNotifyFolder;
+    entry.fRecursive = FALSE;
+
+    m_changeNotifyId = ::SHChangeNotifyRegister(m_host->GetHWND(),
+                        SHCNRF_ShellLevel | SHCNRF_InterruptLevel | SHCNRF_NewDelivery,
+                        SHCNE_CREATE | SHCNE_DELETE | SHCNE_MKDIR | SHCNE_RMDIR
+                        | SHCNE_RENAMEITEM | SHCNE_RENAMEFOLDER
+                        | SHCNE_UPDATEITEM | SHCNE_UPDATEDIR | SHCNE_ATTRIBUTES,
+                        GetChangeNotifyMessage(), 1, &entry);
+    if ( !m_changeNotifyId )
+    {
+        wxLogLastError(wxS("SHChangeNotifyRegister()"));
+        UnregisterChangeNotify();
+        return false;
+    }
+
+    return true;
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::UnregisterChangeNotify()
+{
+    if ( m_changeNotifyId )
+    {
+        if ( !::SHChangeNotifyDeregister(m_changeNotifyId) )
+            wxLogLastError(wxS("SHChangeNotifyDeregister()"));
+        m_changeNotifyId = 0;
+    }
+
+    ::CoTaskMemFree(m_changeNotifyFolder);
+    m_changeNotifyFolder = nullptr;
+    m_changeNotifyFolderKey = 0;
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::ProcessChangeNotify(LONG event, PIDLIST_ABSOLUTE* pidls)
+{
+    if ( m_itemCache )
+        m_itemCache->InvalidateFolder(m_changeNotifyFolderKey);
+
+    m_quickFinder.Reset();
+
+    switch ( event & ~SHCNE_INTERRUPT )
+    {
+        case SHCNE_CREATE:
+        case SHCNE_MKDIR:
+            AddChange(wxExplorerBrowserItemChange::Created, pidls[0]);
+            break;
+
+        case SHCNE_DELETE:
+        case SHCNE_RMDIR:
+            AddChange(wxExplorerBrowserItemChange::Deleted, pidls[0]);
+            break;
+
+        case SHCNE_RENAMEITEM:
+        case SHCNE_RENAMEFOLDER:
+            AddChange(wxExplorerBrowserItemChange::Deleted, pidls[0]);
+            AddChange(wxExplorerBrowserItemChange::Created, pidls[1]);
+            break;
+
+        case SHCNE_UPDATEDIR:
+            if ( pidls[0] && ::ILIsEqual(pidls[0], m_changeNotifyFolder) )
+            {
+                // the shell does not tell what changed in the folder
+                if ( m_changeBatcher.AddFolderChange(::GetTickCount64()) )
+                    UpdateChangeTimer();
+                m_searchIndex.SetStale();
+                break;
+            }
+            AddChange(wxExplorerBrowserItemChange::Updated, pidls[0]);
+            break;
+
+        case SHCNE_UPDATEITEM:
+        case SHCNE_ATTRIBUTES:
+            AddChange(wxExplorerBrowserItemChange::Updated, pidls[0]);
+            break;
+    }
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::AddChange(wxExplorerBrowserItemChange::Type type,
+                                                         PCIDLIST_ABSOLUTE pidl)
+{
+    // e.g. an item moved here from another folder is reported
+    // as renamed, only its new name is in the current folder
+    if ( !pidl || !::ILIsParent(m_changeNotifyFolder, pidl, TRUE) )
+        return;
+
+    PWSTR name = nullptr;
+    HRESULT hr = ::SHGetNameFromIDList(pidl, SIGDN_DESKTOPABSOLUTEPARSING, &name);
+
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("SHGetNameFromIDList()"), hr);
+        return;
+    }
+
+    const wxString path(name);
+
+    ::CoTaskMemFree(name);
+
+    if ( m_searchIndex.IsUpToDate() )
+        UpdateSearchIndex(type, pidl);
+
+    if ( m_changeBatcher.Add(type, path, ::GetTickCount64()) )
+        UpdateChangeTimer();
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::UpdateChangeTimer()
+{
+    wxUint64 deadline;
+
+    if ( !m_changeBatcher.GetDeadline(deadline) )
+    {
+        m_changeTimer.Stop();
+        return;
+    }
+
+    const wxUint64 now = ::GetTickCount64();
+    const int delay = deadline > now ? static_cast<int>(deadline - now) : 1;
+
+    m_changeTimer.StartOnce(delay);
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::OnChangeTimer(wxTimerEvent& WXUNUSED(evt))
+{
+    wxExplorerBrowserChangeEvent evt(wxEVT_EXPLORER_BROWSER_ITEMS_CHANGED, m_host->GetId());
+    wxExplorerBrowserItemChange::List changes;
+
+    evt.SetEventObject(m_host);
+    evt.SetOverflow(m_changeBatcher.Flush(changes));
+    evt.SetChanges(std::move(changes));
+
+    // the individual changes were lost, make sure the view is up to date
+    if ( evt.IsOverflow() )
+        Refresh();
+
+    m_host->ProcessWindowEvent(evt);
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::OnNavigationComplete(wxExplorerBrowserEvent& evt)
+{
+    evt.Skip();
+
+    if ( m_restoringParkedView )
+    {
+        m_restoringParkedView = false;
+        RestoreParkedView();
+    }
+
+    m_quickFinder.Reset();
+    ResetSearchIndex();
+
+    // the items of the new folder are loaded when its visible range is sent
+    m_viewportSent = false;
+    m_thumbnails.ClearPrefetch();
+
+    // the enumeration was of the previous folder
+    EndRecursiveEnumeration(true);
+
+    if ( !m_changeNotificationsEnabled )
+        return;
+
+    // the pending changes are for the previous folder
+    m_changeTimer.Stop();
+    m_changeBatcher.Clear();
+    RegisterChangeNotify();
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::HandleHostMessage(WXUINT nMsg, WXWPARAM wParam, WXLPARAM lParam)
+{
+    if ( nMsg != GetChangeNotifyMessage() )
+        return false;
+
+    PIDLIST_ABSOLUTE* pidls = nullptr;
+    LONG event = 0;
+    HANDLE lock = ::SHChangeNotification_Lock(reinterpret_cast<HANDLE>(wParam), static_cast<DWORD>(lParam),
+                                              &pidls, &event);
+
+    if ( lock )
+    {
+        if ( m_changeNotifyId )
+            ProcessChangeNotify(event, pidls);
+        ::SHChangeNotification_Unlock(lock);
+    }
+
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::UseSharedItemCache(bool use)
+{
+    wxCHECK(m_explorerBrowserHelper, false);
+
+    m_itemCache = use ? &wxExplorerBrowserItemCache::Get() : nullptr;
+    m_explorerBrowserHelper->_SetItemCache(m_itemCache);
+
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::EnableThumbnails(bool enable, size_t maxMemory, unsigned threadCount)
+{
+    if ( enable )
+        m_thumbnails.Enable(maxMemory, threadCount);
+    else
+        m_thumbnails.Disable();
+
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::GetThumbnail(const wxExplorerBrowserItem& item, int size,
+                                                            wxBitmap& bitmap)
+{
+    wxCHECK(m_thumbnails.GetService(), false);
+    wxCHECK(size > 0, false);
+
+    wxExplorerBrowserThumbnail::Ptr thumbnail;
+
+    if ( !m_thumbnails.GetService()->Request(item, static_cast<unsigned>(size), thumbnail) )
+        return false;
+
+    bitmap = wxExplorerBrowserThumbnailEvent::ThumbnailToBitmap(*thumbnail);
+    return bitmap.IsOk();
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::CancelThumbnailRequests()
+{
+    wxCHECK(m_thumbnails.GetService(), false);
+
+    m_thumbnails.GetService()->CancelPending();
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::SetThumbnailStore(const wxString& fileName, size_t maxSize)
+{
+    return m_thumbnails.SetStore(fileName, maxSize);
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::GetVisibleItemRange(size_t& first, size_t& count)
+{
+    wxCHECK(m_explorerBrowser, false);
+
+    HRESULT hr;
+    wxCOMPtr<IFolderView2> fv2;
+
+    if ( !GetCurrentView(fv2) )
+        return false;
+
+    int item = -1;
+
+    first = count = 0;
+
+    // S_FALSE when no items are visible
+    hr = fv2->GetVisibleItem(-1, FALSE, &item);
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IFolderView2::GetVisibleItem()"), hr);
+        return false;
+    }
+    if ( hr != S_OK || item < 0 )
+        return true;
+
+    // the visible items are not in the view order in the grouped views;
+    // the walk is bounded as the view may report more items than fit on the screen
+    static const int MaxVisibleItems = 4096;
+
+    int firstItem = item;
+    int lastItem = item;
+
+    for ( int i = 1; i < MaxVisibleItems; ++i )
+    {
+        if ( fv2->GetVisibleItem(item, FALSE, &item) != S_OK || item < 0 )
+            break;
+
+        firstItem = wxMin(firstItem, item);
+        lastItem = wxMax(lastItem, item);
+    }
+
+    first = static_cast<size_t>(firstItem);
+    count = static_cast<size_t>(lastItem - firstItem) + 1;
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::EnableViewportTracking(bool enable, int pollInterval)
+{
+    wxCHECK(pollInterval > 0, false);
+
+    m_viewportTimer.Stop();
+    if ( !enable )
+        return true;
+
+    // the first check sends the event
+    m_viewportSent = false;
+    m_viewportTimer.Start(pollInterval);
+    return true;
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::OnViewportTimer(wxTimerEvent& WXUNUSED(evt))
+{
+    if ( m_tornDown || !m_explorerBrowser )
+        return;
+
+    // the view does not exist for a while during the navigation
+    wxLogNull noLog;
+
+    wxCOMPtr<IFolderView2> fv2;
+    int itemCount = 0;
+    size_t first = 0, count = 0;
+
+    if ( !GetCurrentView(fv2) || FAILED(fv2->ItemCount(SVGIO_ALLVIEW, &itemCount))
+         || !GetVisibleItemRange(first, count) )
+        return;
+
+    if ( m_viewportSent && first == m_viewportFirst && count == m_viewportCount
+         && static_cast<size_t>(itemCount) == m_viewportItemCount )
+        return;
+
+    const bool itemsChanged = !m_viewportSent || static_cast<size_t>(itemCount) != m_viewportItemCount;
+
+    m_viewportSent = true;
+    m_viewportFirst = first;
+    m_viewportCount = count;
+    m_viewportItemCount = static_cast<size_t>(itemCount);
+
+    wxExplorerBrowserViewportEvent evt(wxEVT_EXPLORER_BROWSER_VIEWPORT_CHANGED, m_host->GetId());
+
+    evt.SetEventObject(m_host);
+    evt.SetRange(first, count);
+    evt.SetItemCount(m_viewportItemCount);
+    m_host->ProcessWindowEvent(evt);
+
+    UpdateThumbnailPrefetch(first, count, itemsChanged);
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::PrefetchThumbnails(int size, size_t distance)
+{
+    wxCHECK(size >= 0, false);
+    wxCHECK_MSG(!size || m_thumbnails.GetService(), false, wxS("The thumbnails must be enabled"));
+    wxCHECK_MSG(!size || m_viewportTimer.IsRunning(), false, wxS("Viewport tracking must be enabled"));
+
+    m_thumbnails.SetPrefetch(static_cast<unsigned>(size), distance);
+
+    // started with the next check of the visible range
+    m_viewportSent = false;
+    return true;
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::UpdateThumbnailPrefetch(size_t first, size_t count, bool reloadItems)
+{
+    if ( !m_thumbnails.IsPrefetching() )
+        return;
+
+    if ( reloadItems )
+    {
+        wxCOMPtr<IFolderView2> fv2;
+        wxCOMPtr<IShellItemArray> sia;
+
+        // the indices of the pending items are for the previous listing
+        m_thumbnails.ClearPrefetch();
+        if ( !GetCurrentView(fv2)
+             || FAILED(fv2->Items(SVGIO_ALLVIEW | SVGIO_FLAG_VIEWORDER, wxIID_PPV_ARGS(IShellItemArray, &sia)))
+             || !ShellItemArrayToExplorerBrowserItemList(sia, m_thumbnails.GetPrefetchItems(),
+                                                         wxExplorerBrowserItem::File | wxExplorerBrowserItem::Directory
+                                                         | wxExplorerBrowserItem::Other,
+                                                         Items_Overwrite, m_itemCache, nullptr,
+                                                         &m_thumbnails.GetPrefetchViewIndices()) )
+        {
+            m_thumbnails.ClearPrefetch();
+            return;
+        }
+
+        m_thumbnails.PreparePrefetch();
+    }
+
+    m_thumbnails.UpdatePrefetch(first, count);
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::OnThumbnailReady(wxExplorerBrowserThumbnailEvent& evt)
+{
+    evt.Skip();
+
+    m_thumbnails.RequestPrefetched();
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::CalculateFolderSize(const wxExplorerBrowserItem::List& items,
+                                                                  int progressInterval)
+{
+    wxCHECK(progressInterval > 0, false);
+
+    wxArrayString folders;
+
+    for ( const auto& item : items )
+    {
+        if ( item.GetType() == wxExplorerBrowserItem::Directory && !item.GetPath().empty() )
+            folders.push_back(item.GetPath());
+    }
+
+    if ( folders.empty() )
+        return false;
+
+    // the previous computation gets its completed event, even if it is done
+    // and the timer did not notice it yet
+    EndFolderSizeCalculation(true);
+
+    std::unique_ptr<wxExplorerBrowserFolderSizer> folderSizer(new wxExplorerBrowserFolderSizer());
+
+    if ( !folderSizer->Start(folders) )
+        return false;
+
+    m_folderSizer = std::move(folderSizer);
+    m_folderSizeTimer.Start(progressInterval);
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::CancelFolderSizeCalculation()
+{
+    EndFolderSizeCalculation(true);
+    return true;
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::EndFolderSizeCalculation(bool cancel)
+{
+    if ( !m_folderSizer )
+        return;
+
+    // taken first, the handler of the event can start a new computation
+    std::unique_ptr<wxExplorerBrowserFolderSizer> folderSizer(std::move(m_folderSizer));
+
+    m_folderSizeTimer.Stop();
+    if ( cancel && folderSizer->IsRunning() )
+        folderSizer->Cancel();
+    SendFolderSizeEvent(wxEVT_EXPLORER_BROWSER_FOLDER_SIZE_COMPLETED, *folderSizer);
+
+    // a cancelled walk stops only after the directories being enumerated are done,
+    // which can take long on a network drive, so it is not waited for here
+    // but on the thread of the reaper, joined when wxWidgets is cleaned up
+    GetReaper().Destroy(std::move(folderSizer));
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::OnFolderSizeTimer(wxTimerEvent& WXUNUSED(evt))
+{
+    if ( !m_folderSizer )
+        return;
+
+    if ( m_folderSizer->IsRunning() )
+    {
+        SendFolderSizeEvent(wxEVT_EXPLORER_BROWSER_FOLDER_SIZE_PROGRESS, *m_folderSizer);
+        return;
+    }
+
+    EndFolderSizeCalculation(false);
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::SendFolderSizeEvent(wxEventType command,
+                                                                  const wxExplorerBrowserFolderSizer& folderSizer)
+{
+    wxExplorerBrowserFolderSizeEvent evt(command, m_host->GetId());
+
+    evt.SetEventObject(m_host);
+    evt.SetTotals(folderSizer.GetTotals());
+    evt.SetCancelled(folderSizer.IsCancelled());
+    m_host->ProcessWindowEvent(evt);
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::EnumerateRecursively(wxUint32 itemTypes, unsigned maxDepth,
+                                                                   int batchInterval)
+{
+    wxCHECK(m_explorerBrowserHelper, false);
+    wxCHECK(batchInterval > 0, false);
+
+    wxExplorerBrowserItem folder;
+
+    if ( !GetFolder(folder) || folder.GetPath().empty() )
+        return false;
+
+    // the previous enumeration gets its completed event, even if it is done
+    // and the timer did not notice it yet
+    EndRecursiveEnumeration(true);
+
+    std::unique_ptr<wxExplorerBrowserRecursiveEnumerator> enumerator(new wxExplorerBrowserRecursiveEnumerator());
+
+    // the incomplete batches are sent with the next event after the interval
+    if ( !enumerator->Start(folder.GetPath(), itemTypes, m_explorerBrowserHelper->_GetFilter(), maxDepth,
+                            256, static_cast<unsigned>(batchInterval)) )
+        return false;
+
+    m_recursiveEnumerator = std::move(enumerator);
+    m_enumerationTimer.Start(batchInterval);
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::CancelRecursiveEnumeration()
+{
+    EndRecursiveEnumeration(true);
+    return true;
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::EndRecursiveEnumeration(bool cancel)
+{
+    if ( !m_recursiveEnumerator )
+        return;
+
+    // taken first, the handlers of the events can start a new enumeration
+    std::unique_ptr<wxExplorerBrowserRecursiveEnumerator> enumerator(std::move(m_recursiveEnumerator));
+
+    m_enumerationTimer.Stop();
+
+    // checked first, so that the items found before it finished are taken below
+    const bool running = enumerator->IsRunning();
+
+    if ( cancel && running )
+        enumerator->Cancel();
+
+    // the items found so far are sent even if cancelled, as they were counted
+    wxExplorerBrowserItem::List items;
+
+    if ( enumerator->TakeItems(items) )
+        SendEnumerationEvent(wxEVT_EXPLORER_BROWSER_ENUMERATION_ITEMS, *enumerator, &items);
+    SendEnumerationEvent(wxEVT_EXPLORER_BROWSER_ENUMERATION_COMPLETED, *enumerator);
+
+    // the walk is not waited for, see EndFolderSizeCalculation()
+    GetReaper().Destroy(std::move(enumerator));
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::OnEnumerationTimer(wxTimerEvent& WXUNUSED(evt))
+{
+    if ( !m_recursiveEnumerator )
+        return;
+
+    if ( !m_recursiveEnumerator->IsRunning() )
+    {
+        EndRecursiveEnumeration(false);
+        return;
+    }
+
+    wxExplorerBrowserItem::List items;
+
+    if ( m_recursiveEnumerator->TakeItems(items) )
+        SendEnumerationEvent(wxEVT_EXPLORER_BROWSER_ENUMERATION_ITEMS, *m_recursiveEnumerator, &items);
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::SendEnumerationEvent(wxEventType command,
+                                                                   const wxExplorerBrowserRecursiveEnumerator& enumerator,
+                                                                   wxExplorerBrowserItem::List* items)
+{
+    wxExplorerBrowserEnumerationEvent evt(command, m_host->GetId());
+
+    evt.SetEventObject(m_host);
+    if ( items )
+        evt.GetItems().swap(*items);
+    evt.SetFoundCount(enumerator.GetFoundCount());
+    evt.SetErrorCount(enumerator.GetErrorCount());
+    evt.SetCancelled(enumerator.IsCancelled());
+    m_host->ProcessWindowEvent(evt);
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::GetMemoryUsage(wxExplorerBrowserMemoryUsage& usage) const
+{
+    usage = wxExplorerBrowserMemoryUsage();
+
+    usage.itemLists = m_listingFingerprint.GetMemoryUsage()
+                      + m_quickFinder.GetMemoryUsage()
+                      + m_searchIndex.GetIndexMemoryUsage()
+                      + m_parkedState.selection.capacity() * sizeof(PIDLIST_ABSOLUTE);
+    if ( m_parkedState.folder )
+        usage.itemLists += ::ILGetSize(m_parkedState.folder);
+    for ( auto pidl : m_parkedState.selection )
+        usage.itemLists += ::ILGetSize(pidl);
+
+    if ( m_itemCache )
+        usage.sharedItemCache = m_itemCache->GetMemoryUsage();
+    if ( m_thumbnails.GetService() )
+        usage.cachedConversions = m_thumbnails.GetService()->GetMemoryUsage();
+
+    if ( m_explorerBrowserHelper )
+        usage.filters = m_explorerBrowserHelper->_GetFilterMemoryUsage();
+
+    usage.pendingEvents = m_changeBatcher.GetMemoryUsage() + m_searchScheduler.GetMemoryUsage()
+                          + m_searchIndex.GetSchedulerMemoryUsage() + m_resultInjector.GetMemoryUsage();
+
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::SetMemoryBudget(size_t softLimit, size_t hardLimit)
+{
+    wxCHECK(!softLimit || !hardLimit || softLimit <= hardLimit, false);
+
+    m_memoryBudget.SetLimits(softLimit, hardLimit);
+    CheckMemoryBudget();
+
+    return true;
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::CheckMemoryBudget()
+{
+    if ( !m_memoryBudget.IsEnabled() )
+        return;
+
+    wxExplorerBrowserMemoryUsage usage;
+
+    GetMemoryUsage(usage);
+
+    if ( m_memoryBudget.GetLevel(usage.GetTotal()) == wxExplorerBrowserMemoryBudget::Level_Normal )
+        return;
+
+    // the shared item cache is not trimmed, it is not counted in the usage
+    // and it has its own limit, the thumbnails are the cheapest to recreate
+    wxExplorerBrowserThumbnailService* thumbnails = m_thumbnails.GetService();
+
+    if ( thumbnails )
+    {
+        const size_t excess = m_memoryBudget.GetExcess(usage.GetTotal());
+        const size_t memory = thumbnails->GetMemoryUsage();
+
+        thumbnails->Shrink(memory > excess ? memory - excess : 0);
+        usage.cachedConversions -= memory - std::min(memory, thumbnails->GetMemoryUsage());
+    }
+
+    if ( m_memoryBudget.GetLevel(usage.GetTotal()) != wxExplorerBrowserMemoryBudget::Level_Hard )
+        return;
+
+    // the next GetItemChanges() reports all items as added
+    m_listingFingerprint.Clear();
+    m_quickFinder.Reset();
+
+    // indexed again by the next search, the names shown by the filtered view are kept
+    m_searchIndex.Clear();
+
+    // the batch is reported as overflowed, which refreshes the view
+    if ( m_changeBatcher.GetPendingCount() )
+        m_changeBatcher.AddFolderChange(::GetTickCount64());
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::EnableQueuedEvents(bool enable, size_t queueCapacity)
+{
+    wxCHECK(m_explorerBrowserHelper, false);
+    wxCHECK(queueCapacity, false);
+
+    // kept alive when detached from the helper
+    const std::shared_ptr<QueuedEvents> queue = m_explorerBrowserHelper->_GetEventQueue();
+
+    if ( queue )
+    {
+        // detached first, so that the event handlers see the queued events disabled
+        m_explorerBrowserHelper->_SetEventQueue(nullptr);
+        m_host->Unbind(wxEVT_IDLE, &wxExplorerBrowserImpl::OnIdle, this);
+
+        // the events already queued are sent in the original order
+        m_explorerBrowserHelper->_SendQueuedEvents(*queue, queue->GetCapacity());
+    }
+
+    if ( !enable )
+        return true;
+
+    m_host->Bind(wxEVT_IDLE, &wxExplorerBrowserImpl::OnIdle, this);
+    m_explorerBrowserHelper->_SetEventQueue(std::make_shared<QueuedEvents>(queueCapacity));
+
+    return true;
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::SendQueuedEvents(size_t maxCount)
+{
+    if ( !m_explorerBrowserHelper )
+        return;
+
+    // kept alive even if an event handler disables the queued events
+    const std::shared_ptr<QueuedEvents> queue = m_explorerBrowserHelper->_GetEventQueue();
+
+    if ( queue )
+        m_explorerBrowserHelper->_SendQueuedEvents(*queue, maxCount);
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::OnIdle(wxIdleEvent& evt)
+{
+    evt.Skip();
+
+    // the events are sent in batches, so that the application stays responsive
+    static const size_t maxBatchSize = 64;
+
+    SendQueuedEvents(maxBatchSize);
+
+    // an event handler could have disabled the queued events
+    const QueuedEvents* queue = m_explorerBrowserHelper ? m_explorerBrowserHelper->_GetEventQueue().get() : nullptr;
+
+    if ( queue && !queue->IsEmpty() )
+        evt.RequestMore();
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::InvalidateCurrentFolderItems()
+{
+    if ( !m_itemCache )
+        return;
+
+    PIDLIST_ABSOLUTE pidl = nullptr;
+
+    if ( !GetCurrentFolder(pidl) )
+        return;
+
+    m_itemCache->InvalidateFolder(wxExplorerBrowserImplHelper::_GetFolderKey(pidl));
+    ::CoTaskMemFree(pidl);
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::Park(size_t estimatedMemory)
+{
+    if ( m_parked )
+        return true;
+
+    wxCHECK(m_explorerBrowser, false);
+
+    wxExplorerBrowserParkingLot::ViewIdList evicted;
+
+    m_parked = true;
+    GetParkingLot().Park(this, estimatedMemory, evicted);
+    TearDownParkedViews(evicted);
+
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::Unpark()
+{
+    if ( m_parked )
+    {
+        m_parked = false;
+        GetParkingLot().Unpark(this);
+    }
+
+    // a view which could not be revived the last time is revived again
+    if ( !m_tornDown )
+        return true;
+
+    return Revive();
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::SetParkingBudget(size_t maxParkedViews, size_t maxParkedMemory)
+{
+    wxExplorerBrowserParkingLot::ViewIdList evicted;
+
+    GetParkingLot().SetBudget(maxParkedViews, maxParkedMemory, evicted);
+    TearDownParkedViews(evicted);
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::TearDownParkedViews(const wxExplorerBrowserParkingLot::ViewIdList& views)
+{
+    for ( const auto view : views )
+        static_cast<wxExplorerBrowserImpl*>(const_cast<void*>(view))->TearDown();
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::ParkedState::Clear()
+{
+    ::CoTaskMemFree(folder);
+    folder = nullptr;
+
+    for ( auto pidl : selection )
+        ::CoTaskMemFree(pidl);
+    selection.clear();
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::TearDown()
+{
+    if ( m_tornDown )
+        return;
+
+    HRESULT hr;
+    wxCOMPtr<IFolderView2> fv2;
+
+    m_parkedState.Clear();
+    GetOptions(m_parkedState.options);
+
+    if ( GetCurrentView(fv2) && GetCurrentFolder(m_parkedState.folder) )
+    {
+        FOLDERVIEWMODE viewMode;
+        DWORD flags;
+
+        if ( SUCCEEDED(fv2->GetViewModeAndIconSize(&viewMode, &m_parkedState.iconSize)) )
+            m_parkedState.folderSettings.m_viewMode = static_cast<wxUint32>(viewMode);
+        if ( SUCCEEDED(fv2->GetCurrentFolderFlags(&flags)) )
+            m_parkedState.folderSettings.m_flags = flags;
+
+        wxCOMPtr<IShellItemArray> sia;
+        DWORD count = 0;
+
+        if ( SUCCEEDED(fv2->GetSelection(FALSE, &sia)) && SUCCEEDED(sia->GetCount(&count)) )
+        {
+            for ( DWORD i = 0; i < count; ++i )
+            {
+                wxCOMPtr<IShellItem> si;
+                PIDLIST_ABSOLUTE pidl = nullptr;
+
+                hr = sia->GetItemAt(i, &si);
+                if ( SUCCEEDED(hr) )
+                    hr = ::SHGetIDListFromObject(si, &pidl);
+                if ( SUCCEEDED(hr) )
+                    m_parkedState.selection.push_back(pidl);
+            }
+        }
+    }
+
+    m_searchTimer.Stop();
+    m_searchScheduler.Reset();
+
+    // the results folder does not survive parking
+    CancelAddingResults();
+
+    m_changeTimer.Stop();
+    m_changeBatcher.Clear();
+    UnregisterChangeNotify();
+
+    DestroyExplorerBrowser();
+    m_tornDown = true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::Revive()
+{
+    CreateStruct createStruct;
+
+    createStruct.options = m_parkedState.options;
+    createStruct.folderSettings = m_parkedState.folderSettings;
+
+    // stays torn down if it cannot be created again, so that the next Unpark() retries
+    if ( !Initialize(createStruct) )
+        return false;
+
+    m_tornDown = false;
+
+    const wxSize size = m_host->GetClientSize();
+    RECT rect = {0};
+
+    rect.right = size.GetWidth();
+    rect.bottom = size.GetHeight();
+    m_explorerBrowser->SetRect(nullptr, rect);
+
+    if ( !m_parkedState.folder )
+        return true;
+
+    HRESULT hr;
+
+    m_restoringParkedView = true;
+
+    hr = m_explorerBrowser->BrowseToIDList(m_parkedState.folder, SBSP_ABSOLUTE);
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IExplorerBrowser::BrowseToIDList()"), hr);
+        m_restoringParkedView = false;
+        m_parkedState.Clear();
+        return false;
+    }
+
+    return true;
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::RestoreParkedView()
+{
+    wxCOMPtr<IFolderView2> fv2;
+
+    if ( GetCurrentView(fv2) )
+    {
+        HRESULT hr;
+
+        if ( m_parkedState.iconSize > 0 )
+        {
+            hr = fv2->SetViewModeAndIconSize(static_cast<FOLDERVIEWMODE>(m_parkedState.folderSettings.m_viewMode),
+                                             m_parkedState.iconSize);
+            if ( FAILED(hr) )
+                wxLogApiError(wxS("IFolderView2::SetViewModeAndIconSize()"), hr);
+        }
+
+        wxCOMPtr<IShellView> sv;
+
+        if ( !m_parkedState.selection.empty() && GetCurrentView(sv) )
+        {
+            UINT flags = SVSI_SELECT | SVSI_DESELECTOTHERS | SVSI_ENSUREVISIBLE | SVSI_FOCUSED;
+
+            for ( auto pidl : m_parkedState.selection )
+            {
+                hr = sv->SelectItem(::ILFindLastID(pidl), flags);
+                if ( FAILED(hr) )
+                    wxLogApiError(wxS("IShellView::SelectItem()"), hr);
+                flags = SVSI_SELECT;
+            }
+        }
+    }
+
+    m_parkedState.Clear();
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::SetResizePolicy(ResizePolicy policy, int maxUpdateInterval)
+{
+    wxCHECK(maxUpdateInterval >= 0, false);
+
+    const bool coalesce = policy == Resize_Coalesce;
+
+    m_resizeCoalescer.SetPolicy(coalesce, static_cast<wxUint64>(maxUpdateInterval));
+    TrackTopLevelParent(coalesce);
+
+    if ( !coalesce )
+        m_resizeCoalescer.EndInteractive(::GetTickCount64());
+
+    if ( m_resizeCoalescer.HasPendingSize() && !coalesce )
+        ApplyPendingSize();
+    else
+        UpdateResizeTimer();
+
+    return true;
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::TrackTopLevelParent(bool track)
+{
+    if ( m_topLevelParent )
+    {
+        m_topLevelParent->Unbind(wxEVT_MOVE_START, &wxExplorerBrowserImpl::OnTopLevelParentMoveStart, this);
+        m_topLevelParent->Unbind(wxEVT_MOVE_END, &wxExplorerBrowserImpl::OnTopLevelParentMoveEnd, this);
+        m_topLevelParent = nullptr;
+    }
+
+    if ( !track )
+        return;
+
+    // wxEVT_MOVE_START and wxEVT_MOVE_END are sent for WM_ENTERSIZEMOVE
+    // and WM_EXITSIZEMOVE, i.e., also when the window is being resized
+    m_topLevelParent = wxGetTopLevelParent(m_host);
+    if ( m_topLevelParent )
+    {
+        m_topLevelParent->Bind(wxEVT_MOVE_START, &wxExplorerBrowserImpl::OnTopLevelParentMoveStart, this);
+        m_topLevelParent->Bind(wxEVT_MOVE_END, &wxExplorerBrowserImpl::OnTopLevelParentMoveEnd, this);
+    }
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::SetSize(const wxSize& size)
+{
+    if ( m_resizeCoalescer.OnSizeChanged(size, ::GetTickCount64()) )
+        ApplyPendingSize();
+    else
+        UpdateResizeTimer();
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::ApplyPendingSize()
+{
+    const wxSize size = m_resizeCoalescer.GetPendingSize();
+
+    m_resizeCoalescer.OnApplied(::GetTickCount64());
+    UpdateResizeTimer();
+
+    m_host->SetSize(size);
+
+    if ( !m_explorerBrowser )
+        return;
+
+    RECT rect = {0};
+
+    rect.right = size.GetWidth();
+    rect.bottom = size.GetHeight();
+    m_explorerBrowser->SetRect(nullptr, rect);
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::UpdateResizeTimer()
+{
+    wxUint64 deadline;
+
+    if ( !m_resizeCoalescer.GetDeadline(deadline) )
+    {
+        m_resizeTimer.Stop();
+        return;
+    }
+
+    const wxUint64 now = ::GetTickCount64();
+    const int delay = deadline > now ? static_cast<int>(deadline - now) : 1;
+
+    m_resizeTimer.StartOnce(delay);
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::OnResizeTimer(wxTimerEvent& WXUNUSED(evt))
+{
+    if ( m_resizeCoalescer.OnTimer(::GetTickCount64()) )
+        ApplyPendingSize();
+    else
+        UpdateResizeTimer();
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::OnTopLevelParentMoveStart(wxMoveEvent& evt)
+{
+    m_resizeCoalescer.BeginInteractive();
+    UpdateResizeTimer();
+    evt.Skip();
+}
+
+void wxExplorerBrowser::wxExplorerBrowserImpl::OnTopLevelParentMoveEnd(wxMoveEvent& evt)
+{
+    if ( m_resizeCoalescer.EndInteractive(::GetTickCount64()) )
+        ApplyPendingSize();
+    evt.Skip();
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::TranslateMessage(WXMSG* msg)
+{
+    if ( m_explorerBrowser && WM_KEYFIRST <= msg->message && msg->message <= WM_KEYLAST )
+    {
+        wxCOMPtr<IInputObject> io;
+
+        if ( SUCCEEDED(m_explorerBrowser->QueryInterface(wxIID_PPV_ARGS(IInputObject, &io))) )
+        {
+            if ( io->HasFocusIO() == S_OK )
+            {
+                if ( io->TranslateAcceleratorIO(msg) == S_OK )
+                    return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::GetCurrentView(wxCOMPtr<IShellView>& sv)
+{
+    HRESULT hr = m_explorerBrowser->GetCurrentView(wxIID_PPV_ARGS(IShellView, &sv));
+
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IExplorerBrowser::GetCurrentView(IShellView)"), hr);
+        return false;
+    }
+
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::GetCurrentView(wxCOMPtr<IFolderView2>& sv)
+{
+    HRESULT hr = m_explorerBrowser->GetCurrentView(wxIID_PPV_ARGS(IFolderView2, &sv));
+
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IExplorerBrowser::GetCurrentView(IFolderView2)"), hr);
+        return false;
+    }
+
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::GetCurrentFolder(PIDLIST_ABSOLUTE& pidl)
+{
+    HRESULT hr;
+    wxCOMPtr<IFolderView2> fv2;
+
+    if ( !GetCurrentView(fv2) )
+        return false;
+
+    wxCOMPtr<IPersistFolder2> pf2;
+
+    hr = fv2->GetFolder(wxIID_PPV_ARGS(IPersistFolder2, &pf2));
+    if  ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IFolderView2::GetFolder()"), hr);
+        return false;
+    }
+
+    hr = pf2->GetCurFolder(&pidl);
+    if  ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IPersistFolder2::GetCurFolder()"), hr);
+        return false;
+    }
+
+    return true;
+}
+
+bool wxExplorerBrowser::wxExplorerBrowserImpl::ShellItemArrayToExplorerBrowserItemList(wxCOMPtr<IShellItemArray> shellItems,
+                                                wxExplorerBrowserItem::List& items, wxUint32 itemTypes,
+                                                ItemsFillMode mode, wxExplorerBrowserItemCache* cache,
+                                                std::vector<PIDLIST_ABSOLUTE>* pidls,
+                                                std::vector<size_t>* viewIndices)
+{
+    HRESULT hr;
+    DWORD count = 0;
+    const size_t first = mode == Items_Append ? items.size() : 0;
+
+    hr = shellItems->GetCount(&count);
+    if ( FAILED(hr) )
+    {
+        wxLogApiError(wxS("IShellItemArray::GetCount()"), hr);
+        items.resize(first);
+        return false;
+    }
+
+    items.reserve(first + static_cast<size_t>(count));
+
+    // the items already in the list are converted into in place,
+    // so that their string buffers are reused
+    size_t filled = first;
+
+    for ( DWORD i = 0; i < count; ++i )
+    {
+        wxCOMPtr<IShellItem> si;
+
+        hr = shellItems->GetItemAt(i, &si);
+        if ( FAILED(hr) )
+        {
+            wxLogApiError(wxS("IShellItemArray::GetItemAt()"), hr);
+            items.resize(first);
+            return false;
+        }
+
+        if ( filled == items.size() )
+            items.emplace_back();
+
+        wxExplorerBrowserItem& ebi = items[filled];
+        PIDLIST_ABSOLUTE pidl = nullptr;
+
+        // the ID list obtained for the conversion is kept when the caller wants it
+        if ( !wxExplorerBrowserImplHelper::_IShellItem2wxExplorerBrowserItem(si, ebi, cache,
+                                                                             pidls ? &pidl : nullptr) )
+        {
+            items.resize(first);
+            return false;
+        }
+
+        if ( !(itemTypes & ebi.GetType()) )
+        {
+            ::CoTaskMemFree(pidl);
+            continue;
+        }
+
+        ++filled;
+
+        // the caller frees them
+        if ( pidls )
+            pidls->push_back(pidl);
+        // the index in the array for the items left out by itemTypes
+        if ( viewIndices )
+            viewIndices->push_back(static_cast<size_t>(i));
+    }
+
+    items.resize(filled);
+    return true;
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowser
+    ---------------------------------
+    methods just call the actual implemention in wxExplorerBrowserImpl
+
+*****************************************************************************/
+
+const char wxExplorerBrowserNameStr[] = "wxExplorerBrowser";
+
+wxIMPLEMENT_DYNAMIC_CLASS(wxExplorerBrowser, wxPanel);
+
+wxExplorerBrowser::wxExplorerBrowser(wxWindow* parent,
+                                     const CreateStruct& createStruct,
+                                     const wxString& path,
+                                     wxWindowID id,
+                                     const wxPoint& pos, const wxSize& size,
+                                     const wxString& name)
+{
+    Create(parent, createStruct, path, id, pos, size, name);
+}
+
+wxExplorerBrowser::~wxExplorerBrowser()
+{
+    if ( m_impl )
+        delete m_impl;
+}
+
+
+bool wxExplorerBrowser::Create(wxWindow* parent,
+                               const CreateStruct& createStruct,
+                               const wxString& path,
+                               wxWindowID id,
+                               const wxPoint& pos, const wxSize& size,
+                               const wxString& name)
+{
+    if ( !wxPanel::Create(parent, id, pos, size,
+            wxBORDER_NONE | wxWANTS_CHARS | wxCLIP_CHILDREN | wxCLIP_SIBLINGS,
+            name ) )
+    {
+        return false;
+    }
+
+    // when the ExplorerBrowser was hosted directly, there was an issue
+    // with its wxButton sibling, where upon a wxButton
+    // having focus and user clicking on an ExplorerBrowser item
+    // resulted in the application being stuck in an infinite
+    // loop in the window procedure.
+    // Thus we create a wxWindow which will actually host the browser
+    // as the only child of wxExplorerBrowser
+    wxExplorerBrowserHostWindow* host = new wxExplorerBrowserHostWindow(this);
+
+    m_host = host;
+#if wxCHECK_VERSION(3, 3, 0)
+    m_host->MSWDisableComposited();
+#endif // #if wxCHECK_VERSION(3, 3, 0)
+
+    m_impl = new wxExplorerBrowserImpl(host);
+
+    if ( m_impl->Create(createStruct, path) )
+    {
+        Bind(wxEVT_SIZE, &wxExplorerBrowser::OnSize, this);
+
+        // the following four lines are just
+        // to suppress needless window background erasing
+        SetBackgroundStyle(wxBG_STYLE_PAINT);
+        Bind(wxEVT_PAINT, &wxExplorerBrowser::OnPaint, this);
+        m_host->SetBackgroundStyle(wxBG_STYLE_PAINT);
+        m_host->Bind(wxEVT_PAINT, &wxExplorerBrowser::OnPaint, this);
+
+        return true;
+    }
+
+    return false;
+}
+
+bool wxExplorerBrowser::SetFolderSettings(const FolderSettings& folderSettings)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->SetFolderSettings(folderSettings);
+}
+
+bool wxExplorerBrowser::GetOptions(wxUint32& options)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->GetOptions(options);
+}
+bool wxExplorerBrowser::SetOptions(wxUint32 options)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->SetOptions(options);
+}
+
+bool wxExplorerBrowser::SetEmptyText(const wxString& text)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->SetEmptyText(text);
+}
+
+bool wxExplorerBrowser::SetPropertyBag(const wxString& bag)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->SetPropertyBag(bag);
+}
+
+bool wxExplorerBrowser::BrowseTo(const wxString& item, bool keepWordWheelText)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->BrowseTo(item, keepWordWheelText);
+}
+
+bool wxExplorerBrowser::BrowseTo(BrowseTarget target, bool keepWordWheelText)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->BrowseTo(target, keepWordWheelText);
+}
+
+bool wxExplorerBrowser::Refresh()
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->Refresh();
+}
+
+bool wxExplorerBrowser::SearchFolder(const wxString& str)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->SearchFolder(str);
+}
+
+bool wxExplorerBrowser::EnableSearchPipeline(bool enable, int debounceDelay)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->EnableSearchPipeline(enable, debounceDelay);
+}
+
+bool wxExplorerBrowser::RemoveAll()
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->RemoveAll();
+}
+
+bool wxExplorerBrowser::AddResults(const wxArrayString& paths)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->AddResults(paths);
+}
+
+bool wxExplorerBrowser::AddResults(const std::vector<wxExplorerBrowserResultInjector::IDList>& idLists)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->AddResults(idLists);
+}
+
+bool wxExplorerBrowser::CancelAddingResults()
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->CancelAddingResults();
+}
+
+bool wxExplorerBrowser::SetResultBatchLimits(int batchTime, int batchInterval)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->SetResultBatchLimits(batchTime, batchInterval);
+}
+
+bool wxExplorerBrowser::EnableThumbnails(bool enable, size_t maxMemory, unsigned threadCount)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->EnableThumbnails(enable, maxMemory, threadCount);
+}
+
+bool wxExplorerBrowser::GetThumbnail(const wxExplorerBrowserItem& item, int size, wxBitmap& bitmap)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->GetThumbnail(item, size, bitmap);
+}
+
+bool wxExplorerBrowser::CancelThumbnailRequests()
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->CancelThumbnailRequests();
+}
+
+bool wxExplorerBrowser::SetThumbnailStore(const wxString& fileName, size_t maxSize)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->SetThumbnailStore(fileName, maxSize);
+}
+
+bool wxExplorerBrowser::PrefetchThumbnails(int size, size_t distance)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->PrefetchThumbnails(size, distance);
+}
+
+bool wxExplorerBrowser::GetVisibleItemRange(size_t& first, size_t& count)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->GetVisibleItemRange(first, count);
+}
+
+bool wxExplorerBrowser::EnableViewportTracking(bool enable, int pollInterval)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->EnableViewportTracking(enable, pollInterval);
+}
+
+bool wxExplorerBrowser::CalculateFolderSize(const wxExplorerBrowserItem::List& items, int progressInterval)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->CalculateFolderSize(items, progressInterval);
+}
+
+bool wxExplorerBrowser::CancelFolderSizeCalculation()
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->CancelFolderSizeCalculation();
+}
+
+bool wxExplorerBrowser::EnumerateRecursively(wxUint32 itemTypes, unsigned maxDepth, int batchInterval)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->EnumerateRecursively(itemTypes, maxDepth, batchInterval);
+}
+
+bool wxExplorerBrowser::CancelRecursiveEnumeration()
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->CancelRecursiveEnumeration();
+}
+
+bool wxExplorerBrowser::SelectItems(const wxExplorerBrowserItem::List& items, bool notTakeFocus)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->SelectItems(items, notTakeFocus);
+}
+
+bool wxExplorerBrowser::SelectWhere(const wxArrayString& fileMasks, wxUint32 itemTypes,
+                                    bool notTakeFocus, size_t* selectedCount)
+{
+    wxCHECK(m_impl, false);
+    wxCHECK_MSG(itemTypes, false, wxS("At least one item type must be specified"));
+
+    const wxExplorerBrowserMaskMatcher matcher(fileMasks, itemTypes);
+    wxString name;
+
+    return m_impl->SelectWhere([&matcher, &name](const wxExplorerBrowserItem& item)
+                               { return matcher.AppliesTo(item.GetType()) && matcher.MatchesName(item, name); },
+                               notTakeFocus, selectedCount);
+}
+
+bool wxExplorerBrowser::SelectWhere(const ItemPredicate& predicate, bool notTakeFocus, size_t* selectedCount)
+{
+    wxCHECK(m_impl, false);
+    wxCHECK(predicate, false);
+
+    return m_impl->SelectWhere(predicate, notTakeFocus, selectedCount);
+}
+
+bool wxExplorerBrowser::DeselectAllItems(bool notTakeFocus)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->DeselectAllItems(notTakeFocus);
+}
+bool wxExplorerBrowser::GetSelectedItems(wxExplorerBrowserItem::List& items, wxUint32 itemTypes)
+{
+    return GetSelectedItems(items, itemTypes, Items_Overwrite);
+}
+
+bool wxExplorerBrowser::GetSelectedItems(wxExplorerBrowserItem::List& items, wxUint32 itemTypes,
+                                         ItemsFillMode mode)
+{
+    wxCHECK(m_impl, false);
+    wxCHECK_MSG(itemTypes, false, wxS("At least one item type must be specified"));
+
+    return m_impl->GetSelectedItems(items, itemTypes, mode);
+}
+
+bool wxExplorerBrowser::GetAllItems(wxExplorerBrowserItem::List& items, wxUint32 itemTypes)
+{
+    return GetAllItems(items, itemTypes, Items_Overwrite);
+}
+
+bool wxExplorerBrowser::GetAllItems(wxExplorerBrowserItem::List& items, wxUint32 itemTypes,
+                                    ItemsFillMode mode)
+{
+    wxCHECK(m_impl, false);
+    wxCHECK_MSG(itemTypes, false, wxS("At least one item type must be specified"));
+
+    return m_impl->GetAllItems(items, itemTypes, mode);
+}
+
+bool wxExplorerBrowser::GetAllItemsSorted(wxExplorerBrowserItem::List& items,
+                                          wxExplorerBrowserItemSorter::Order order, wxUint32 itemTypes)
+{
+    wxCHECK(m_impl, false);
+    wxCHECK_MSG(itemTypes, false, wxS("At least one item type must be specified"));
+
+    return m_impl->GetAllItemsSorted(items, order, itemTypes);
+}
+
+bool wxExplorerBrowser::GetItemProperties(wxExplorerBrowserItem::List& items,
+                                          wxExplorerBrowserItemProperties& properties,
+                                          wxUint32 propertyFlags, wxUint32 itemTypes)
+{
+    wxCHECK(m_impl, false);
+    wxCHECK_MSG(itemTypes, false, wxS("At least one item type must be specified"));
+
+    return m_impl->GetItemProperties(items, properties, propertyFlags, itemTypes);
+}
+
+bool wxExplorerBrowser::RequestItemProperties(wxUint32 propertyFlags, wxUint32 itemTypes)
+{
+    wxCHECK(m_impl, false);
+    wxCHECK_MSG(itemTypes, false, wxS("At least one item type must be specified"));
+
+    return m_impl->RequestItemProperties(propertyFlags, itemTypes);
+}
+
+bool wxExplorerBrowser::CancelItemPropertiesRequest()
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->CancelItemPropertiesRequest();
+}
+
+bool wxExplorerBrowser::QuickFind(const wxString& pattern, wxExplorerBrowserItem::List& items,
+                                  size_t maxResults, std::vector<int>* scores, wxUint32 itemTypes)
+{
+    wxCHECK(m_impl, false);
+    wxCHECK_MSG(itemTypes, false, wxS("At least one item type must be specified"));
+
+    return m_impl->QuickFind(pattern, items, maxResults, scores, itemTypes);
+}
+
+bool wxExplorerBrowser::EnableSearchIndex(bool enable, int filterDelay)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->EnableSearchIndex(enable, filterDelay);
+}
+
+bool wxExplorerBrowser::SearchIndex(const wxString& str, bool filterView, wxArrayString* names)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->SearchIndex(str, filterView, names);
+}
+
+bool wxExplorerBrowser::ExportSnapshot(const wxString& fileName, wxUint32 itemTypes)
+{
+    wxCHECK(m_impl, false);
+    wxCHECK_MSG(itemTypes, false, wxS("At least one item type must be specified"));
+
+    return m_impl->ExportSnapshot(fileName, itemTypes);
+}
+
+bool wxExplorerBrowser::GetItemChanges(wxExplorerBrowserListingDelta& delta, wxUint32 itemTypes)
+{
+    wxCHECK(m_impl, false);
+    wxCHECK_MSG(itemTypes, false, wxS("At least one item type must be specified"));
+
+    return m_impl->GetItemChanges(delta, itemTypes);
+}
+
+bool wxExplorerBrowser::ResetItemChanges()
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->ResetItemChanges();
+}
+
+bool wxExplorerBrowser::GetFolder(wxExplorerBrowserItem& item)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->GetFolder(item);
+}
+
+bool wxExplorerBrowser::SetFilter(const wxArrayString& fileMasks, wxUint32 itemTypes)
+{
+    wxCHECK(m_impl, false);
+    wxCHECK_MSG(itemTypes, false, wxS("At least one item type must be specified"));
+
+    if ( m_impl->SetFilter(fileMasks, itemTypes) )
+    {
+        Refresh();
+        return true;
+    }
+
+    return false;
+}
+
+bool wxExplorerBrowser::RemoveFilter()
+{
+    wxCHECK(m_impl, false);
+
+    if ( m_impl->RemoveFilter() )
+    {
+        Refresh();
+        return true;
+    }
+
+    return false;
+}
+
+bool wxExplorerBrowser::SetIgnoreRules(const wxString& root, const wxString& fileName, const wxString& globalRules)
+{
+    wxCHECK(m_impl, false);
+    wxCHECK_MSG(!root.empty() && !fileName.empty(), false, wxS("The root and the file name must be specified"));
+
+    if ( m_impl->SetIgnoreRules(root, fileName, globalRules) )
+    {
+        Refresh();
+        return true;
+    }
+
+    return false;
+}
+
+bool wxExplorerBrowser::RemoveIgnoreRules()
+{
+    wxCHECK(m_impl, false);
+
+    if ( m_impl->RemoveIgnoreRules() )
+    {
+        Refresh();
+        return true;
+    }
+
+    return false;
+}
+
+bool wxExplorerBrowser::SetPaneSettings(const PaneSettings& settings)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->SetPaneSettings(settings);
+}
+
+bool wxExplorerBrowser::EnableChangeNotifications(bool enable, int batchDelay, size_t maxQueuedChanges)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->EnableChangeNotifications(enable, batchDelay, maxQueuedChanges);
+}
+
+bool wxExplorerBrowser::UseSharedItemCache(bool use)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->UseSharedItemCache(use);
+}
+
+bool wxExplorerBrowser::EnableQueuedEvents(bool enable, size_t queueCapacity)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->EnableQueuedEvents(enable, queueCapacity);
+}
+
+bool wxExplorerBrowser::GetMemoryUsage(wxExplorerBrowserMemoryUsage& usage) const
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->GetMemoryUsage(usage);
+}
+
+bool wxExplorerBrowser::SetMemoryBudget(size_t softLimit, size_t hardLimit)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->SetMemoryBudget(softLimit, hardLimit);
+}
+
+bool wxExplorerBrowser::Park(size_t estimatedMemory)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->Park(estimatedMemory);
+}
+
+bool wxExplorerBrowser::Unpark()
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->Unpark();
+}
+
+bool wxExplorerBrowser::IsParked() const
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->IsParked();
+}
+
+void wxExplorerBrowser::SetParkingBudget(size_t maxParkedViews, size_t maxParkedMemory)
+{
+    wxExplorerBrowserImpl::SetParkingBudget(maxParkedViews, maxParkedMemory);
+}
+
+bool wxExplorerBrowser::SetResizePolicy(ResizePolicy policy, int maxUpdateInterval)
+{
+    wxCHECK(m_impl, false);
+
+    return m_impl->SetResizePolicy(policy, maxUpdateInterval);
+}
+
+void* wxExplorerBrowser::GetIExplorerBrowser()
+{
+    wxCHECK(m_impl, nullptr);
+
+    return m_impl->GetIExplorerBrowser();
+}
+
+bool wxExplorerBrowser::MSWTranslateMessage(WXMSG* msg)
+{
+    if ( m_impl && m_impl->TranslateMessage(msg) )
+        return true;
+
+    return wxPanel::MSWTranslateMessage(msg);
+}
+
+void wxExplorerBrowser::OnSize(wxSizeEvent& evt)
+{
+    m_impl->SetSize(GetClientSize());
+    evt.Skip();
+}
+
+void wxExplorerBrowser::OnPaint(wxPaintEvent& evt)
+{
+    wxWindow* w = static_cast<wxWindow*>(evt.GetEventObject());
+
+    if ( w )
+    {
+        wxPaintDC pdc(w);
+        // do nothing here, the window is covered by the ExplorerBrowser,
+        // this paint handler exists solely to prevent useless background
+        // erasing
+    }
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserEvent
+    ---------------------------------
+    just some definitions through wxWidgets macros,
+    most methods are implemented inline in the header
+
+*****************************************************************************/
+
+namespace {
+
+wxExplorerBrowserBlockPool& GetEventBlockPool()
+{
+    // never destroyed, so that the events deleted during
+    // the static deinitialization can still return to the pool
+    static wxExplorerBrowserBlockPool* s_pool = new wxExplorerBrowserBlockPool(sizeof(wxExplorerBrowserEvent));
+
+    return *s_pool;
+}
+
+wxExplorerBrowserItemPool& GetEventItemPool()
+{
+    // never destroyed for the same reason, the pool is thread-safe
+    // and the events are created also on the worker threads
+    static wxExplorerBrowserItemPool* s_pool = new wxExplorerBrowserItemPool(64);
+
+    return *s_pool;
+}
+
+} // unnamed namespace
+
+void wxExplorerBrowserEvent::SetItem(const wxExplorerBrowserItem& item)
+{
+    m_item = GetEventItemPool().Acquire(item);
+}
+
+void* wxExplorerBrowserEvent::operator new(size_t size)
+{
+    // a derived class can be larger
+    if ( size != sizeof(wxExplorerBrowserEvent) )
+        return ::operator new(size);
+
+    return GetEventBlockPool().Allocate();
+}
+
+void wxExplorerBrowserEvent::operator delete(void* ptr, size_t size)
+{
+    if ( size != sizeof(wxExplorerBrowserEvent) )
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    GetEventBlockPool().Free(ptr);
+}
+
+const wxExplorerBrowserItem& wxExplorerBrowserEvent::GetEmptyItem()
+{
+    static const wxExplorerBrowserItem s_emptyItem;
+
+    return s_emptyItem;
+}
+
+wxBitmap wxExplorerBrowserThumbnailEvent::ThumbnailToBitmap(const wxExplorerBrowserThumbnail& thumbnail)
+{
+    if ( !thumbnail.width || !thumbnail.height )
+        return wxBitmap();
+
+    const size_t pixelCount = static_cast<size_t>(thumbnail.width) * thumbnail.height;
+    // wxImage takes ownership of the buffers allocated with malloc()
+    unsigned char* rgb = static_cast<unsigned char*>(malloc(pixelCount * 3));
+    unsigned char* alpha = static_cast<unsigned char*>(malloc(pixelCount));
+
+    if ( !rgb || !alpha )
+    {
+        free(rgb);
+        free(alpha);
+        return wxBitmap();
+    }
+
+    for ( size_t i = 0; i < pixelCount; ++i )
+    {
+        rgb[i * 3]     = thumbnail.pixels[i * 4];
+        rgb[i * 3 + 1] = thumbnail.pixels[i * 4 + 1];
+        rgb[i * 3 + 2] = thumbnail.pixels[i * 4 + 2];
+        alpha[i]       = thumbnail.pixels[i * 4 + 3];
+    }
+
+    return wxBitmap(wxImage(thumbnail.width, thumbnail.height, rgb, alpha));
+}
+
+wxIMPLEMENT_DYNAMIC_CLASS(wxExplorerBrowserEvent, wxNotifyEvent);
+wxIMPLEMENT_DYNAMIC_CLASS(wxExplorerBrowserChangeEvent, wxCommandEvent);
+wxIMPLEMENT_DYNAMIC_CLASS(wxExplorerBrowserProgressEvent, wxCommandEvent);
+wxIMPLEMENT_DYNAMIC_CLASS(wxExplorerBrowserThumbnailEvent, wxCommandEvent);
+wxIMPLEMENT_DYNAMIC_CLASS(wxExplorerBrowserViewportEvent, wxCommandEvent);
+wxIMPLEMENT_DYNAMIC_CLASS(wxExplorerBrowserFolderSizeEvent, wxCommandEvent);
+wxIMPLEMENT_DYNAMIC_CLASS(wxExplorerBrowserItemPropertiesEvent, wxCommandEvent);
+wxIMPLEMENT_DYNAMIC_CLASS(wxExplorerBrowserEnumerationEvent, wxCommandEvent);
+
+wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_DEFAULT_COMMAND, wxExplorerBrowserEvent);
+wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_SELECTION_CHANGED, wxExplorerBrowserEvent);
+wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_CONTEXTMENU_START, wxExplorerBrowserEvent);
+wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_NAVIGATING, wxExplorerBrowserEvent);
+wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_NAVIGATION_COMPLETE, wxExplorerBrowserEvent);
+wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_NAVIGATION_FAILED, wxExplorerBrowserEvent);
+wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_VIEW_CREATED, wxExplorerBrowserEvent);
+wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_ITEMS_CHANGED, wxExplorerBrowserChangeEvent);
+wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_SEARCH_PROGRESS, wxExplorerBrowserProgressEvent);
+wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_SEARCH_COMPLETED, wxExplorerBrowserProgressEvent);
+wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_RESULTS_PROGRESS, wxExplorerBrowserProgressEvent);
+wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_RESULTS_COMPLETED, wxExplorerBrowserProgressEvent);
+wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_THUMBNAIL_READY, wxExplorerBrowserThumbnailEvent);
+wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_VIEWPORT_CHANGED, wxExplorerBrowserViewportEvent);
+wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_FOLDER_SIZE_PROGRESS, wxExplorerBrowserFolderSizeEvent);
+wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_FOLDER_SIZE_COMPLETED, wxExplorerBrowserFolderSizeEvent);
+wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_ITEM_PROPERTIES, wxExplorerBrowserItemPropertiesEvent);
+wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_ENUMERATION_ITEMS, wxExplorerBrowserEnumerationEvent);
+wxDEFINE_EVENT(wxEVT_EXPLORER_BROWSER_ENUMERATION_COMPLETED, wxExplorerBrowserEnumerationEvent);
@@ -1,110 +1,34 @@
-////////////////////////////////////////////////////////////////////////////////////
-//
-//  Name:        wxExplorerBrowser.h
-//  Purpose:     Implements wxExplorerBrowser, a class for hosting
-//               IExplorerBrowser in wxWidgets applications
-//  Author:      PB
-//  Copyright:   (c) 2018 PB <pbfordev@gmail.com>
-//  Licence:     wxWindows licence
-//
-////////////////////////////////////////////////////////////////////////////////////
-
-#ifndef WX_EXPLORER_BROWSER_H_DEFINED
-#define WX_EXPLORER_BROWSER_H_DEFINED
-
-#include <vector>
-
-#include <wx/panel.h>
-
-/** @file 
-    
-    Contains wxExplorerBrowser, a wxWidgets control hosting IExplorerBrowser.
-*/
-
-/**    
-    Represents a very simplified shell item. 
-*/
-class wxExplorerBrowserItem
-{
-public:
-    typedef std::vector<wxExplorerBrowserItem> List;
-
-    /**    
-        Zip files are reported as File although they 
-        can also browsed as folders, all items inside 
-        zips are reported as Other.    
-    */    
-    enum Type
-    {
-        Unknown     = 0,    /*!< item type is unknown, unimportant, or item is invalid  */
-        File        = 0x01, /*!< filesystem file        */
-        Directory   = 0x02, /*!< filesystem directory   */
-        Other       = 0x08  /*!< not File or Directory  */
-    };
-
-    wxExplorerBrowserItem(Type type = Unknown)
-        : m_type(type), m_SFGAO(0)  {}
-
-    Type GetType() const { return m_type; }
-
-    /*! Returns the full filesystem path if the item is File
-        or Directory and empty string otherwise. */
-    wxString GetPath() const { return m_path; }
-
-    /*! Returns parent-relative display name as shown in the explorer view */
-    wxString GetDisplayName() const { return m_displayName; }
-
-    /** 
-        Returns a combination of SFGAO_FILESYSTEM, SFGAO_FOLDER, SFGAO_LINK, and SFGAO_STREAM for the item.
-        
-        @see IsFile(), IsDirectory(), IsFileSystem(), IsFolder, IsVirtualZipDirectory(), IsShortcut()
-    */
-    wxUint32 GetSFGAO() const { return m_SFGAO; }
-
-    /*! Returns true if the item is a filesystem file. */
-    bool IsFile() const { return GetType() == File; }
-
-    /*! Returns true if the item is a filesystem folder. */
-    bool IsDirectory() const { return GetType() == Directory; }
-
-    /*! Returns true if the item is a filesystem file or folder. */
-    bool IsFileSystem() const { return (IsFile() || IsDirectory()); }
-
-    /*! Returns true if the item is Directory or a virtual folder. */
-    bool IsFolder() const { return (GetSFGAO() & 0x20000000L); } // 0x20000000L = SFGAO_FOLDER
-
-    /** 
-        Returns true if the item is a virtual zip directory, i.e.,
-        a filesystem file that can also be browsed as a virtual folder. 
-    */
-    bool IsVirtualZipDirectory() const { return IsFile() && IsFolder(); }
-
-    /*! Returns true if the item is a shortcut. */
-    bool IsShortcut() const { return (GetSFGAO() & 0x00010000); } // 0x00010000 = SFGAO_LINK
-   
-    /*! Sets item's type. */
-    void SetType(Type type) { m_type = type; }
-    
-    /*! Sets item's path. */
-    void SetPath(const wxString& path) { m_path = path; }
-    
-    /*! Sets item's display name. */
-    void SetDisplayName(const wxString& name) { m_displayName = name; }
-    
-    /*! Sets item's SFGAO attributes. */
-    void SetSFGAO(wxUint32 attr) { m_SFGAO = attr; }
-private:
-    Type m_type;
-    wxString m_path;
-    wxString m_displayName;
-    wxUint32 m_SFGAO;
-};
-
+////////////////////////////////////////////////////////////////////////////////////
+//
+//  Name:        wxExplorerBrowser.h
+//  Purpose:     Implements wxExplorerBrowser, a class for hosting
+//               IExplorerBrowser in wxWidgets applications
+//  Author:      PB
+//  Copyright:   (c) 2018 PB <pbfordev@gmail.com>
+//  Licence:     wxWindows licence
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef WX_EXPLORER_BROWSER_H_DEFINED
+#define WX_EXPLORER_BROWSER_H_DEFINED
+
+#include <vector>
+
+#include <wx/bitmap.h>
+#include <wx/panel.h>
+
+#include "wxExplorerBrowserCore.h"
+
+/** @file 
+    
+    Contains wxExplorerBrowser, a wxWidgets control hosting IExplorerBrowser.
+*/
+
 /**
     Default name for wxExplorerBrowser.
-*/
-extern const char wxExplorerBrowserNameStr[];
-
+*/
+extern const char wxExplorerBrowserNameStr[];
+
 /**
     A wxWidgets control that hosts [IExplorerBrowser](https://msdn.microsoft.com/en-us/library/windows/desktop/bb761909).
 
@@ -114,390 +38,1243 @@ extern const char wxExplorerBrowserNameStr[];
     Filtering does not work at all for folders that are part of Windows libraries.
 
     @see wxExplorerBrowserItem, wxExplorerBrowserEvent
-*/
-class wxExplorerBrowser : public wxPanel
-{
-public:
-    /** 
-        Same as [EXPLORER_BROWSER_OPTIONS](https://msdn.microsoft.com/en-us/library/windows/desktop/bb762501)
-    */
-    enum Options
-    {
-        EBO_NONE                = 0x00000000,
-        EBO_NAVIGATEONCE        = 0x00000001,
-        EBO_SHOWFRAMES          = 0x00000002,
-        EBO_ALWAYSNAVIGATE      = 0x00000004,
-        EBO_NOTRAVELLOG         = 0x00000008,
-        EBO_NOWRAPPERWINDOW     = 0x00000010,
-        EBO_HTMLSHAREPOINTVIEW  = 0x00000020,
-        EBO_NOBORDER            = 0x00000040,
-        EBO_NOPERSISTVIEWSTATE  = 0x00000080
-    };
-    
-    /** 
-        Same as [FOLDERVIEWMODE](https://msdn.microsoft.com/en-us/library/windows/desktop/bb762510)
-    */
-    enum ViewMode
-    {
-        FVM_AUTO        = -1,
-        FVM_ICON        = 1,
-        FVM_SMALLICON   = 2,
-        FVM_LIST        = 3,
-        FVM_DETAILS     = 4,
-        FVM_THUMBNAIL   = 5,
-        FVM_TILE        = 6,
-        FVM_THUMBSTRIP  = 7,
-        FVM_CONTENT     = 8,
-    };
-    
-    /** 
-        Same as [FOLDERFLAGS](https://msdn.microsoft.com/en-us/library/windows/desktop/bb762508)
-    */
-    enum FolderFlags
-    {
-        FWF_NONE                 = 0x00000000,
-        FWF_AUTOARRANGE          = 0x00000001,
-        FWF_ABBREVIATEDNAMES     = 0x00000002,
-        FWF_SNAPTOGRID           = 0x00000004,
-        FWF_OWNERDATA            = 0x00000008,
-        FWF_BESTFITWINDOW        = 0x00000010,
-        FWF_DESKTOP              = 0x00000020,
-        FWF_SINGLESEL            = 0x00000040,
-        FWF_NOSUBFOLDERS         = 0x00000080,
-        FWF_TRANSPARENT          = 0x00000100,
-        FWF_NOCLIENTEDGE         = 0x00000200,
-        FWF_NOSCROLL             = 0x00000400,
-        FWF_ALIGNLEFT            = 0x00000800,
-        FWF_NOICONS              = 0x00001000,
-        FWF_SHOWSELALWAYS        = 0x00002000,
-        FWF_NOVISIBLE            = 0x00004000,
-        FWF_SINGLECLICKACTIVATE  = 0x00008000,
-        FWF_NOWEBVIEW            = 0x00010000,
-        FWF_HIDEFILENAMES        = 0x00020000,
-        FWF_CHECKSELECT          = 0x00040000,
-        FWF_NOENUMREFRESH        = 0x00080000,
-        FWF_NOGROUPING           = 0x00100000,
-        FWF_FULLROWSELECT        = 0x00200000,
-        FWF_NOFILTERS            = 0x00400000,
-        FWF_NOCOLUMNHEADER       = 0x00800000,
-        FWF_NOHEADERINALLVIEWS   = 0x01000000,
-        FWF_EXTENDEDTILES        = 0x02000000,
-        FWF_TRICHECKSELECT       = 0x04000000,
-        FWF_AUTOCHECKSELECT      = 0x08000000,
-        FWF_NOBROWSERVIEWSTATE   = 0x10000000,
-        FWF_SUBSETGROUPS         = 0x20000000,
-        FWF_USESEARCHFOLDER      = 0x40000000,
-        FWF_ALLOWRTLREADING      = 0x80000000
-    };
-
-    /** 
-        Same as [FOLDERSETTINGS](https://msdn.microsoft.com/en-us/library/windows/desktop/bb773308)
-    */
-    struct FolderSettings
-    {
-        wxUint32 m_viewMode;
-        wxUint32 m_flags;
-
-        FolderSettings() 
-            : m_viewMode(static_cast<wxUint32>(FVM_AUTO)), m_flags(FWF_NONE) {}        
-    };
-
-    /** 
-        Individual explorer panes, see [here](https://msdn.microsoft.com/en-us/library/windows/desktop/bb761856)
-        for descriptions of individual panes.
-
-        @see PaneState, PaneSettings
-    */
-    enum PaneID
-    {
-        EP_NavPane = 0,
-        EP_Commands,
-        EP_Commands_Organize,
-        EP_Commands_View,
-        EP_DetailsPane,
-        EP_PreviewPane,
-        EP_QueryPane,
-        EP_AdvQueryPane,
-        EP_StatusBar,
-        EP_Ribbon     
-    };
-
-    /** 
-        Same as [EXPLORERPANESTATE](https://msdn.microsoft.com/en-us/library/windows/desktop/bb762580).
-
-        @see PaneID, PaneSettings
-    */
-     enum PaneState
-     { 
-        EPS_DONTCARE      = 0x0000,
-        EPS_DEFAULT_ON    = 0x0001,
-        EPS_DEFAULT_OFF   = 0x0002,
-        EPS_STATEMASK     = 0xFFFF,
-        EPS_INITIALSTATE  = 0x00010000,
-        EPS_FORCE         = 0x00020000
-    };
-     /** 
-        @class PaneSettings
-        Manages visiblity of individual explorer panes.
-        
-        @see PaneID, PaneState, wxExplorerBrowser::CreateStruct
-     */
-     class PaneSettings
-     {
-     public:
-         PaneSettings() { memset(&m_data, EPS_DONTCARE, sizeof(m_data)); }
-
-         /** See PaneState for possible values of flags. */
-         void SetFlags(PaneID pane, wxUint32 flags) { m_data[pane] = flags; }
-         
-         /** See PaneState for possible values of flags. */
-         wxUint32 GetFlags(PaneID pane) const { return m_data[pane]; }
-     private:
-         wxUint32 m_data[EP_Ribbon+1];
-     };
-     
-     /**
-        Determines the parameters of newly created hosted ExplorerBrowser.
-     */
-     struct CreateStruct
-     {        
-         wxUint32 options;   /*!< see the Options enum  */
-         FolderSettings folderSettings;
-         PaneSettings paneSettings;
-
-         CreateStruct() : options(EBO_NOBORDER | EBO_SHOWFRAMES) {}
-     };
-
-     enum BrowseTarget
-     {
-        Parent,         /*!< Go the parent of the current folder. */  
-        HistoryBack,    /*!< Go back in the browsing history. */  
-        HistoryForward  /*!< Go forward in the browsing history. */     
-     };
-     
-     /** 
-        The default constructor, the control is not created until Create() is called.
-     */
-     wxExplorerBrowser() {}
-     ~wxExplorerBrowser();
-
-    wxExplorerBrowser(wxWindow* parent, const CreateStruct& createStruct,                      
-                      const wxString& path = wxEmptyString,
-                      wxWindowID id = wxID_ANY,
-                      const wxPoint& pos = wxDefaultPosition, const wxSize& size = wxDefaultSize,
-                      const wxString& name = wxExplorerBrowserNameStr);
-
-    bool Create(wxWindow* parent, const CreateStruct& createStruct,                
-                const wxString& path = wxEmptyString,
-                wxWindowID id = wxID_ANY,
-                const wxPoint& pos = wxDefaultPosition, const wxSize& size = wxDefaultSize,
-                const wxString& name = wxExplorerBrowserNameStr);
-
-    bool SetFolderSettings(const FolderSettings& folderSettings);
-
-    /**
-        See Options for possible values of @a options.
-    */
-    bool GetOptions(wxUint32& options);
-    
-    /**
-        See Options for possible values of @a options.
-    */
-    bool SetOptions(wxUint32 options);
-    
-    /**
-        String @a text will be shown when the view does not contain any items.
-    */
-    bool SetEmptyText(const wxString& text);    
-    
-    /**
-        The view settings will be stored in the Registry under the name @a bag.
-    */
-    bool SetPropertyBag(const wxString& bag);   
-    
-    /**
-        Will change the curent folder to the @a item.
-        Item can be an absolute filesystem path or another string
-        ::SHParseDisplayName can understand, such as 
-        "::{20D04FE0-3AEA-1069-A2D8-08002B30309D}" for My Computer.
-
-        if @keepWordWheelText then any search text entered in the Search box in Windows Explorer
-         will be be preserved during the navigation, i.e., the items at the new location will be
-         filtered in the same way they were filtered at the previous location,
-    */
-    bool BrowseTo(const wxString& item, bool keepWordWheelText = false);
-    
-    /**
-        Will change the curent folder to the @a target. 
-        For explanation of @a keepWordWheelText see the other variant
-        of this method.
-    */
-    bool BrowseTo(BrowseTarget target, bool keepWordWheelText = false);
-    
-    /**  Refreshes the current folder view. */
-    bool Refresh();
-
-    /** Returns the folder the contents of which is currently displayed. */
-    bool GetFolder(wxExplorerBrowserItem& item);
-
-    /** Displays the result of search for the curent folder and
-        its subfolders. @a str can be anything Search in Explorer understands.  
-        Call with an empty string to cancel search.
-    */
-    bool SearchFolder(const wxString& str);
-    
-    /** Removes all items from the results folder */
-    bool RemoveAll();    
-
-    /**
-        Items' type is ignored here, items' path or display name must be relative to the current folder.
-        Items that were already selected keep their selection.
-        If @a notTakeFocus is true, the folder view will not be focused.
-    */
-    bool SelectItems(const wxExplorerBrowserItem::List& items, bool notTakeFocus = true);
-    
-    /**
-        Deselects all the selected items in the current folder.
-        If @a notTakeFocus is true, the folder view will not be focused.
-    */
-    bool DeselectAllItems(bool notTakeFocus = true);
-
-    /** 
-        Returns selected items that match @a itemTypes.
-    */
-    bool GetSelectedItems(wxExplorerBrowserItem::List& items,
-                          wxUint32 itemTypes = wxExplorerBrowserItem::File);
-
-    /** 
-        Returns all items in the current folder that match @a itemTypes.        
-    */
-    bool GetAllItems(wxExplorerBrowserItem::List& items,
-                     wxUint32 itemTypes = wxExplorerBrowserItem::File);
-                
-    /**
-        An item of @a fileMasks should contain a single wild-card mask such as "*.jpg" or "budget201*.*".
-        The filter will be applied only on items with their type matching @a itemTypes.
-
-        @bug Unfortunately filtering does not work for query-backed views such as libraries or search results.        
-    */
-    bool SetFilter(const wxArrayString& fileMasks, wxUint32 itemTypes = wxExplorerBrowserItem::File);
-    
-    /** 
-        Clears the filter. @see SetFilter()
-    */
-    bool RemoveFilter();
-
-    /** 
-        Sets pane settings. 
-        The change in settings will be reflected only when the view changes,
-        e.g. a different folder was navigated to.
-    */
-    bool SetPaneSettings(const PaneSettings& settings);
-
-    /** 
-        Returns the actual IExplorerBrowser pointer
-        or nullptr if the interface was not created.
-    */
-    void* GetIExplorerBrowser();
-    
-    /** @private 
-        Overriding is necessary for ExplorerBrowser shortcuts like <Ctrl+A>
-        or <F2> keep working while being hosted.
-    */
-    bool MSWTranslateMessage(WXMSG* msg) override;         
-private:    
-    // use the pimpl idiom so MSW headers are not included from a public header
-    class wxExplorerBrowserImpl;    
-    wxExplorerBrowserImpl* m_impl { nullptr };
-  
-    // the only child of the panel which is
-    // the actual parent of ExploreBrowser control
-    wxWindow* m_host {nullptr};
-
-    void OnSize(wxSizeEvent& evt);
-    void OnPaint(wxPaintEvent& evt);
-
-    wxDECLARE_DYNAMIC_CLASS(wxExplorerBrowser);
-};
-
-/**
-    All the wxExplorerBrowserEvents are those sent only for the items of the folder view,
-    see [IExplorerBrowserEvents](https://msdn.microsoft.com/en-us/library/windows/desktop/bb761883).
-    I.e., the events for the navigation panel hosting favorites and the folder tree 
-    ([INameSpaceTreeControlEvents](https://msdn.microsoft.com/en-us/library/windows/desktop/bb761567)
-    are not sent. 
-
-    For some of the events which may concern selected items, the event's
-    item contains only the first selected item of possible many.
-    Use wxIExplorerBrowser::GetSelectedItems() to obtain all selected items.
-
-    @b wxEVT_EXPLORER_BROWSER_DEFAULT_COMMAND    
-    Sent before the default action is taken on the selected item(s), can be vetoed.
-    
-    @b wxEVT_EXPLORER_BROWSER_SELECTION_CHANGED    
-    Sent after the selection was changed. If the current selection is empty, 
-    event's item type will be Unknown and the item will not contain any other information.    
-    
-    @b wxEVT_EXPLORER_BROWSER_CONTEXTMENU_START    
-    Sent before the shell context menu for the selected item(s) is shown, can be vetoed.
-    
-    @b wxEVT_EXPLORER_BROWSER_NAVIGATING    
-    Sent before the folder is changed, can be vetoed. 
-    Event's item contains the folder to which the view is navigating.
-    
-    @b wxEVT_EXPLORER_BROWSER_NAVIGATION_COMPLETE
-    Sent after the folder was changed. 
-    
-    @b wxEVT_EXPLORER_BROWSER_NAVIGATION_FAILED
-    Sent when the folder could not be changed, e.g., navigating was vetoed or the folder is not available.
-    
-    @b wxEVT_EXPLORER_BROWSER_VIEW_CREATED
-    Sent when the new view for a folder was created.    
-
-    @see wxExplorerBrowserItem, wxExplorerBrowser, wxNotifyEvent::Veto()
-
-*/
-class wxExplorerBrowserEvent: public wxNotifyEvent
-{
-public:
-    wxExplorerBrowserEvent(wxEventType command = wxEVT_NULL, int id = 0)
-        : wxNotifyEvent(command, id) {}
-
-    const wxExplorerBrowserItem& GetItem() const { return m_item; }
-    void SetItem(const wxExplorerBrowserItem& item) { m_item = item; }
-
-    wxEvent* Clone() const override { return new wxExplorerBrowserEvent(*this); }
-private:
-    wxExplorerBrowserItem m_item;
-
-    wxDECLARE_DYNAMIC_CLASS_NO_ASSIGN(wxExplorerBrowserEvent);
-};
-
-wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_DEFAULT_COMMAND, wxExplorerBrowserEvent);
-wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_SELECTION_CHANGED, wxExplorerBrowserEvent);
-wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_CONTEXTMENU_START, wxExplorerBrowserEvent);
-wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_NAVIGATING, wxExplorerBrowserEvent);
-wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_NAVIGATION_COMPLETE, wxExplorerBrowserEvent);
-wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_NAVIGATION_FAILED, wxExplorerBrowserEvent);
-wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_VIEW_CREATED, wxExplorerBrowserEvent);
-
-#define wxExplorerBrowserEventHandler(func) (&func)
-
-typedef void (wxEvtHandler::*wxExplorerBrowserEventFunction)(wxExplorerBrowserEvent&);
-
-#define EXPLORER_DEFAULT_COMMAND(id, func) \
-    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_DEFAULT_COMMAND, id, wxExplorerBrowserEventHandler(func))
-#define EXPLORER_BROWSER_SELECTION_CHANGED(id, func) \
-    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_SELECTION_CHANGED, id, wxExplorerBrowserEventHandler(func))
-#define EVT_EXPLORER_BROWSER_CONTEXTMENU_START(id, func) \
-    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_CONTEXTMENU_START, id, wxExplorerBrowserEventHandler(func))
-#define EXPLORER_BROWSER_NAVIGATING(id, func) \
-    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_NAVIGATING, id, wxExplorerBrowserEventHandler(func))
-#define EXPLORER_BROWSER_NAVIGATION_COMPLETE(id, func) \
-    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_NAVIGATION_COMPLETE, id, wxExplorerBrowserEventHandler(func))
-#define EXPLORER_BROWSER_NAVIGATION_FAILED(id, func) \
-    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_NAVIGATION_FAILED, id, wxExplorerBrowserEventHandler(func))
-#define EXPLORER_BROWSER_VIEW_CREATED(id, func) \
-    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_VIEW_CREATED, id, wxExplorerBrowserEventHandler(func))
-
+*/
+class wxExplorerBrowser : public wxPanel
+{
+public:
+    /** 
+        Same as [EXPLORER_BROWSER_OPTIONS](https://msdn.microsoft.com/en-us/library/windows/desktop/bb762501)
+    */
+    enum Options
+    {
+        EBO_NONE                = 0x00000000,
+        EBO_NAVIGATEONCE        = 0x00000001,
+        EBO_SHOWFRAMES          = 0x00000002,
+        EBO_ALWAYSNAVIGATE      = 0x00000004,
+        EBO_NOTRAVELLOG         = 0x00000008,
+        EBO_NOWRAPPERWINDOW     = 0x00000010,
+        EBO_HTMLSHAREPOINTVIEW  = 0x00000020,
+        EBO_NOBORDER            = 0x00000040,
+        EBO_NOPERSISTVIEWSTATE  = 0x00000080
+    };
+    
+    /** 
+        Same as [FOLDERVIEWMODE](https://msdn.microsoft.com/en-us/library/windows/desktop/bb762510)
+    */
+    enum ViewMode
+    {
+        FVM_AUTO        = -1,
+        FVM_ICON        = 1,
+        FVM_SMALLICON   = 2,
+        FVM_LIST        = 3,
+        FVM_DETAILS     = 4,
+        FVM_THUMBNAIL   = 5,
+        FVM_TILE        = 6,
+        FVM_THUMBSTRIP  = 7,
+        FVM_CONTENT     = 8,
+    };
+    
+    /** 
+        Same as [FOLDERFLAGS](https://msdn.microsoft.com/en-us/library/windows/desktop/bb762508)
+    */
+    enum FolderFlags
+    {
+        FWF_NONE                 = 0x00000000,
+        FWF_AUTOARRANGE          = 0x00000001,
+        FWF_ABBREVIATEDNAMES     = 0x00000002,
+        FWF_SNAPTOGRID           = 0x00000004,
+        FWF_OWNERDATA            = 0x00000008,
+        FWF_BESTFITWINDOW        = 0x00000010,
+        FWF_DESKTOP              = 0x00000020,
+        FWF_SINGLESEL            = 0x00000040,
+        FWF_NOSUBFOLDERS         = 0x00000080,
+        FWF_TRANSPARENT          = 0x00000100,
+        FWF_NOCLIENTEDGE         = 0x00000200,
+        FWF_NOSCROLL             = 0x00000400,
+        FWF_ALIGNLEFT            = 0x00000800,
+        FWF_NOICONS              = 0x00001000,
+        FWF_SHOWSELALWAYS        = 0x00002000,
+        FWF_NOVISIBLE            = 0x00004000,
+        FWF_SINGLECLICKACTIVATE  = 0x00008000,
+        FWF_NOWEBVIEW            = 0x00010000,
+        FWF_HIDEFILENAMES        = 0x00020000,
+        FWF_CHECKSELECT          = 0x00040000,
+        FWF_NOENUMREFRESH        = 0x00080000,
+        FWF_NOGROUPING           = 0x00100000,
+        FWF_FULLROWSELECT        = 0x00200000,
+        FWF_NOFILTERS            = 0x00400000,
+        FWF_NOCOLUMNHEADER       = 0x00800000,
+        FWF_NOHEADERINALLVIEWS   = 0x01000000,
+        FWF_EXTENDEDTILES        = 0x02000000,
+        FWF_TRICHECKSELECT       = 0x04000000,
+        FWF_AUTOCHECKSELECT      = 0x08000000,
+        FWF_NOBROWSERVIEWSTATE   = 0x10000000,
+        FWF_SUBSETGROUPS         = 0x20000000,
+        FWF_USESEARCHFOLDER      = 0x40000000,
+        FWF_ALLOWRTLREADING      = 0x80000000
+    };
+
+    /** 
+        Same as [FOLDERSETTINGS](https://msdn.microsoft.com/en-us/library/windows/desktop/bb773308)
+    */
+    struct FolderSettings
+    {
+        wxUint32 m_viewMode;
+        wxUint32 m_flags;
+
+        FolderSettings() 
+            : m_viewMode(static_cast<wxUint32>(FVM_AUTO)), m_flags(FWF_NONE) {}        
+    };
+
+    /** 
+        Individual explorer panes, see [here](https://msdn.microsoft.com/en-us/library/windows/desktop/bb761856)
+        for descriptions of individual panes.
+
+        @see PaneState, PaneSettings
+    */
+    enum PaneID
+    {
+        EP_NavPane = 0,
+        EP_Commands,
+        EP_Commands_Organize,
+        EP_Commands_View,
+        EP_DetailsPane,
+        EP_PreviewPane,
+        EP_QueryPane,
+        EP_AdvQueryPane,
+        EP_StatusBar,
+        EP_Ribbon     
+    };
+
+    /** 
+        Same as [EXPLORERPANESTATE](https://msdn.microsoft.com/en-us/library/windows/desktop/bb762580).
+
+        @see PaneID, PaneSettings
+    */
+     enum PaneState
+     { 
+        EPS_DONTCARE      = 0x0000,
+        EPS_DEFAULT_ON    = 0x0001,
+        EPS_DEFAULT_OFF   = 0x0002,
+        EPS_STATEMASK     = 0xFFFF,
+        EPS_INITIALSTATE  = 0x00010000,
+        EPS_FORCE         = 0x00020000
+    };
+     /** 
+        @class PaneSettings
+        Manages visiblity of individual explorer panes.
+        
+        @see PaneID, PaneState, wxExplorerBrowser::CreateStruct
+     */
+     class PaneSettings
+     {
+     public:
+         PaneSettings() { memset(&m_data, EPS_DONTCARE, sizeof(m_data)); }
+
+         /** See PaneState for possible values of flags. */
+         void SetFlags(PaneID pane, wxUint32 flags) { m_data[pane] = flags; }
+         
+         /** See PaneState for possible values of flags. */
+         wxUint32 GetFlags(PaneID pane) const { return m_data[pane]; }
+     private:
+         wxUint32 m_data[EP_Ribbon+1];
+     };
+     
+     /**
+        Determines the parameters of newly created hosted ExplorerBrowser.
+     */
+     struct CreateStruct
+     {        
+         wxUint32 options;   /*!< see the Options enum  */
+         FolderSettings folderSettings;
+         PaneSettings paneSettings;
+
+         CreateStruct() : options(EBO_NOBORDER | EBO_SHOWFRAMES) {}
+     };
+
+     enum BrowseTarget
+     {
+        Parent,         /*!< Go the parent of the current folder. */  
+        HistoryBack,    /*!< Go back in the browsing history. */  
+        HistoryForward  /*!< Go forward in the browsing history. */     
+     };
+     
+     /**
+        Determines when the hosted ExplorerBrowser is resized.
+
+        @see SetResizePolicy()
+     */
+     enum ResizePolicy
+     {
+        Resize_Immediate, /*!< Resize on every size event (the default). */
+        Resize_Coalesce   /*!< Resize only once the resizing is finished. */
+     };
+
+     /**
+        Determines how GetAllItems() and GetSelectedItems() fill the list.
+        Both reuse the capacity of the list and the string buffers of the items
+        already in it, so repeatedly retrieving similar items into the same list
+        does not allocate.
+     */
+     enum ItemsFillMode
+     {
+        Items_Overwrite, /*!< Replace the items in the list. */
+        Items_Append     /*!< Add the items after those already in the list. */
+     };
+
+     /** 
+        The default constructor, the control is not created until Create() is called.
+     */
+     wxExplorerBrowser() {}
+     ~wxExplorerBrowser();
+
+    wxExplorerBrowser(wxWindow* parent, const CreateStruct& createStruct,                      
+                      const wxString& path = wxEmptyString,
+                      wxWindowID id = wxID_ANY,
+                      const wxPoint& pos = wxDefaultPosition, const wxSize& size = wxDefaultSize,
+                      const wxString& name = wxExplorerBrowserNameStr);
+
+    bool Create(wxWindow* parent, const CreateStruct& createStruct,                
+                const wxString& path = wxEmptyString,
+                wxWindowID id = wxID_ANY,
+                const wxPoint& pos = wxDefaultPosition, const wxSize& size = wxDefaultSize,
+                const wxString& name = wxExplorerBrowserNameStr);
+
+    bool SetFolderSettings(const FolderSettings& folderSettings);
+
+    /**
+        See Options for possible values of @a options.
+    */
+    bool GetOptions(wxUint32& options);
+    
+    /**
+        See Options for possible values of @a options.
+    */
+    bool SetOptions(wxUint32 options);
+    
+    /**
+        String @a text will be shown when the view does not contain any items.
+    */
+    bool SetEmptyText(const wxString& text);    
+    
+    /**
+        The view settings will be stored in the Registry under the name @a bag.
+    */
+    bool SetPropertyBag(const wxString& bag);   
+    
+    /**
+        Will change the curent folder to the @a item.
+        Item can be an absolute filesystem path or another string
+        ::SHParseDisplayName can understand, such as 
+        "::{20D04FE0-3AEA-1069-A2D8-08002B30309D}" for My Computer.
+
+        if @keepWordWheelText then any search text entered in the Search box in Windows Explorer
+         will be be preserved during the navigation, i.e., the items at the new location will be
+         filtered in the same way they were filtered at the previous location,
+    */
+    bool BrowseTo(const wxString& item, bool keepWordWheelText = false);
+    
+    /**
+        Will change the curent folder to the @a target. 
+        For explanation of @a keepWordWheelText see the other variant
+        of this method.
+    */
+    bool BrowseTo(BrowseTarget target, bool keepWordWheelText = false);
+    
+    /**  Refreshes the current folder view. */
+    bool Refresh();
+
+    /** Returns the folder the contents of which is currently displayed. */
+    bool GetFolder(wxExplorerBrowserItem& item);
+
+    /** Displays the result of search for the curent folder and
+        its subfolders. @a str can be anything Search in Explorer understands.  
+        Call with an empty string to cancel search.
+
+        If the search pipeline is enabled, the search is only scheduled
+        and the method returns immediately, see EnableSearchPipeline().
+    */
+    bool SearchFolder(const wxString& str);
+
+    /**
+        When enabled, SearchFolder() is suitable for calling on every keystroke.
+        The search is started only when SearchFolder() was not called for
+        @a debounceDelay milliseconds, a newer search cancels the running one,
+        and a search identical to the running or the last completed one is not
+        started again.
+
+        wxEVT_EXPLORER_BROWSER_SEARCH_PROGRESS is sent when the search starts and
+        whenever the number of the found items changes, wxEVT_EXPLORER_BROWSER_SEARCH_COMPLETED
+        when the number stops changing or the search was cancelled.
+
+        @see wxExplorerBrowserProgressEvent
+    */
+    bool EnableSearchPipeline(bool enable = true, int debounceDelay = 250);
+
+    /**
+        Enables SearchIndex(). The names of the items in the current folder are indexed
+        in memory when first searched after navigating, see wxExplorerBrowserTrigramIndex.
+        The folder is enumerated by the shell, not taken from the view, so a view filtered by
+        the previous search does not limit the next one; the filter set with SetFilter() and
+        the ignore rules apply. With the change notifications enabled, see
+        EnableChangeNotifications(), the created, deleted and renamed items update the index
+        as they are reported, and the folder is indexed again when the shell reports only
+        that it changed. Without them, a folder in the file system is indexed again when it
+        was written to since; the index of a folder outside the file system is kept until
+        navigating or calling Refresh().
+
+        Filtering the view by SearchIndex() makes the view enumerate the folder again,
+        so the view is filtered only when SearchIndex() was not called for @a filterDelay
+        milliseconds.
+
+        Disabling the index also shows all items again.
+    */
+    bool EnableSearchIndex(bool enable = true, int filterDelay = 250);
+
+    /**
+        Finds the items in the current folder whose names contain @a str, case-insensitively.
+        The names are the filenames of File and Directory items and the display names of the
+        other items. Unlike SearchFolder(), the folder is not searched by the shell but the names
+        are looked up in the index, so the found names are returned at once and this is suitable
+        for calling on every keystroke.
+
+        If @a filterView is true, only the found items are shown, after the delay set by
+        EnableSearchIndex(), until the next call, navigating, or disabling the index; an empty
+        @a str shows all items again. If @a names is not null, it is filled with the names found.
+
+        @bug As with SetFilter(), the view cannot be filtered for query-backed views.
+    */
+    bool SearchIndex(const wxString& str, bool filterView = true, wxArrayString* names = nullptr);
+    
+    /** Removes all items from the results folder, cancels adding the results */
+    bool RemoveAll();    
+
+    /**
+        Adds the items to the results folder, displaying an empty one first
+        if the browser does not display a results folder yet.
+
+        The items are added in batches on timer, so that adding many items
+        does not make the view unresponsive, see SetResultBatchLimits().
+        Adding more items while the previous ones are still being added
+        appends them to the queue.
+
+        wxEVT_EXPLORER_BROWSER_RESULTS_PROGRESS is sent after each batch,
+        wxEVT_EXPLORER_BROWSER_RESULTS_COMPLETED when all the items were added,
+        or when adding them was cancelled by CancelAddingResults(), RemoveAll(),
+        Park() or by navigating away from the results.
+
+        @see wxExplorerBrowserProgressEvent
+    */
+    bool AddResults(const wxArrayString& paths);
+
+    /**
+        Adds the items identified by serialized absolute ID lists, i.e., the bytes
+        of ITEMIDLIST including its terminator. The invalid ones are counted as failed.
+    */
+    bool AddResults(const std::vector<wxExplorerBrowserResultInjector::IDList>& idLists);
+
+    /** Drops the items queued by AddResults() which were not added yet. */
+    bool CancelAddingResults();
+
+    /**
+        A batch of AddResults() should take no longer than @a batchTime milliseconds,
+        and the next batch starts @a batchInterval milliseconds after the previous one.
+    */
+    bool SetResultBatchLimits(int batchTime = 15, int batchInterval = 30);
+
+    /**
+        Items' type is ignored here, items' path or display name must be relative to the current folder.
+        Items that were already selected keep their selection.
+        If @a notTakeFocus is true, the folder view will not be focused.
+    */
+    bool SelectItems(const wxExplorerBrowserItem::List& items, bool notTakeFocus = true);
+
+    typedef std::function<bool(const wxExplorerBrowserItem& item)> ItemPredicate;
+
+    /**
+        Selects the items in the current folder with their type matching @a itemTypes
+        and their name matching any of @a fileMasks, see SetFilter() for the masks.
+        The items are matched and selected in one pass, without retrieving them first.
+
+        Items that were already selected keep their selection.
+        If @a notTakeFocus is true, the folder view will not be focused.
+        If @a selectedCount is not null, it is set to the number of the newly selected items.
+    */
+    bool SelectWhere(const wxArrayString& fileMasks, wxUint32 itemTypes = wxExplorerBrowserItem::File,
+                     bool notTakeFocus = true, size_t* selectedCount = nullptr);
+
+    /**
+        Selects the items in the current folder for which @a predicate returns true.
+        The item passed to @a predicate is valid only during the call.
+        @see SelectWhere(const wxArrayString&, wxUint32, bool, size_t*)
+    */
+    bool SelectWhere(const ItemPredicate& predicate, bool notTakeFocus = true,
+                     size_t* selectedCount = nullptr);
+    
+    /**
+        Deselects all the selected items in the current folder.
+        If @a notTakeFocus is true, the folder view will not be focused.
+    */
+    bool DeselectAllItems(bool notTakeFocus = true);
+
+    /** 
+        Returns selected items that match @a itemTypes.
+        When no item is selected, @a items is left unchanged.
+    */
+    bool GetSelectedItems(wxExplorerBrowserItem::List& items,
+                          wxUint32 itemTypes = wxExplorerBrowserItem::File);
+
+    /**
+        Returns selected items that match @a itemTypes, filling @a items as @a mode says.
+        On failure, @a items contains only the items it had before for Items_Append
+        and is empty for Items_Overwrite. As with the overload above, @a items is
+        left unchanged when no item is selected, whatever the @a mode.
+    */
+    bool GetSelectedItems(wxExplorerBrowserItem::List& items, wxUint32 itemTypes,
+                          ItemsFillMode mode);
+
+    /** 
+        Returns all items in the current folder that match @a itemTypes.        
+    */
+    bool GetAllItems(wxExplorerBrowserItem::List& items,
+                     wxUint32 itemTypes = wxExplorerBrowserItem::File);
+
+    /**
+        Returns all items in the current folder that match @a itemTypes,
+        filling @a items as @a mode says. @see GetSelectedItems(items, itemTypes, mode)
+    */
+    bool GetAllItems(wxExplorerBrowserItem::List& items, wxUint32 itemTypes,
+                     ItemsFillMode mode);
+
+    /**
+        Returns all items in the current folder that match @a itemTypes,
+        sorted in @a order. The sort keys are computed once for each item
+        and the items are sorted in parallel on all cores.
+    */
+    bool GetAllItemsSorted(wxExplorerBrowserItem::List& items,
+                           wxExplorerBrowserItemSorter::Order order = wxExplorerBrowserItemSorter::Order_Natural,
+                           wxUint32 itemTypes = wxExplorerBrowserItem::File);
+
+    /**
+        Returns all items in the current folder that match @a itemTypes and their
+        properties requested with @a propertyFlags, a combination of
+        wxExplorerBrowserItemProperties::Property values. The properties of the item
+        at an index in @a items are at the same index in the columns of @a properties.
+
+        The properties are obtained in parallel, in chunks of items, and the call
+        returns when all of them are done, see RequestItemProperties() for not waiting.
+        The containers are reused, so passing the same ones again avoids allocations.
+    */
+    bool GetItemProperties(wxExplorerBrowserItem::List& items, wxExplorerBrowserItemProperties& properties,
+                           wxUint32 propertyFlags = wxExplorerBrowserItemProperties::Property_All,
+                           wxUint32 itemTypes = wxExplorerBrowserItem::File);
+
+    /**
+        As GetItemProperties(), but only the items are obtained before returning and their
+        properties are obtained on background threads. wxEVT_EXPLORER_BROWSER_ITEM_PROPERTIES
+        is sent with both when done, and before that when the properties of the visible
+        items, which are obtained first, are done.
+
+        A new request cancels the running one, whose event is then not sent.
+        The threads belong to the control, which waits for the chunks being
+        fetched when destroyed.
+    */
+    bool RequestItemProperties(wxUint32 propertyFlags = wxExplorerBrowserItemProperties::Property_All,
+                               wxUint32 itemTypes = wxExplorerBrowserItem::File);
+
+    /**
+        Cancels the request made with RequestItemProperties(), returns false if there is none.
+    */
+    bool CancelItemPropertiesRequest();
+
+    /**
+        Returns in @a items up to @a maxResults items in the current folder that match
+        @a itemTypes and whose display names match @a pattern fuzzily, best first:
+        the characters of @a pattern must appear in the name in the same order,
+        e.g. "prjrpt23" matches "Project_Report_2023.xlsx". If @a scores is not null,
+        it is filled with the scores of the items. See wxExplorerBrowserFuzzyMatcher
+        for the scoring.
+
+        The names of the listing are prepared by the first call and reused by the next
+        ones, so that a search can be repeated on every keystroke. They are prepared again
+        after navigating or refreshing, when the view reports that its items changed,
+        e.g. an item was renamed, when the number of items changes, or when a change
+        notification arrives, see EnableChangeNotifications().
+    */
+    bool QuickFind(const wxString& pattern, wxExplorerBrowserItem::List& items, size_t maxResults = 10,
+                   std::vector<int>* scores = nullptr,
+                   wxUint32 itemTypes = wxExplorerBrowserItem::File | wxExplorerBrowserItem::Directory);
+
+    /**
+        Writes all items in the current folder that match @a itemTypes
+        to @a fileName, see wxExplorerBrowserSnapshot for the file format
+        and reading the file.
+    */
+    bool ExportSnapshot(const wxString& fileName,
+                        wxUint32 itemTypes = wxExplorerBrowserItem::File);
+
+    /**
+        Retrieves all items in the current folder that match @a itemTypes
+        and returns in @a delta how they differ from the items retrieved by the
+        previous call of this method. The first call, a call with different
+        @a itemTypes, or a call after ResetItemChanges() report all items as added.
+
+        Only a hashed fingerprint of the listing is compared, so the changes
+        are found in linear time.
+    */
+    bool GetItemChanges(wxExplorerBrowserListingDelta& delta,
+                        wxUint32 itemTypes = wxExplorerBrowserItem::File);
+
+    /**
+        Forgets the listing remembered by GetItemChanges().
+    */
+    bool ResetItemChanges();
+                
+    /**
+        An item of @a fileMasks should contain a single wild-card mask such as "*.jpg" or "budget201*.*".
+        The masks are added to those set before, call RemoveFilter() first to replace them.
+        The filter will be applied only on items with their type matching @a itemTypes.
+
+        @bug Unfortunately filtering does not work for query-backed views such as libraries or search results.        
+    */
+    bool SetFilter(const wxArrayString& fileMasks, wxUint32 itemTypes = wxExplorerBrowserItem::File);
+    
+    /** 
+        Clears the filter. @see SetFilter()
+    */
+    bool RemoveFilter();
+
+    /**
+        Hides the files and folders in the tree of @a root ignored by the rules of the ignore
+        files named @a fileName, with the syntax and precedence of .gitignore files: a file applies
+        to its folder and the subfolders, its later lines and the files deeper in the tree win,
+        and nothing in an ignored folder can be shown again. @a globalRules are the lines of
+        an ignore file with a lower priority than that in @a root, e.g. those of .git/info/exclude.
+
+        The files of a folder and its ancestors are read once, when first navigating to it and not
+        while its items are filtered, a changed file applies after calling SetIgnoreRules() again.
+        The matching is case-insensitive.
+        Applied together with the filter set with SetFilter(), with the same @bug.
+    */
+    bool SetIgnoreRules(const wxString& root, const wxString& fileName = wxS(".gitignore"),
+                        const wxString& globalRules = wxEmptyString);
+
+    /**
+        Clears the ignore rules. @see SetIgnoreRules()
+    */
+    bool RemoveIgnoreRules();
+
+    /** 
+        Sets pane settings. 
+        The change in settings will be reflected only when the view changes,
+        e.g. a different folder was navigated to.
+    */
+    bool SetPaneSettings(const PaneSettings& settings);
+
+    /**
+        When enabled, the control subscribes to the shell change notifications
+        for the current folder and sends wxEVT_EXPLORER_BROWSER_ITEMS_CHANGED
+        with the changes of its items, so there is no need to poll the folder.
+
+        The changes are collected for @a batchDelay milliseconds after the first one
+        and several changes of the same item are merged into one. If more than
+        @a maxQueuedChanges items change in one batch, the batch is reported as
+        overflowed without the individual changes and the view is refreshed.
+
+        @see wxExplorerBrowserChangeEvent
+    */
+    bool EnableChangeNotifications(bool enable = true, int batchDelay = 200,
+                                   size_t maxQueuedChanges = 10000);
+
+    /**
+        When used, the items returned by GetAllItems(), GetSelectedItems()
+        and the events are looked up in the process-wide wxExplorerBrowserItemCache
+        first, so that several controls showing the same folder do not query
+        the shell for the same items again.
+
+        The cached items of the current folder are invalidated by Refresh()
+        and by the shell change notifications, if enabled.
+
+        @see wxExplorerBrowserItemCache::Get(), EnableChangeNotifications()
+    */
+    bool UseSharedItemCache(bool use = true);
+
+    /**
+        When enabled, the events which cannot be vetoed (selection changed,
+        navigation complete or failed, and view created) are not sent from
+        the shell callbacks but put into a queue and sent in batches when
+        the application is idle. A slow event handler then does not block
+        the shell view. The vetoable events are always sent immediately.
+        The items of the navigation and view created events are retrieved
+        from the shell only when the events are sent.
+
+        When more than @a queueCapacity events are waiting, the waiting events
+        and then the new one are sent immediately, so the events always come
+        in the order they occurred. The event handlers may call this method too,
+        disabling the queued events sends the waiting events right away.
+    */
+    bool EnableQueuedEvents(bool enable = true, size_t queueCapacity = 1024);
+
+    /**
+        When enabled, GetThumbnail() can be used to obtain the thumbnails of the items,
+        which are extracted on @a threadCount worker threads and the most recently used
+        ones kept in the memory up to @a maxMemory bytes. If @a threadCount is 0,
+        it is chosen based on the number of cores.
+
+        Disabling the thumbnails waits for the extractions in progress to finish.
+
+        @see wxExplorerBrowserThumbnailService
+    */
+    bool EnableThumbnails(bool enable = true,
+                          size_t maxMemory = wxExplorerBrowserThumbnailService::DefaultMaxMemory,
+                          unsigned threadCount = 0);
+
+    /**
+        Returns true and sets @a bitmap if the thumbnail of @a item no larger than
+        @a size pixels is available. Otherwise returns false and schedules its extraction,
+        wxEVT_EXPLORER_BROWSER_THUMBNAIL_READY is sent when it is done. Requesting
+        a thumbnail whose extraction is scheduled or in progress does not schedule it again.
+
+        The item must have a path, e.g., it was returned by GetSelectedItems().
+        Must not be called unless the thumbnails are enabled, see EnableThumbnails().
+    */
+    bool GetThumbnail(const wxExplorerBrowserItem& item, int size, wxBitmap& bitmap);
+
+    /**
+        Drops the scheduled thumbnail extractions, e.g., when the selection has changed.
+        The events are not sent for the dropped ones.
+    */
+    bool CancelThumbnailRequests();
+
+    /**
+        Keeps the thumbnails extracted for GetThumbnail() in @a fileName, so that they
+        are available after the application restarts. The thumbnails of the file system
+        items are looked up there before extracting them and are extracted again
+        when the item was modified. The file does not grow beyond @a maxSize bytes.
+
+        Pass an empty @a fileName to stop using the store.
+        The file should not be used by several controls at once.
+
+        @see wxExplorerBrowserThumbnailStore
+    */
+    bool SetThumbnailStore(const wxString& fileName,
+                           size_t maxSize = wxExplorerBrowserThumbnailStore::DefaultMaxSize);
+
+    /**
+        Extracts the thumbnails of @a size of the visible items, and then of the items
+        within @a distance items of them, before GetThumbnail() is called for them.
+        wxEVT_EXPLORER_BROWSER_THUMBNAIL_READY is sent for each. 0 for @a distance means
+        the number of the visible items and 0 for @a size stops the prefetching.
+
+        The visible range is followed when it changes, the items scrolled too far from it
+        are not extracted. Only a few extractions are queued at a time, so the requests
+        made with GetThumbnail() do not wait for all of them.
+
+        Viewport tracking and the thumbnails must be enabled, see EnableViewportTracking()
+        and EnableThumbnails(). Disabling the thumbnails stops the prefetching.
+    */
+    bool PrefetchThumbnails(int size, size_t distance = 0);
+
+    /**
+        Returns the range of the items scrolled into the view, @a count items
+        starting at @a first. The indices are in the view order, as the items
+        returned by GetAllItems(). In the grouped views, the range can include
+        items which are not visible. @a count is 0 if no items are visible.
+    */
+    bool GetVisibleItemRange(size_t& first, size_t& count);
+
+    /**
+        When enabled, the visible range is checked every @a pollInterval milliseconds
+        and wxEVT_EXPLORER_BROWSER_VIEWPORT_CHANGED is sent when it changes, e.g.,
+        after scrolling, resizing the control or navigating.
+
+        RequestItemProperties() and PrefetchThumbnails() use the visible range to do
+        the work for the visible items first. Passing the range to
+        wxExplorerBrowserViewportScheduler::SetViewport() lets the other background
+        work for the items be done in the same order.
+
+        @see GetVisibleItemRange()
+    */
+    bool EnableViewportTracking(bool enable = true, int pollInterval = 100);
+
+    /**
+        Starts computing the total size of the files in the trees of the Directory
+        items in @a items, e.g., returned by GetSelectedItems(), and the numbers of
+        the files and folders in them. The other items are ignored, returns false
+        if there are no Directory items.
+
+        The trees are walked in parallel on background threads,
+        wxEVT_EXPLORER_BROWSER_FOLDER_SIZE_PROGRESS is sent every
+        @a progressInterval milliseconds and wxEVT_EXPLORER_BROWSER_FOLDER_SIZE_COMPLETED
+        when done. Starting a new computation cancels the one in progress, which
+        gets its completed event first.
+
+        @see wxExplorerBrowserFolderSizer
+    */
+    bool CalculateFolderSize(const wxExplorerBrowserItem::List& items, int progressInterval = 250);
+
+    /**
+        Stops the computation started with CalculateFolderSize(),
+        wxEVT_EXPLORER_BROWSER_FOLDER_SIZE_COMPLETED is sent with the totals so far.
+        It returns without waiting for the background threads to stop.
+    */
+    bool CancelFolderSizeCalculation();
+
+    /**
+        Starts enumerating the items of @a itemTypes in the current folder and its
+        subfolders, up to @a maxDepth levels below it, 0 meaning no limit. Unlike
+        SearchFolder(), it does not need Windows Search, the file system is walked
+        in parallel on background threads. The filter set with SetFilter() is applied
+        to the items as they are found, all subfolders are walked regardless of it.
+
+        The found items are sent in batches with wxEVT_EXPLORER_BROWSER_ENUMERATION_ITEMS
+        every @a batchInterval milliseconds, wxEVT_EXPLORER_BROWSER_ENUMERATION_COMPLETED
+        is sent when done. Starting a new enumeration cancels the one in progress.
+        Returns false if the current folder is not a file system folder.
+
+        @see wxExplorerBrowserRecursiveEnumerator
+    */
+    bool EnumerateRecursively(wxUint32 itemTypes = wxExplorerBrowserItem::File,
+                              unsigned maxDepth = 0, int batchInterval = 100);
+
+    /**
+        Stops the enumeration started with EnumerateRecursively(),
+        wxEVT_EXPLORER_BROWSER_ENUMERATION_COMPLETED is sent.
+    */
+    bool CancelRecursiveEnumeration();
+
+    /**
+        Fills @a usage with the memory held by the control's own structures,
+        the memory of the hosted ExplorerBrowser is not included.
+    */
+    bool GetMemoryUsage(wxExplorerBrowserMemoryUsage& usage) const;
+
+    /**
+        Sets the limits for the memory reported by GetMemoryUsage(), 0 means no limit.
+        The usage is checked whenever the items are retrieved.
+
+        Over the soft limit, the thumbnails are trimmed. Over the hard limit,
+        the listing remembered for GetItemChanges() is dropped as well, so its next
+        call reports all items as added, and the pending item changes are reported
+        as overflowed.
+
+        The shared item cache is not counted, as it would be charged once for every
+        control using it, it has its own limit set by wxExplorerBrowserItemCache::SetMaxMemory().
+    */
+    bool SetMemoryBudget(size_t softLimit, size_t hardLimit = 0);
+
+    /**
+        Parks the control which is not going to be shown for a while,
+        e.g. its notebook page was deselected. The control keeps its
+        ExplorerBrowser, so it can be shown again without recreating it.
+
+        Parked controls share a budget set with SetParkingBudget(),
+        @a estimatedMemory is the number of bytes the control is counted with.
+        When the budget is exceeded, the ExplorerBrowser of the least recently
+        parked control is torn down. Unpark() then recreates it and restores
+        its folder, view mode, icon size and selection.
+
+        The visibility of the control is not changed. A parked control must be
+        unparked before calling its other methods.
+    */
+    bool Park(size_t estimatedMemory = 0);
+
+    /**
+        Unparks the control, recreating its ExplorerBrowser if it was torn down.
+        If it could not be recreated, false is returned and calling Unpark()
+        again tries to recreate it again.
+        @see Park()
+    */
+    bool Unpark();
+
+    bool IsParked() const;
+
+    /**
+        Sets the budget for all parked controls. 0 means no limit, by default
+        at most wxExplorerBrowserParkingLot::DefaultMaxViews controls stay parked.
+        @see Park()
+    */
+    static void SetParkingBudget(size_t maxParkedViews, size_t maxParkedMemory = 0);
+
+    /**
+        With Resize_Coalesce, the size changes are not applied while the top-level
+        window is being interactively resized, or until the size stops changing
+        (e.g. when a splitter sash is dragged). Only the final size is then applied.
+        This avoids relayouting the shell view on every mouse move.
+
+        If @a maxUpdateInterval is not 0, the view is still resized at least
+        every @a maxUpdateInterval milliseconds while the resizing goes on.
+    */
+    bool SetResizePolicy(ResizePolicy policy, int maxUpdateInterval = 0);
+
+    /** 
+        Returns the actual IExplorerBrowser pointer
+        or nullptr if the interface was not created.
+    */
+    void* GetIExplorerBrowser();
+    
+    /** @private 
+        Overriding is necessary for ExplorerBrowser shortcuts like <Ctrl+A>
+        or <F2> keep working while being hosted.
+    */
+    bool MSWTranslateMessage(WXMSG* msg) override;         
+private:    
+    // use the pimpl idiom so MSW headers are not included from a public header
+    class wxExplorerBrowserImpl;    
+    wxExplorerBrowserImpl* m_impl { nullptr };
+  
+    // the only child of the panel which is
+    // the actual parent of ExploreBrowser control
+    wxWindow* m_host {nullptr};
+
+    void OnSize(wxSizeEvent& evt);
+    void OnPaint(wxPaintEvent& evt);
+
+    wxDECLARE_DYNAMIC_CLASS(wxExplorerBrowser);
+};
+
+/**
+    All the wxExplorerBrowserEvents are those sent only for the items of the folder view,
+    see [IExplorerBrowserEvents](https://msdn.microsoft.com/en-us/library/windows/desktop/bb761883).
+    I.e., the events for the navigation panel hosting favorites and the folder tree 
+    ([INameSpaceTreeControlEvents](https://msdn.microsoft.com/en-us/library/windows/desktop/bb761567)
+    are not sent. 
+
+    For some of the events which may concern selected items, the event's
+    item contains only the first selected item of possible many.
+    Use wxIExplorerBrowser::GetSelectedItems() to obtain all selected items.
+
+    @b wxEVT_EXPLORER_BROWSER_DEFAULT_COMMAND    
+    Sent before the default action is taken on the selected item(s), can be vetoed.
+    
+    @b wxEVT_EXPLORER_BROWSER_SELECTION_CHANGED    
+    Sent after the selection was changed. If the current selection is empty, 
+    event's item type will be Unknown and the item will not contain any other information.    
+    
+    @b wxEVT_EXPLORER_BROWSER_CONTEXTMENU_START    
+    Sent before the shell context menu for the selected item(s) is shown, can be vetoed.
+    
+    @b wxEVT_EXPLORER_BROWSER_NAVIGATING    
+    Sent before the folder is changed, can be vetoed. 
+    Event's item contains the folder to which the view is navigating.
+    
+    @b wxEVT_EXPLORER_BROWSER_NAVIGATION_COMPLETE
+    Sent after the folder was changed. 
+    
+    @b wxEVT_EXPLORER_BROWSER_NAVIGATION_FAILED
+    Sent when the folder could not be changed, e.g., navigating was vetoed or the folder is not available.
+    
+    @b wxEVT_EXPLORER_BROWSER_VIEW_CREATED
+    Sent when the new view for a folder was created.    
+
+    The event's item is immutable and shared by the event and its clones,
+    so cloning the event, e.g. when it is queued, does not copy the item.
+    The memory for the cloned events and for the items is reused.
+
+    @see wxExplorerBrowserItem, wxExplorerBrowser, wxNotifyEvent::Veto()
+
+*/
+class wxExplorerBrowserEvent: public wxNotifyEvent
+{
+public:
+    typedef wxExplorerBrowserItemPool::ItemPtr ItemPtr;
+
+    wxExplorerBrowserEvent(wxEventType command = wxEVT_NULL, int id = 0)
+        : wxNotifyEvent(command, id) {}
+
+    const wxExplorerBrowserItem& GetItem() const { return m_item ? *m_item : GetEmptyItem(); }
+    /*! Sets a copy of @a item taken from a pool shared by all the events. */
+    void SetItem(const wxExplorerBrowserItem& item);
+
+    /*! Returns the shared item, can be null if no item was set. */
+    const ItemPtr& GetItemPtr() const { return m_item; }
+    void SetItem(ItemPtr item) { m_item = std::move(item); }
+
+    wxEvent* Clone() const override { return new wxExplorerBrowserEvent(*this); }
+
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+private:
+    ItemPtr m_item;
+
+    static const wxExplorerBrowserItem& GetEmptyItem();
+
+    wxDECLARE_DYNAMIC_CLASS_NO_ASSIGN(wxExplorerBrowserEvent);
+};
+
+wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_DEFAULT_COMMAND, wxExplorerBrowserEvent);
+wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_SELECTION_CHANGED, wxExplorerBrowserEvent);
+wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_CONTEXTMENU_START, wxExplorerBrowserEvent);
+wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_NAVIGATING, wxExplorerBrowserEvent);
+wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_NAVIGATION_COMPLETE, wxExplorerBrowserEvent);
+wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_NAVIGATION_FAILED, wxExplorerBrowserEvent);
+wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_VIEW_CREATED, wxExplorerBrowserEvent);
+
+#define wxExplorerBrowserEventHandler(func) (&func)
+
+typedef void (wxEvtHandler::*wxExplorerBrowserEventFunction)(wxExplorerBrowserEvent&);
+
+#define EXPLORER_DEFAULT_COMMAND(id, func) \
+    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_DEFAULT_COMMAND, id, wxExplorerBrowserEventHandler(func))
+#define EXPLORER_BROWSER_SELECTION_CHANGED(id, func) \
+    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_SELECTION_CHANGED, id, wxExplorerBrowserEventHandler(func))
+#define EVT_EXPLORER_BROWSER_CONTEXTMENU_START(id, func) \
+    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_CONTEXTMENU_START, id, wxExplorerBrowserEventHandler(func))
+#define EXPLORER_BROWSER_NAVIGATING(id, func) \
+    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_NAVIGATING, id, wxExplorerBrowserEventHandler(func))
+#define EXPLORER_BROWSER_NAVIGATION_COMPLETE(id, func) \
+    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_NAVIGATION_COMPLETE, id, wxExplorerBrowserEventHandler(func))
+#define EXPLORER_BROWSER_NAVIGATION_FAILED(id, func) \
+    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_NAVIGATION_FAILED, id, wxExplorerBrowserEventHandler(func))
+#define EXPLORER_BROWSER_VIEW_CREATED(id, func) \
+    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_VIEW_CREATED, id, wxExplorerBrowserEventHandler(func))
+
+/**
+    @b wxEVT_EXPLORER_BROWSER_ITEMS_CHANGED
+    Sent when items in the current folder were created, deleted, or updated.
+    If IsOverflow() returns true, there were too many changes or the shell did not
+    tell which items changed, GetChanges() is empty then and the whole folder
+    should be considered changed.
+
+    @see wxExplorerBrowser::EnableChangeNotifications(), wxExplorerBrowserItemChange
+*/
+class wxExplorerBrowserChangeEvent: public wxCommandEvent
+{
+public:
+    wxExplorerBrowserChangeEvent(wxEventType command = wxEVT_NULL, int id = 0)
+        : wxCommandEvent(command, id) {}
+
+    const wxExplorerBrowserItemChange::List& GetChanges() const { return m_changes; }
+    void SetChanges(wxExplorerBrowserItemChange::List&& changes) { m_changes = std::move(changes); }
+
+    bool IsOverflow() const { return m_overflow; }
+    void SetOverflow(bool overflow) { m_overflow = overflow; }
+
+    wxEvent* Clone() const override { return new wxExplorerBrowserChangeEvent(*this); }
+private:
+    wxExplorerBrowserItemChange::List m_changes;
+    bool m_overflow {false};
+
+    wxDECLARE_DYNAMIC_CLASS_NO_ASSIGN(wxExplorerBrowserChangeEvent);
+};
+
+wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_ITEMS_CHANGED, wxExplorerBrowserChangeEvent);
+
+typedef void (wxEvtHandler::*wxExplorerBrowserChangeEventFunction)(wxExplorerBrowserChangeEvent&);
+
+#define wxExplorerBrowserChangeEventHandler(func) (&func)
+
+#define EVT_EXPLORER_BROWSER_ITEMS_CHANGED(id, func) \
+    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_ITEMS_CHANGED, id, wxExplorerBrowserChangeEventHandler(func))
+
+/**
+    Reports the progress of a long running operation.
+
+    @b wxEVT_EXPLORER_BROWSER_SEARCH_PROGRESS
+    Sent when the search started and when the number of found items changed.
+    GetString() returns the search text and GetProcessed() the number of found items.
+
+    @b wxEVT_EXPLORER_BROWSER_SEARCH_COMPLETED
+    Sent when the search has finished or was cancelled, see IsCancelled().
+
+    @b wxEVT_EXPLORER_BROWSER_RESULTS_PROGRESS
+    Sent after each batch of items was added to the results folder.
+    GetProcessed() returns the number of the processed items, GetTotal() the number
+    of the queued ones and GetFailed() the number of those which could not be added.
+
+    @b wxEVT_EXPLORER_BROWSER_RESULTS_COMPLETED
+    Sent when all items were added or adding them was cancelled, see IsCancelled().
+
+    @see wxExplorerBrowser::EnableSearchPipeline(), wxExplorerBrowser::AddResults()
+*/
+class wxExplorerBrowserProgressEvent: public wxCommandEvent
+{
+public:
+    wxExplorerBrowserProgressEvent(wxEventType command = wxEVT_NULL, int id = 0)
+        : wxCommandEvent(command, id) {}
+
+    wxUint64 GetProcessed() const { return m_processed; }
+    void SetProcessed(wxUint64 processed) { m_processed = processed; }
+
+    /*! Returns 0 if the total is not known. */
+    wxUint64 GetTotal() const { return m_total; }
+    void SetTotal(wxUint64 total) { m_total = total; }
+
+    /*! The number of the processed items which failed. */
+    wxUint64 GetFailed() const { return m_failed; }
+    void SetFailed(wxUint64 failed) { m_failed = failed; }
+
+    bool IsCancelled() const { return m_cancelled; }
+    void SetCancelled(bool cancelled) { m_cancelled = cancelled; }
+
+    wxEvent* Clone() const override { return new wxExplorerBrowserProgressEvent(*this); }
+private:
+    wxUint64 m_processed {0};
+    wxUint64 m_total {0};
+    wxUint64 m_failed {0};
+    bool     m_cancelled {false};
+
+    wxDECLARE_DYNAMIC_CLASS_NO_ASSIGN(wxExplorerBrowserProgressEvent);
+};
+
+wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_SEARCH_PROGRESS, wxExplorerBrowserProgressEvent);
+wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_SEARCH_COMPLETED, wxExplorerBrowserProgressEvent);
+wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_RESULTS_PROGRESS, wxExplorerBrowserProgressEvent);
+wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_RESULTS_COMPLETED, wxExplorerBrowserProgressEvent);
+
+typedef void (wxEvtHandler::*wxExplorerBrowserProgressEventFunction)(wxExplorerBrowserProgressEvent&);
+
+#define wxExplorerBrowserProgressEventHandler(func) (&func)
+
+#define EVT_EXPLORER_BROWSER_SEARCH_PROGRESS(id, func) \
+    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_SEARCH_PROGRESS, id, wxExplorerBrowserProgressEventHandler(func))
+#define EVT_EXPLORER_BROWSER_SEARCH_COMPLETED(id, func) \
+    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_SEARCH_COMPLETED, id, wxExplorerBrowserProgressEventHandler(func))
+#define EVT_EXPLORER_BROWSER_RESULTS_PROGRESS(id, func) \
+    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_RESULTS_PROGRESS, id, wxExplorerBrowserProgressEventHandler(func))
+#define EVT_EXPLORER_BROWSER_RESULTS_COMPLETED(id, func) \
+    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_RESULTS_COMPLETED, id, wxExplorerBrowserProgressEventHandler(func))
+
+/**
+    @b wxEVT_EXPLORER_BROWSER_THUMBNAIL_READY
+    Sent when the thumbnail requested with wxExplorerBrowser::GetThumbnail()
+    was extracted, or the extraction failed, see IsOk().
+    The event is sent even if the thumbnail did not fit into the memory limit,
+    CreateBitmap() can always be used.
+
+    @see wxExplorerBrowser::EnableThumbnails()
+*/
+class wxExplorerBrowserThumbnailEvent: public wxCommandEvent
+{
+public:
+    wxExplorerBrowserThumbnailEvent(wxEventType command = wxEVT_NULL, int id = 0)
+        : wxCommandEvent(command, id) {}
+
+    const wxExplorerBrowserItem& GetItem() const { return m_item; }
+    void SetItem(const wxExplorerBrowserItem& item) { m_item = item; }
+
+    /*! Returns the size passed to wxExplorerBrowser::GetThumbnail(). */
+    int GetSize() const { return m_size; }
+    void SetSize(int size) { m_size = size; }
+
+    /*! Returns false if the thumbnail could not be extracted. */
+    bool IsOk() const { return m_thumbnail != nullptr; }
+
+    /*! Can be null, see IsOk(). */
+    const wxExplorerBrowserThumbnail::Ptr& GetThumbnail() const { return m_thumbnail; }
+    void SetThumbnail(const wxExplorerBrowserThumbnail::Ptr& thumbnail) { m_thumbnail = thumbnail; }
+
+    /** Returns the thumbnail as a new bitmap, or an invalid one if the extraction failed. */
+    wxBitmap CreateBitmap() const { return m_thumbnail ? ThumbnailToBitmap(*m_thumbnail) : wxBitmap(); }
+
+    static wxBitmap ThumbnailToBitmap(const wxExplorerBrowserThumbnail& thumbnail);
+
+    wxEvent* Clone() const override { return new wxExplorerBrowserThumbnailEvent(*this); }
+private:
+    wxExplorerBrowserItem m_item;
+    int m_size {0};
+    wxExplorerBrowserThumbnail::Ptr m_thumbnail;
+
+    wxDECLARE_DYNAMIC_CLASS_NO_ASSIGN(wxExplorerBrowserThumbnailEvent);
+};
+
+wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_THUMBNAIL_READY, wxExplorerBrowserThumbnailEvent);
+
+typedef void (wxEvtHandler::*wxExplorerBrowserThumbnailEventFunction)(wxExplorerBrowserThumbnailEvent&);
+
+#define wxExplorerBrowserThumbnailEventHandler(func) (&func)
+
+#define EVT_EXPLORER_BROWSER_THUMBNAIL_READY(id, func) \
+    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_THUMBNAIL_READY, id, wxExplorerBrowserThumbnailEventHandler(func))
+
+/**
+    @b wxEVT_EXPLORER_BROWSER_VIEWPORT_CHANGED
+    Sent when the range of the items scrolled into the view changed.
+
+    @see wxExplorerBrowser::EnableViewportTracking()
+*/
+class wxExplorerBrowserViewportEvent: public wxCommandEvent
+{
+public:
+    wxExplorerBrowserViewportEvent(wxEventType command = wxEVT_NULL, int id = 0)
+        : wxCommandEvent(command, id) {}
+
+    /*! See wxExplorerBrowser::GetVisibleItemRange(). */
+    size_t GetFirst() const { return m_first; }
+    size_t GetCount() const { return m_count; }
+    void SetRange(size_t first, size_t count) { m_first = first; m_count = count; }
+
+    /*! The number of all items in the view. */
+    size_t GetItemCount() const { return m_itemCount; }
+    void SetItemCount(size_t itemCount) { m_itemCount = itemCount; }
+
+    wxEvent* Clone() const override { return new wxExplorerBrowserViewportEvent(*this); }
+private:
+    size_t m_first {0};
+    size_t m_count {0};
+    size_t m_itemCount {0};
+
+    wxDECLARE_DYNAMIC_CLASS_NO_ASSIGN(wxExplorerBrowserViewportEvent);
+};
+
+wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_VIEWPORT_CHANGED, wxExplorerBrowserViewportEvent);
+
+typedef void (wxEvtHandler::*wxExplorerBrowserViewportEventFunction)(wxExplorerBrowserViewportEvent&);
+
+#define wxExplorerBrowserViewportEventHandler(func) (&func)
+
+#define EVT_EXPLORER_BROWSER_VIEWPORT_CHANGED(id, func) \
+    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_VIEWPORT_CHANGED, id, wxExplorerBrowserViewportEventHandler(func))
+
+/**
+    @b wxEVT_EXPLORER_BROWSER_FOLDER_SIZE_PROGRESS
+    Sent periodically while the computation started with
+    wxExplorerBrowser::CalculateFolderSize() is running, with the totals so far.
+
+    @b wxEVT_EXPLORER_BROWSER_FOLDER_SIZE_COMPLETED
+    Sent when the computation is done or was cancelled, see IsCancelled().
+*/
+class wxExplorerBrowserFolderSizeEvent: public wxCommandEvent
+{
+public:
+    wxExplorerBrowserFolderSizeEvent(wxEventType command = wxEVT_NULL, int id = 0)
+        : wxCommandEvent(command, id) {}
+
+    const wxExplorerBrowserFolderSizer::Totals& GetTotals() const { return m_totals; }
+    void SetTotals(const wxExplorerBrowserFolderSizer::Totals& totals) { m_totals = totals; }
+
+    wxUint64 GetSize() const { return m_totals.size; }
+    wxUint64 GetFileCount() const { return m_totals.fileCount; }
+    wxUint64 GetFolderCount() const { return m_totals.folderCount; }
+    /*! The number of the folders which could not be read, e.g., for the lack of access rights. */
+    wxUint64 GetErrorCount() const { return m_totals.errorCount; }
+
+    bool IsCancelled() const { return m_cancelled; }
+    void SetCancelled(bool cancelled) { m_cancelled = cancelled; }
+
+    wxEvent* Clone() const override { return new wxExplorerBrowserFolderSizeEvent(*this); }
+private:
+    wxExplorerBrowserFolderSizer::Totals m_totals;
+    bool m_cancelled {false};
+
+    wxDECLARE_DYNAMIC_CLASS_NO_ASSIGN(wxExplorerBrowserFolderSizeEvent);
+};
+
+wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_FOLDER_SIZE_PROGRESS, wxExplorerBrowserFolderSizeEvent);
+wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_FOLDER_SIZE_COMPLETED, wxExplorerBrowserFolderSizeEvent);
+
+typedef void (wxEvtHandler::*wxExplorerBrowserFolderSizeEventFunction)(wxExplorerBrowserFolderSizeEvent&);
+
+#define wxExplorerBrowserFolderSizeEventHandler(func) (&func)
+
+#define EVT_EXPLORER_BROWSER_FOLDER_SIZE_PROGRESS(id, func) \
+    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_FOLDER_SIZE_PROGRESS, id, wxExplorerBrowserFolderSizeEventHandler(func))
+#define EVT_EXPLORER_BROWSER_FOLDER_SIZE_COMPLETED(id, func) \
+    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_FOLDER_SIZE_COMPLETED, id, wxExplorerBrowserFolderSizeEventHandler(func))
+
+/**
+    @b wxEVT_EXPLORER_BROWSER_ITEM_PROPERTIES
+    Sent when the properties requested with wxExplorerBrowser::RequestItemProperties()
+    were obtained. The results are shared by the copies of the event, not copied.
+
+    If some of the items were visible when requested, their properties are obtained
+    first and the event is sent for them before the one for all the items, see IsComplete().
+*/
+class wxExplorerBrowserItemPropertiesEvent: public wxCommandEvent
+{
+public:
+    wxExplorerBrowserItemPropertiesEvent(wxEventType command = wxEVT_NULL, int id = 0)
+        : wxCommandEvent(command, id) {}
+
+    /*! The items in the view order, as they were when requested. */
+    const wxExplorerBrowserItem::List& GetItems() const { return *m_items; }
+    void SetItems(const std::shared_ptr<const wxExplorerBrowserItem::List>& items) { m_items = items; }
+
+    /*! The properties of the item at an index in GetItems() are at the same index. */
+    const wxExplorerBrowserItemProperties& GetProperties() const { return *m_properties; }
+    void SetProperties(const std::shared_ptr<const wxExplorerBrowserItemProperties>& properties)
+        { m_properties = properties; }
+
+    /*!
+        The range of the items whose properties were obtained, @a count items starting at @a first.
+        Until the complete event, the properties of the other items must not be accessed,
+        they are being written on the background threads.
+    */
+    void GetReadyRange(size_t& first, size_t& count) const { first = m_readyFirst; count = m_readyCount; }
+    void SetReadyRange(size_t first, size_t count) { m_readyFirst = first; m_readyCount = count; }
+
+    /*! Returns true if the properties of all the items were obtained. */
+    bool IsComplete() const { return m_readyFirst == 0 && m_readyCount == m_items->size(); }
+
+    wxEvent* Clone() const override { return new wxExplorerBrowserItemPropertiesEvent(*this); }
+private:
+    std::shared_ptr<const wxExplorerBrowserItem::List> m_items {std::make_shared<wxExplorerBrowserItem::List>()};
+    std::shared_ptr<const wxExplorerBrowserItemProperties> m_properties
+        {std::make_shared<wxExplorerBrowserItemProperties>()};
+    size_t m_readyFirst {0};
+    size_t m_readyCount {0};
+
+    wxDECLARE_DYNAMIC_CLASS_NO_ASSIGN(wxExplorerBrowserItemPropertiesEvent);
+};
+
+wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_ITEM_PROPERTIES, wxExplorerBrowserItemPropertiesEvent);
+
+typedef void (wxEvtHandler::*wxExplorerBrowserItemPropertiesEventFunction)(wxExplorerBrowserItemPropertiesEvent&);
+
+#define wxExplorerBrowserItemPropertiesEventHandler(func) (&func)
+
+#define EVT_EXPLORER_BROWSER_ITEM_PROPERTIES(id, func) \
+    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_ITEM_PROPERTIES, id, wxExplorerBrowserItemPropertiesEventHandler(func))
+
+/**
+    @b wxEVT_EXPLORER_BROWSER_ENUMERATION_ITEMS
+    Sent with a batch of the items found by wxExplorerBrowser::EnumerateRecursively().
+
+    @b wxEVT_EXPLORER_BROWSER_ENUMERATION_COMPLETED
+    Sent when the enumeration is done or was cancelled, see IsCancelled().
+    It has no items, all of them were sent before.
+*/
+class wxExplorerBrowserEnumerationEvent: public wxCommandEvent
+{
+public:
+    wxExplorerBrowserEnumerationEvent(wxEventType command = wxEVT_NULL, int id = 0)
+        : wxCommandEvent(command, id) {}
+
+    /*! The items can be moved out of the event. */
+    wxExplorerBrowserItem::List& GetItems() { return m_items; }
+    const wxExplorerBrowserItem::List& GetItems() const { return m_items; }
+
+    /*! The number of the items found so far. */
+    wxUint64 GetFoundCount() const { return m_foundCount; }
+    void SetFoundCount(wxUint64 count) { m_foundCount = count; }
+
+    /*! The number of the folders which could not be read, e.g., for the lack of access rights. */
+    wxUint64 GetErrorCount() const { return m_errorCount; }
+    void SetErrorCount(wxUint64 count) { m_errorCount = count; }
+
+    bool IsCancelled() const { return m_cancelled; }
+    void SetCancelled(bool cancelled) { m_cancelled = cancelled; }
+
+    wxEvent* Clone() const override { return new wxExplorerBrowserEnumerationEvent(*this); }
+private:
+    wxExplorerBrowserItem::List m_items;
+    wxUint64 m_foundCount {0};
+    wxUint64 m_errorCount {0};
+    bool     m_cancelled {false};
+
+    wxDECLARE_DYNAMIC_CLASS_NO_ASSIGN(wxExplorerBrowserEnumerationEvent);
+};
+
+wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_ENUMERATION_ITEMS, wxExplorerBrowserEnumerationEvent);
+wxDECLARE_EVENT(wxEVT_EXPLORER_BROWSER_ENUMERATION_COMPLETED, wxExplorerBrowserEnumerationEvent);
+
+typedef void (wxEvtHandler::*wxExplorerBrowserEnumerationEventFunction)(wxExplorerBrowserEnumerationEvent&);
+
+#define wxExplorerBrowserEnumerationEventHandler(func) (&func)
+
+#define EVT_EXPLORER_BROWSER_ENUMERATION_ITEMS(id, func) \
+    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_ENUMERATION_ITEMS, id, wxExplorerBrowserEnumerationEventHandler(func))
+#define EVT_EXPLORER_BROWSER_ENUMERATION_COMPLETED(id, func) \
+    wx__DECLARE_EVT1(wxEVT_EXPLORER_BROWSER_ENUMERATION_COMPLETED, id, wxExplorerBrowserEnumerationEventHandler(func))
+
 #endif //ifndef WX_EXPLORER_BROWSER_H_DEFINED
\ No newline at end of file
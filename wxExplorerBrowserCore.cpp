@@ -0,0 +1,5061 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//  Name:        wxExplorerBrowserCore.cpp
+//  Purpose:     Platform-independent helpers used by wxExplorerBrowser
+//  Author:      PB
+//  Copyright:   (c) 2018 PB <pbfordev@gmail.com>
+//  Licence:     wxWindows licence
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#include "wxExplorerBrowserCore.h"
+
+#include <chrono>
+#include <iterator>
+#include <limits>
+
+#include <wx/file.h>
+#include <wx/filefn.h>
+#include <wx/intl.h>
+#include <wx/log.h>
+
+#ifdef __WINDOWS__
+    #include <wx/msw/wrapwin.h>
+#else
+    #include <dirent.h>
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #ifdef __LINUX__
+        #include <sys/syscall.h>
+    #endif
+#endif
+
+namespace {
+
+// helpers for reading and writing little-endian numbers regardless of the platform
+
+void PutUint32(wxUint8* p, wxUint32 value)
+{
+    for ( size_t i = 0; i < 4; ++i )
+        p[i] = static_cast<wxUint8>(value >> (i * 8));
+}
+
+void PutUint64(wxUint8* p, wxUint64 value)
+{
+    for ( size_t i = 0; i < 8; ++i )
+        p[i] = static_cast<wxUint8>(value >> (i * 8));
+}
+
+wxUint32 GetUint32(const wxUint8* p)
+{
+    wxUint32 value = 0;
+
+    for ( size_t i = 0; i < 4; ++i )
+        value |= static_cast<wxUint32>(p[i]) << (i * 8);
+    return value;
+}
+
+wxUint64 GetUint64(const wxUint8* p)
+{
+    wxUint64 value = 0;
+
+    for ( size_t i = 0; i < 8; ++i )
+        value |= static_cast<wxUint64>(p[i]) << (i * 8);
+    return value;
+}
+
+} // unnamed namespace
+
+/***************************************************************************
+
+    hashing
+
+*****************************************************************************/
+
+wxUint64 wxExplorerBrowserHashBytes(const void* data, size_t size, wxUint64 seed)
+{
+    const wxUint8* p = static_cast<const wxUint8*>(data);
+    wxUint64 hash = seed;
+
+    for ( size_t i = 0; i < size; ++i )
+    {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+wxUint64 wxExplorerBrowserHashString(const wxString& str, wxUint64 seed)
+{
+    return wxExplorerBrowserHashBytes(str.wx_str(), str.length() * sizeof(wxStringCharType), seed);
+}
+
+wxUint64 wxExplorerBrowserMakeItemId(const void* data, size_t size, wxUint64 seed)
+{
+    const wxUint64 id = wxExplorerBrowserHashBytes(data, size, seed);
+
+    // 0 means no id
+    return id ? id : 1;
+}
+
+wxUint64 wxExplorerBrowserMakeItemId(const wxChar* parsingName)
+{
+    wxCHECK(parsingName, 0);
+
+    return wxExplorerBrowserMakeItemId(parsingName, wxStrlen(parsingName) * sizeof(wxChar));
+}
+
+/***************************************************************************
+
+    memory accounting
+    ---------------------------------
+
+*****************************************************************************/
+
+namespace {
+
+// only the heap allocations, the string object itself is a part of its owner
+size_t GetStringHeapUsage(const wxString& str)
+{
+    return str.empty() ? 0 : (str.length() + 1) * sizeof(wxStringCharType);
+}
+
+size_t GetItemHeapUsage(const wxExplorerBrowserItem& item)
+{
+    return GetStringHeapUsage(item.GetPath()) + GetStringHeapUsage(item.GetDisplayName());
+}
+
+template <typename Map>
+size_t GetMapMemoryUsage(const Map& map)
+{
+    // a node holds the value, the pointer to the next node and the cached hash
+    return map.bucket_count() * sizeof(void*)
+           + map.size() * (sizeof(typename Map::value_type) + 2 * sizeof(void*));
+}
+
+} // unnamed namespace
+
+size_t wxExplorerBrowserGetMemoryUsage(const wxString& str)
+{
+    return sizeof(str) + GetStringHeapUsage(str);
+}
+
+size_t wxExplorerBrowserGetMemoryUsage(const wxArrayString& strings)
+{
+    size_t memory = sizeof(strings) + strings.size() * sizeof(wxString);
+
+    for ( const auto& str : strings )
+        memory += GetStringHeapUsage(str);
+
+    return memory;
+}
+
+size_t wxExplorerBrowserGetMemoryUsage(const wxExplorerBrowserItem& item)
+{
+    return sizeof(item) + GetItemHeapUsage(item);
+}
+
+size_t wxExplorerBrowserGetMemoryUsage(const wxExplorerBrowserItem::List& items)
+{
+    size_t memory = sizeof(items) + items.capacity() * sizeof(wxExplorerBrowserItem);
+
+    for ( const auto& item : items )
+        memory += GetItemHeapUsage(item);
+
+    return memory;
+}
+
+wxExplorerBrowserMemoryBudget::Level wxExplorerBrowserMemoryBudget::GetLevel(size_t usage) const
+{
+    if ( m_hardLimit && usage > m_hardLimit )
+        return Level_Hard;
+
+    if ( m_softLimit && usage > m_softLimit )
+        return Level_Soft;
+
+    return Level_Normal;
+}
+
+size_t wxExplorerBrowserMemoryBudget::GetExcess(size_t usage) const
+{
+    const size_t limit = m_softLimit ? m_softLimit : m_hardLimit;
+
+    if ( !limit || usage <= limit )
+        return 0;
+
+    return usage - limit;
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserResizeCoalescer
+    ---------------------------------
+
+*****************************************************************************/
+
+void wxExplorerBrowserResizeCoalescer::SetPolicy(bool coalesce, wxUint64 maxUpdateInterval,
+                                                 wxUint64 settleDelay)
+{
+    m_coalesce = coalesce;
+    m_maxUpdateInterval = maxUpdateInterval;
+    m_settleDelay = settleDelay;
+}
+
+bool wxExplorerBrowserResizeCoalescer::OnSizeChanged(const wxSize& size, wxUint64 now)
+{
+    m_pendingSize = size;
+    m_hasPending = true;
+    m_lastChange = now;
+
+    if ( !m_coalesce )
+        return true;
+
+    // keep the view updated at least at the requested rate
+    return IsUpdateIntervalDue(now);
+}
+
+void wxExplorerBrowserResizeCoalescer::BeginInteractive()
+{
+    m_interactive = true;
+}
+
+bool wxExplorerBrowserResizeCoalescer::EndInteractive(wxUint64 WXUNUSED(now))
+{
+    m_interactive = false;
+
+    return m_hasPending;
+}
+
+bool wxExplorerBrowserResizeCoalescer::OnTimer(wxUint64 now)
+{
+    wxUint64 deadline = 0;
+
+    return GetDeadline(deadline) && now >= deadline;
+}
+
+void wxExplorerBrowserResizeCoalescer::OnApplied(wxUint64 now)
+{
+    m_hasPending = false;
+    m_lastApplied = now;
+    m_everApplied = true;
+}
+
+bool wxExplorerBrowserResizeCoalescer::GetDeadline(wxUint64& deadline) const
+{
+    if ( !m_hasPending )
+        return false;
+
+    bool hasDeadline = false;
+
+    // outside of interactive resizing (e.g. when a splitter sash is dragged,
+    // which we are not told about) wait until the size stops changing
+    if ( !m_interactive )
+    {
+        deadline = m_lastChange + m_settleDelay;
+        hasDeadline = true;
+    }
+
+    if ( m_maxUpdateInterval )
+    {
+        const wxUint64 intervalDeadline = m_everApplied ? m_lastApplied + m_maxUpdateInterval : m_lastChange;
+
+        if ( !hasDeadline || intervalDeadline < deadline )
+            deadline = intervalDeadline;
+        hasDeadline = true;
+    }
+
+    return hasDeadline;
+}
+
+bool wxExplorerBrowserResizeCoalescer::IsUpdateIntervalDue(wxUint64 now) const
+{
+    if ( !m_maxUpdateInterval )
+        return false;
+
+    return !m_everApplied || now - m_lastApplied >= m_maxUpdateInterval;
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserMappedFile
+    ---------------------------------
+
+*****************************************************************************/
+
+bool wxExplorerBrowserMappedFile::Open(const wxString& fileName, Mode mode, size_t minSize)
+{
+    Close();
+
+    m_fileName = fileName;
+    m_writable = mode == Mode_ReadWrite;
+
+    size_t fileSize;
+
+#ifdef __WINDOWS__
+    HANDLE file = m_writable
+                  ? ::CreateFileW(fileName.wc_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                  OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr)
+                  : ::CreateFileW(fileName.wc_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if ( file == INVALID_HANDLE_VALUE )
+    {
+        wxLogSysError(_("Could not open file \"%s\""), fileName);
+        m_writable = false;
+        return false;
+    }
+
+    LARGE_INTEGER size;
+
+    if ( !::GetFileSizeEx(file, &size) || (size.QuadPart == 0 && !minSize)
+         || static_cast<wxUint64>(size.QuadPart) > static_cast<wxUint64>(SIZE_MAX) )
+    {
+        wxLogError(_("File \"%s\" is empty or too large to be mapped."), fileName);
+        ::CloseHandle(file);
+        m_writable = false;
+        return false;
+    }
+
+    fileSize = static_cast<size_t>(size.QuadPart);
+
+    if ( m_writable )
+    {
+        m_file = file;
+    }
+    else
+    {
+        m_mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        ::CloseHandle(file);
+        if ( !m_mapping )
+        {
+            wxLogSysError(_("Could not map file \"%s\""), fileName);
+            return false;
+        }
+
+        m_data = static_cast<wxUint8*>(::MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        if ( !m_data )
+        {
+            wxLogSysError(_("Could not map file \"%s\""), fileName);
+            Close();
+            return false;
+        }
+
+        m_size = fileSize;
+        return true;
+    }
+#else
+    const int fd = m_writable ? ::open(fileName.fn_str(), O_RDWR | O_CREAT, 0666)
+                              : ::open(fileName.fn_str(), O_RDONLY);
+
+    if ( fd == -1 )
+    {
+        wxLogSysError(_("Could not open file \"%s\""), fileName);
+        m_writable = false;
+        return false;
+    }
+
+    struct stat st;
+
+    if ( ::fstat(fd, &st) != 0 || (st.st_size <= 0 && !minSize)
+         || static_cast<wxUint64>(st.st_size) > static_cast<wxUint64>(SIZE_MAX) )
+    {
+        wxLogError(_("File \"%s\" is empty or too large to be mapped."), fileName);
+        ::close(fd);
+        m_writable = false;
+        return false;
+    }
+
+    fileSize = static_cast<size_t>(st.st_size);
+
+    if ( !m_writable )
+    {
+        void* data = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        ::close(fd);
+        if ( data == MAP_FAILED )
+        {
+            wxLogSysError(_("Could not map file \"%s\""), fileName);
+            return false;
+        }
+
+        m_data = static_cast<wxUint8*>(data);
+        m_size = fileSize;
+        return true;
+    }
+
+    m_fd = fd;
+#endif
+
+    // Mode_ReadWrite
+    if ( !Map(std::max(fileSize, minSize)) )
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+bool wxExplorerBrowserMappedFile::Resize(size_t size)
+{
+    wxCHECK(m_writable, false);
+    wxCHECK(size, false);
+
+    Unmap();
+
+#ifdef __WINDOWS__
+    LARGE_INTEGER newSize;
+
+    newSize.QuadPart = static_cast<LONGLONG>(size);
+    if ( !::SetFilePointerEx(m_file, newSize, nullptr, FILE_BEGIN) || !::SetEndOfFile(m_file) )
+#else
+    if ( ::ftruncate(m_fd, static_cast<off_t>(size)) != 0 )
+#endif
+    {
+        wxLogSysError(_("Could not resize file \"%s\""), m_fileName);
+        Close();
+        return false;
+    }
+
+    if ( !Map(size) )
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+bool wxExplorerBrowserMappedFile::Flush()
+{
+    wxCHECK(m_writable && m_data, false);
+
+#ifdef __WINDOWS__
+    if ( !::FlushViewOfFile(m_data, 0) || !::FlushFileBuffers(m_file) )
+#else
+    if ( ::msync(m_data, m_size, MS_SYNC) != 0 )
+#endif
+    {
+        wxLogSysError(_("Could not write file \"%s\""), m_fileName);
+        return false;
+    }
+
+    return true;
+}
+
+bool wxExplorerBrowserMappedFile::Map(size_t size)
+{
+#ifdef __WINDOWS__
+    // a larger mapping than the file extends it with zeros
+    const wxUint64 size64 = size;
+
+    m_mapping = ::CreateFileMappingW(m_file, nullptr, PAGE_READWRITE,
+                                     static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64), nullptr);
+    if ( m_mapping )
+        m_data = static_cast<wxUint8*>(::MapViewOfFile(m_mapping, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, size));
+#else
+    struct stat st;
+
+    if ( ::fstat(m_fd, &st) == 0 && static_cast<wxUint64>(st.st_size) < size
+         && ::ftruncate(m_fd, static_cast<off_t>(size)) != 0 )
+    {
+        wxLogSysError(_("Could not resize file \"%s\""), m_fileName);
+        return false;
+    }
+
+    void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+
+    if ( data != MAP_FAILED )
+        m_data = static_cast<wxUint8*>(data);
+#endif
+
+    if ( !m_data )
+    {
+        wxLogSysError(_("Could not map file \"%s\""), m_fileName);
+        Unmap();
+        return false;
+    }
+
+    m_size = size;
+    return true;
+}
+
+void wxExplorerBrowserMappedFile::Unmap()
+{
+#ifdef __WINDOWS__
+    if ( m_data )
+        ::UnmapViewOfFile(m_data);
+    if ( m_mapping )
+        ::CloseHandle(m_mapping);
+    m_mapping = nullptr;
+#else
+    if ( m_data )
+        ::munmap(m_data, m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+void wxExplorerBrowserMappedFile::Close()
+{
+    Unmap();
+
+#ifdef __WINDOWS__
+    if ( m_file )
+        ::CloseHandle(m_file);
+    m_file = nullptr;
+#else
+    if ( m_fd != -1 )
+        ::close(m_fd);
+    m_fd = -1;
+#endif
+
+    m_writable = false;
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserSnapshot
+    ---------------------------------
+
+    File layout, all numbers are little-endian:
+
+    Header (HeaderSize bytes)
+        char[8]  magic "WXEBSNAP"
+        uint32   version
+        uint32   header size
+        uint64   item count
+        uint32   record size
+        uint32   flags (reserved, 0)
+        uint64   offset of the records
+        uint64   offset of the string arena
+        uint64   size of the string arena
+        uint64   offset of the folder path in the arena
+        uint32   length of the folder path
+        uint32   reserved, 0
+
+    Record (RecordSize bytes), one per item
+        uint32   wxExplorerBrowserItem::Type
+        uint32   SFGAO
+        uint64   offset of the path in the arena
+        uint64   offset of the display name in the arena
+        uint32   length of the path
+        uint32   length of the display name
+
+    String arena
+        NUL-terminated UTF-8 strings
+
+*****************************************************************************/
+
+namespace {
+
+const char     SnapshotMagic[8] = { 'W', 'X', 'E', 'B', 'S', 'N', 'A', 'P' };
+const wxUint32 SnapshotHeaderSize = 72;
+const wxUint32 SnapshotRecordSize = 32;
+
+// appends the string to the arena, returns its offset and length
+void AppendSnapshotString(std::vector<char>& arena, const wxString& str,
+                          wxUint64& offset, wxUint32& length)
+{
+    const wxScopedCharBuffer utf8 = str.utf8_str();
+
+    offset = arena.size();
+    length = static_cast<wxUint32>(utf8.length());
+    arena.insert(arena.end(), utf8.data(), utf8.data() + utf8.length());
+    arena.push_back('\0');
+}
+
+} // unnamed namespace
+
+bool wxExplorerBrowserSnapshot::Write(const wxString& fileName, const wxString& folderPath,
+                                      const wxExplorerBrowserItem::List& items)
+{
+    std::vector<wxUint8> records(SnapshotRecordSize * items.size());
+    std::vector<char> arena;
+    wxUint64 offset;
+    wxUint32 length;
+
+    AppendSnapshotString(arena, folderPath, offset, length);
+
+    wxUint8 header[SnapshotHeaderSize] = {0};
+
+    memcpy(header, SnapshotMagic, sizeof(SnapshotMagic));
+    PutUint32(header + 8, Version);
+    PutUint32(header + 12, SnapshotHeaderSize);
+    PutUint64(header + 16, items.size());
+    PutUint32(header + 24, SnapshotRecordSize);
+    PutUint64(header + 32, SnapshotHeaderSize);
+    PutUint64(header + 40, SnapshotHeaderSize + records.size());
+    PutUint64(header + 56, offset);
+    PutUint32(header + 64, length);
+
+    for ( size_t i = 0; i < items.size(); ++i )
+    {
+        const wxExplorerBrowserItem& item = items[i];
+        wxUint8* record = &records[i * SnapshotRecordSize];
+
+        PutUint32(record, item.GetType());
+        PutUint32(record + 4, item.GetSFGAO());
+
+        AppendSnapshotString(arena, item.GetPath(), offset, length);
+        PutUint64(record + 8, offset);
+        PutUint32(record + 24, length);
+
+        AppendSnapshotString(arena, item.GetDisplayName(), offset, length);
+        PutUint64(record + 16, offset);
+        PutUint32(record + 28, length);
+    }
+
+    PutUint64(header + 48, arena.size());
+
+    wxTempFile file;
+
+    if ( !file.Open(fileName) )
+        return false;
+
+    if ( !file.Write(header, sizeof(header))
+         || (!records.empty() && !file.Write(records.data(), records.size()))
+         || !file.Write(arena.data(), arena.size()) )
+    {
+        file.Discard();
+        return false;
+    }
+
+    return file.Commit();
+}
+
+wxExplorerBrowserItem wxExplorerBrowserSnapshot::Item::ToItem() const
+{
+    wxExplorerBrowserItem item(type);
+
+    item.SetSFGAO(SFGAO);
+    item.SetPath(GetPath());
+    item.SetDisplayName(GetDisplayName());
+
+    return item;
+}
+
+bool wxExplorerBrowserSnapshot::Open(const wxString& fileName)
+{
+    Close();
+
+    if ( !m_file.Open(fileName) )
+        return false;
+
+    const wxUint8* data = m_file.GetData();
+    const wxUint64 size = m_file.GetSize();
+
+    if ( size < SnapshotHeaderSize || memcmp(data, SnapshotMagic, sizeof(SnapshotMagic)) != 0 )
+    {
+        wxLogError(_("File \"%s\" is not a folder snapshot."), fileName);
+        Close();
+        return false;
+    }
+
+    const wxUint32 version = GetUint32(data + 8);
+
+    if ( version > Version )
+    {
+        wxLogError(_("Folder snapshot \"%s\" has unsupported version %u."), fileName, version);
+        Close();
+        return false;
+    }
+
+    const wxUint64 headerSize    = GetUint32(data + 12);
+    const wxUint64 count         = GetUint64(data + 16);
+    const wxUint64 recordSize    = GetUint32(data + 24);
+    const wxUint64 recordsOffset = GetUint64(data + 32);
+    const wxUint64 stringsOffset = GetUint64(data + 40);
+    const wxUint64 stringsSize   = GetUint64(data + 48);
+
+    // later versions may only make the header and records larger
+    if ( headerSize < SnapshotHeaderSize || recordSize < SnapshotRecordSize
+         || recordsOffset < headerSize || recordsOffset > size
+         || count > (size - recordsOffset) / recordSize
+         || stringsOffset > size || stringsSize > size - stringsOffset )
+    {
+        wxLogError(_("Folder snapshot \"%s\" is corrupted."), fileName);
+        Close();
+        return false;
+    }
+
+    m_count = static_cast<size_t>(count);
+    m_recordSize = static_cast<size_t>(recordSize);
+    m_records = data + recordsOffset;
+    m_strings = reinterpret_cast<const char*>(data + stringsOffset);
+    m_stringsSize = static_cast<size_t>(stringsSize);
+    m_folderPathOffset = GetUint64(data + 56);
+    m_folderPathLength = GetUint32(data + 64);
+
+    return true;
+}
+
+void wxExplorerBrowserSnapshot::Close()
+{
+    m_file.Close();
+    m_count = 0;
+    m_recordSize = 0;
+    m_records = nullptr;
+    m_strings = nullptr;
+    m_stringsSize = 0;
+    m_folderPathOffset = 0;
+    m_folderPathLength = 0;
+}
+
+bool wxExplorerBrowserSnapshot::GetItem(size_t index, Item& item) const
+{
+    wxCHECK(index < m_count, false);
+
+    const wxUint8* record = m_records + index * m_recordSize;
+
+    const wxUint32 pathLength = GetUint32(record + 24);
+    const wxUint32 displayNameLength = GetUint32(record + 28);
+
+    if ( !GetString(GetUint64(record + 8), pathLength, item.path)
+         || !GetString(GetUint64(record + 16), displayNameLength, item.displayName) )
+        return false;
+
+    item.type = static_cast<wxExplorerBrowserItem::Type>(GetUint32(record));
+    item.SFGAO = GetUint32(record + 4);
+    item.pathLength = pathLength;
+    item.displayNameLength = displayNameLength;
+
+    return true;
+}
+
+wxString wxExplorerBrowserSnapshot::GetFolderPath() const
+{
+    const char* path;
+
+    if ( !GetString(m_folderPathOffset, m_folderPathLength, path) )
+        return wxString();
+
+    return wxString::FromUTF8(path, m_folderPathLength);
+}
+
+bool wxExplorerBrowserSnapshot::GetString(wxUint64 offset, wxUint32 length, const char*& str) const
+{
+    // the string must fit into the arena including its terminating NUL
+    if ( offset >= m_stringsSize || length >= m_stringsSize - offset
+         || m_strings[offset + length] != '\0' )
+        return false;
+
+    str = m_strings + offset;
+    return true;
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserListingFingerprint
+    ---------------------------------
+
+*****************************************************************************/
+
+void wxExplorerBrowserListingFingerprint::Update(const wxExplorerBrowserItem::List& items,
+                                                 wxExplorerBrowserListingDelta* delta)
+{
+    Update(wxExplorerBrowserItem::List(items), delta);
+}
+
+void wxExplorerBrowserListingFingerprint::Update(wxExplorerBrowserItem::List&& items,
+                                                 wxExplorerBrowserListingDelta* delta)
+{
+    Entries entries;
+
+    BuildEntries(items, entries);
+
+    if ( delta )
+    {
+        delta->Clear();
+
+        for ( const auto& entry : entries )
+        {
+            const wxExplorerBrowserItem& item = items[entry.second.index];
+            const Entries::const_iterator it = FindEntry(m_entries, m_items, item, entry.first);
+
+            if ( it == m_entries.end() )
+                delta->added.push_back(item);
+            else
+            if ( it->second.attributesHash != entry.second.attributesHash )
+                delta->changed.push_back(item);
+        }
+
+        for ( const auto& entry : m_entries )
+        {
+            const wxExplorerBrowserItem& item = m_items[entry.second.index];
+
+            if ( FindEntry(entries, items, item, entry.first) == entries.end() )
+                delta->removed.push_back(item);
+        }
+    }
+
+    m_items = std::move(items);
+    m_entries.swap(entries);
+}
+
+void wxExplorerBrowserListingFingerprint::Clear()
+{
+    // release the memory too, the listing can be large
+    wxExplorerBrowserItem::List().swap(m_items);
+    Entries().swap(m_entries);
+}
+
+size_t wxExplorerBrowserListingFingerprint::GetMemoryUsage() const
+{
+    return wxExplorerBrowserGetMemoryUsage(m_items) + GetMapMemoryUsage(m_entries);
+}
+
+wxUint64 wxExplorerBrowserListingFingerprint::GetItemKey(const wxExplorerBrowserItem& item)
+{
+    // the hashes are cached in the item, a path must not be mistaken for a display name
+    if ( !item.GetPath().empty() )
+        return item.GetPathHash();
+
+    return item.GetDisplayNameHash() ^ 0x9E3779B97F4A7C15ULL;
+}
+
+wxUint64 wxExplorerBrowserListingFingerprint::GetItemAttributesHash(const wxExplorerBrowserItem& item)
+{
+    const wxUint64 attributes[3] = { static_cast<wxUint64>(item.GetType()), item.GetSFGAO(),
+                                     item.GetDisplayNameHash() };
+
+    return wxExplorerBrowserHashBytes(attributes, sizeof(attributes));
+}
+
+bool wxExplorerBrowserListingFingerprint::IsSameItem(const wxExplorerBrowserItem& item1,
+                                                     const wxExplorerBrowserItem& item2)
+{
+    if ( item1.GetPath().empty() != item2.GetPath().empty() )
+        return false;
+
+    if ( !item1.GetPath().empty() )
+        return item1.GetPath() == item2.GetPath();
+
+    return item1.GetDisplayName() == item2.GetDisplayName();
+}
+
+void wxExplorerBrowserListingFingerprint::BuildEntries(const wxExplorerBrowserItem::List& items,
+                                                       Entries& entries)
+{
+    entries.reserve(items.size());
+
+    for ( size_t i = 0; i < items.size(); ++i )
+    {
+        const wxUint64 key = GetItemKey(items[i]);
+        const Entry entry = { GetItemAttributesHash(items[i]), i };
+        const auto range = entries.equal_range(key);
+        auto it = range.first;
+
+        while ( it != range.second && !IsSameItem(items[it->second.index], items[i]) )
+            ++it;
+
+        if ( it != range.second )
+            it->second = entry; // a duplicate, the last one wins
+        else
+            entries.insert(range.second, Entries::value_type(key, entry));
+    }
+}
+
+wxExplorerBrowserListingFingerprint::Entries::const_iterator
+wxExplorerBrowserListingFingerprint::FindEntry(const Entries& entries, const wxExplorerBrowserItem::List& items,
+                                               const wxExplorerBrowserItem& item, wxUint64 key)
+{
+    const auto range = entries.equal_range(key);
+
+    for ( auto it = range.first; it != range.second; ++it )
+    {
+        if ( IsSameItem(items[it->second.index], item) )
+            return it;
+    }
+
+    return entries.end();
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserChangeBatcher
+    ---------------------------------
+
+*****************************************************************************/
+
+void wxExplorerBrowserChangeBatcher::SetLimits(wxUint64 batchDelay, size_t maxPending)
+{
+    m_batchDelay = batchDelay;
+    m_maxPending = maxPending;
+}
+
+bool wxExplorerBrowserChangeBatcher::Add(wxExplorerBrowserItemChange::Type type,
+                                         const wxString& path, wxUint64 now)
+{
+    const bool newBatch = !m_hasBatch;
+
+    StartBatch(now);
+
+    if ( m_overflowed )
+        return newBatch;
+
+    const auto it = m_indices.find(path);
+
+    if ( it == m_indices.end() )
+    {
+        if ( m_indices.size() >= m_maxPending )
+        {
+            m_overflowed = true;
+            DropChanges();
+            return newBatch;
+        }
+
+        m_indices[path] = m_changes.size();
+        m_changes.push_back(wxExplorerBrowserItemChange(type, path));
+        return newBatch;
+    }
+
+    wxExplorerBrowserItemChange::Type& merged = m_changes[it->second].type;
+
+    // merge the change with the one already pending for the item,
+    // None means the item did not exist before the batch and does not exist now
+    switch ( type )
+    {
+        case wxExplorerBrowserItemChange::Created:
+            if ( merged == wxExplorerBrowserItemChange::Deleted )
+                merged = wxExplorerBrowserItemChange::Updated;
+            else
+            if ( merged == wxExplorerBrowserItemChange::None )
+                merged = wxExplorerBrowserItemChange::Created;
+            break;
+
+        case wxExplorerBrowserItemChange::Deleted:
+            // an item created in the batch did not exist before it, whatever happens later
+            if ( merged == wxExplorerBrowserItemChange::Created || merged == wxExplorerBrowserItemChange::None )
+                merged = wxExplorerBrowserItemChange::None;
+            else
+                merged = wxExplorerBrowserItemChange::Deleted;
+            break;
+
+        case wxExplorerBrowserItemChange::Updated:
+            // the item exists now, so it was created again after being cancelled out
+            if ( merged == wxExplorerBrowserItemChange::None )
+                merged = wxExplorerBrowserItemChange::Created;
+            else
+            if ( merged != wxExplorerBrowserItemChange::Created )
+                merged = wxExplorerBrowserItemChange::Updated;
+            break;
+
+        default:
+            wxFAIL_MSG(wxS("Invalid change type"));
+    }
+
+    return newBatch;
+}
+
+bool wxExplorerBrowserChangeBatcher::AddFolderChange(wxUint64 now)
+{
+    const bool newBatch = !m_hasBatch;
+
+    StartBatch(now);
+    m_overflowed = true;
+    DropChanges();
+
+    return newBatch;
+}
+
+bool wxExplorerBrowserChangeBatcher::GetDeadline(wxUint64& deadline) const
+{
+    if ( !m_hasBatch )
+        return false;
+
+    deadline = m_batchStart + m_batchDelay;
+    return true;
+}
+
+bool wxExplorerBrowserChangeBatcher::Flush(wxExplorerBrowserItemChange::List& changes)
+{
+    const bool overflowed = m_overflowed;
+
+    changes.clear();
+    changes.reserve(m_changes.size());
+    for ( auto& change : m_changes )
+    {
+        if ( change.type != wxExplorerBrowserItemChange::None )
+            changes.push_back(std::move(change));
+    }
+
+    Clear();
+    return overflowed;
+}
+
+void wxExplorerBrowserChangeBatcher::Clear()
+{
+    m_hasBatch = false;
+    m_overflowed = false;
+    m_changes.clear();
+    m_indices.clear();
+}
+
+size_t wxExplorerBrowserChangeBatcher::GetMemoryUsage() const
+{
+    size_t memory = m_changes.capacity() * sizeof(wxExplorerBrowserItemChange) + GetMapMemoryUsage(m_indices);
+
+    // the path is stored in both the change and the index
+    for ( const auto& change : m_changes )
+        memory += 2 * GetStringHeapUsage(change.path);
+
+    return memory;
+}
+
+void wxExplorerBrowserChangeBatcher::DropChanges()
+{
+    // the overflowed batch can be large, release its memory
+    wxExplorerBrowserItemChange::List().swap(m_changes);
+    m_indices.clear();
+}
+
+void wxExplorerBrowserChangeBatcher::StartBatch(wxUint64 now)
+{
+    if ( m_hasBatch )
+        return;
+
+    m_hasBatch = true;
+    m_batchStart = now;
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserSearchScheduler
+    ---------------------------------
+
+*****************************************************************************/
+
+void wxExplorerBrowserSearchScheduler::SetDelays(wxUint64 debounceDelay, wxUint64 pollInterval,
+                                                 wxUint64 settleDelay)
+{
+    m_debounceDelay = debounceDelay;
+    m_pollInterval = pollInterval;
+    m_settleDelay = settleDelay;
+}
+
+bool wxExplorerBrowserSearchScheduler::Submit(const wxString& query, wxUint64 now, wxString* cancelledQuery)
+{
+    bool cancelled = false;
+
+    if ( m_inFlight && query != m_inFlightQuery )
+    {
+        if ( cancelledQuery )
+            *cancelledQuery = m_inFlightQuery;
+        m_inFlight = false;
+        m_hasCompleted = false;
+        cancelled = true;
+    }
+
+    // supersedes the pending query, if any
+    m_hasPending = true;
+    m_pendingQuery = query;
+    m_pendingSubmitted = now;
+
+    return cancelled;
+}
+
+bool wxExplorerBrowserSearchScheduler::GetDeadline(wxUint64& deadline) const
+{
+    bool hasDeadline = false;
+
+    if ( m_hasPending )
+    {
+        deadline = m_pendingSubmitted + m_debounceDelay;
+        hasDeadline = true;
+    }
+
+    if ( m_inFlight )
+    {
+        const wxUint64 pollDeadline = m_lastPoll + m_pollInterval;
+
+        if ( !hasDeadline || pollDeadline < deadline )
+            deadline = pollDeadline;
+        hasDeadline = true;
+    }
+
+    return hasDeadline;
+}
+
+wxExplorerBrowserSearchScheduler::Action wxExplorerBrowserSearchScheduler::OnTimer(wxUint64 now)
+{
+    if ( m_hasPending && now >= m_pendingSubmitted + m_debounceDelay )
+    {
+        m_hasPending = false;
+
+        const bool sameAsInFlight = m_inFlight && m_pendingQuery == m_inFlightQuery;
+        const bool sameAsCompleted = !m_inFlight && m_hasCompleted && m_pendingQuery == m_completedQuery;
+
+        if ( !sameAsInFlight && !sameAsCompleted )
+        {
+            m_inFlight = true;
+            m_inFlightQuery = m_pendingQuery;
+            m_lastPoll = now;
+            m_lastProgress = now;
+            m_resultCount = 0;
+            return Action_Start;
+        }
+    }
+
+    if ( m_inFlight )
+    {
+        if ( now - m_lastProgress >= m_settleDelay )
+        {
+            Complete();
+            return Action_Complete;
+        }
+
+        if ( now >= m_lastPoll + m_pollInterval )
+            return Action_Poll;
+    }
+
+    return Action_None;
+}
+
+bool wxExplorerBrowserSearchScheduler::UpdateProgress(size_t count, wxUint64 now)
+{
+    m_lastPoll = now;
+
+    if ( count == m_resultCount )
+        return false;
+
+    m_resultCount = count;
+    m_lastProgress = now;
+    return true;
+}
+
+void wxExplorerBrowserSearchScheduler::Complete()
+{
+    if ( !m_inFlight )
+        return;
+
+    m_inFlight = false;
+    m_hasCompleted = true;
+    m_completedQuery = m_inFlightQuery;
+}
+
+void wxExplorerBrowserSearchScheduler::Reset()
+{
+    m_hasPending = false;
+    m_inFlight = false;
+    m_hasCompleted = false;
+    m_pendingQuery.clear();
+    m_inFlightQuery.clear();
+    m_completedQuery.clear();
+    m_resultCount = 0;
+}
+
+size_t wxExplorerBrowserSearchScheduler::GetMemoryUsage() const
+{
+    return GetStringHeapUsage(m_pendingQuery) + GetStringHeapUsage(m_inFlightQuery)
+           + GetStringHeapUsage(m_completedQuery);
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserResultInjector
+    ---------------------------------
+
+*****************************************************************************/
+
+void wxExplorerBrowserResultInjector::SetLimits(wxUint64 batchTime, wxUint64 batchInterval)
+{
+    m_batchTime = batchTime;
+    m_batchInterval = batchInterval;
+}
+
+void wxExplorerBrowserResultInjector::PrepareAdd(size_t count, wxUint64 now)
+{
+    if ( !HasPending() )
+    {
+        // a new injection, start counting from zero
+        m_entries.clear();
+        m_next = 0;
+        m_nextBatch = now;
+        m_processed = 0;
+        m_failed = 0;
+        m_total = 0;
+    }
+
+    m_entries.reserve(m_entries.size() + count);
+    m_total += count;
+}
+
+void wxExplorerBrowserResultInjector::AddPaths(const wxArrayString& paths, wxUint64 now)
+{
+    if ( paths.empty() )
+        return;
+
+    PrepareAdd(paths.size(), now);
+
+    for ( const auto& path : paths )
+    {
+        Entry entry;
+
+        entry.path = path;
+        m_entries.push_back(std::move(entry));
+    }
+}
+
+void wxExplorerBrowserResultInjector::AddIDLists(const std::vector<IDList>& idLists, wxUint64 now)
+{
+    if ( idLists.empty() )
+        return;
+
+    PrepareAdd(idLists.size(), now);
+
+    for ( const auto& idList : idLists )
+    {
+        Entry entry;
+
+        entry.idList = idList;
+        m_entries.push_back(std::move(entry));
+    }
+}
+
+bool wxExplorerBrowserResultInjector::GetDeadline(wxUint64& deadline) const
+{
+    if ( !HasPending() )
+        return false;
+
+    deadline = m_nextBatch;
+    return true;
+}
+
+size_t wxExplorerBrowserResultInjector::ProcessBatch(const Sink& sink, const Clock& clock)
+{
+    const wxUint64 start = clock();
+    wxUint64 now = start;
+    size_t processed = 0;
+
+    while ( HasPending() )
+    {
+        // the sink is much slower than the clock, so checking the time for each item is fine
+        if ( processed && now - start >= m_batchTime )
+            break;
+
+        Entry& entry = m_entries[m_next++];
+
+        if ( !sink(entry) )
+            ++m_failed;
+
+        // release the memory of the processed entry right away
+        entry = Entry();
+
+        ++processed;
+        ++m_processed;
+        now = clock();
+    }
+
+    if ( HasPending() )
+    {
+        m_nextBatch = now + m_batchInterval;
+    }
+    else
+    {
+        m_entries.clear();
+        m_entries.shrink_to_fit();
+        m_next = 0;
+    }
+
+    return processed;
+}
+
+size_t wxExplorerBrowserResultInjector::Cancel()
+{
+    const size_t dropped = GetPendingCount();
+
+    std::vector<Entry>().swap(m_entries);
+    m_next = 0;
+
+    return dropped;
+}
+
+size_t wxExplorerBrowserResultInjector::GetMemoryUsage() const
+{
+    size_t usage = m_entries.capacity() * sizeof(Entry);
+
+    for ( size_t i = m_next; i < m_entries.size(); ++i )
+        usage += GetStringHeapUsage(m_entries[i].path) + m_entries[i].idList.capacity();
+
+    return usage;
+}
+
+bool wxExplorerBrowserResultInjector::IsValidIDList(const IDList& idList)
+{
+    // SHITEMID::cb is a little-endian USHORT which includes its own size
+    const size_t sizeSize = 2;
+    size_t pos = 0;
+
+    while ( pos + sizeSize <= idList.size() )
+    {
+        const size_t size = idList[pos] | (static_cast<size_t>(idList[pos + 1]) << 8);
+
+        if ( size == 0 )
+            return pos + sizeSize == idList.size();
+
+        if ( size < sizeSize || size > idList.size() - pos )
+            return false;
+
+        pos += size;
+    }
+
+    return false;
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserItemCache
+    ---------------------------------
+
+*****************************************************************************/
+
+wxExplorerBrowserItemCache::wxExplorerBrowserItemCache(size_t maxMemory)
+    : m_maxMemory(maxMemory), m_hits(0), m_misses(0)
+{
+    for ( auto& generation : m_generations )
+        generation.store(0, std::memory_order_relaxed);
+}
+
+wxExplorerBrowserItemCache& wxExplorerBrowserItemCache::Get()
+{
+    static wxExplorerBrowserItemCache s_cache;
+
+    return s_cache;
+}
+
+void wxExplorerBrowserItemCache::SetMaxMemory(size_t maxMemory)
+{
+    m_maxMemory.store(maxMemory, std::memory_order_relaxed);
+    Shrink(maxMemory);
+}
+
+bool wxExplorerBrowserItemCache::Lookup(wxUint64 itemKey, wxExplorerBrowserItem& item)
+{
+    Shard& shard = GetShard(itemKey);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const auto it = shard.entries.find(itemKey);
+
+    if ( it == shard.entries.end() )
+    {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if ( it->second.generation != GetGeneration(it->second.folderKey) )
+    {
+        Erase(shard, it);
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lruPos);
+    item = it->second.item;
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+
+    return true;
+}
+
+void wxExplorerBrowserItemCache::Insert(wxUint64 itemKey, wxUint64 folderKey, const wxExplorerBrowserItem& item)
+{
+    const size_t maxShardMemory = m_maxMemory.load(std::memory_order_relaxed) / ShardCount;
+    const size_t memory = GetItemMemory(item);
+
+    if ( memory > maxShardMemory )
+        return;
+
+    Shard& shard = GetShard(itemKey);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const auto it = shard.entries.find(itemKey);
+
+    if ( it != shard.entries.end() )
+        Erase(shard, it);
+
+    shard.lru.push_front(itemKey);
+
+    Entry& entry = shard.entries[itemKey];
+
+    entry.item = item;
+    entry.folderKey = folderKey;
+    entry.generation = GetGeneration(folderKey);
+    entry.memory = memory;
+    entry.lruPos = shard.lru.begin();
+    shard.memory += memory;
+
+    Trim(shard, maxShardMemory);
+}
+
+void wxExplorerBrowserItemCache::InvalidateFolder(wxUint64 folderKey)
+{
+    m_generations[folderKey % GenerationCount].fetch_add(1, std::memory_order_acq_rel);
+}
+
+void wxExplorerBrowserItemCache::Shrink(size_t memory)
+{
+    for ( auto& shard : m_shards )
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        Trim(shard, memory / ShardCount);
+    }
+}
+
+void wxExplorerBrowserItemCache::Clear()
+{
+    for ( auto& shard : m_shards )
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        shard.entries.clear();
+        shard.lru.clear();
+        shard.memory = 0;
+    }
+}
+
+size_t wxExplorerBrowserItemCache::GetMemoryUsage() const
+{
+    size_t memory = 0;
+
+    for ( const auto& shard : m_shards )
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        memory += shard.memory;
+    }
+
+    return memory;
+}
+
+size_t wxExplorerBrowserItemCache::GetCount() const
+{
+    size_t count = 0;
+
+    for ( const auto& shard : m_shards )
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        count += shard.entries.size();
+    }
+
+    return count;
+}
+
+size_t wxExplorerBrowserItemCache::GetItemMemory(const wxExplorerBrowserItem& item)
+{
+    // the hash map and list nodes and their allocation overhead are just estimated
+    static const size_t nodesOverhead = 4 * sizeof(void*) + 32;
+
+    return sizeof(Entry) + nodesOverhead
+           + (item.GetPath().length() + item.GetDisplayName().length()) * sizeof(wxStringCharType);
+}
+
+void wxExplorerBrowserItemCache::Erase(Shard& shard, std::unordered_map<wxUint64, Entry>::iterator it)
+{
+    shard.memory -= it->second.memory;
+    shard.lru.erase(it->second.lruPos);
+    shard.entries.erase(it);
+}
+
+void wxExplorerBrowserItemCache::Trim(Shard& shard, size_t maxMemory)
+{
+    while ( shard.memory > maxMemory && !shard.lru.empty() )
+        Erase(shard, shard.entries.find(shard.lru.back()));
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserParkingLot
+    ---------------------------------
+
+*****************************************************************************/
+
+void wxExplorerBrowserParkingLot::SetBudget(size_t maxViews, size_t maxMemory, ViewIdList& evicted)
+{
+    m_maxViews = maxViews;
+    m_maxMemory = maxMemory;
+
+    Evict(evicted);
+}
+
+void wxExplorerBrowserParkingLot::Park(ViewId view, size_t memory, ViewIdList& evicted)
+{
+    Unpark(view);
+
+    m_views.push_back({view, memory});
+    m_index[view] = std::prev(m_views.end());
+    m_memory += memory;
+
+    Evict(evicted);
+}
+
+bool wxExplorerBrowserParkingLot::Unpark(ViewId view)
+{
+    const auto it = m_index.find(view);
+
+    if ( it == m_index.end() )
+        return false;
+
+    m_memory -= it->second->memory;
+    m_views.erase(it->second);
+    m_index.erase(it);
+
+    return true;
+}
+
+bool wxExplorerBrowserParkingLot::IsOverBudget() const
+{
+    return (m_maxViews && m_views.size() > m_maxViews)
+           || (m_maxMemory && m_memory > m_maxMemory);
+}
+
+void wxExplorerBrowserParkingLot::Evict(ViewIdList& evicted)
+{
+    while ( !m_views.empty() && IsOverBudget() )
+    {
+        const ViewId view = m_views.front().id;
+
+        Unpark(view);
+        evicted.push_back(view);
+    }
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserItemPool
+    ---------------------------------
+
+*****************************************************************************/
+
+class wxExplorerBrowserItemPool::FreeList
+{
+public:
+    explicit FreeList(size_t maxItems)
+        : m_maxItems(maxItems), m_controlBlocks(ControlBlockSize, maxItems)
+    {
+        m_items.reserve(maxItems);
+    }
+
+    ~FreeList()
+    {
+        for ( auto item : m_items )
+            delete item;
+    }
+
+    wxExplorerBrowserItem* Pop()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if ( m_items.empty() )
+            return nullptr;
+
+        wxExplorerBrowserItem* item = m_items.back();
+
+        m_items.pop_back();
+        return item;
+    }
+
+    void Push(wxExplorerBrowserItem* item)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if ( m_items.size() < m_maxItems )
+            {
+                m_items.push_back(item);
+                return;
+            }
+        }
+
+        delete item;
+    }
+
+    size_t GetCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        return m_items.size();
+    }
+
+    // the deleter of ItemPtr, the mutex orders the releasing thread's
+    // accesses to the item before its reuse by another thread
+    struct Releaser
+    {
+        std::shared_ptr<FreeList> freeList;
+
+        void operator()(const wxExplorerBrowserItem* item) const
+            { freeList->Push(const_cast<wxExplorerBrowserItem*>(item)); }
+    };
+
+    // allocates the control blocks of ItemPtr, so that they are reused too
+    template <typename T>
+    struct Allocator
+    {
+        typedef T value_type;
+
+        std::shared_ptr<FreeList> freeList;
+
+        explicit Allocator(const std::shared_ptr<FreeList>& list) : freeList(list) {}
+        template <typename U>
+        Allocator(const Allocator<U>& other) : freeList(other.freeList) {}
+
+        T* allocate(size_t n)
+        {
+            if ( n * sizeof(T) <= ControlBlockSize )
+                return static_cast<T*>(freeList->m_controlBlocks.Allocate());
+
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, size_t n)
+        {
+            if ( n * sizeof(T) <= ControlBlockSize )
+                freeList->m_controlBlocks.Free(p);
+            else
+                ::operator delete(p);
+        }
+
+        template <typename U>
+        bool operator==(const Allocator<U>& other) const { return freeList == other.freeList; }
+        template <typename U>
+        bool operator!=(const Allocator<U>& other) const { return freeList != other.freeList; }
+    };
+
+private:
+    // large enough for the control block holding the deleter and the allocator
+    enum { ControlBlockSize = 128 };
+
+    const size_t m_maxItems;
+
+    mutable std::mutex m_mutex;
+    std::vector<wxExplorerBrowserItem*> m_items;
+
+    wxExplorerBrowserBlockPool m_controlBlocks;
+};
+
+wxExplorerBrowserItemPool::wxExplorerBrowserItemPool(size_t maxItems)
+    : m_freeList(std::make_shared<FreeList>(maxItems))
+{
+}
+
+wxExplorerBrowserItemPool::ItemPtr wxExplorerBrowserItemPool::Acquire(const wxExplorerBrowserItem& item)
+{
+    wxExplorerBrowserItem* pooled = m_freeList->Pop();
+
+    if ( pooled )
+        *pooled = item;
+    else
+        pooled = new wxExplorerBrowserItem(item);
+
+    // the allocator keeps the free list alive until the control block is freed,
+    // after the deleter returned the item
+    return ItemPtr(pooled, FreeList::Releaser{m_freeList}, FreeList::Allocator<wxExplorerBrowserItem>(m_freeList));
+}
+
+size_t wxExplorerBrowserItemPool::GetCount() const
+{
+    return m_freeList->GetCount();
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserBlockPool
+    ---------------------------------
+
+*****************************************************************************/
+
+wxExplorerBrowserBlockPool::~wxExplorerBrowserBlockPool()
+{
+    for ( auto block : m_freeBlocks )
+        ::operator delete(block);
+}
+
+void* wxExplorerBrowserBlockPool::Allocate()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if ( !m_freeBlocks.empty() )
+        {
+            void* block = m_freeBlocks.back();
+
+            m_freeBlocks.pop_back();
+            return block;
+        }
+    }
+
+    return ::operator new(m_blockSize);
+}
+
+void wxExplorerBrowserBlockPool::Free(void* block)
+{
+    if ( !block )
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if ( m_freeBlocks.size() < m_maxFreeBlocks )
+        {
+            m_freeBlocks.push_back(block);
+            return;
+        }
+    }
+
+    ::operator delete(block);
+}
+
+/***************************************************************************
+
+    parallel algorithms
+    ---------------------------------
+
+*****************************************************************************/
+
+struct wxExplorerBrowserThreadPool::Job
+{
+    Job(size_t count, const std::function<void(size_t)>& function)
+        : func(&function), taskCount(count), nextTask(0)
+    {}
+
+    // only called for a task taken before all the tasks finished, so still valid
+    const std::function<void(size_t)>* func;
+    const size_t taskCount;
+    std::atomic<size_t> nextTask;
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t finishedTasks {0};
+};
+
+wxExplorerBrowserThreadPool::wxExplorerBrowserThreadPool(unsigned workerCount)
+{
+    if ( !workerCount )
+        workerCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+    for ( unsigned i = 0; i < workerCount; ++i )
+        m_workers.emplace_back(&wxExplorerBrowserThreadPool::WorkerMain, this);
+}
+
+wxExplorerBrowserThreadPool::~wxExplorerBrowserThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_stopping = true;
+    }
+
+    m_condition.notify_all();
+
+    for ( auto& worker : m_workers )
+        worker.join();
+}
+
+wxExplorerBrowserThreadPool& wxExplorerBrowserThreadPool::Get()
+{
+    // not destroyed, so that it can be used from the destructors of other static objects
+    static wxExplorerBrowserThreadPool* s_pool = new wxExplorerBrowserThreadPool();
+
+    return *s_pool;
+}
+
+void wxExplorerBrowserThreadPool::Run(size_t taskCount, const std::function<void(size_t task)>& func,
+                                      unsigned maxWorkers)
+{
+    const size_t helperCount = std::min<size_t>(std::min<size_t>(maxWorkers, m_workers.size()),
+                                                taskCount ? taskCount - 1 : 0);
+
+    if ( !helperCount )
+    {
+        for ( size_t task = 0; task < taskCount; ++task )
+            func(task);
+        return;
+    }
+
+    const std::shared_ptr<Job> job = std::make_shared<Job>(taskCount, func);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_jobs.insert(m_jobs.end(), helperCount, job);
+    }
+
+    if ( helperCount < m_workers.size() )
+    {
+        for ( size_t i = 0; i < helperCount; ++i )
+            m_condition.notify_one();
+    }
+    else
+    {
+        m_condition.notify_all();
+    }
+
+    RunTasks(*job);
+
+    {
+        std::unique_lock<std::mutex> lock(job->mutex);
+
+        job->finished.wait(lock, [&job]() { return job->finishedTasks == job->taskCount; });
+    }
+
+    // the requests no busy worker got to are not needed any more
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_jobs.erase(std::remove(m_jobs.begin(), m_jobs.end(), job), m_jobs.end());
+}
+
+void wxExplorerBrowserThreadPool::WorkerMain()
+{
+    for ( ;; )
+    {
+        std::shared_ptr<Job> job;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            m_condition.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+
+            if ( m_jobs.empty() )
+                return;
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        RunTasks(*job);
+    }
+}
+
+void wxExplorerBrowserThreadPool::RunTasks(Job& job)
+{
+    size_t finishedTasks = 0;
+
+    for ( size_t task = job.nextTask++; task < job.taskCount; task = job.nextTask++ )
+    {
+        (*job.func)(task);
+        ++finishedTasks;
+    }
+
+    if ( !finishedTasks )
+        return;
+
+    std::lock_guard<std::mutex> lock(job.mutex);
+
+    job.finishedTasks += finishedTasks;
+    if ( job.finishedTasks == job.taskCount )
+        job.finished.notify_all();
+}
+
+wxExplorerBrowserReaper::~wxExplorerBrowserReaper()
+{
+    Shutdown();
+}
+
+void wxExplorerBrowserReaper::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_shutDown = true;
+    }
+
+    m_condition.notify_all();
+
+    if ( m_thread.joinable() )
+        m_thread.join();
+}
+
+size_t wxExplorerBrowserReaper::GetPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_objects.size() + m_destroyingCount;
+}
+
+void wxExplorerBrowserReaper::Add(std::shared_ptr<void> object)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if ( !m_shutDown )
+        {
+            m_objects.push_back(std::move(object));
+            if ( !m_thread.joinable() )
+                m_thread = std::thread(&wxExplorerBrowserReaper::ThreadMain, this);
+        }
+    }
+
+    // destroyed here, outside the lock, when shut down
+    if ( object )
+    {
+        object.reset();
+        return;
+    }
+
+    m_condition.notify_one();
+}
+
+void wxExplorerBrowserReaper::ThreadMain()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    for ( ;; )
+    {
+        m_condition.wait(lock, [this]() { return m_shutDown || !m_objects.empty(); });
+
+        if ( m_objects.empty() )
+            return;
+
+        std::shared_ptr<void> object(std::move(m_objects.front()));
+
+        m_objects.pop_front();
+        ++m_destroyingCount;
+
+        lock.unlock();
+        object.reset();
+        lock.lock();
+
+        --m_destroyingCount;
+    }
+}
+
+wxExplorerBrowserWorkerThread::~wxExplorerBrowserWorkerThread()
+{
+    Stop();
+}
+
+void wxExplorerBrowserWorkerThread::Post(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_tasks.push_back(std::move(task));
+        if ( !m_thread.joinable() )
+            m_thread = std::thread(&wxExplorerBrowserWorkerThread::ThreadMain, this);
+    }
+
+    m_condition.notify_one();
+}
+
+void wxExplorerBrowserWorkerThread::Stop()
+{
+    std::deque<std::function<void()>> dropped;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_stopping = true;
+        dropped.swap(m_tasks);
+    }
+
+    m_condition.notify_all();
+
+    if ( m_thread.joinable() )
+        m_thread.join();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_stopping = false;
+}
+
+bool wxExplorerBrowserWorkerThread::IsIdle() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return !m_running && m_tasks.empty();
+}
+
+void wxExplorerBrowserWorkerThread::ThreadMain()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    for ( ;; )
+    {
+        m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+
+        if ( m_stopping )
+            return;
+
+        std::function<void()> task(std::move(m_tasks.front()));
+
+        m_tasks.pop_front();
+        m_running = true;
+
+        // destroyed outside the lock too, it can own the results of the task
+        lock.unlock();
+        task();
+        task = nullptr;
+        lock.lock();
+
+        m_running = false;
+    }
+}
+
+void wxExplorerBrowserParallelFor(size_t count, const std::function<void(size_t begin, size_t end)>& func,
+                                  unsigned threadCount, size_t minRangeSize)
+{
+    if ( !count )
+        return;
+
+    if ( !threadCount )
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    const size_t rangeCount = std::min<size_t>(threadCount,
+                                               std::max<size_t>(1, count / std::max<size_t>(minRangeSize, 1)));
+
+    if ( rangeCount < 2 )
+    {
+        func(0, count);
+        return;
+    }
+
+    wxExplorerBrowserThreadPool::Get().Run(rangeCount, [&](size_t range)
+        {
+            func(count * range / rangeCount, count * (range + 1) / rangeCount);
+        }, threadCount - 1);
+}
+
+void wxExplorerBrowserParallelForChunks(size_t count, size_t chunkSize,
+                                        const std::function<void(size_t begin, size_t end)>& func,
+                                        unsigned threadCount)
+{
+    if ( !count )
+        return;
+
+    chunkSize = std::max<size_t>(chunkSize, 1);
+
+    if ( !threadCount )
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+    // the pool hands out the chunks one by one
+    wxExplorerBrowserThreadPool::Get().Run(chunkCount, [&](size_t chunk)
+        {
+            func(chunk * chunkSize, std::min(count, (chunk + 1) * chunkSize));
+        }, threadCount - 1);
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserItemSorter
+    ---------------------------------
+
+*****************************************************************************/
+
+std::u32string wxExplorerBrowserItemSorter::MakeNaturalKey(const wxString& str)
+{
+    // A run of digits is encoded as DigitsMarker, the number of its significant
+    // digits and the significant digits. Other characters are lowercased and
+    // shifted above DigitsMarker, so numbers sort before them.
+    static const char32_t DigitsMarker = 1;
+    static const char32_t CharOffset = 2;
+
+    const wxStringCharType* s = str.wx_str();
+    const size_t length = str.length();
+    std::u32string key;
+
+    key.reserve(length + 2);
+
+    for ( size_t i = 0; i < length; )
+    {
+        if ( s[i] >= wxS('0') && s[i] <= wxS('9') )
+        {
+            size_t end = i;
+
+            while ( end < length && s[end] >= wxS('0') && s[end] <= wxS('9') )
+                ++end;
+
+            // leading zeros do not change the value
+            while ( i + 1 < end && s[i] == wxS('0') )
+                ++i;
+
+            key.push_back(DigitsMarker);
+            key.push_back(static_cast<char32_t>(end - i));
+            for ( ; i < end; ++i )
+                key.push_back(static_cast<char32_t>(s[i]));
+        }
+        else
+        {
+            key.push_back(static_cast<char32_t>(wxTolower(s[i])) + CharOffset);
+            ++i;
+        }
+    }
+
+    return key;
+}
+
+std::u32string wxExplorerBrowserItemSorter::MakeCaseInsensitiveKey(const wxString& str)
+{
+    const wxStringCharType* s = str.wx_str();
+    const size_t length = str.length();
+    std::u32string key;
+
+    key.reserve(length);
+
+    for ( size_t i = 0; i < length; ++i )
+        key.push_back(static_cast<char32_t>(wxTolower(s[i])));
+
+    return key;
+}
+
+std::u32string wxExplorerBrowserItemSorter::MakeKey(const wxExplorerBrowserItem& item, Order order)
+{
+    switch ( order )
+    {
+        case Order_Name:
+            return MakeCaseInsensitiveKey(item.GetDisplayName());
+
+        case Order_Path:
+            return MakeCaseInsensitiveKey(item.GetPath());
+
+        case Order_Type:
+        {
+            char32_t rank = 3;
+
+            if ( item.IsDirectory() )
+                rank = 0;
+            else if ( item.IsFile() )
+                rank = 1;
+            else if ( item.GetType() == wxExplorerBrowserItem::Other )
+                rank = 2;
+
+            return rank + MakeNaturalKey(item.GetDisplayName());
+        }
+
+        case Order_Natural:
+            return MakeNaturalKey(item.GetDisplayName());
+    }
+
+    wxFAIL_MSG(wxS("Invalid sort order"));
+    return std::u32string();
+}
+
+void wxExplorerBrowserItemSorter::Sort(wxExplorerBrowserItem::List& items, Order order, unsigned threadCount)
+{
+    struct Entry
+    {
+        std::u32string key;
+        size_t index;
+
+        bool operator<(const Entry& other) const
+        {
+            const int result = key.compare(other.key);
+
+            return result < 0 || (result == 0 && index < other.index);
+        }
+    };
+
+    std::vector<Entry> entries(items.size());
+
+    // the keys are computed only once for each item, not in every comparison
+    wxExplorerBrowserParallelFor(items.size(), [&](size_t begin, size_t end)
+        {
+            for ( size_t i = begin; i < end; ++i )
+            {
+                entries[i].key = MakeKey(items[i], order);
+                entries[i].index = i;
+            }
+        }, threadCount);
+
+    wxExplorerBrowserParallelSort(entries.begin(), entries.end(), std::less<Entry>(), threadCount);
+
+    wxExplorerBrowserItem::List sorted;
+
+    sorted.reserve(items.size());
+    for ( const auto& entry : entries )
+        sorted.push_back(std::move(items[entry.index]));
+
+    items.swap(sorted);
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserMaskMatcher
+    ---------------------------------
+
+*****************************************************************************/
+
+void wxExplorerBrowserMaskMatcher::Set(const wxArrayString& masks, wxUint32 itemTypes)
+{
+    m_masks.clear();
+    Add(masks, itemTypes);
+}
+
+void wxExplorerBrowserMaskMatcher::Add(const wxArrayString& masks, wxUint32 itemTypes)
+{
+    m_masks.reserve(m_masks.size() + masks.size());
+
+    // we do not want case-sensitive filtering
+    for ( const auto& mask : masks )
+        m_masks.push_back(mask.Upper());
+
+    m_itemTypes = itemTypes;
+}
+
+void wxExplorerBrowserMaskMatcher::Clear()
+{
+    m_masks.clear();
+    m_itemTypes = 0;
+}
+
+bool wxExplorerBrowserMaskMatcher::MatchesName(const wxExplorerBrowserItem& item, wxString& buffer) const
+{
+    GetMatchName(item, buffer);
+    return MatchesUpperName(buffer);
+}
+
+bool wxExplorerBrowserMaskMatcher::MatchesFileName(const wxString& name, wxString& buffer) const
+{
+    buffer = name;
+    buffer.MakeUpper();
+    return MatchesUpperName(buffer);
+}
+
+bool wxExplorerBrowserMaskMatcher::MatchesUpperName(const wxString& name) const
+{
+    for ( const auto& mask : m_masks )
+    {
+        if ( wxMatchWild(mask, name, false) )
+            return true;
+    }
+
+    return false;
+}
+
+void wxExplorerBrowserMaskMatcher::GetMatchName(const wxExplorerBrowserItem& item, wxString& name)
+{
+    GetItemName(item, name);
+
+    // wxMatchWild() is surprisingly case sensitive even on MSW
+    name.MakeUpper();
+}
+
+void wxExplorerBrowserMaskMatcher::GetItemName(const wxExplorerBrowserItem& item, wxString& name)
+{
+    if ( item.GetType() == wxExplorerBrowserItem::Other )
+    {
+        name = item.GetDisplayName();
+    }
+    else
+    {
+        // the path for directories does not end with a slash,
+        // so this also returns the parent-relative directory name
+        const wxString& path = item.GetPath();
+        const size_t pos = path.find_last_of(wxS("\\/"));
+
+        if ( pos == wxString::npos )
+            name = path;
+        else
+            name.assign(path, pos + 1, wxString::npos);
+    }
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserThumbnailService
+    ---------------------------------
+
+*****************************************************************************/
+
+wxExplorerBrowserThumbnailService::wxExplorerBrowserThumbnailService(const Decoder& decoder,
+                                                                     const ReadyCallback& onReady,
+                                                                     size_t maxMemory, unsigned threadCount)
+    : m_decoder(decoder), m_onReady(onReady),
+      m_threadCount(threadCount ? threadCount : std::min(4u, std::max(1u, std::thread::hardware_concurrency()))),
+      m_maxMemory(maxMemory)
+{
+    wxASSERT(m_decoder);
+}
+
+wxExplorerBrowserThumbnailService::~wxExplorerBrowserThumbnailService()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_stopping = true;
+        m_tasks.clear();
+    }
+
+    m_wakeUp.notify_all();
+
+    for ( auto& thread : m_threads )
+        thread.join();
+}
+
+wxExplorerBrowserThumbnailService::Key wxExplorerBrowserThumbnailService::MakeKey(const wxExplorerBrowserItem& item,
+                                                                                  unsigned size)
+{
+    Key key;
+
+    if ( item.HasId() )
+    {
+        key.itemId = item.GetId();
+    }
+    else
+    {
+        const wxString& path = item.GetPath();
+
+        key.itemId = wxExplorerBrowserMakeItemId(path.wx_str(), path.length() * sizeof(wxStringCharType));
+    }
+
+    key.size = size;
+    return key;
+}
+
+bool wxExplorerBrowserThumbnailService::Lookup(const Key& key, wxExplorerBrowserThumbnail::Ptr& thumbnail)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_entries.find(key);
+
+    if ( it == m_entries.end() )
+        return false;
+
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lruPos);
+    thumbnail = it->second.thumbnail;
+
+    return true;
+}
+
+bool wxExplorerBrowserThumbnailService::Request(const wxExplorerBrowserItem& item, unsigned size,
+                                                wxExplorerBrowserThumbnail::Ptr& thumbnail)
+{
+    const Key key = MakeKey(item, size);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_entries.find(key);
+
+    if ( it != m_entries.end() )
+    {
+        m_lru.splice(m_lru.begin(), m_lru, it->second.lruPos);
+        thumbnail = it->second.thumbnail;
+        return true;
+    }
+
+    if ( !m_inFlight.insert(key).second )
+        return false; // the result will be delivered for the earlier request
+
+    Task task;
+
+    task.key = key;
+    task.item = item;
+    // wxString copies may share the buffer, which is not thread-safe
+    task.item.SetPath(item.GetPath().wx_str());
+    task.item.SetDisplayName(item.GetDisplayName().wx_str());
+    m_tasks.push_back(std::move(task));
+
+    // the in-flight requests include the queued ones and those being extracted
+    if ( m_threads.size() < m_threadCount && m_threads.size() < m_inFlight.size() )
+        m_threads.emplace_back(&wxExplorerBrowserThumbnailService::WorkerMain, this);
+
+    m_wakeUp.notify_one();
+    return false;
+}
+
+size_t wxExplorerBrowserThumbnailService::CancelPending()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const size_t count = m_tasks.size();
+
+    for ( const auto& task : m_tasks )
+        m_inFlight.erase(task.key);
+
+    m_tasks.clear();
+    return count;
+}
+
+void wxExplorerBrowserThumbnailService::SetMaxMemory(size_t maxMemory)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_maxMemory = maxMemory;
+    ShrinkLocked(maxMemory);
+}
+
+size_t wxExplorerBrowserThumbnailService::GetMaxMemory() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_maxMemory;
+}
+
+void wxExplorerBrowserThumbnailService::Shrink(size_t memory)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    ShrinkLocked(memory);
+}
+
+void wxExplorerBrowserThumbnailService::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    ShrinkLocked(0);
+}
+
+size_t wxExplorerBrowserThumbnailService::GetMemoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_memory;
+}
+
+size_t wxExplorerBrowserThumbnailService::GetCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_entries.size();
+}
+
+size_t wxExplorerBrowserThumbnailService::GetPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_tasks.size();
+}
+
+size_t wxExplorerBrowserThumbnailService::GetInFlightCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_inFlight.size();
+}
+
+void wxExplorerBrowserThumbnailService::WorkerMain()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    for ( ;; )
+    {
+        m_wakeUp.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+
+        if ( m_stopping )
+            return;
+
+        const Task task = std::move(m_tasks.back());
+
+        m_tasks.pop_back();
+        lock.unlock();
+
+        std::shared_ptr<wxExplorerBrowserThumbnail> thumbnail = std::make_shared<wxExplorerBrowserThumbnail>();
+
+        if ( !m_decoder(task.item, task.key.size, *thumbnail) )
+            thumbnail.reset();
+
+        lock.lock();
+
+        // the entry is cached before the callback, so that the owner notified
+        // by it finds the thumbnail with Lookup()
+        if ( thumbnail )
+            InsertLocked(task.key, thumbnail);
+        m_inFlight.erase(task.key);
+
+        if ( m_onReady && !m_stopping )
+        {
+            lock.unlock();
+            m_onReady(task.item, task.key.size, thumbnail);
+            lock.lock();
+        }
+    }
+}
+
+void wxExplorerBrowserThumbnailService::InsertLocked(const Key& key, const wxExplorerBrowserThumbnail::Ptr& thumbnail)
+{
+    const size_t memory = thumbnail->GetMemoryUsage();
+
+    if ( memory > m_maxMemory )
+        return;
+
+    const auto it = m_entries.find(key);
+
+    if ( it != m_entries.end() )
+    {
+        m_memory -= it->second.thumbnail->GetMemoryUsage();
+        m_lru.erase(it->second.lruPos);
+        m_entries.erase(it);
+    }
+
+    m_lru.push_front(key);
+
+    Entry entry;
+
+    entry.thumbnail = thumbnail;
+    entry.lruPos = m_lru.begin();
+    m_entries.emplace(key, std::move(entry));
+    m_memory += memory;
+
+    ShrinkLocked(m_maxMemory);
+}
+
+void wxExplorerBrowserThumbnailService::ShrinkLocked(size_t memory)
+{
+    while ( m_memory > memory && !m_lru.empty() )
+    {
+        const auto it = m_entries.find(m_lru.back());
+
+        m_memory -= it->second.thumbnail->GetMemoryUsage();
+        m_entries.erase(it);
+        m_lru.pop_back();
+    }
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserThumbnailStore
+    ---------------------------------
+
+    File layout, all numbers are little-endian:
+
+    Header (StoreHeaderSize bytes)
+        char[8]  magic "WXEBTHMB"
+        uint32   version
+        uint32   header size
+        uint32   record header size
+        uint32   reserved, 0
+        uint64   reserved, 0
+
+    Record, 8-byte aligned, one per stored thumbnail
+        uint32   magic StoreRecordMagic
+        uint32   size of the pixels
+        uint64   size of the record including the padding
+        uint64   item key
+        uint64   modification time
+        uint32   requested size
+        uint32   width
+        uint32   height
+        uint32   reserved, 0
+        uint64   item check, a second hash of the item identity, see MakeKey()
+        uint64   checksum of the pixels
+        uint64   checksum of the record header up to here
+        uint64   last access, updated in place, not covered by the checksum
+        uint8[]  RGBA pixels followed by the padding
+
+    A record replaces the earlier ones with the same key.
+    The records end with the first invalid one or with zeros.
+
+*****************************************************************************/
+
+namespace {
+
+const char     StoreMagic[8] = { 'W', 'X', 'E', 'B', 'T', 'H', 'M', 'B' };
+const wxUint32 StoreHeaderSize = 32;
+const wxUint32 StoreRecordMagic = 0x52485457; // "WTHR"
+const wxUint32 StoreRecordHeaderSize = 80;
+const wxUint32 StoreRecordPayloadChecksumOffset = 56;
+const wxUint32 StoreRecordChecksumOffset = 64;
+const wxUint32 StoreRecordAccessOffset = 72;
+const wxUint32 StoreMaxDimension = 16384;
+const size_t   StoreMinGrowth = 1024 * 1024;
+
+size_t GetStoreRecordSize(size_t payloadSize)
+{
+    return (StoreRecordHeaderSize + payloadSize + 7) & ~static_cast<size_t>(7);
+}
+
+// unlike FNV-1a used for the item key, each step mixes the whole state,
+// so a collision of both hashes is not more likely than of two unrelated ones
+wxUint64 GetStoreItemCheck(const wxString& path)
+{
+    const wxStringCharType* p = path.wx_str();
+    wxUint64 hash = 0x9E3779B97F4A7C15ULL ^ path.length();
+
+    for ( size_t i = 0; i < path.length(); ++i )
+    {
+        hash = (hash + static_cast<wxUint64>(p[i])) * 0xBF58476D1CE4E5B9ULL;
+        hash ^= hash >> 31;
+    }
+
+    return hash;
+}
+
+} // unnamed namespace
+
+wxExplorerBrowserThumbnailStore::Key wxExplorerBrowserThumbnailStore::MakeKey(const wxExplorerBrowserItem& item,
+                                                                              wxUint64 modificationTime,
+                                                                              unsigned size)
+{
+    Key key;
+
+    key.itemKey = item.GetPathHash();
+    key.itemCheck = GetStoreItemCheck(item.GetPath());
+    key.modificationTime = modificationTime;
+    key.size = size;
+
+    return key;
+}
+
+bool wxExplorerBrowserThumbnailStore::Open(const wxString& fileName, size_t maxSize)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_fileName = fileName;
+    m_maxSize = maxSize;
+
+    if ( !OpenLocked() )
+        return false;
+
+    // the file could have been created with a larger maximum size
+    if ( m_end > m_maxSize )
+        CompactLocked(m_maxSize / 4 * 3);
+
+    return m_file.IsOpened();
+}
+
+void wxExplorerBrowserThumbnailStore::Close()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if ( m_file.IsOpened() )
+        m_file.Flush();
+
+    m_file.Close();
+    m_index.clear();
+    m_end = 0;
+}
+
+bool wxExplorerBrowserThumbnailStore::IsOpened() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_file.IsOpened();
+}
+
+bool wxExplorerBrowserThumbnailStore::SetMaxSize(size_t maxSize)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_maxSize = maxSize;
+
+    if ( m_file.IsOpened() && m_end > maxSize )
+        return CompactLocked(maxSize / 4 * 3);
+
+    return true;
+}
+
+bool wxExplorerBrowserThumbnailStore::Lookup(const Key& key, wxExplorerBrowserThumbnail& thumbnail)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_index.find(key);
+
+    if ( it == m_index.end() )
+        return false;
+
+    wxUint8* record = m_file.GetWritableData() + it->second.offset;
+
+    if ( GetUint64(record + 48) != key.itemCheck || !IsPayloadValid(it->second) )
+    {
+        m_index.erase(it);
+        return false;
+    }
+    const size_t payloadSize = GetUint32(record + 4);
+
+    thumbnail.width = GetUint32(record + 36);
+    thumbnail.height = GetUint32(record + 40);
+    thumbnail.pixels.assign(record + StoreRecordHeaderSize, record + StoreRecordHeaderSize + payloadSize);
+
+    PutUint64(record + StoreRecordAccessOffset, ++m_lastAccess);
+
+    return true;
+}
+
+bool wxExplorerBrowserThumbnailStore::Insert(const Key& key, const wxExplorerBrowserThumbnail& thumbnail)
+{
+    wxCHECK(thumbnail.width && thumbnail.width <= StoreMaxDimension, false);
+    wxCHECK(thumbnail.height && thumbnail.height <= StoreMaxDimension, false);
+
+    const size_t payloadSize = static_cast<size_t>(thumbnail.width) * thumbnail.height * 4;
+
+    wxCHECK(thumbnail.pixels.size() >= payloadSize, false);
+
+    const size_t recordSize = GetStoreRecordSize(payloadSize);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if ( !m_file.IsOpened() || StoreHeaderSize + recordSize > m_maxSize / 2 )
+        return false;
+
+    if ( m_end + recordSize > m_maxSize && !CompactLocked(m_maxSize / 4 * 3 - recordSize) )
+        return false;
+
+    if ( !Reserve(m_end + recordSize) )
+        return false;
+
+    wxUint8* record = m_file.GetWritableData() + m_end;
+
+    memset(record, 0, StoreRecordHeaderSize);
+    memcpy(record + StoreRecordHeaderSize, thumbnail.pixels.data(), payloadSize);
+
+    PutUint32(record, StoreRecordMagic);
+    PutUint32(record + 4, static_cast<wxUint32>(payloadSize));
+    PutUint64(record + 8, recordSize);
+    PutUint64(record + 16, key.itemKey);
+    PutUint64(record + 24, key.modificationTime);
+    PutUint32(record + 32, key.size);
+    PutUint32(record + 36, thumbnail.width);
+    PutUint32(record + 40, thumbnail.height);
+    PutUint64(record + 48, key.itemCheck);
+    PutUint64(record + StoreRecordPayloadChecksumOffset,
+              wxExplorerBrowserHashBytes(record + StoreRecordHeaderSize, payloadSize));
+    PutUint64(record + StoreRecordChecksumOffset, wxExplorerBrowserHashBytes(record, StoreRecordChecksumOffset));
+    PutUint64(record + StoreRecordAccessOffset, ++m_lastAccess);
+
+    IndexEntry entry;
+
+    entry.offset = m_end;
+    entry.size = recordSize;
+    m_index[key] = entry;
+    m_end += recordSize;
+
+    return true;
+}
+
+bool wxExplorerBrowserThumbnailStore::Compact(size_t size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return CompactLocked(size);
+}
+
+bool wxExplorerBrowserThumbnailStore::Flush()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_file.IsOpened() && m_file.Flush();
+}
+
+size_t wxExplorerBrowserThumbnailStore::GetCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_index.size();
+}
+
+size_t wxExplorerBrowserThumbnailStore::GetUsedSize() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_end;
+}
+
+bool wxExplorerBrowserThumbnailStore::OpenLocked()
+{
+    m_index.clear();
+    m_end = 0;
+    m_lastAccess = 0;
+
+    if ( !m_file.Open(m_fileName, wxExplorerBrowserMappedFile::Mode_ReadWrite, StoreHeaderSize) )
+        return false;
+
+    const wxUint8* data = m_file.GetData();
+
+    // the store is just a cache, a file in an unknown format is replaced
+    if ( memcmp(data, StoreMagic, sizeof(StoreMagic)) != 0 || GetUint32(data + 8) != Version
+         || GetUint32(data + 12) != StoreHeaderSize || GetUint32(data + 16) != StoreRecordHeaderSize )
+    {
+        if ( !Create() )
+        {
+            m_file.Close();
+            return false;
+        }
+    }
+
+    Load();
+    return true;
+}
+
+bool wxExplorerBrowserThumbnailStore::Create()
+{
+    if ( !m_file.Resize(StoreHeaderSize) )
+        return false;
+
+    wxUint8* header = m_file.GetWritableData();
+
+    if ( !header )
+        return false;
+
+    memset(header, 0, StoreHeaderSize);
+    memcpy(header, StoreMagic, sizeof(StoreMagic));
+    PutUint32(header + 8, Version);
+    PutUint32(header + 12, StoreHeaderSize);
+    PutUint32(header + 16, StoreRecordHeaderSize);
+
+    return m_file.Flush();
+}
+
+void wxExplorerBrowserThumbnailStore::Load()
+{
+    const wxUint8* data = m_file.GetData();
+    const size_t size = m_file.GetSize();
+    size_t pos = StoreHeaderSize;
+
+    while ( size - pos >= StoreRecordHeaderSize )
+    {
+        const wxUint8* record = data + pos;
+
+        if ( GetUint32(record) != StoreRecordMagic
+             || GetUint64(record + StoreRecordChecksumOffset)
+                != wxExplorerBrowserHashBytes(record, StoreRecordChecksumOffset) )
+            break;
+
+        const wxUint64 payloadSize = GetUint32(record + 4);
+        const wxUint64 recordSize = GetUint64(record + 8);
+        const wxUint32 width = GetUint32(record + 36);
+        const wxUint32 height = GetUint32(record + 40);
+
+        if ( width > StoreMaxDimension || height > StoreMaxDimension
+             || payloadSize != static_cast<wxUint64>(width) * height * 4
+             || recordSize != GetStoreRecordSize(static_cast<size_t>(payloadSize))
+             || recordSize > size - pos )
+            break;
+
+        Key key;
+        IndexEntry entry;
+
+        key.itemKey = GetUint64(record + 16);
+        key.itemCheck = GetUint64(record + 48);
+        key.modificationTime = GetUint64(record + 24);
+        key.size = GetUint32(record + 32);
+        entry.offset = pos;
+        entry.size = static_cast<size_t>(recordSize);
+        m_index[key] = entry;
+
+        m_lastAccess = std::max(m_lastAccess, GetUint64(record + StoreRecordAccessOffset));
+        pos += entry.size;
+    }
+
+    m_end = pos;
+
+    // after a crash, the garbage after the last valid record could be
+    // partially overwritten by the new records and then taken for valid ones
+    if ( std::any_of(data + pos, data + std::min(size, pos + StoreRecordHeaderSize),
+                     [](wxUint8 b) { return b != 0; }) )
+        memset(m_file.GetWritableData() + pos, 0, size - pos);
+}
+
+bool wxExplorerBrowserThumbnailStore::CompactLocked(size_t size)
+{
+    if ( !m_file.IsOpened() )
+        return false;
+
+    struct Candidate
+    {
+        wxUint64 lastAccess;
+        const IndexEntry* entry;
+    };
+
+    const wxUint8* data = m_file.GetData();
+    std::vector<Candidate> candidates;
+
+    candidates.reserve(m_index.size());
+    for ( const auto& it : m_index )
+    {
+        Candidate candidate;
+
+        candidate.lastAccess = GetUint64(data + it.second.offset + StoreRecordAccessOffset);
+        candidate.entry = &it.second;
+        candidates.push_back(candidate);
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate& a, const Candidate& b) { return a.lastAccess > b.lastAccess; });
+
+    wxTempFile file;
+
+    if ( !file.Open(m_fileName) || !file.Write(data, StoreHeaderSize) )
+        return false;
+
+    size_t written = StoreHeaderSize;
+
+    for ( const auto& candidate : candidates )
+    {
+        if ( written + candidate.entry->size > size )
+            break;
+
+        if ( !IsPayloadValid(*candidate.entry) )
+            continue;
+
+        if ( !file.Write(data + candidate.entry->offset, candidate.entry->size) )
+        {
+            file.Discard();
+            return false;
+        }
+
+        written += candidate.entry->size;
+    }
+
+    // the file cannot be replaced while it is mapped on MSW
+    m_file.Close();
+
+    const bool committed = file.Commit();
+
+    // reopen either the compacted or the original file
+    return OpenLocked() && committed;
+}
+
+bool wxExplorerBrowserThumbnailStore::Reserve(size_t size)
+{
+    if ( size <= m_file.GetSize() )
+        return true;
+
+    // grow in large steps, as each growth maps the file again
+    const size_t growth = std::max(StoreMinGrowth, m_file.GetSize() / 2);
+
+    return m_file.Resize(std::max(size, std::min(m_maxSize, m_file.GetSize() + growth)));
+}
+
+bool wxExplorerBrowserThumbnailStore::IsPayloadValid(const IndexEntry& entry) const
+{
+    const wxUint8* record = m_file.GetData() + entry.offset;
+
+    return GetUint64(record + StoreRecordPayloadChecksumOffset)
+           == wxExplorerBrowserHashBytes(record + StoreRecordHeaderSize, GetUint32(record + 4));
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserItemProperties
+    ---------------------------------
+
+*****************************************************************************/
+
+namespace {
+
+// assign() keeps the capacity, so that fetching again does not allocate
+template <typename T>
+void ResetPropertyColumn(std::vector<T>& column, size_t count, bool used)
+{
+    if ( used )
+        column.assign(count, T());
+    else
+        column.clear();
+}
+
+} // unnamed namespace
+
+void wxExplorerBrowserItemProperties::Reset(size_t count, wxUint32 properties)
+{
+    m_properties = properties;
+    m_fetched.assign(count, 0);
+
+    ResetPropertyColumn(m_sizes, count, (properties & Property_Size) != 0);
+    ResetPropertyColumn(m_modificationTimes, count, (properties & Property_ModificationTime) != 0);
+    ResetPropertyColumn(m_creationTimes, count, (properties & Property_CreationTime) != 0);
+    ResetPropertyColumn(m_attributes, count, (properties & Property_Attributes) != 0);
+    ResetPropertyColumn(m_typeNames, count, (properties & Property_TypeName) != 0);
+}
+
+size_t wxExplorerBrowserItemProperties::GetMemoryUsage() const
+{
+    size_t usage = m_fetched.capacity() + (m_sizes.capacity() + m_modificationTimes.capacity()
+                                           + m_creationTimes.capacity()) * sizeof(wxUint64)
+                   + m_attributes.capacity() * sizeof(wxUint32);
+
+    usage += m_typeNames.capacity() * sizeof(wxString);
+    for ( const auto& typeName : m_typeNames )
+        usage += GetStringHeapUsage(typeName);
+
+    return usage;
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserViewportScheduler
+    ---------------------------------
+
+*****************************************************************************/
+
+void wxExplorerBrowserViewportScheduler::SetDistances(size_t nearbyDistance, size_t cancelDistance)
+{
+    m_nearbyDistance = nearbyDistance;
+    m_cancelDistance = cancelDistance;
+}
+
+size_t wxExplorerBrowserViewportScheduler::SetViewport(size_t first, size_t count, std::vector<size_t>* cancelled)
+{
+    m_first = first;
+    m_count = count;
+
+    if ( m_cancelDistance == 0 || m_pending.empty() )
+        return 0;
+
+    size_t dropped = 0;
+
+    // the items before the kept range
+    if ( m_first > m_cancelDistance )
+    {
+        const auto end = m_pending.lower_bound(m_first - m_cancelDistance);
+
+        if ( cancelled )
+            cancelled->insert(cancelled->end(), m_pending.begin(), end);
+        dropped += std::distance(m_pending.begin(), end);
+        m_pending.erase(m_pending.begin(), end);
+    }
+
+    // and after it, the visible range is never empty for this purpose
+    const size_t last = m_first + std::max<size_t>(m_count, 1) - 1;
+
+    if ( last < std::numeric_limits<size_t>::max() - m_cancelDistance )
+    {
+        const auto begin = m_pending.upper_bound(last + m_cancelDistance);
+
+        if ( cancelled )
+            cancelled->insert(cancelled->end(), begin, m_pending.end());
+        dropped += std::distance(begin, m_pending.end());
+        m_pending.erase(begin, m_pending.end());
+    }
+
+    return dropped;
+}
+
+bool wxExplorerBrowserViewportScheduler::Add(size_t index)
+{
+    return m_pending.insert(index).second;
+}
+
+void wxExplorerBrowserViewportScheduler::AddRange(size_t first, size_t count)
+{
+    // the hint makes inserting the ascending indices constant time
+    for ( size_t i = 0; i < count; ++i )
+        m_pending.insert(m_pending.end(), first + i);
+}
+
+bool wxExplorerBrowserViewportScheduler::Remove(size_t index)
+{
+    return m_pending.erase(index) != 0;
+}
+
+bool wxExplorerBrowserViewportScheduler::Next(size_t& index)
+{
+    if ( m_pending.empty() )
+        return false;
+
+    // the first item at or after the start of the visible range,
+    // which is the next visible one if it is in the range
+    auto it = m_pending.lower_bound(m_first);
+
+    if ( it != m_pending.begin() )
+    {
+        const auto before = std::prev(it);
+
+        if ( it == m_pending.end() || GetDistance(*before) < GetDistance(*it) )
+            it = before;
+    }
+
+    index = *it;
+    m_pending.erase(it);
+
+    return true;
+}
+
+size_t wxExplorerBrowserViewportScheduler::TakeAll(std::vector<size_t>& indices)
+{
+    size_t visible = 0;
+    size_t index;
+
+    indices.reserve(indices.size() + m_pending.size());
+    while ( Next(index) )
+    {
+        if ( GetDistance(index) == 0 )
+            ++visible;
+        indices.push_back(index);
+    }
+
+    return visible;
+}
+
+size_t wxExplorerBrowserViewportScheduler::GetDistance(size_t index) const
+{
+    if ( index < m_first )
+        return m_first - index;
+
+    if ( index - m_first < m_count )
+        return 0;
+
+    return index - m_first - std::max<size_t>(m_count, 1) + 1;
+}
+
+wxExplorerBrowserViewportScheduler::Priority wxExplorerBrowserViewportScheduler::GetPriority(size_t index) const
+{
+    const size_t distance = GetDistance(index);
+
+    if ( distance == 0 )
+        return Priority_Visible;
+
+    if ( distance <= (m_nearbyDistance != 0 ? m_nearbyDistance : m_count) )
+        return Priority_Nearby;
+
+    return Priority_Far;
+}
+
+size_t wxExplorerBrowserViewportScheduler::GetMemoryUsage() const
+{
+    // a tree node: three links, the color and the value
+    return m_pending.size() * (4 * sizeof(void*) + sizeof(size_t));
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserDirectoryWalker
+    ---------------------------------
+
+*****************************************************************************/
+
+namespace {
+
+#ifdef __WINDOWS__
+// not declared when targeting Windows Vista
+#ifndef FIND_FIRST_EX_LARGE_FETCH
+    #define FIND_FIRST_EX_LARGE_FETCH 2
+#endif
+#endif
+
+#ifdef __LINUX__
+// a record returned by getdents64(), which glibc does not declare
+struct LinuxDirent64
+{
+    wxUint64       d_ino;
+    wxInt64        d_off;
+    unsigned short d_reclen;
+    unsigned char  d_type;
+    char           d_name[1];
+};
+
+// large enough for the entries of most directories to be read at once
+const size_t DirectoryBufferSize = 64 * 1024;
+#endif
+
+template <typename T>
+bool IsDotOrDotDot(const T* name)
+{
+    return name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0));
+}
+
+#ifndef __WINDOWS__
+wxUint64 GetModificationFileTime(const struct stat& st)
+{
+    // the seconds between January 1, 1601 and January 1, 1970
+    const wxUint64 secondsTo1970 = 11644473600ULL;
+
+#ifdef __LINUX__
+    return (static_cast<wxUint64>(st.st_mtim.tv_sec) + secondsTo1970) * 10000000
+           + static_cast<wxUint64>(st.st_mtim.tv_nsec) / 100;
+#else
+    return (static_cast<wxUint64>(st.st_mtime) + secondsTo1970) * 10000000;
+#endif
+}
+#endif
+
+} // unnamed namespace
+
+wxString wxExplorerBrowserDirectoryWalker::Entry::GetName() const
+{
+#ifdef __WINDOWS__
+    return wxString(name, nameLength);
+#else
+    return wxString(name, *wxConvFileName, nameLength);
+#endif
+}
+
+wxString wxExplorerBrowserDirectoryWalker::Entry::GetPath() const
+{
+    NativeString path(*directory);
+
+    path.append(name, nameLength);
+#ifdef __WINDOWS__
+    return wxString(path.c_str(), path.length());
+#else
+    return wxString(path.c_str(), *wxConvFileName, path.length());
+#endif
+}
+
+wxExplorerBrowserDirectoryWalker::wxExplorerBrowserDirectoryWalker(unsigned threadCount)
+    : m_threadCount{threadCount}
+{
+    if ( m_threadCount == 0 )
+        m_threadCount = std::max(2u, 2 * std::thread::hardware_concurrency());
+}
+
+bool wxExplorerBrowserDirectoryWalker::Walk(const wxArrayString& roots, const Visitor& visitor, const CancelFlag* cancel)
+{
+    m_directoryCount = 0;
+    m_errorCount = 0;
+    m_visitor = &visitor;
+    m_cancel = cancel;
+
+    m_workers.clear();
+    for ( unsigned i = 0; i < m_threadCount; ++i )
+        m_workers.push_back(std::unique_ptr<Worker>(new Worker));
+
+    m_unfinishedTasks = roots.size();
+    m_queuedTasks = roots.size();
+    m_idleWorkers = 0;
+
+    // the roots are spread over the workers, the others steal the subdirectories
+    for ( size_t i = 0; i < roots.size(); ++i )
+    {
+        Task task;
+
+        task.path = ToNative(roots[i]);
+        m_workers[i % m_threadCount]->tasks.push_back(std::move(task));
+    }
+
+    std::vector<std::thread> threads;
+
+    for ( unsigned i = 1; i < m_threadCount; ++i )
+        threads.push_back(std::thread(&wxExplorerBrowserDirectoryWalker::RunWorker, this, i));
+
+    RunWorker(0);
+
+    for ( auto& thread : threads )
+        thread.join();
+
+    const bool cancelled = IsCancelled();
+
+    m_workers.clear();
+    m_visitor = nullptr;
+    m_cancel = nullptr;
+
+    return !cancelled;
+}
+
+wxExplorerBrowserDirectoryWalker::NativeString wxExplorerBrowserDirectoryWalker::ToNative(const wxString& path)
+{
+#ifdef __WINDOWS__
+    NativeString native(path.wc_str(), path.length());
+
+    if ( native.empty() || (native.back() != L'\\' && native.back() != L'/') )
+        native += L'\\';
+#else
+    const auto buffer = path.fn_str();
+    NativeString native(buffer.data(), buffer.length());
+
+    if ( native.empty() || native.back() != '/' )
+        native += '/';
+#endif
+
+    return native;
+}
+
+void wxExplorerBrowserDirectoryWalker::RunWorker(unsigned threadIndex)
+{
+    std::vector<char> buffer;
+    std::vector<Task> subdirectories;
+    Task task;
+
+    while ( !IsCancelled() )
+    {
+        if ( TakeTask(threadIndex, task) )
+        {
+            subdirectories.clear();
+            if ( Enumerate(threadIndex, task, buffer, subdirectories) )
+                ++m_directoryCount;
+            else
+                ++m_errorCount;
+
+            // queued before this task is finished, so that the count does not drop to 0 meanwhile
+            QueueTasks(threadIndex, subdirectories);
+
+            if ( --m_unfinishedTasks == 0 )
+            {
+                std::lock_guard<std::mutex> lock(m_idleLock);
+                m_idleCondition.notify_all();
+            }
+            continue;
+        }
+
+        if ( m_unfinishedTasks == 0 )
+            break;
+
+        // another worker is enumerating a directory and may queue its subdirectories,
+        // the timeout is for noticing the cancellation
+        std::unique_lock<std::mutex> lock(m_idleLock);
+
+        ++m_idleWorkers;
+        m_idleCondition.wait_for(lock, std::chrono::milliseconds(10),
+                                 [this] { return m_queuedTasks != 0 || m_unfinishedTasks == 0; });
+        --m_idleWorkers;
+    }
+}
+
+bool wxExplorerBrowserDirectoryWalker::TakeTask(unsigned threadIndex, Task& task)
+{
+    if ( m_queuedTasks == 0 )
+        return false;
+
+    // the most recently queued own task, going deep first keeps the queues short
+    {
+        Worker& worker = *m_workers[threadIndex];
+        std::lock_guard<std::mutex> lock(worker.lock);
+
+        if ( !worker.tasks.empty() )
+        {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            --m_queuedTasks;
+            return true;
+        }
+    }
+
+    // the oldest task of another worker, the closest to its root and so likely the largest
+    for ( unsigned i = 1; i < m_threadCount; ++i )
+    {
+        Worker& victim = *m_workers[(threadIndex + i) % m_threadCount];
+        std::lock_guard<std::mutex> lock(victim.lock);
+
+        if ( !victim.tasks.empty() )
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --m_queuedTasks;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void wxExplorerBrowserDirectoryWalker::QueueTasks(unsigned threadIndex, std::vector<Task>& tasks)
+{
+    if ( tasks.empty() )
+        return;
+
+    m_unfinishedTasks += tasks.size();
+    m_queuedTasks += tasks.size();
+
+    {
+        Worker& worker = *m_workers[threadIndex];
+        std::lock_guard<std::mutex> lock(worker.lock);
+
+        for ( auto& task : tasks )
+            worker.tasks.push_back(std::move(task));
+    }
+
+    if ( m_idleWorkers != 0 )
+    {
+        std::lock_guard<std::mutex> lock(m_idleLock);
+        m_idleCondition.notify_all();
+    }
+}
+
+bool wxExplorerBrowserDirectoryWalker::Enumerate(unsigned threadIndex, const Task& task,
+                                                 std::vector<char>& buffer, std::vector<Task>& subdirectories)
+{
+    Entry entry;
+
+    entry.directory = &task.path;
+    entry.depth = task.depth + 1;
+
+    const bool walkSubdirectories = m_maxDepth == 0 || entry.depth < m_maxDepth;
+
+    auto visit = [&]()
+    {
+        if ( !(*m_visitor)(threadIndex, entry) || !entry.isDirectory || entry.isLink || !walkSubdirectories )
+            return;
+
+        Task subdirectory;
+
+        subdirectory.path.reserve(task.path.length() + entry.nameLength + 1);
+        subdirectory.path = task.path;
+        subdirectory.path.append(entry.name, entry.nameLength);
+#ifdef __WINDOWS__
+        subdirectory.path += L'\\';
+#else
+        subdirectory.path += '/';
+#endif
+        subdirectory.depth = entry.depth;
+        subdirectories.push_back(std::move(subdirectory));
+    };
+
+#ifdef __WINDOWS__
+    wxUnusedVar(buffer);
+
+    WIN32_FIND_DATAW data;
+    const NativeString pattern = task.path + L'*';
+    HANDLE find = ::FindFirstFileExW(pattern.c_str(), FindExInfoBasic, &data,
+                                     FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+
+    // Windows Vista supports neither the basic information nor the large fetch
+    if ( find == INVALID_HANDLE_VALUE && ::GetLastError() == ERROR_INVALID_PARAMETER )
+        find = ::FindFirstFileExW(pattern.c_str(), FindExInfoStandard, &data, FindExSearchNameMatch, nullptr, 0);
+
+    if ( find == INVALID_HANDLE_VALUE )
+        return false;
+
+    do
+    {
+        if ( IsDotOrDotDot(data.cFileName) )
+            continue;
+
+        entry.name = data.cFileName;
+        entry.nameLength = wcslen(data.cFileName);
+        entry.isDirectory = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        // other reparse points, e.g., the cloud files, are walked
+        entry.isLink = (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0
+                       && (data.dwReserved0 == IO_REPARSE_TAG_SYMLINK || data.dwReserved0 == IO_REPARSE_TAG_MOUNT_POINT);
+        entry.size = entry.isDirectory ? 0 : (static_cast<wxUint64>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+        entry.modificationTime = (static_cast<wxUint64>(data.ftLastWriteTime.dwHighDateTime) << 32)
+                                 | data.ftLastWriteTime.dwLowDateTime;
+        visit();
+    } while ( !IsCancelled() && ::FindNextFileW(find, &data) );
+
+    const bool ok = IsCancelled() || ::GetLastError() == ERROR_NO_MORE_FILES;
+
+    ::FindClose(find);
+    return ok;
+#else // !__WINDOWS__
+    auto process = [&](int fd, const char* name, unsigned char type)
+    {
+        if ( IsDotOrDotDot(name) )
+            return;
+
+        entry.name = name;
+        entry.nameLength = strlen(name);
+        entry.isDirectory = type == DT_DIR;
+        entry.isLink = type == DT_LNK;
+        entry.size = entry.modificationTime = 0;
+
+        if ( m_fileInfoNeeded || type == DT_UNKNOWN )
+        {
+            struct stat st;
+
+            if ( ::fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) == 0 )
+            {
+                entry.isDirectory = S_ISDIR(st.st_mode);
+                entry.isLink = S_ISLNK(st.st_mode);
+                if ( S_ISREG(st.st_mode) )
+                    entry.size = static_cast<wxUint64>(st.st_size);
+                entry.modificationTime = GetModificationFileTime(st);
+            }
+            else if ( type == DT_UNKNOWN )
+            {
+                return; // removed meanwhile
+            }
+        }
+
+        visit();
+    };
+
+    bool ok = true;
+
+#ifdef __LINUX__
+    const int fd = ::open(task.path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    if ( fd == -1 )
+        return false;
+
+    buffer.resize(DirectoryBufferSize);
+
+    while ( !IsCancelled() )
+    {
+        const long read = ::syscall(SYS_getdents64, fd, buffer.data(), buffer.size());
+
+        if ( read <= 0 )
+        {
+            ok = read == 0;
+            break;
+        }
+
+        for ( long offset = 0; offset < read && !IsCancelled(); )
+        {
+            const LinuxDirent64* dirent = reinterpret_cast<const LinuxDirent64*>(buffer.data() + offset);
+
+            offset += dirent->d_reclen;
+            process(fd, dirent->d_name, dirent->d_type);
+        }
+    }
+
+    ::close(fd);
+#else // !__LINUX__
+    wxUnusedVar(buffer);
+
+    DIR* dir = ::opendir(task.path.c_str());
+
+    if ( !dir )
+        return false;
+
+    while ( !IsCancelled() )
+    {
+        errno = 0;
+
+        const dirent* d = ::readdir(dir);
+
+        if ( !d )
+        {
+            ok = errno == 0;
+            break;
+        }
+
+        process(::dirfd(dir), d->d_name, d->d_type);
+    }
+
+    ::closedir(dir);
+#endif // __LINUX__/!__LINUX__
+
+    return ok;
+#endif // __WINDOWS__/!__WINDOWS__
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserFolderSizer
+    ---------------------------------
+
+*****************************************************************************/
+
+namespace {
+
+// for the counters written by a single thread, cheaper than fetch_add()
+void AddRelaxed(std::atomic<wxUint64>& counter, wxUint64 value)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+} // unnamed namespace
+
+bool wxExplorerBrowserFolderSizer::Start(const wxArrayString& folders)
+{
+    if ( m_running )
+        return false;
+
+    Wait();
+
+    m_cancel = false;
+    m_counters.clear();
+    for ( unsigned i = 0; i < m_walker.GetThreadCount(); ++i )
+        m_counters.push_back(std::unique_ptr<Counters>(new Counters));
+
+    // wxString copies may share the buffer, which is not thread-safe
+    m_folders.clear();
+    for ( const auto& folder : folders )
+        m_folders.push_back(folder.wx_str());
+
+    m_walker.SetFileInfoNeeded(true);
+    m_running = true;
+
+    m_thread = std::thread([this]()
+    {
+        m_walker.Walk(m_folders,
+                      [this](unsigned threadIndex, const wxExplorerBrowserDirectoryWalker::Entry& entry)
+                      {
+                          if ( entry.isLink )
+                              return false;
+
+                          Counters& counters = *m_counters[threadIndex];
+
+                          if ( entry.isDirectory )
+                          {
+                              AddRelaxed(counters.folderCount, 1);
+                              return true;
+                          }
+
+                          AddRelaxed(counters.fileCount, 1);
+                          AddRelaxed(counters.size, entry.size);
+                          return false;
+                      },
+                      &m_cancel);
+        m_running = false;
+    });
+
+    return true;
+}
+
+void wxExplorerBrowserFolderSizer::Wait()
+{
+    if ( m_thread.joinable() )
+        m_thread.join();
+}
+
+wxExplorerBrowserFolderSizer::Totals wxExplorerBrowserFolderSizer::GetTotals() const
+{
+    Totals totals;
+
+    for ( const auto& counters : m_counters )
+    {
+        totals.size += counters->size.load(std::memory_order_relaxed);
+        totals.fileCount += counters->fileCount.load(std::memory_order_relaxed);
+        totals.folderCount += counters->folderCount.load(std::memory_order_relaxed);
+    }
+    totals.errorCount = m_walker.GetErrorCount();
+
+    return totals;
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserRecursiveEnumerator
+    ---------------------------------
+
+*****************************************************************************/
+
+bool wxExplorerBrowserRecursiveEnumerator::Start(const wxString& root, wxUint32 itemTypes,
+                                                 const wxExplorerBrowserMaskMatcher& filter,
+                                                 unsigned maxDepth, size_t batchSize, unsigned maxBatchDelay)
+{
+    wxCHECK(batchSize > 0, false);
+
+    if ( m_running )
+        return false;
+
+    Wait();
+
+    // wxString copies may share the buffer, which is not thread-safe
+    wxArrayString masks;
+
+    for ( const auto& mask : filter.GetMasks() )
+        masks.push_back(mask.wx_str());
+
+    m_root = root.wx_str();
+    m_itemTypes = itemTypes;
+    m_filter.Set(masks, filter.GetItemTypes());
+    m_batchSize = batchSize;
+    m_maxBatchDelay = std::chrono::milliseconds(maxBatchDelay);
+
+    m_workerStates.clear();
+    for ( unsigned i = 0; i < m_walker.GetThreadCount(); ++i )
+        m_workerStates.push_back(std::unique_ptr<WorkerState>(new WorkerState));
+
+    m_items.clear();
+    m_foundCount = 0;
+    m_cancel = false;
+    m_running = true;
+
+    m_walker.SetMaxDepth(maxDepth);
+    m_walker.SetFileInfoNeeded(false);
+
+    m_thread = std::thread([this]()
+    {
+        wxArrayString roots;
+
+        roots.push_back(m_root);
+        m_walker.Walk(roots,
+                      [this](unsigned threadIndex, const wxExplorerBrowserDirectoryWalker::Entry& entry)
+                      { return Visit(threadIndex, entry); },
+                      &m_cancel);
+
+        // the last, incomplete batches
+        for ( auto& state : m_workerStates )
+        {
+            std::lock_guard<std::mutex> lock(state->lock);
+
+            FlushBatch(*state);
+        }
+
+        m_running = false;
+    });
+
+    return true;
+}
+
+void wxExplorerBrowserRecursiveEnumerator::Wait()
+{
+    if ( m_thread.joinable() )
+        m_thread.join();
+}
+
+bool wxExplorerBrowserRecursiveEnumerator::TakeItems(wxExplorerBrowserItem::List& items)
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    // the states are locked before the items, as by the workers
+    for ( auto& state : m_workerStates )
+    {
+        std::lock_guard<std::mutex> lock(state->lock);
+
+        if ( !state->batch.empty() && now - state->batchStart >= m_maxBatchDelay )
+            FlushBatch(*state);
+    }
+
+    std::lock_guard<std::mutex> lock(m_itemsLock);
+
+    if ( m_items.empty() )
+        return false;
+
+    if ( items.empty() )
+    {
+        items.swap(m_items);
+    }
+    else
+    {
+        std::move(m_items.begin(), m_items.end(), std::back_inserter(items));
+        m_items.clear();
+    }
+
+    return true;
+}
+
+bool wxExplorerBrowserRecursiveEnumerator::Visit(unsigned threadIndex, const wxExplorerBrowserDirectoryWalker::Entry& entry)
+{
+    const wxExplorerBrowserItem::Type type = entry.isDirectory ? wxExplorerBrowserItem::Directory
+                                                               : wxExplorerBrowserItem::File;
+
+    if ( !(type & m_itemTypes) )
+        return true;
+
+    WorkerState& state = *m_workerStates[threadIndex];
+    const wxString name = entry.GetName();
+
+    if ( m_filter.AppliesTo(type) && !m_filter.IsEmpty() && !m_filter.MatchesFileName(name, state.matchName) )
+        return true;
+
+    wxExplorerBrowserItem item(type);
+
+    item.SetPath(entry.GetPath());
+    item.SetDisplayName(name);
+    // SFGAO_FILESYSTEM and SFGAO_FOLDER or SFGAO_STREAM
+    item.SetSFGAO(0x40000000 | (entry.isDirectory ? 0x20000000 : 0x00400000));
+
+    std::lock_guard<std::mutex> lock(state.lock);
+
+    if ( state.batch.empty() )
+        state.batchStart = std::chrono::steady_clock::now();
+    state.batch.push_back(std::move(item));
+    ++m_foundCount;
+
+    if ( state.batch.size() >= m_batchSize )
+        FlushBatch(state);
+
+    return true;
+}
+
+void wxExplorerBrowserRecursiveEnumerator::FlushBatch(WorkerState& state)
+{
+    if ( state.batch.empty() )
+        return;
+
+    std::lock_guard<std::mutex> lock(m_itemsLock);
+
+    std::move(state.batch.begin(), state.batch.end(), std::back_inserter(m_items));
+    state.batch.clear();
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserIgnoreRules
+    ---------------------------------
+
+*****************************************************************************/
+
+namespace {
+
+bool IsPathSeparator(wxChar c)
+{
+    return c == wxS('\\') || c == wxS('/');
+}
+
+} // unnamed namespace
+
+bool wxExplorerBrowserIgnoreRules::Token::Matches(wxChar c) const
+{
+    switch ( kind )
+    {
+        case Kind_Char:
+            return c == ch;
+        case Kind_AnyChar:
+            return true;
+        case Kind_Class:
+        {
+            bool inRanges = false;
+
+            for ( const auto& range : ranges )
+            {
+                if ( c >= range.first && c <= range.second )
+                {
+                    inRanges = true;
+                    break;
+                }
+            }
+
+            return inRanges != negated;
+        }
+        case Kind_Star:
+            break;
+    }
+
+    return false;
+}
+
+bool wxExplorerBrowserIgnoreRules::DirectoryRules::IsIgnored(const wxString& name, bool isDirectory,
+                                                             Buffer& buffer) const
+{
+    if ( m_excluded )
+        return true;
+
+    if ( m_rules.empty() )
+        return false;
+
+    buffer.name = name;
+    buffer.name.MakeUpper();
+
+    int rule = -1;
+
+    if ( !m_literals.empty() )
+    {
+        const auto it = m_literals.find(buffer.name);
+
+        if ( it != m_literals.end() )
+        {
+            rule = it->second.any;
+            if ( isDirectory )
+                rule = std::max(rule, it->second.dirOnly);
+        }
+    }
+
+    if ( m_wordCount != 0 )
+        rule = std::max(rule, FindMatchingRule(buffer.name, isDirectory, buffer.states));
+
+    return rule >= 0 && !m_rules[rule].negated;
+}
+
+size_t wxExplorerBrowserIgnoreRules::DirectoryRules::GetMemoryUsage() const
+{
+    size_t usage = sizeof(*this) + m_rules.capacity() * sizeof(RuleRef);
+
+    for ( const auto& literal : m_literals )
+        usage += sizeof(literal) + 2 * sizeof(void*) + GetStringHeapUsage(literal.first);
+
+    usage += (m_startStates.capacity() + m_starStates.capacity() + m_acceptStates.capacity()
+              + m_anyCharStates.capacity() + m_asciiStates.capacity()) * sizeof(wxUint64);
+    usage += m_otherStates.size() * (sizeof(wxChar) + 3 * sizeof(void*) + m_wordCount * sizeof(wxUint64));
+    usage += m_classStates.capacity() * sizeof(m_classStates[0]);
+    usage += m_stateRules.capacity() * sizeof(int);
+
+    return usage;
+}
+
+void wxExplorerBrowserIgnoreRules::DirectoryRules::AddPattern(const Glob& glob, int rule, size_t& state)
+{
+    const size_t wordCount = m_wordCount;
+
+    m_startStates[state / 64] |= wxUint64(1) << (state % 64);
+    ++state;
+
+    for ( const auto& token : glob )
+    {
+        const size_t word = state / 64;
+        const wxUint64 bit = wxUint64(1) << (state % 64);
+
+        switch ( token.kind )
+        {
+            case Token::Kind_Star:
+                m_starStates[word] |= bit;
+                break;
+
+            case Token::Kind_Char:
+                if ( token.ch < 128 )
+                {
+                    m_asciiStates[token.ch * wordCount + word] |= bit;
+                }
+                else
+                {
+                    std::vector<wxUint64>& states = m_otherStates[token.ch];
+
+                    states.resize(wordCount);
+                    states[word] |= bit;
+                }
+                break;
+
+            case Token::Kind_AnyChar:
+            case Token::Kind_Class:
+                for ( wxChar c = 0; c < 128; ++c )
+                {
+                    if ( token.Matches(c) )
+                        m_asciiStates[c * wordCount + word] |= bit;
+                }
+
+                if ( token.kind == Token::Kind_AnyChar )
+                    m_anyCharStates[word] |= bit;
+                else
+                    m_classStates.push_back(std::make_pair(state, token));
+                break;
+        }
+
+        ++state;
+    }
+
+    m_acceptStates[(state - 1) / 64] |= wxUint64(1) << ((state - 1) % 64);
+    m_stateRules[state - 1] = rule;
+}
+
+void wxExplorerBrowserIgnoreRules::DirectoryRules::GetCharStates(wxChar c, wxUint64* states) const
+{
+    std::copy(m_anyCharStates.begin(), m_anyCharStates.end(), states);
+
+    const auto it = m_otherStates.find(c);
+
+    if ( it != m_otherStates.end() )
+    {
+        for ( size_t i = 0; i < m_wordCount; ++i )
+            states[i] |= it->second[i];
+    }
+
+    for ( const auto& classState : m_classStates )
+    {
+        if ( classState.second.Matches(c) )
+            states[classState.first / 64] |= wxUint64(1) << (classState.first % 64);
+    }
+}
+
+// a "*" matches also nothing, so its state is entered together with the preceding one;
+// the stars are never consecutive, a single pass is enough
+void wxExplorerBrowserIgnoreRules::DirectoryRules::AddStarClosure(wxUint64* states) const
+{
+    wxUint64 carry = 0;
+
+    for ( size_t i = 0; i < m_wordCount; ++i )
+    {
+        const wxUint64 word = states[i];
+
+        states[i] |= ((word << 1) | carry) & m_starStates[i];
+        carry = word >> 63;
+    }
+}
+
+// returns the index of the last rule whose pattern matches the name, or -1
+int wxExplorerBrowserIgnoreRules::DirectoryRules::FindMatchingRule(const wxString& name, bool isDirectory,
+                                                                   std::vector<wxUint64>& buffer) const
+{
+    // the current, next and character states, the buffer grows only for the first names
+    if ( buffer.size() < 3 * m_wordCount )
+        buffer.resize(3 * m_wordCount);
+
+    wxUint64* states = buffer.data();
+    wxUint64* next = states + m_wordCount;
+    wxUint64* charStates = next + m_wordCount;
+
+    std::copy(m_startStates.begin(), m_startStates.end(), states);
+    AddStarClosure(states);
+
+    const wxStringCharType* s = name.wx_str();
+    const size_t length = name.length();
+
+    for ( size_t i = 0; i < length; ++i )
+    {
+        const wxChar c = s[i];
+        const wxUint64* entered;
+
+        if ( c >= 0 && c < 128 )
+        {
+            entered = &m_asciiStates[c * m_wordCount];
+        }
+        else
+        {
+            GetCharStates(c, charStates);
+            entered = charStates;
+        }
+
+        // the token states advance on the characters they accept, the star states stay
+        wxUint64 carry = 0;
+        wxUint64 any = 0;
+
+        for ( size_t w = 0; w < m_wordCount; ++w )
+        {
+            const wxUint64 shifted = (states[w] << 1) | carry;
+
+            carry = states[w] >> 63;
+            next[w] = (shifted & entered[w]) | (states[w] & m_starStates[w]);
+            any |= next[w];
+        }
+
+        if ( !any )
+            return -1;
+
+        AddStarClosure(next);
+        std::swap(states, next);
+    }
+
+    // the patterns are in the order of their rules, so the last accepting state wins
+    for ( size_t w = m_wordCount; w-- > 0; )
+    {
+        const wxUint64 accepted = states[w] & m_acceptStates[w];
+
+        for ( int bit = 63; accepted && bit >= 0; --bit )
+        {
+            if ( !(accepted & (wxUint64(1) << bit)) )
+                continue;
+
+            const int rule = m_stateRules[w * 64 + bit];
+
+            if ( isDirectory || !m_rules[rule].dirOnly )
+                return rule;
+        }
+    }
+
+    return -1;
+}
+
+void wxExplorerBrowserIgnoreRules::Set(const wxString& root, const wxString& fileName, const wxString& globalRules)
+{
+    Clear();
+
+    m_root = root;
+    while ( m_root.length() > 1 && IsPathSeparator(m_root[m_root.length() - 1]) )
+        m_root = m_root.substr(0, m_root.length() - 1);
+
+    m_fileName = fileName;
+    ParseRules(globalRules, m_globalRules);
+}
+
+void wxExplorerBrowserIgnoreRules::Clear()
+{
+    m_root.clear();
+    m_fileName.clear();
+    m_globalRules.clear();
+    m_nodes.clear();
+    m_lastDirectory.clear();
+    m_lastRules.reset();
+}
+
+wxExplorerBrowserIgnoreRules::DirectoryRulesPtr wxExplorerBrowserIgnoreRules::GetDirectoryRules(const wxString& directory)
+{
+    std::vector<wxString> segments;
+
+    if ( !GetRelativeSegments(directory, segments) )
+        return DirectoryRulesPtr();
+
+    if ( m_nodes.size() > MaxCachedDirectories )
+        m_nodes.clear();
+
+    return GetDirectoryRules(segments, segments.size());
+}
+
+bool wxExplorerBrowserIgnoreRules::IsIgnored(const wxString& path, bool isDirectory)
+{
+    const size_t pos = path.find_last_of(wxS("\\/"));
+
+    if ( pos == wxString::npos )
+        return false;
+
+    // the items of a directory are usually asked about one after another
+    const size_t directoryLength = pos != 0 ? pos : 1;
+
+    if ( m_lastDirectory.length() != directoryLength || path.compare(0, directoryLength, m_lastDirectory) != 0 )
+    {
+        m_lastDirectory.assign(path, 0, directoryLength);
+        m_lastRules = GetDirectoryRules(m_lastDirectory);
+    }
+
+    if ( !m_lastRules )
+        return false;
+
+    m_nameBuffer.assign(path, pos + 1, wxString::npos);
+    return m_lastRules->IsIgnored(m_nameBuffer, isDirectory, m_matchBuffer);
+}
+
+size_t wxExplorerBrowserIgnoreRules::GetMemoryUsage() const
+{
+    auto getRulesMemoryUsage = [](const std::vector<Rule>& rules)
+    {
+        size_t usage = rules.capacity() * sizeof(Rule);
+
+        for ( const auto& rule : rules )
+        {
+            usage += rule.segments.capacity() * sizeof(Segment);
+            for ( const auto& segment : rule.segments )
+            {
+                usage += segment.glob.capacity() * sizeof(Token);
+                for ( const auto& token : segment.glob )
+                    usage += token.ranges.capacity() * sizeof(token.ranges[0]);
+            }
+        }
+
+        return usage;
+    };
+
+    size_t usage = GetStringHeapUsage(m_root) + GetStringHeapUsage(m_fileName)
+                   + getRulesMemoryUsage(m_globalRules);
+
+    for ( const auto& node : m_nodes )
+    {
+        usage += sizeof(node) + 2 * sizeof(void*) + GetStringHeapUsage(node.first)
+                 + sizeof(DirectoryNode) + getRulesMemoryUsage(node.second->rules);
+        if ( node.second->compiled )
+            usage += node.second->compiled->GetMemoryUsage();
+    }
+
+    return usage;
+}
+
+bool wxExplorerBrowserIgnoreRules::GetRelativeSegments(const wxString& directory, std::vector<wxString>& segments) const
+{
+    const size_t rootLength = m_root.length();
+
+    if ( rootLength == 0 || directory.length() < rootLength )
+        return false;
+
+    // case-insensitively, as the file system is on Windows
+    if ( !directory.substr(0, rootLength).IsSameAs(m_root, false) )
+        return false;
+
+    if ( directory.length() > rootLength && !IsPathSeparator(m_root[rootLength - 1])
+         && !IsPathSeparator(directory[rootLength]) )
+        return false; // only starts with the name of the root
+
+    wxString segment;
+
+    for ( size_t i = rootLength; i < directory.length(); ++i )
+    {
+        const wxChar c = directory[i];
+
+        if ( !IsPathSeparator(c) )
+        {
+            segment += c;
+            continue;
+        }
+
+        if ( !segment.empty() )
+        {
+            segments.push_back(segment);
+            segment.clear();
+        }
+    }
+
+    if ( !segment.empty() )
+        segments.push_back(segment);
+
+    return true;
+}
+
+wxExplorerBrowserIgnoreRules::DirectoryNode& wxExplorerBrowserIgnoreRules::GetNode(const std::vector<wxString>& segments,
+                                                                                   size_t depth)
+{
+    wxString key;
+
+    for ( size_t i = 0; i < depth; ++i )
+    {
+        if ( i != 0 )
+            key += wxS('/');
+        key += segments[i];
+    }
+    key.MakeUpper();
+
+    std::unique_ptr<DirectoryNode>& node = m_nodes[key];
+
+    if ( node )
+        return *node;
+
+    node.reset(new DirectoryNode);
+
+    wxString fileName = m_root;
+
+    for ( size_t i = 0; i <= depth; ++i )
+    {
+        if ( !IsPathSeparator(fileName[fileName.length() - 1]) )
+            fileName += wxFILE_SEP_PATH;
+        fileName += i < depth ? segments[i] : m_fileName;
+    }
+
+    // most directories have no ignore file
+    wxFile file;
+    wxString contents;
+
+    if ( wxFile::Exists(fileName) && file.Open(fileName) && file.ReadAll(&contents, wxConvUTF8) )
+        ParseRules(contents, node->rules);
+
+    return *node;
+}
+
+wxExplorerBrowserIgnoreRules::DirectoryRulesPtr wxExplorerBrowserIgnoreRules::GetDirectoryRules(const std::vector<wxString>& segments,
+                                                                                                size_t depth)
+{
+    DirectoryNode& node = GetNode(segments, depth);
+
+    if ( node.compiled )
+        return node.compiled;
+
+    // an item in an ignored directory cannot be re-included
+    bool excluded = false;
+
+    if ( depth > 0 )
+    {
+        const DirectoryRulesPtr parent = GetDirectoryRules(segments, depth - 1);
+        DirectoryRules::Buffer buffer;
+
+        excluded = parent->IsIgnored(segments[depth - 1], true, buffer);
+    }
+
+    node.compiled = Compile(segments, depth, excluded);
+    return node.compiled;
+}
+
+wxExplorerBrowserIgnoreRules::DirectoryRulesPtr wxExplorerBrowserIgnoreRules::Compile(const std::vector<wxString>& segments,
+                                                                                      size_t depth, bool excluded)
+{
+    std::shared_ptr<DirectoryRules> compiled = std::make_shared<DirectoryRules>();
+
+    compiled->m_excluded = excluded;
+    if ( excluded )
+        return compiled;
+
+    std::vector<wxString> names;
+
+    for ( size_t i = 0; i < depth; ++i )
+        names.push_back(segments[i].Upper());
+
+    // the patterns left for the names of the items once the rules have matched
+    // the directories between that of their ignore file and this one
+    std::vector<const Glob*> patterns;
+    Glob anyName(1);
+
+    anyName[0].kind = Token::Kind_Star;
+
+    auto addRules = [&](const std::vector<Rule>& rules, size_t level)
+    {
+        std::vector<bool> active, next;
+
+        // a "**" matches also no directories
+        auto addDoubleStarClosure = [](const Rule& rule, std::vector<bool>& positions)
+        {
+            for ( size_t i = 0; i < rule.segments.size(); ++i )
+            {
+                if ( positions[i] && rule.segments[i].isDoubleStar )
+                    positions[i + 1] = true;
+            }
+        };
+
+        for ( const auto& rule : rules )
+        {
+            const size_t count = rule.segments.size();
+
+            active.assign(count + 1, false);
+            active[0] = true;
+            addDoubleStarClosure(rule, active);
+
+            for ( size_t d = level; d < depth; ++d )
+            {
+                next.assign(count + 1, false);
+
+                bool any = false;
+
+                for ( size_t i = 0; i < count; ++i )
+                {
+                    if ( !active[i] )
+                        continue;
+
+                    const Segment& segment = rule.segments[i];
+
+                    if ( segment.isDoubleStar )
+                        next[i] = any = true;
+                    else if ( MatchGlob(segment.glob, names[d]) )
+                        next[i + 1] = any = true;
+                }
+
+                active.swap(next);
+                if ( !any )
+                    break;
+
+                addDoubleStarClosure(rule, active);
+            }
+
+            // the last segment must be left for the name
+            if ( !active[count - 1] )
+                continue;
+
+            DirectoryRules::RuleRef ruleRef;
+
+            ruleRef.negated = rule.negated;
+            ruleRef.dirOnly = rule.dirOnly;
+            compiled->m_rules.push_back(ruleRef);
+
+            const Segment& last = rule.segments[count - 1];
+
+            patterns.push_back(last.isDoubleStar ? &anyName : &last.glob);
+        }
+    };
+
+    addRules(m_globalRules, 0);
+    for ( size_t level = 0; level <= depth; ++level )
+        addRules(GetNode(segments, level).rules, level);
+
+    // the literal names are looked up, the other patterns make the automaton
+    size_t stateCount = 0;
+
+    for ( const Glob* glob : patterns )
+    {
+        if ( !IsLiteralGlob(*glob) )
+            stateCount += glob->size() + 1;
+    }
+
+    const size_t wordCount = (stateCount + 63) / 64;
+
+    compiled->m_wordCount = wordCount;
+    compiled->m_startStates.resize(wordCount);
+    compiled->m_starStates.resize(wordCount);
+    compiled->m_acceptStates.resize(wordCount);
+    compiled->m_anyCharStates.resize(wordCount);
+    compiled->m_asciiStates.resize(128 * wordCount);
+    compiled->m_stateRules.resize(stateCount, -1);
+
+    size_t state = 0;
+
+    for ( size_t i = 0; i < patterns.size(); ++i )
+    {
+        const Glob& glob = *patterns[i];
+
+        if ( IsLiteralGlob(glob) )
+        {
+            wxString name;
+
+            for ( const auto& token : glob )
+                name += token.ch;
+
+            DirectoryRules::LiteralRules& literal = compiled->m_literals[name];
+
+            if ( compiled->m_rules[i].dirOnly )
+                literal.dirOnly = static_cast<int>(i);
+            else
+                literal.any = static_cast<int>(i);
+        }
+        else
+        {
+            compiled->AddPattern(glob, static_cast<int>(i), state);
+        }
+    }
+
+    return compiled;
+}
+
+void wxExplorerBrowserIgnoreRules::ParseRules(const wxString& contents, std::vector<Rule>& rules)
+{
+    size_t lineStart = 0;
+
+    while ( lineStart < contents.length() )
+    {
+        size_t lineEnd = lineStart;
+
+        while ( lineEnd < contents.length() && contents[lineEnd] != wxS('\n') )
+            ++lineEnd;
+
+        wxString line = contents.substr(lineStart, lineEnd - lineStart);
+
+        lineStart = lineEnd + 1;
+
+        size_t length = line.length();
+
+        if ( length > 0 && line[length - 1] == wxS('\r') )
+            --length;
+
+        // the trailing spaces are ignored unless escaped
+        while ( length > 0 && line[length - 1] == wxS(' ') && !(length > 1 && line[length - 2] == wxS('\\')) )
+            --length;
+
+        if ( length == 0 || line[0] == wxS('#') )
+            continue;
+
+        Rule rule;
+        size_t start = 0;
+
+        if ( line[0] == wxS('!') )
+        {
+            rule.negated = true;
+            start = 1;
+        }
+
+        if ( line[length - 1] == wxS('/') )
+        {
+            rule.dirOnly = true;
+            --length;
+        }
+
+        if ( length <= start )
+            continue;
+
+        const wxString pattern = line.substr(start, length - start).Upper();
+
+        // without a slash, the pattern matches the name at any level
+        if ( pattern.find(wxS("/")) == wxString::npos )
+        {
+            Segment segment;
+
+            segment.isDoubleStar = true;
+            rule.segments.push_back(segment);
+        }
+
+        wxString text;
+
+        for ( size_t i = 0; i <= pattern.length(); ++i )
+        {
+            if ( i < pattern.length() && pattern[i] != wxS('/') )
+            {
+                text += pattern[i];
+                continue;
+            }
+
+            if ( text.empty() )
+                continue;
+
+            Segment segment;
+
+            if ( text == wxS("**") )
+                segment.isDoubleStar = true;
+            else
+                ParseGlob(text, segment.glob);
+
+            rule.segments.push_back(std::move(segment));
+            text.clear();
+        }
+
+        if ( !rule.segments.empty() )
+            rules.push_back(std::move(rule));
+    }
+}
+
+void wxExplorerBrowserIgnoreRules::ParseGlob(const wxString& text, Glob& glob)
+{
+    const wxStringCharType* s = text.wx_str();
+    const size_t length = text.length();
+
+    glob.clear();
+
+    for ( size_t i = 0; i < length; ++i )
+    {
+        const wxChar c = s[i];
+        Token token;
+
+        if ( c == wxS('\\') && i + 1 < length )
+        {
+            token.ch = s[++i];
+        }
+        else if ( c == wxS('*') )
+        {
+            if ( !glob.empty() && glob.back().kind == Token::Kind_Star )
+                continue;
+            token.kind = Token::Kind_Star;
+        }
+        else if ( c == wxS('?') )
+        {
+            token.kind = Token::Kind_AnyChar;
+        }
+        else if ( c == wxS('[') )
+        {
+            size_t j = i + 1;
+
+            token.kind = Token::Kind_Class;
+            if ( j < length && (s[j] == wxS('!') || s[j] == wxS('^')) )
+            {
+                token.negated = true;
+                ++j;
+            }
+
+            // "]" right after the opening bracket is a member
+            for ( bool first = true; j < length && (s[j] != wxS(']') || first); ++j, first = false )
+            {
+                wxChar low = s[j];
+
+                if ( low == wxS('\\') && j + 1 < length )
+                    low = s[++j];
+
+                wxChar high = low;
+
+                if ( j + 2 < length && s[j + 1] == wxS('-') && s[j + 2] != wxS(']') )
+                {
+                    high = s[j + 2];
+                    j += 2;
+                }
+
+                token.ranges.push_back(std::make_pair(low, high));
+            }
+
+            if ( j < length )
+            {
+                i = j;
+            }
+            else // not closed, so not a class
+            {
+                token = Token();
+                token.ch = c;
+            }
+        }
+        else
+        {
+            token.ch = c;
+        }
+
+        glob.push_back(std::move(token));
+    }
+}
+
+bool wxExplorerBrowserIgnoreRules::IsLiteralGlob(const Glob& glob)
+{
+    for ( const auto& token : glob )
+    {
+        if ( token.kind != Token::Kind_Char )
+            return false;
+    }
+
+    return true;
+}
+
+bool wxExplorerBrowserIgnoreRules::MatchGlob(const Glob& glob, const wxString& name)
+{
+    const wxStringCharType* s = name.wx_str();
+    const size_t length = name.length();
+    size_t t = 0;
+    size_t n = 0;
+    size_t starToken = wxString::npos;
+    size_t starName = 0;
+
+    // on a mismatch, the last star takes one more character
+    while ( n < length )
+    {
+        if ( t < glob.size() && glob[t].kind == Token::Kind_Star )
+        {
+            starToken = t++;
+            starName = n;
+        }
+        else if ( t < glob.size() && glob[t].Matches(s[n]) )
+        {
+            ++t;
+            ++n;
+        }
+        else if ( starToken != wxString::npos )
+        {
+            t = starToken + 1;
+            n = ++starName;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    while ( t < glob.size() && glob[t].kind == Token::Kind_Star )
+        ++t;
+
+    return t == glob.size();
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserFuzzyMatcher
+    ---------------------------------
+
+*****************************************************************************/
+
+namespace {
+
+// the scores of matched characters and gaps, the bonuses are added to the matches
+const int FuzzyScoreMatch = 16;
+const int FuzzyScoreGapStart = -3;
+const int FuzzyScoreGapExtension = -1;
+const int FuzzyBonusBoundary = 8;  // at the start of a word
+const int FuzzyBonusCamelCase = 7; // at a camel-case hump or the start of a number
+const int FuzzyBonusConsecutive = -(FuzzyScoreGapStart + FuzzyScoreGapExtension);
+const int FuzzyBonusFirstCharMultiplier = 2;
+
+enum FuzzyCharClass
+{
+    FuzzyChar_Other,
+    FuzzyChar_Lower,
+    FuzzyChar_Upper,
+    FuzzyChar_Digit
+};
+
+FuzzyCharClass GetFuzzyCharClass(wxChar c)
+{
+    if ( wxIsdigit(c) )
+        return FuzzyChar_Digit;
+    if ( wxIsupper(c) )
+        return FuzzyChar_Upper;
+    if ( wxIsalnum(c) )
+        return FuzzyChar_Lower; // also the letters without case
+    return FuzzyChar_Other;
+}
+
+int GetFuzzyBonus(FuzzyCharClass previous, FuzzyCharClass current)
+{
+    if ( current == FuzzyChar_Other )
+        return 0;
+    if ( previous == FuzzyChar_Other )
+        return FuzzyBonusBoundary;
+    if ( (previous == FuzzyChar_Lower && current == FuzzyChar_Upper)
+         || (previous != FuzzyChar_Digit && current == FuzzyChar_Digit) )
+        return FuzzyBonusCamelCase;
+    return 0;
+}
+
+inline wxUint64 GetFuzzyCharBit(wxChar c)
+{
+    return wxUint64(1) << (static_cast<wxUint32>(c) % 64);
+}
+
+} // unnamed namespace
+
+struct wxExplorerBrowserFuzzyMatcher::Pattern
+{
+    std::vector<wxChar> chars; // folded
+    wxUint64 charSet {0};
+
+    // bit i is set in the mask of the character at position i
+    wxUint64 asciiMasks[128];
+    std::vector<std::pair<wxChar, wxUint64>> otherMasks;
+
+    wxUint64 GetMask(wxChar c) const
+    {
+        if ( static_cast<wxUint32>(c) < 128 )
+            return asciiMasks[c];
+
+        for ( const auto& otherMask : otherMasks )
+        {
+            if ( otherMask.first == c )
+                return otherMask.second;
+        }
+
+        return 0;
+    }
+};
+
+void wxExplorerBrowserFuzzyMatcher::Clear()
+{
+    m_chars.clear();
+    m_bonuses.clear();
+    m_starts.assign(1, 0);
+    m_charSets.clear();
+}
+
+void wxExplorerBrowserFuzzyMatcher::Reserve(size_t nameCount, size_t totalLength)
+{
+    m_chars.reserve(totalLength);
+    m_bonuses.reserve(totalLength);
+    m_starts.reserve(nameCount + 1);
+    m_charSets.reserve(nameCount);
+}
+
+void wxExplorerBrowserFuzzyMatcher::AddName(const wxString& name)
+{
+    const wxStringCharType* s = name.wx_str();
+    const size_t length = name.length();
+    FuzzyCharClass previous = FuzzyChar_Other;
+    wxUint64 charSet = 0;
+
+    for ( size_t i = 0; i < length; ++i )
+    {
+        const FuzzyCharClass current = GetFuzzyCharClass(s[i]);
+        const wxChar c = static_cast<wxChar>(wxTolower(s[i]));
+
+        m_chars.push_back(c);
+        m_bonuses.push_back(static_cast<wxUint8>(GetFuzzyBonus(previous, current)));
+        charSet |= GetFuzzyCharBit(c);
+        previous = current;
+    }
+
+    m_starts.push_back(m_chars.size());
+    m_charSets.push_back(charSet);
+}
+
+void wxExplorerBrowserFuzzyMatcher::SetItems(const wxExplorerBrowserItem::List& items)
+{
+    size_t totalLength = 0;
+
+    for ( const auto& item : items )
+        totalLength += item.GetDisplayName().length();
+
+    Clear();
+    Reserve(items.size(), totalLength);
+
+    for ( const auto& item : items )
+        AddName(item.GetDisplayName());
+}
+
+size_t wxExplorerBrowserFuzzyMatcher::Find(const wxString& text, size_t maxResults, Matches& matches) const
+{
+    Pattern pattern;
+
+    matches.clear();
+
+    if ( maxResults == 0 || !PreparePattern(text, pattern) )
+        return 0;
+
+    const size_t patternLength = pattern.chars.size();
+
+    auto isBetter = [this](const Match& a, const Match& b)
+    {
+        if ( a.score != b.score )
+            return a.score > b.score;
+
+        const size_t aLength = m_starts[a.index + 1] - m_starts[a.index];
+        const size_t bLength = m_starts[b.index + 1] - m_starts[b.index];
+
+        if ( aLength != bLength )
+            return aLength < bLength;
+
+        return a.index < b.index;
+    };
+
+    // the worst of the best matches found so far is at the top of the heap
+    for ( size_t i = 0; i < m_charSets.size(); ++i )
+    {
+        if ( (pattern.charSet & ~m_charSets[i]) != 0 || m_starts[i + 1] - m_starts[i] < patternLength )
+            continue;
+
+        const int score = ScoreName(pattern, i);
+
+        if ( score < 0 )
+            continue;
+
+        const Match match = { i, score };
+
+        if ( matches.size() < maxResults )
+        {
+            matches.push_back(match);
+            std::push_heap(matches.begin(), matches.end(), isBetter);
+        }
+        else if ( isBetter(match, matches.front()) )
+        {
+            std::pop_heap(matches.begin(), matches.end(), isBetter);
+            matches.back() = match;
+            std::push_heap(matches.begin(), matches.end(), isBetter);
+        }
+    }
+
+    std::sort_heap(matches.begin(), matches.end(), isBetter);
+    return matches.size();
+}
+
+int wxExplorerBrowserFuzzyMatcher::Score(const wxString& text, const wxString& name)
+{
+    wxExplorerBrowserFuzzyMatcher matcher;
+    Pattern pattern;
+
+    if ( !PreparePattern(text, pattern) )
+        return -1;
+
+    matcher.AddName(name);
+    if ( (pattern.charSet & ~matcher.m_charSets[0]) != 0 )
+        return -1;
+
+    return matcher.ScoreName(pattern, 0);
+}
+
+size_t wxExplorerBrowserFuzzyMatcher::GetMemoryUsage() const
+{
+    return m_chars.capacity() * sizeof(wxChar) + m_bonuses.capacity() * sizeof(wxUint8)
+           + m_starts.capacity() * sizeof(size_t) + m_charSets.capacity() * sizeof(wxUint64);
+}
+
+int wxExplorerBrowserFuzzyMatcher::ScoreName(const Pattern& pattern, size_t index) const
+{
+    const wxChar* chars = m_chars.data() + m_starts[index];
+    const wxUint8* bonuses = m_bonuses.data() + m_starts[index];
+    const size_t length = m_starts[index + 1] - m_starts[index];
+    const size_t patternLength = pattern.chars.size();
+
+    // bit i of the state is set once the first i + 1 characters
+    // of the pattern were found in order, the earliest end is where
+    // the whole pattern is found first
+    const wxUint64 lastBit = wxUint64(1) << (patternLength - 1);
+    wxUint64 state = 0;
+    size_t end = 0;
+
+    for ( ; end < length; ++end )
+    {
+        state |= ((state << 1) | 1) & pattern.GetMask(chars[end]);
+        if ( state & lastBit )
+            break;
+    }
+
+    if ( end == length )
+        return -1;
+
+    // the latest start of a match ending there
+    size_t start = end;
+
+    for ( size_t k = patternLength; ; --start )
+    {
+        if ( chars[start] == pattern.chars[k - 1] && --k == 0 )
+            break;
+    }
+
+    int score = 0;
+    int consecutive = 0;
+    int firstBonus = 0;
+    bool inGap = false;
+    size_t k = 0;
+
+    for ( size_t i = start; i <= end; ++i )
+    {
+        if ( k < patternLength && chars[i] == pattern.chars[k] )
+        {
+            int bonus = bonuses[i];
+
+            // a run keeps the bonus of its start
+            if ( consecutive == 0 )
+            {
+                firstBonus = bonus;
+            }
+            else
+            {
+                if ( bonus >= FuzzyBonusBoundary && bonus > firstBonus )
+                    firstBonus = bonus;
+                bonus = std::max(bonus, std::max(firstBonus, FuzzyBonusConsecutive));
+            }
+
+            score += FuzzyScoreMatch + (k == 0 ? bonus * FuzzyBonusFirstCharMultiplier : bonus);
+            inGap = false;
+            ++consecutive;
+            ++k;
+        }
+        else
+        {
+            score += inGap ? FuzzyScoreGapExtension : FuzzyScoreGapStart;
+            inGap = true;
+            consecutive = 0;
+            firstBonus = 0;
+        }
+    }
+
+    // the penalties of long gaps cannot outweigh the matches
+    return std::max(score, 0);
+}
+
+bool wxExplorerBrowserFuzzyMatcher::PreparePattern(const wxString& text, Pattern& pattern)
+{
+    const wxStringCharType* s = text.wx_str();
+    // copied, std::min() would take the constant by reference, which needs its definition
+    const size_t length = std::min(text.length(), size_t(MaxPatternLength));
+
+    if ( length == 0 )
+        return false;
+
+    std::fill(std::begin(pattern.asciiMasks), std::end(pattern.asciiMasks), 0);
+
+    for ( size_t i = 0; i < length; ++i )
+    {
+        const wxChar c = static_cast<wxChar>(wxTolower(s[i]));
+        const wxUint64 bit = wxUint64(1) << i;
+
+        pattern.chars.push_back(c);
+        pattern.charSet |= GetFuzzyCharBit(c);
+
+        if ( static_cast<wxUint32>(c) < 128 )
+        {
+            pattern.asciiMasks[c] |= bit;
+            continue;
+        }
+
+        auto it = std::find_if(pattern.otherMasks.begin(), pattern.otherMasks.end(),
+                               [c](const std::pair<wxChar, wxUint64>& otherMask) { return otherMask.first == c; });
+
+        if ( it != pattern.otherMasks.end() )
+            it->second |= bit;
+        else
+            pattern.otherMasks.push_back(std::make_pair(c, bit));
+    }
+
+    return true;
+}
+
+/***************************************************************************
+
+    class wxExplorerBrowserTrigramIndex
+    ---------------------------------
+
+*****************************************************************************/
+
+namespace {
+
+// advances pos to the first element of the sorted list not less than id,
+// returns true if it is equal to id
+bool SeekSortedId(const wxExplorerBrowserTrigramIndex::IdList& list, size_t& pos,
+                  wxExplorerBrowserTrigramIndex::Id id)
+{
+    // galloping, as the lists are usually much longer than the shortest one
+    size_t step = 1;
+    size_t end = pos;
+
+    while ( end < list.size() && list[end] < id )
+    {
+        pos = end + 1;
+        end += step;
+        step *= 2;
+    }
+
+    pos = std::lower_bound(list.begin() + pos, list.begin() + std::min(end, list.size()), id) - list.begin();
+    return pos < list.size() && list[pos] == id;
+}
+
+} // unnamed namespace
+
+void wxExplorerBrowserTrigramIndex::Clear()
+{
+    m_names.clear();
+    m_upperNames.clear();
+    m_removedCount = 0;
+    m_ids.clear();
+    m_postings.clear();
+}
+
+void wxExplorerBrowserTrigramIndex::Reserve(size_t count)
+{
+    m_names.reserve(count);
+    m_upperNames.reserve(count);
+    m_ids.reserve(count);
+}
+
+bool wxExplorerBrowserTrigramIndex::Add(const wxString& name)
+{
+    wxCHECK(m_names.size() < std::numeric_limits<Id>::max(), false);
+
+    const wxString upperName = name.Upper();
+
+    if ( !m_ids.insert(std::make_pair(upperName, static_cast<Id>(m_names.size()))).second )
+        return false;
+
+    m_names.push_back(name);
+    m_upperNames.push_back(upperName);
+    AddPostings(static_cast<Id>(m_names.size() - 1));
+
+    return true;
+}
+
+bool wxExplorerBrowserTrigramIndex::Remove(const wxString& name)
+{
+    const auto it = m_ids.find(name.Upper());
+
+    if ( it == m_ids.end() )
+        return false;
+
+    m_names[it->second].clear();
+    m_upperNames[it->second].clear();
+    m_ids.erase(it);
+    ++m_removedCount;
+
+    // the posting lists are not searched for the id, it is skipped by the queries
+    static const size_t minRemovedCount = 1024;
+
+    if ( m_removedCount >= minRemovedCount && m_removedCount > m_ids.size() )
+        Compact();
+
+    return true;
+}
+
+void wxExplorerBrowserTrigramIndex::SetItems(const wxExplorerBrowserItem::List& items)
+{
+    wxString name;
+
+    Clear();
+    Reserve(items.size());
+
+    for ( const auto& item : items )
+    {
+        wxExplorerBrowserMaskMatcher::GetItemName(item, name);
+        Add(name);
+    }
+}
+
+void wxExplorerBrowserTrigramIndex::Find(const wxString& str, IdList& ids) const
+{
+    ids.clear();
+
+    const wxString upperStr = str.Upper();
+    const size_t length = upperStr.length();
+
+    if ( length == 0 )
+        return;
+
+    if ( length < 3 )
+    {
+        for ( size_t id = 0; id < m_upperNames.size(); ++id )
+        {
+            if ( m_upperNames[id].find(upperStr) != wxString::npos )
+                ids.push_back(static_cast<Id>(id));
+        }
+
+        return;
+    }
+
+    // a single missing trigram means no match
+    const wxStringCharType* s = upperStr.wx_str();
+    std::vector<const IdList*> lists;
+
+    for ( size_t i = 0; i + 3 <= length; ++i )
+    {
+        const auto it = m_postings.find(MakeTrigram(s + i));
+
+        if ( it == m_postings.end() )
+            return;
+
+        if ( std::find(lists.begin(), lists.end(), &it->second) == lists.end() )
+            lists.push_back(&it->second);
+    }
+
+    std::sort(lists.begin(), lists.end(),
+              [](const IdList* a, const IdList* b) { return a->size() < b->size(); });
+
+    std::vector<size_t> positions(lists.size(), 0);
+
+    for ( const Id id : *lists[0] )
+    {
+        bool inAll = true;
+
+        for ( size_t i = 1; i < lists.size() && inAll; ++i )
+            inAll = SeekSortedId(*lists[i], positions[i], id);
+
+        // the trigrams can be in another order, and the removed names are empty
+        if ( inAll && m_upperNames[id].find(upperStr) != wxString::npos )
+            ids.push_back(id);
+    }
+}
+
+size_t wxExplorerBrowserTrigramIndex::GetMemoryUsage() const
+{
+    size_t usage = (m_names.capacity() + m_upperNames.capacity()) * sizeof(wxString);
+
+    for ( size_t i = 0; i < m_names.size(); ++i )
+        usage += GetStringHeapUsage(m_names[i]) + GetStringHeapUsage(m_upperNames[i]);
+
+    // the keys of m_ids share the buffers of m_upperNames
+    usage += m_ids.size() * (sizeof(wxString) + sizeof(Id) + 2 * sizeof(void*))
+             + m_ids.bucket_count() * sizeof(void*);
+
+    for ( const auto& posting : m_postings )
+        usage += sizeof(posting) + 2 * sizeof(void*) + posting.second.capacity() * sizeof(Id);
+    usage += m_postings.bucket_count() * sizeof(void*);
+
+    return usage;
+}
+
+void wxExplorerBrowserTrigramIndex::AddPostings(Id id)
+{
+    const wxString& upperName = m_upperNames[id];
+    const wxStringCharType* s = upperName.wx_str();
+
+    for ( size_t i = 0; i + 3 <= upperName.length(); ++i )
+    {
+        IdList& list = m_postings[MakeTrigram(s + i)];
+
+        // the ids are added in increasing order, so a repeated trigram is at the back
+        if ( list.empty() || list.back() != id )
+            list.push_back(id);
+    }
+}
+
+void wxExplorerBrowserTrigramIndex::Compact()
+{
+    std::vector<wxString> names;
+
+    names.reserve(m_ids.size());
+    for ( auto& name : m_names )
+    {
+        if ( !name.empty() )
+            names.push_back(std::move(name));
+    }
+
+    Clear();
+    Reserve(names.size());
+
+    for ( const auto& name : names )
+        Add(name);
+}
+
+wxExplorerBrowserTrigramIndex::Trigram wxExplorerBrowserTrigramIndex::MakeTrigram(const wxStringCharType* s)
+{
+    // 21 bits are enough for any code point
+    static const Trigram mask = 0x1FFFFF;
+
+    return ((static_cast<Trigram>(s[0]) & mask) << 42) | ((static_cast<Trigram>(s[1]) & mask) << 21)
+           | (static_cast<Trigram>(s[2]) & mask);
+}
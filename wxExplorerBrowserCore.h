@@ -0,0 +1,2300 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//  Name:        wxExplorerBrowserCore.h
+//  Purpose:     Platform-independent helpers used by wxExplorerBrowser
+//  Author:      PB
+//  Copyright:   (c) 2018 PB <pbfordev@gmail.com>
+//  Licence:     wxWindows licence
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef WX_EXPLORER_BROWSER_CORE_H_DEFINED
+#define WX_EXPLORER_BROWSER_CORE_H_DEFINED
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <wx/defs.h>
+#include <wx/gdicmn.h>
+#include <wx/hashmap.h>
+#include <wx/string.h>
+
+#if wxCHECK_CXX_STD(201703L)
+    #include <string_view>
+#endif
+
+/** @file
+
+    Contains the parts of wxExplorerBrowser which do not depend on
+    the Windows shell, such as scheduling policies and data structures.
+    They can be built and used on any platform wxWidgets supports.
+
+    All the times passed to the classes here are in milliseconds
+    and come from the caller, so the classes can be driven by any clock.
+*/
+
+/**
+    Returns 64-bit FNV-1a hash of @a size bytes at @a data,
+    @a seed can be used to chain several hashes.
+*/
+wxUint64 wxExplorerBrowserHashBytes(const void* data, size_t size,
+                                    wxUint64 seed = 14695981039346656037ULL);
+
+/**
+    Returns 64-bit hash of the string, computed from its
+    UTF-16/UTF-32 code units, so it differs between platforms.
+*/
+wxUint64 wxExplorerBrowserHashString(const wxString& str,
+                                     wxUint64 seed = 14695981039346656037ULL);
+
+/**
+    Returns an id which is a hash of the @a size bytes at @a data and never 0,
+    @a seed can be e.g. the id of the parent of the item.
+*/
+wxUint64 wxExplorerBrowserMakeItemId(const void* data, size_t size,
+                                     wxUint64 seed = 14695981039346656037ULL);
+
+/**
+    Returns the id of the item with the absolute parsing name (SIGDN_DESKTOPABSOLUTEPARSING)
+    @a parsingName. Unlike the ID list, the name does not change when the item is modified,
+    so it is used for the folders, whose items are then invalidated by this id.
+*/
+wxUint64 wxExplorerBrowserMakeItemId(const wxChar* parsingName);
+
+/**    
+    Represents a very simplified shell item. 
+*/
+class wxExplorerBrowserItem
+{
+public:
+    typedef std::vector<wxExplorerBrowserItem> List;
+
+    /**    
+        Zip files are reported as File although they 
+        can also browsed as folders, all items inside 
+        zips are reported as Other.    
+    */    
+    enum Type
+    {
+        Unknown     = 0,    /*!< item type is unknown, unimportant, or item is invalid  */
+        File        = 0x01, /*!< filesystem file        */
+        Directory   = 0x02, /*!< filesystem directory   */
+        Other       = 0x08  /*!< not File or Directory  */
+    };
+
+    /*! wxExplorerBrowserHashString() of an empty string, i.e. its default seed. */
+    static const wxUint64 EmptyStringHash = 14695981039346656037ULL;
+
+    wxExplorerBrowserItem(Type type = Unknown)
+        : m_type(type), m_SFGAO(0), m_id(0),
+          m_pathHash(EmptyStringHash),
+          m_displayNameHash(EmptyStringHash)  {}
+
+    wxExplorerBrowserItem(const wxExplorerBrowserItem&) = default;
+    wxExplorerBrowserItem(wxExplorerBrowserItem&&) = default;
+    wxExplorerBrowserItem& operator=(const wxExplorerBrowserItem&) = default;
+    wxExplorerBrowserItem& operator=(wxExplorerBrowserItem&&) = default;
+
+    Type GetType() const { return m_type; }
+
+    /**
+        Returns the full filesystem path if the item is File
+        or Directory and empty string otherwise.
+
+        Unlike in the previous versions, the path is not returned by value,
+        so the code modifying it in place, e.g. GetPath().MakeLower(),
+        must copy it first: wxString(GetPath()).MakeLower().
+    */
+    const wxString& GetPath() const { return m_path; }
+
+    /**
+        Returns parent-relative display name as shown in the explorer view.
+        It is returned by reference too, see GetPath().
+    */
+    const wxString& GetDisplayName() const { return m_displayName; }
+
+#if wxCHECK_CXX_STD(201703L)
+    typedef std::basic_string_view<wxStringCharType> StringView;
+
+    /*! Returns a view of the path, valid until the path is changed. */
+    StringView GetPathView() const { return StringView(m_path.wx_str(), m_path.length()); }
+
+    /*! Returns a view of the display name, valid until the name is changed. */
+    StringView GetDisplayNameView() const { return StringView(m_displayName.wx_str(), m_displayName.length()); }
+#endif
+
+    /**
+        Returns the 64-bit id of the item, a hash of the last ID of its ID list
+        chained to the id of its folder, or 0 if the item has no id, e.g. it was
+        not created by wxExplorerBrowser.
+
+        The id stays the same across the refreshes of the folder. The ID lists
+        of the filesystem items contain also their size and time, so the id
+        changes when the item is modified, renamed or moved.
+    */
+    wxUint64 GetId() const { return m_id; }
+    bool HasId() const { return m_id != 0; }
+
+    /** Hash and equality of the items by their id, for unordered containers. */
+    struct IdHash
+    {
+        size_t operator()(const wxExplorerBrowserItem& item) const { return static_cast<size_t>(item.GetId()); }
+    };
+    struct IdEqual
+    {
+        bool operator()(const wxExplorerBrowserItem& a, const wxExplorerBrowserItem& b) const
+            { return a.GetId() == b.GetId(); }
+    };
+
+    /*! Returns wxExplorerBrowserHashString() of the path, computed when the path was set. */
+    wxUint64 GetPathHash() const { return m_pathHash; }
+
+    /*! Returns wxExplorerBrowserHashString() of the display name, computed when the name was set. */
+    wxUint64 GetDisplayNameHash() const { return m_displayNameHash; }
+
+    /** 
+        Returns a combination of SFGAO_FILESYSTEM, SFGAO_FOLDER, SFGAO_LINK, and SFGAO_STREAM for the item.
+        
+        @see IsFile(), IsDirectory(), IsFileSystem(), IsFolder, IsVirtualZipDirectory(), IsShortcut()
+    */
+    wxUint32 GetSFGAO() const { return m_SFGAO; }
+
+    /*! Returns true if the item is a filesystem file. */
+    bool IsFile() const { return GetType() == File; }
+
+    /*! Returns true if the item is a filesystem folder. */
+    bool IsDirectory() const { return GetType() == Directory; }
+
+    /*! Returns true if the item is a filesystem file or folder. */
+    bool IsFileSystem() const { return (IsFile() || IsDirectory()); }
+
+    /*! Returns true if the item is Directory or a virtual folder. */
+    bool IsFolder() const { return (GetSFGAO() & 0x20000000L); } // 0x20000000L = SFGAO_FOLDER
+
+    /** 
+        Returns true if the item is a virtual zip directory, i.e.,
+        a filesystem file that can also be browsed as a virtual folder. 
+    */
+    bool IsVirtualZipDirectory() const { return IsFile() && IsFolder(); }
+
+    /*! Returns true if the item is a shortcut. */
+    bool IsShortcut() const { return (GetSFGAO() & 0x00010000); } // 0x00010000 = SFGAO_LINK
+   
+    /*! Sets item's type. */
+    void SetType(Type type) { m_type = type; }
+    
+    /*! Sets item's path. */
+    void SetPath(const wxString& path)
+        { m_path = path; m_pathHash = wxExplorerBrowserHashString(m_path); }
+
+    /*! Sets item's path, reusing the buffer of the current one when it is large enough. */
+    void SetPath(const wxChar* path)
+        { m_path = path; m_pathHash = wxExplorerBrowserHashString(m_path); }
+    
+    /*! Sets item's display name. */
+    void SetDisplayName(const wxString& name)
+        { m_displayName = name; m_displayNameHash = wxExplorerBrowserHashString(m_displayName); }
+
+    /*! Sets item's display name, reusing the buffer of the current one when it is large enough. */
+    void SetDisplayName(const wxChar* name)
+        { m_displayName = name; m_displayNameHash = wxExplorerBrowserHashString(m_displayName); }
+    
+    /*! Sets item's SFGAO attributes. */
+    void SetSFGAO(wxUint32 attr) { m_SFGAO = attr; }
+
+    /*! Sets item's id, see GetId(). */
+    void SetId(wxUint64 id) { m_id = id; }
+private:
+    Type m_type;
+    wxString m_path;
+    wxString m_displayName;
+    wxUint32 m_SFGAO;
+    wxUint64 m_id;
+    wxUint64 m_pathHash;
+    wxUint64 m_displayNameHash;
+};
+
+/**
+    Return the approximate number of bytes used by the object,
+    including its heap allocations.
+*/
+size_t wxExplorerBrowserGetMemoryUsage(const wxString& str);
+size_t wxExplorerBrowserGetMemoryUsage(const wxArrayString& strings);
+size_t wxExplorerBrowserGetMemoryUsage(const wxExplorerBrowserItem& item);
+size_t wxExplorerBrowserGetMemoryUsage(const wxExplorerBrowserItem::List& items);
+
+/**
+    Memory held by a wxExplorerBrowser, in bytes.
+
+    @see wxExplorerBrowser::GetMemoryUsage()
+*/
+struct wxExplorerBrowserMemoryUsage
+{
+    size_t itemLists {0};         /*!< the listings remembered for GetItemChanges(), QuickFind() and SearchIndex(),
+                                       and the state of a parked view */
+    size_t cachedConversions {0}; /*!< the thumbnails */
+    size_t filters {0};           /*!< the filter masks, the ignore rules and the names shown by SearchIndex() */
+    size_t pendingEvents {0};     /*!< the changes, search queries and results waiting to be processed */
+
+    /**
+        The process-wide item cache, if the control uses it. It is shared by
+        all controls, so it is not included in GetTotal() and does not count
+        against the budget of any of them, it is limited by
+        wxExplorerBrowserItemCache::SetMaxMemory() instead.
+    */
+    size_t sharedItemCache {0};
+
+    size_t GetTotal() const { return itemLists + cachedConversions + filters + pendingEvents; }
+};
+
+/**
+    Soft and hard memory limits, 0 means no limit.
+
+    Exceeding the soft limit should trigger trimming the memory which
+    is cheap to recreate, exceeding the hard one also dropping the data
+    which cannot be fully recreated.
+*/
+class wxExplorerBrowserMemoryBudget
+{
+public:
+    enum Level
+    {
+        Level_Normal,
+        Level_Soft,  /*!< the soft limit is exceeded */
+        Level_Hard   /*!< the hard limit is exceeded */
+    };
+
+    wxExplorerBrowserMemoryBudget(size_t softLimit = 0, size_t hardLimit = 0)
+        : m_softLimit(softLimit), m_hardLimit(hardLimit)
+    {}
+
+    void SetLimits(size_t softLimit, size_t hardLimit)
+    {
+        m_softLimit = softLimit;
+        m_hardLimit = hardLimit;
+    }
+
+    size_t GetSoftLimit() const { return m_softLimit; }
+    size_t GetHardLimit() const { return m_hardLimit; }
+
+    bool IsEnabled() const { return m_softLimit || m_hardLimit; }
+
+    Level GetLevel(size_t usage) const;
+
+    /**
+        Returns the number of bytes which need to be freed to get
+        below the soft limit, or the hard one when there is no soft limit.
+    */
+    size_t GetExcess(size_t usage) const;
+
+private:
+    size_t m_softLimit;
+    size_t m_hardLimit;
+};
+
+/**
+    Decides when the size of the hosted ExplorerBrowser should be updated.
+
+    With coalescing enabled, size changes are only recorded and the last one
+    is applied when the resizing settles down, interactive resizing ends,
+    or the maximum update interval elapses.
+
+    The owner is expected to call OnTimer() at the time returned by GetDeadline().
+*/
+class wxExplorerBrowserResizeCoalescer
+{
+public:
+    /*! How long must the size remain unchanged to be applied outside of interactive resizing. */
+    static const wxUint64 DefaultSettleDelay = 100;
+
+    wxExplorerBrowserResizeCoalescer() {}
+
+    /**
+        If @a coalesce is false, every size change is applied immediately.
+        If @a maxUpdateInterval is not 0, the size is updated at least
+        that often (in milliseconds) while the size keeps changing.
+    */
+    void SetPolicy(bool coalesce, wxUint64 maxUpdateInterval = 0,
+                   wxUint64 settleDelay = DefaultSettleDelay);
+
+    bool IsCoalescing() const { return m_coalesce; }
+
+    /**
+        Records the new size. Returns true if the size should be applied now,
+        in that case the caller must also call OnApplied().
+    */
+    bool OnSizeChanged(const wxSize& size, wxUint64 now);
+
+    /*! Interactive resizing, e.g. dragging the frame border, has started. */
+    void BeginInteractive();
+
+    /*! Interactive resizing has ended. Returns true if the pending size should be applied now. */
+    bool EndInteractive(wxUint64 now);
+
+    /*! Returns true if the pending size should be applied now. */
+    bool OnTimer(wxUint64 now);
+
+    /*! Must be called after the pending size was applied at time @a now. */
+    void OnApplied(wxUint64 now);
+
+    bool HasPendingSize() const { return m_hasPending; }
+    const wxSize& GetPendingSize() const { return m_pendingSize; }
+    bool IsInteractive() const { return m_interactive; }
+
+    /**
+        Returns false if no timer is needed, otherwise @a deadline
+        is set to the time when OnTimer() should be called.
+    */
+    bool GetDeadline(wxUint64& deadline) const;
+
+private:
+    bool     m_coalesce {false};
+    wxUint64 m_maxUpdateInterval {0};
+    wxUint64 m_settleDelay {DefaultSettleDelay};
+
+    bool     m_interactive {false};
+    bool     m_hasPending {false};
+    wxSize   m_pendingSize;
+    wxUint64 m_lastChange {0};
+    wxUint64 m_lastApplied {0};
+    bool     m_everApplied {false};
+
+    bool IsUpdateIntervalDue(wxUint64 now) const;
+};
+
+/**
+    A view of a whole file mapped into memory, read-only by default.
+*/
+class wxExplorerBrowserMappedFile
+{
+public:
+    enum Mode
+    {
+        Mode_Read,
+        Mode_ReadWrite  /*!< the file is created if it does not exist */
+    };
+
+    wxExplorerBrowserMappedFile() {}
+    ~wxExplorerBrowserMappedFile() { Close(); }
+
+    /**
+        In Mode_ReadWrite, the file is extended with zeros to @a minSize bytes
+        if it is smaller, which must be done for an empty file as it cannot be mapped.
+    */
+    bool Open(const wxString& fileName, Mode mode = Mode_Read, size_t minSize = 0);
+    void Close();
+
+    bool IsOpened() const { return m_data != nullptr; }
+    bool IsWritable() const { return m_writable; }
+
+    const wxUint8* GetData() const { return m_data; }
+    /*! Returns null unless the file was opened in Mode_ReadWrite. */
+    wxUint8* GetWritableData() { return m_writable ? m_data : nullptr; }
+    size_t GetSize() const { return m_size; }
+
+    /**
+        Changes the size of a file opened in Mode_ReadWrite, the added part is zeroed.
+        The file is mapped again, invalidating the pointers to the data.
+    */
+    bool Resize(size_t size);
+
+    /** Writes the modified data of a file opened in Mode_ReadWrite to the disk. */
+    bool Flush();
+
+private:
+    wxUint8* m_data {nullptr};
+    size_t   m_size {0};
+    bool     m_writable {false};
+    wxString m_fileName; // for the error messages
+#ifdef __WINDOWS__
+    void*    m_mapping {nullptr};
+    void*    m_file {nullptr}; // kept open only in Mode_ReadWrite
+#else
+    int      m_fd {-1};        // kept open only in Mode_ReadWrite
+#endif
+
+    bool Map(size_t size);
+    void Unmap();
+
+    wxDECLARE_NO_COPY_CLASS(wxExplorerBrowserMappedFile);
+};
+
+/**
+    Writes and reads folder listing snapshots in a compact binary format.
+
+    The file consists of a header, followed by fixed-size records, one per item,
+    and a string arena with the items' paths and display names. All the numbers
+    are stored as little-endian, the strings are stored as NUL-terminated UTF-8,
+    the record contains the offset of a string in the arena and its length.
+
+    The reader memory-maps the file and does not copy the data
+    unless asked for wxString or wxExplorerBrowserItem.
+*/
+class wxExplorerBrowserSnapshot
+{
+public:
+    /*! The version of the file format written by Write(). */
+    static const wxUint32 Version = 1;
+
+    /**
+        Writes @a items from @a folderPath to @a fileName.
+        The file is replaced only when it was written successfully.
+    */
+    static bool Write(const wxString& fileName, const wxString& folderPath,
+                      const wxExplorerBrowserItem::List& items);
+
+    /**
+        A snapshot item pointing directly into the mapped file,
+        it becomes invalid when the snapshot is closed.
+    */
+    struct Item
+    {
+        wxExplorerBrowserItem::Type type {wxExplorerBrowserItem::Unknown};
+        wxUint32    SFGAO {0};
+        const char* path {nullptr};         /*!< UTF-8, NUL-terminated */
+        size_t      pathLength {0};         /*!< in bytes, without the NUL */
+        const char* displayName {nullptr};  /*!< UTF-8, NUL-terminated */
+        size_t      displayNameLength {0};  /*!< in bytes, without the NUL */
+
+        wxString GetPath() const { return wxString::FromUTF8(path, pathLength); }
+        wxString GetDisplayName() const { return wxString::FromUTF8(displayName, displayNameLength); }
+
+        wxExplorerBrowserItem ToItem() const;
+    };
+
+    wxExplorerBrowserSnapshot() {}
+
+    /** Maps @a fileName into memory and validates its header. */
+    bool Open(const wxString& fileName);
+    void Close();
+
+    bool IsOpened() const { return m_file.IsOpened(); }
+
+    size_t GetCount() const { return m_count; }
+
+    /** Returns false if the index is invalid or the item data are corrupted. */
+    bool GetItem(size_t index, Item& item) const;
+
+    /** Returns the path of the folder the items were in. */
+    wxString GetFolderPath() const;
+
+private:
+    wxExplorerBrowserMappedFile m_file;
+    size_t         m_count {0};
+    size_t         m_recordSize {0};
+    const wxUint8* m_records {nullptr};
+    const char*    m_strings {nullptr};
+    size_t         m_stringsSize {0};
+    wxUint64       m_folderPathOffset {0};
+    wxUint32       m_folderPathLength {0};
+
+    bool GetString(wxUint64 offset, wxUint32 length, const char*& str) const;
+
+    wxDECLARE_NO_COPY_CLASS(wxExplorerBrowserSnapshot);
+};
+
+/**
+    Changes between two listings of the same folder.
+
+    @see wxExplorerBrowserListingFingerprint
+*/
+struct wxExplorerBrowserListingDelta
+{
+    wxExplorerBrowserItem::List added;
+    wxExplorerBrowserItem::List removed;
+    wxExplorerBrowserItem::List changed; /*!< items with changed type, SFGAO, or display name */
+
+    bool IsEmpty() const { return added.empty() && removed.empty() && changed.empty(); }
+    void Clear() { added.clear(); removed.clear(); changed.clear(); }
+};
+
+/**
+    Remembers the last listing and computes the changes in a new listing in O(n).
+
+    Items are identified by their path, or by their display name for items
+    without a path, looked up by the hash of it. The remembered listing is
+    the only copy of the items kept, the hashes map to indices into it and
+    colliding hashes are told apart by comparing the paths. If a listing
+    contains several items with the same identity, only the last one of them is tracked.
+*/
+class wxExplorerBrowserListingFingerprint
+{
+public:
+    wxExplorerBrowserListingFingerprint() {}
+
+    /**
+        Compares @a items with the previous listing and fills @a delta with the changes,
+        then remembers @a items as the listing to compare the next one with.
+        @a delta can be nullptr when only the listing is to be remembered.
+        When called for the first time, all items are reported as added.
+    */
+    void Update(const wxExplorerBrowserItem::List& items, wxExplorerBrowserListingDelta* delta);
+    /*! Like Update() above, but takes over @a items instead of copying them. */
+    void Update(wxExplorerBrowserItem::List&& items, wxExplorerBrowserListingDelta* delta);
+
+    /*! Forgets the remembered listing. */
+    void Clear();
+
+    size_t GetCount() const { return m_items.size(); }
+
+    /*! Returns the remembered listing. */
+    const wxExplorerBrowserItem::List& GetItems() const { return m_items; }
+
+    size_t GetMemoryUsage() const;
+
+    static wxUint64 GetItemKey(const wxExplorerBrowserItem& item);
+    static wxUint64 GetItemAttributesHash(const wxExplorerBrowserItem& item);
+    /*! Returns true if the items have the same path, or the same display name when they have no path. */
+    static bool IsSameItem(const wxExplorerBrowserItem& item1, const wxExplorerBrowserItem& item2);
+
+private:
+    struct Entry
+    {
+        wxUint64 attributesHash;
+        size_t   index; // to the listing
+    };
+    // several items can have the same key, a collision is rare so the entries are not chained
+    typedef std::unordered_multimap<wxUint64, Entry> Entries;
+
+    wxExplorerBrowserItem::List m_items;
+    Entries m_entries;
+
+    static void BuildEntries(const wxExplorerBrowserItem::List& items, Entries& entries);
+    static Entries::const_iterator FindEntry(const Entries& entries, const wxExplorerBrowserItem::List& items,
+                                             const wxExplorerBrowserItem& item, wxUint64 key);
+};
+
+/**
+    A change of an item in the current folder reported by the shell.
+
+    @see wxExplorerBrowserChangeBatcher, wxExplorerBrowser::EnableChangeNotifications()
+*/
+struct wxExplorerBrowserItemChange
+{
+    typedef std::vector<wxExplorerBrowserItemChange> List;
+
+    /**
+        Renamed items are reported as Deleted with the old name
+        and Created with the new one.
+    */
+    enum Type
+    {
+        None     = 0,
+        Created  = 0x01, /*!< item was created */
+        Deleted  = 0x02, /*!< item was deleted */
+        Updated  = 0x04  /*!< item contents or attributes changed, or it was deleted and created again */
+    };
+
+    Type     type {None};
+    wxString path; /*!< filesystem path or parsing name for other items */
+
+    wxExplorerBrowserItemChange() {}
+    wxExplorerBrowserItemChange(Type changeType, const wxString& itemPath)
+        : type(changeType), path(itemPath) {}
+};
+
+/**
+    Collects item changes into batches, merges several changes of the same item
+    into one, and limits the number of changes waiting to be delivered.
+
+    When the limit is exceeded, the individual changes are dropped and only
+    the fact the batch overflowed is remembered, as the whole listing
+    must be retrieved again anyway.
+
+    The owner is expected to call Flush() at the time returned by GetDeadline().
+*/
+class wxExplorerBrowserChangeBatcher
+{
+public:
+    wxExplorerBrowserChangeBatcher() {}
+
+    /**
+        Changes are delivered @a batchDelay milliseconds after the first
+        change in the batch. At most @a maxPending distinct items are kept.
+    */
+    void SetLimits(wxUint64 batchDelay, size_t maxPending);
+
+    /** Adds a change, returns true if it started a new batch. */
+    bool Add(wxExplorerBrowserItemChange::Type type, const wxString& path, wxUint64 now);
+
+    /**
+        The whole folder changed in an unspecified way,
+        the batch is marked as overflowed.
+    */
+    bool AddFolderChange(wxUint64 now);
+
+    bool HasPending() const { return m_hasBatch; }
+
+    /** Returns false if there is nothing to deliver. */
+    bool GetDeadline(wxUint64& deadline) const;
+
+    /**
+        Moves the merged changes to @a changes, in the order the items first changed,
+        and starts a new batch. Returns true if the batch overflowed, in that case
+        @a changes are empty.
+    */
+    bool Flush(wxExplorerBrowserItemChange::List& changes);
+
+    /** Discards all pending changes. */
+    void Clear();
+
+    /** Returns the number of items with pending changes. */
+    size_t GetPendingCount() const { return m_indices.size(); }
+
+    size_t GetMemoryUsage() const;
+
+private:
+    wxUint64 m_batchDelay {200};
+    size_t   m_maxPending {10000};
+
+    bool     m_hasBatch {false};
+    bool     m_overflowed {false};
+    wxUint64 m_batchStart {0};
+
+    wxExplorerBrowserItemChange::List      m_changes; // merged changes, type None when cancelled out
+    std::unordered_map<wxString, size_t, wxStringHash, wxStringEqual> m_indices; // path to m_changes
+
+    void StartBatch(wxUint64 now);
+    void DropChanges();
+};
+
+/**
+    Schedules search queries typed by the user.
+
+    A query is started only after no other query was submitted for the debounce
+    delay, so the queries typed on the way to the final one (usually its prefixes)
+    are never started. A newer query cancels the one in flight, a query identical
+    to the one in flight or the last completed one is not started again.
+
+    Once started, the query is considered in flight until its result count
+    stops changing for the settle delay, or until Complete() is called.
+
+    The owner is expected to call OnTimer() at the time returned by GetDeadline().
+*/
+class wxExplorerBrowserSearchScheduler
+{
+public:
+    /*! What the owner should do after OnTimer() */
+    enum Action
+    {
+        Action_None,     /*!< nothing to do */
+        Action_Start,    /*!< start the query returned by GetInFlightQuery() */
+        Action_Poll,     /*!< call UpdateProgress() with the current result count */
+        Action_Complete  /*!< the query in flight has completed */
+    };
+
+    wxExplorerBrowserSearchScheduler() {}
+
+    void SetDelays(wxUint64 debounceDelay, wxUint64 pollInterval = 100, wxUint64 settleDelay = 500);
+
+    /**
+        Submits a new query. Returns true if it cancelled the query in flight,
+        whose text is then returned in @a cancelledQuery.
+    */
+    bool Submit(const wxString& query, wxUint64 now, wxString* cancelledQuery = nullptr);
+
+    /*! Returns false if no timer is needed. */
+    bool GetDeadline(wxUint64& deadline) const;
+
+    Action OnTimer(wxUint64 now);
+
+    /** Records the current result count, returns true if it changed. */
+    bool UpdateProgress(size_t count, wxUint64 now);
+
+    /** Marks the query in flight as completed. */
+    void Complete();
+
+    /** Cancels the pending query and the one in flight, without remembering them. */
+    void Reset();
+
+    bool HasPending() const { return m_hasPending; }
+    bool IsInFlight() const { return m_inFlight; }
+    const wxString& GetInFlightQuery() const { return m_inFlightQuery; }
+    size_t GetResultCount() const { return m_resultCount; }
+
+    size_t GetMemoryUsage() const;
+
+private:
+    wxUint64 m_debounceDelay {250};
+    wxUint64 m_pollInterval {100};
+    wxUint64 m_settleDelay {500};
+
+    bool     m_hasPending {false};
+    wxString m_pendingQuery;
+    wxUint64 m_pendingSubmitted {0};
+
+    bool     m_inFlight {false};
+    wxString m_inFlightQuery;
+    wxUint64 m_lastPoll {0};
+    wxUint64 m_lastProgress {0}; // when the result count last changed
+    size_t   m_resultCount {0};
+
+    bool     m_hasCompleted {false};
+    wxString m_completedQuery;
+};
+
+/**
+    Feeds a long list of items to a results folder in batches, so that
+    adding many items does not block the UI thread.
+
+    The items are either paths or serialized absolute ID lists, see IsValidIDList().
+    ProcessBatch() passes the queued items to the sink until the batch time
+    elapses, the next batch is due after the batch interval, which lets the
+    owner process the messages and repaint the view in between.
+
+    The owner is expected to call ProcessBatch() at the time returned by GetDeadline().
+*/
+class wxExplorerBrowserResultInjector
+{
+public:
+    /*! The bytes of an absolute ID list, including the terminating zero-sized item. */
+    typedef std::vector<wxUint8> IDList;
+
+    struct Entry
+    {
+        wxString path;  /*!< empty if the entry is an ID list */
+        IDList   idList;
+
+        bool IsIDList() const { return path.empty(); }
+    };
+
+    /*! Adds the item to the results, returns false if it could not be added. */
+    typedef std::function<bool(const Entry& entry)> Sink;
+
+    /*! Returns the current time in milliseconds. */
+    typedef std::function<wxUint64()> Clock;
+
+    wxExplorerBrowserResultInjector() {}
+
+    /**
+        @a batchTime is the longest time in milliseconds a batch should take,
+        a batch always adds at least one item. @a batchInterval is the time
+        in milliseconds between the end of a batch and the start of the next one.
+    */
+    void SetLimits(wxUint64 batchTime = 15, wxUint64 batchInterval = 30);
+
+    /** Queues the items, the first batch is due immediately if none was queued. */
+    void AddPaths(const wxArrayString& paths, wxUint64 now);
+    void AddIDLists(const std::vector<IDList>& idLists, wxUint64 now);
+
+    /*! Returns false if nothing is queued. */
+    bool GetDeadline(wxUint64& deadline) const;
+
+    /**
+        Passes the queued items to @a sink until the batch time elapses
+        or the queue is empty, returns the number of the items processed.
+        The items the sink did not add are counted as failed.
+    */
+    size_t ProcessBatch(const Sink& sink, const Clock& clock);
+
+    /** Drops the queued items, returns their number. */
+    size_t Cancel();
+
+    bool HasPending() const { return m_next < m_entries.size(); }
+    size_t GetPendingCount() const { return m_entries.size() - m_next; }
+
+    /*! The counters are reset when items are queued after the queue was emptied or cancelled. */
+    wxUint64 GetProcessed() const { return m_processed; }
+    wxUint64 GetFailed() const { return m_failed; }
+    wxUint64 GetTotal() const { return m_total; }
+
+    size_t GetMemoryUsage() const;
+
+    /**
+        Returns true if @a idList consists of complete items
+        and ends with the terminating zero-sized item.
+    */
+    static bool IsValidIDList(const IDList& idList);
+
+private:
+    wxUint64 m_batchTime {15};
+    wxUint64 m_batchInterval {30};
+
+    std::vector<Entry> m_entries;
+    size_t             m_next {0};  // the first entry not yet processed
+    wxUint64           m_nextBatch {0};
+
+    wxUint64 m_processed {0};
+    wxUint64 m_failed {0};
+    wxUint64 m_total {0};
+
+    void PrepareAdd(size_t count, wxUint64 now);
+};
+
+/**
+    A thread-safe, memory-bounded cache of items, shared by all
+    wxExplorerBrowser instances in the process which use it.
+
+    The items are keyed by a hash of their absolute ID list and belong to a folder,
+    also identified by a hash. Invalidating a folder increments its generation,
+    which makes all the cached items of the folder stale, without having to find them.
+
+    The cache is split into shards, each with its own lock and its own share
+    of the memory limit. Least recently used items of a shard are evicted
+    when the shard exceeds its share.
+
+    @see wxExplorerBrowser::UseSharedItemCache()
+*/
+class wxExplorerBrowserItemCache
+{
+public:
+    /*! The default memory limit in bytes. */
+    static const size_t DefaultMaxMemory = 32 * 1024 * 1024;
+
+    wxExplorerBrowserItemCache(size_t maxMemory = DefaultMaxMemory);
+
+    /** Returns the process-wide instance. */
+    static wxExplorerBrowserItemCache& Get();
+
+    /** Sets the approximate memory limit in bytes, evicting the items over it. */
+    void SetMaxMemory(size_t maxMemory);
+    size_t GetMaxMemory() const { return m_maxMemory; }
+
+    /** Returns true and fills @a item if a valid item with @a itemKey is cached. */
+    bool Lookup(wxUint64 itemKey, wxExplorerBrowserItem& item);
+
+    /** Adds or replaces the item with @a itemKey which is a child of @a folderKey. */
+    void Insert(wxUint64 itemKey, wxUint64 folderKey, const wxExplorerBrowserItem& item);
+
+    /** Makes all cached items of the folder stale. */
+    void InvalidateFolder(wxUint64 folderKey);
+
+    /**
+        Evicts the least recently used items until at most @a memory bytes
+        are used, without changing the memory limit.
+    */
+    void Shrink(size_t memory);
+
+    void Clear();
+
+    /*! Returns the approximate memory used by the cached items in bytes. */
+    size_t GetMemoryUsage() const;
+    size_t GetCount() const;
+
+    wxUint64 GetHitCount() const { return m_hits.load(std::memory_order_relaxed); }
+    wxUint64 GetMissCount() const { return m_misses.load(std::memory_order_relaxed); }
+
+    /*! Returns the approximate memory needed to cache @a item. */
+    static size_t GetItemMemory(const wxExplorerBrowserItem& item);
+
+private:
+    enum
+    {
+        ShardCount = 32,
+        GenerationCount = 4096 // folders sharing a slot just get invalidated together
+    };
+
+    struct Entry
+    {
+        wxExplorerBrowserItem item;
+        wxUint64 folderKey;
+        wxUint64 generation;
+        size_t   memory;
+        std::list<wxUint64>::iterator lruPos;
+    };
+
+    struct Shard
+    {
+        mutable std::mutex mutex;
+        std::unordered_map<wxUint64, Entry> entries;
+        std::list<wxUint64> lru; // most recently used first
+        size_t memory {0};
+    };
+
+    Shard m_shards[ShardCount];
+    std::atomic<wxUint64> m_generations[GenerationCount];
+    std::atomic<size_t> m_maxMemory;
+    std::atomic<wxUint64> m_hits;
+    std::atomic<wxUint64> m_misses;
+
+    Shard& GetShard(wxUint64 itemKey) { return m_shards[itemKey % ShardCount]; }
+    wxUint64 GetGeneration(wxUint64 folderKey) const
+        { return m_generations[folderKey % GenerationCount].load(std::memory_order_acquire); }
+
+    void Erase(Shard& shard, std::unordered_map<wxUint64, Entry>::iterator it);
+    void Trim(Shard& shard, size_t maxMemory);
+
+    wxDECLARE_NO_COPY_CLASS(wxExplorerBrowserItemCache);
+};
+
+/**
+    Keeps track of parked, i.e. hidden but still alive, views and decides
+    which of them must be torn down to stay within the budget.
+
+    The budget limits the number of the parked views and their total
+    estimated memory, 0 means no limit. When it is exceeded, the views
+    parked the longest time ago are evicted first.
+
+    The views are identified by an opaque pointer, the lot does not
+    own or access them.
+
+    @see wxExplorerBrowser::Park()
+*/
+class wxExplorerBrowserParkingLot
+{
+public:
+    typedef const void* ViewId;
+    typedef std::vector<ViewId> ViewIdList;
+
+    /*! The default maximum number of parked views. */
+    static const size_t DefaultMaxViews = 4;
+
+    wxExplorerBrowserParkingLot(size_t maxViews = DefaultMaxViews, size_t maxMemory = 0)
+        : m_maxViews(maxViews), m_maxMemory(maxMemory)
+    {}
+
+    /** Sets the budget, the views over it are appended to @a evicted. */
+    void SetBudget(size_t maxViews, size_t maxMemory, ViewIdList& evicted);
+    size_t GetMaxViews() const { return m_maxViews; }
+    size_t GetMaxMemory() const { return m_maxMemory; }
+
+    /**
+        Parks the view, parking an already parked view updates its memory
+        and makes it the most recently parked one. The views which had to be
+        evicted, possibly including @a view itself, are appended to @a evicted.
+    */
+    void Park(ViewId view, size_t memory, ViewIdList& evicted);
+
+    /** Returns false if the view was not parked, e.g. it was evicted. */
+    bool Unpark(ViewId view);
+
+    bool IsParked(ViewId view) const { return m_index.find(view) != m_index.end(); }
+
+    size_t GetCount() const { return m_views.size(); }
+    size_t GetMemory() const { return m_memory; }
+
+private:
+    struct View
+    {
+        ViewId id;
+        size_t memory;
+    };
+
+    std::list<View> m_views; // the least recently parked first
+    std::unordered_map<ViewId, std::list<View>::iterator> m_index;
+
+    size_t m_maxViews;
+    size_t m_maxMemory;
+    size_t m_memory {0};
+
+    bool IsOverBudget() const;
+    void Evict(ViewIdList& evicted);
+};
+
+/**
+    Hands out immutable, reference-counted copies of items, reusing those
+    no longer referenced by anyone, together with their string buffers.
+
+    When the last reference to an item is released, in whichever thread,
+    the item is returned to the pool explicitly by the deleter of its pointer,
+    the pool never inspects the reference counts. So the pool and the items
+    can be used from any threads, and the items can outlive the pool.
+*/
+class wxExplorerBrowserItemPool
+{
+public:
+    typedef std::shared_ptr<const wxExplorerBrowserItem> ItemPtr;
+
+    /*! At most @a maxItems released items are kept for reuse. */
+    wxExplorerBrowserItemPool(size_t maxItems = 16);
+
+    /** Returns a copy of @a item. */
+    ItemPtr Acquire(const wxExplorerBrowserItem& item);
+
+    /*! Returns the number of the released items waiting to be reused. */
+    size_t GetCount() const;
+
+private:
+    class FreeList; // shared with the deleters of the items
+    std::shared_ptr<FreeList> m_freeList;
+
+    wxDECLARE_NO_COPY_CLASS(wxExplorerBrowserItemPool);
+};
+
+/**
+    A thread-safe free list of memory blocks of the same size,
+    used to implement class-specific operator new and delete.
+*/
+class wxExplorerBrowserBlockPool
+{
+public:
+    wxExplorerBrowserBlockPool(size_t blockSize, size_t maxFreeBlocks = 64)
+        : m_blockSize(blockSize), m_maxFreeBlocks(maxFreeBlocks)
+    {
+        m_freeBlocks.reserve(maxFreeBlocks);
+    }
+    ~wxExplorerBrowserBlockPool();
+
+    size_t GetBlockSize() const { return m_blockSize; }
+
+    void* Allocate();
+    void Free(void* block);
+
+private:
+    const size_t m_blockSize;
+    const size_t m_maxFreeBlocks;
+
+    std::mutex m_mutex;
+    std::vector<void*> m_freeBlocks;
+
+    wxDECLARE_NO_COPY_CLASS(wxExplorerBrowserBlockPool);
+};
+
+/**
+    A fixed set of worker threads running the tasks of the parallel algorithms,
+    so that no threads are created for their calls.
+
+    The thread calling Run() runs the tasks too and the workers only help it,
+    so Run() can also be called from a task or when all the workers are busy.
+*/
+class wxExplorerBrowserThreadPool
+{
+public:
+    /*! 0 means one worker per core, less one for the thread calling Run(). */
+    explicit wxExplorerBrowserThreadPool(unsigned workerCount = 0);
+    /*! Waits for the tasks being run and stops the workers. */
+    ~wxExplorerBrowserThreadPool();
+
+    /** Returns the process-wide instance used by the parallel algorithms, it is never destroyed. */
+    static wxExplorerBrowserThreadPool& Get();
+
+    unsigned GetWorkerCount() const { return static_cast<unsigned>(m_workers.size()); }
+
+    /**
+        Calls @a func for every task in [0, @a taskCount), in the calling thread
+        and in up to @a maxWorkers idle workers, which take the tasks one by one.
+        Returns after all the calls finished.
+    */
+    void Run(size_t taskCount, const std::function<void(size_t task)>& func, unsigned maxWorkers = UINT_MAX);
+
+private:
+    struct Job;
+
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::shared_ptr<Job>> m_jobs; // an entry asks one worker to help with the job
+    bool m_stopping {false};
+
+    void WorkerMain();
+    static void RunTasks(Job& job);
+
+    wxDECLARE_NO_COPY_CLASS(wxExplorerBrowserThreadPool);
+};
+
+/**
+    Calls @a func for consecutive ranges [begin, end) covering [0, @a count),
+    in parallel in up to @a threadCount threads, 0 means one per core.
+    The threads are those of wxExplorerBrowserThreadPool::Get() and the calling one.
+    Ranges shorter than @a minRangeSize are not split any further.
+    Returns after all the calls finished.
+*/
+void wxExplorerBrowserParallelFor(size_t count, const std::function<void(size_t begin, size_t end)>& func,
+                                  unsigned threadCount = 0, size_t minRangeSize = 4096);
+
+/**
+    Like wxExplorerBrowserParallelFor(), but the ranges are chunks of @a chunkSize
+    elements, which the threads take one by one until none is left. This balances
+    the load when the time needed for an element varies a lot, e.g., with I/O.
+*/
+void wxExplorerBrowserParallelForChunks(size_t count, size_t chunkSize,
+                                        const std::function<void(size_t begin, size_t end)>& func,
+                                        unsigned threadCount = 0);
+
+/**
+    Sorts [first, last) with @a comp like std::sort(): the ranges
+    are sorted in parallel and then merged, also in parallel.
+    The sort is not stable.
+*/
+template <typename RandomIt, typename Compare>
+void wxExplorerBrowserParallelSort(RandomIt first, RandomIt last, Compare comp,
+                                   unsigned threadCount = 0, size_t minRangeSize = 16384)
+{
+    const size_t count = static_cast<size_t>(last - first);
+
+    if ( !threadCount )
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    size_t rangeCount = std::min<size_t>(threadCount, count / std::max<size_t>(minRangeSize, 1));
+
+    if ( rangeCount < 2 )
+    {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    std::vector<size_t> bounds;
+
+    for ( size_t i = 0; i <= rangeCount; ++i )
+        bounds.push_back(count * i / rangeCount);
+
+    wxExplorerBrowserParallelFor(rangeCount, [&](size_t begin, size_t end)
+        {
+            for ( size_t i = begin; i < end; ++i )
+                std::sort(first + bounds[i], first + bounds[i + 1], comp);
+        }, threadCount, 1);
+
+    // merge the neighbouring ranges until only one remains
+    while ( bounds.size() > 2 )
+    {
+        const size_t mergeCount = (bounds.size() - 1) / 2;
+
+        wxExplorerBrowserParallelFor(mergeCount, [&](size_t begin, size_t end)
+            {
+                for ( size_t i = begin; i < end; ++i )
+                    std::inplace_merge(first + bounds[2 * i], first + bounds[2 * i + 1],
+                                       first + bounds[2 * i + 2], comp);
+            }, threadCount, 1);
+
+        std::vector<size_t> merged;
+
+        for ( size_t i = 0; i < bounds.size(); i += 2 )
+            merged.push_back(bounds[i]);
+        if ( merged.back() != bounds.back() )
+            merged.push_back(bounds.back());
+
+        bounds.swap(merged);
+    }
+}
+
+/**
+    Destroys objects on its own thread and returns immediately, for the objects
+    whose destructor waits for their background threads, e.g., a cancelled
+    wxExplorerBrowserFolderSizer, which can take a while to notice the
+    cancellation when the file system is slow.
+
+    Unlike a detached thread, the thread is joined by Shutdown(), so that no
+    destruction is still running when the program or the library unloads.
+*/
+class wxExplorerBrowserReaper
+{
+public:
+    wxExplorerBrowserReaper() {}
+    /*! Calls Shutdown(). */
+    ~wxExplorerBrowserReaper();
+
+    /**
+        Destroys @a object on the thread of the reaper, started when first needed.
+        After Shutdown(), the object is destroyed in the calling thread.
+    */
+    template <typename T>
+    void Destroy(std::unique_ptr<T> object)
+    {
+        if ( object )
+            Add(std::shared_ptr<void>(std::move(object)));
+    }
+
+    /** Waits until the objects given so far are destroyed and joins the thread. */
+    void Shutdown();
+
+    /** Returns the number of the objects not destroyed yet. */
+    size_t GetPendingCount() const;
+
+private:
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::shared_ptr<void>> m_objects;
+    size_t m_destroyingCount {0};
+    std::thread m_thread;
+    bool m_shutDown {false};
+
+    void Add(std::shared_ptr<void> object);
+    void ThreadMain();
+
+    wxDECLARE_NO_COPY_CLASS(wxExplorerBrowserReaper);
+};
+
+/**
+    A thread running the tasks posted to it one by one, in the order they were
+    posted, for the blocking work which must not hold up the UI thread nor the
+    workers of wxExplorerBrowserThreadPool, e.g., fetching the item properties.
+
+    Unlike a detached thread, it is joined by Stop() and the destructor, which
+    wait for the task being run, so a long task should check a cancellation flag.
+    The thread waits for the tasks without processing any messages,
+    so a task using COM must not enter a single-threaded apartment.
+*/
+class wxExplorerBrowserWorkerThread
+{
+public:
+    wxExplorerBrowserWorkerThread() {}
+    /*! Calls Stop(). */
+    ~wxExplorerBrowserWorkerThread();
+
+    /** Queues @a task, the thread is started when first needed. */
+    void Post(std::function<void()> task);
+
+    /**
+        Drops the tasks not started yet, waits for the one being run and joins
+        the thread. A task posted afterwards starts the thread again.
+    */
+    void Stop();
+
+    /** Returns true if no task is being run or waiting to be run. */
+    bool IsIdle() const;
+
+private:
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::function<void()>> m_tasks;
+    bool m_running {false};
+    bool m_stopping {false};
+    std::thread m_thread;
+
+    void ThreadMain();
+
+    wxDECLARE_NO_COPY_CLASS(wxExplorerBrowserWorkerThread);
+};
+
+/**
+    Sorts items by precomputed collation keys.
+*/
+class wxExplorerBrowserItemSorter
+{
+public:
+    enum Order
+    {
+        Order_Name,    /*!< by display name, case-insensitive */
+        Order_Path,    /*!< by path, case-insensitive, the items without one come first */
+        Order_Type,    /*!< by type (Directory, File, Other) and then in the natural order of display names */
+        Order_Natural  /*!< by display name, numbers compared numerically, case-insensitive, like Explorer */
+    };
+
+    /**
+        Sorts @a items, the keys are computed and the items sorted
+        in up to @a threadCount threads, 0 means one per core.
+        Items with the same key keep their order.
+    */
+    static void Sort(wxExplorerBrowserItem::List& items, Order order, unsigned threadCount = 0);
+
+    /**
+        Returns the key of @a str which compares in the natural order: case-insensitive,
+        runs of digits compared by their numeric value and sorted before other characters.
+    */
+    static std::u32string MakeNaturalKey(const wxString& str);
+
+    /** Returns lowercase @a str. */
+    static std::u32string MakeCaseInsensitiveKey(const wxString& str);
+
+    static std::u32string MakeKey(const wxExplorerBrowserItem& item, Order order);
+};
+
+/**
+    Matches items against wild-card masks such as "*.jpg" or "budget201*.*",
+    case-insensitively. The masks are matched against the filename part
+    of the path of File and Directory items and against the display name
+    of the other items.
+
+    @see wxExplorerBrowser::SetFilter(), wxExplorerBrowser::SelectWhere()
+*/
+class wxExplorerBrowserMaskMatcher
+{
+public:
+    wxExplorerBrowserMaskMatcher() {}
+    wxExplorerBrowserMaskMatcher(const wxArrayString& masks, wxUint32 itemTypes) { Set(masks, itemTypes); }
+
+    /** Replaces the masks, they apply only to the items with type matching @a itemTypes. */
+    void Set(const wxArrayString& masks, wxUint32 itemTypes);
+
+    /** Adds the masks to the current ones, all of them then apply to the items matching @a itemTypes. */
+    void Add(const wxArrayString& masks, wxUint32 itemTypes);
+
+    void Clear();
+
+    bool IsEmpty() const { return m_masks.empty(); }
+    const wxArrayString& GetMasks() const { return m_masks; } // uppercase
+    wxUint32 GetItemTypes() const { return m_itemTypes; }
+
+    /** Returns true if the masks apply to the items of @a type. */
+    bool AppliesTo(wxExplorerBrowserItem::Type type) const { return (type & m_itemTypes) != 0; }
+
+    /**
+        Returns true if the name of the item matches any of the masks, regardless of its type.
+        @a buffer is used for the uppercase name, so that it can be reused for many items.
+    */
+    bool MatchesName(const wxExplorerBrowserItem& item, wxString& buffer) const;
+
+    /** As MatchesName(), for the filename of a File or Directory item. */
+    bool MatchesFileName(const wxString& name, wxString& buffer) const;
+
+    size_t GetMemoryUsage() const { return wxExplorerBrowserGetMemoryUsage(m_masks); }
+
+    /** Sets @a name to the uppercase name of @a item the masks are matched against. */
+    static void GetMatchName(const wxExplorerBrowserItem& item, wxString& name);
+
+    /**
+        Sets @a name to the filename part of the path of a File or Directory item
+        and to the display name of the other items.
+    */
+    static void GetItemName(const wxExplorerBrowserItem& item, wxString& name);
+
+private:
+    wxArrayString m_masks;
+    wxUint32      m_itemTypes {0};
+
+    bool MatchesUpperName(const wxString& name) const;
+};
+
+/**
+    A decoded thumbnail image, its pixels are RGBA rows from top to bottom,
+    with the alpha not premultiplied.
+*/
+struct wxExplorerBrowserThumbnail
+{
+    typedef std::shared_ptr<const wxExplorerBrowserThumbnail> Ptr;
+
+    unsigned width {0};
+    unsigned height {0};
+    std::vector<wxUint8> pixels;
+
+    size_t GetMemoryUsage() const { return sizeof(*this) + pixels.capacity(); }
+};
+
+/**
+    Extracts thumbnails on a pool of worker threads and keeps
+    the decoded ones in a memory-bounded LRU cache.
+
+    The thumbnails are identified by the item id and the requested size.
+    Requesting a thumbnail which is already queued or being extracted does not
+    queue it again. The most recently requested thumbnails are extracted first,
+    as they are the most likely to be still needed.
+
+    The decoder and the ready callback are called on the worker threads,
+    with an item which does not share its strings with the requested one.
+    The workers wait for the requests without processing any messages,
+    so a decoder using COM must not enter a single-threaded apartment.
+    The workers are started with the first request and stopped in the destructor,
+    which waits for the running extractions to finish.
+*/
+class wxExplorerBrowserThumbnailService
+{
+public:
+    /*! The default memory limit in bytes. */
+    static const size_t DefaultMaxMemory = 64 * 1024 * 1024;
+
+    struct Key
+    {
+        wxUint64 itemId;
+        unsigned size;
+
+        bool operator==(const Key& other) const { return itemId == other.itemId && size == other.size; }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const
+            { return static_cast<size_t>(key.itemId ^ (key.size * 0x9E3779B97F4A7C15ull)); }
+    };
+
+    /*! Fills @a thumbnail, no larger than @a size in either dimension, returns false on failure. */
+    typedef std::function<bool(const wxExplorerBrowserItem& item, unsigned size,
+                               wxExplorerBrowserThumbnail& thumbnail)> Decoder;
+
+    /*! @a thumbnail is null if the extraction failed. */
+    typedef std::function<void(const wxExplorerBrowserItem& item, unsigned size,
+                               const wxExplorerBrowserThumbnail::Ptr& thumbnail)> ReadyCallback;
+
+    /** If @a threadCount is 0, up to four threads are used, depending on the number of cores. */
+    wxExplorerBrowserThumbnailService(const Decoder& decoder, const ReadyCallback& onReady,
+                                      size_t maxMemory = DefaultMaxMemory, unsigned threadCount = 0);
+    ~wxExplorerBrowserThumbnailService();
+
+    /** Uses the id of @a item if it has one, otherwise a hash of its path. */
+    static Key MakeKey(const wxExplorerBrowserItem& item, unsigned size);
+
+    /** Returns true and sets @a thumbnail if it is cached. */
+    bool Lookup(const Key& key, wxExplorerBrowserThumbnail::Ptr& thumbnail);
+
+    /**
+        Returns true and sets @a thumbnail if it is cached, otherwise queues
+        its extraction unless it is already in flight and returns false.
+    */
+    bool Request(const wxExplorerBrowserItem& item, unsigned size, wxExplorerBrowserThumbnail::Ptr& thumbnail);
+
+    /** Drops the queued requests, returns their number. Running extractions are not affected. */
+    size_t CancelPending();
+
+    /** Sets the approximate memory limit in bytes, evicting the thumbnails over it. */
+    void SetMaxMemory(size_t maxMemory);
+    size_t GetMaxMemory() const;
+
+    /**
+        Evicts the least recently used thumbnails until at most @a memory bytes
+        are used, without changing the memory limit.
+    */
+    void Shrink(size_t memory);
+
+    void Clear();
+
+    size_t GetMemoryUsage() const;
+    size_t GetCount() const;
+    size_t GetPendingCount() const;
+    /*! Returns the number of the thumbnails queued or being extracted. */
+    size_t GetInFlightCount() const;
+    unsigned GetThreadCount() const { return m_threadCount; }
+
+private:
+    struct Task
+    {
+        Key key;
+        wxExplorerBrowserItem item;
+    };
+
+    struct Entry
+    {
+        wxExplorerBrowserThumbnail::Ptr thumbnail;
+        std::list<Key>::iterator lruPos;
+    };
+
+    const Decoder       m_decoder;
+    const ReadyCallback m_onReady;
+    const unsigned      m_threadCount;
+
+    mutable std::mutex      m_mutex;
+    std::condition_variable m_wakeUp;
+    std::deque<Task>        m_tasks; // the most recent request last
+    std::unordered_set<Key, KeyHash> m_inFlight;
+    std::vector<std::thread> m_threads;
+    bool m_stopping {false};
+
+    std::unordered_map<Key, Entry, KeyHash> m_entries;
+    std::list<Key> m_lru; // most recently used first
+    size_t m_memory {0};
+    size_t m_maxMemory;
+
+    void WorkerMain();
+    void InsertLocked(const Key& key, const wxExplorerBrowserThumbnail::Ptr& thumbnail);
+    void ShrinkLocked(size_t memory);
+
+    wxDECLARE_NO_COPY_CLASS(wxExplorerBrowserThumbnailService);
+};
+
+/**
+    A disk-backed store of thumbnails in a single memory-mapped file,
+    so that the thumbnails survive restarting the application.
+
+    The thumbnails are keyed by the identity of the item, its modification time
+    and the requested size, so a modified item just gets a new thumbnail.
+    The records are only appended, each with a checksum of its header and of its
+    pixels, and the index is rebuilt from the valid records when the file is opened.
+    A record torn by a crash is therefore ignored, and so are the records after it.
+
+    When the file would exceed its maximum size, it is compacted, keeping the most
+    recently used thumbnails up to three quarters of the size. The compacted file
+    is written next to the original one and replaces it only when complete.
+
+    The store can be used from several threads.
+*/
+class wxExplorerBrowserThumbnailStore
+{
+public:
+    /*! The version of the file format. */
+    static const wxUint32 Version = 2;
+
+    /*! The default maximum file size in bytes. */
+    static const size_t DefaultMaxSize = 256 * 1024 * 1024;
+
+    struct Key
+    {
+        wxUint64 itemKey;           /*!< identifies the item, see MakeKey() */
+        wxUint64 itemCheck;         /*!< an independent hash of the same, so that a collision of the keys is harmless */
+        wxUint64 modificationTime;  /*!< in any units, must change when the item changes */
+        wxUint32 size;              /*!< the requested thumbnail size */
+
+        bool operator==(const Key& other) const
+            { return itemKey == other.itemKey && itemCheck == other.itemCheck
+                     && modificationTime == other.modificationTime && size == other.size; }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const
+            { return static_cast<size_t>(key.itemKey ^ (key.modificationTime * 31) ^ (key.size * 0x9E3779B97F4A7C15ull)); }
+    };
+
+    /**
+        The item is identified by two different hashes of its path, so that
+        a thumbnail is never served for another item with the same item key.
+    */
+    static Key MakeKey(const wxExplorerBrowserItem& item, wxUint64 modificationTime, unsigned size);
+
+    wxExplorerBrowserThumbnailStore() {}
+    ~wxExplorerBrowserThumbnailStore() { Close(); }
+
+    /** Opens the store, creating the file if it does not exist or is not a thumbnail store. */
+    bool Open(const wxString& fileName, size_t maxSize = DefaultMaxSize);
+    /** Flushes and closes the file. */
+    void Close();
+    bool IsOpened() const;
+
+    /** Compacts the file immediately if it exceeds the new maximum size. */
+    bool SetMaxSize(size_t maxSize);
+
+    /**
+        Returns true and fills @a thumbnail if a valid thumbnail is stored,
+        also making it the most recently used one.
+    */
+    bool Lookup(const Key& key, wxExplorerBrowserThumbnail& thumbnail);
+
+    /** Stores the thumbnail, replacing the one with the same key. */
+    bool Insert(const Key& key, const wxExplorerBrowserThumbnail& thumbnail);
+
+    /** Keeps the most recently used thumbnails up to @a size bytes. */
+    bool Compact(size_t size);
+
+    /** Writes the data to the disk, otherwise it is written when the system decides to. */
+    bool Flush();
+
+    size_t GetCount() const;
+    /*! Returns the size of the file used by the records, including the replaced ones. */
+    size_t GetUsedSize() const;
+
+private:
+    struct IndexEntry
+    {
+        size_t offset;
+        size_t size;
+    };
+
+    typedef std::unordered_map<Key, IndexEntry, KeyHash> Index;
+
+    mutable std::mutex m_mutex;
+    wxString m_fileName;
+    wxExplorerBrowserMappedFile m_file;
+    size_t   m_maxSize {DefaultMaxSize};
+    size_t   m_end {0};          // where the next record is appended
+    wxUint64 m_lastAccess {0};   // a counter rather than time, increments with each use
+    Index    m_index;
+
+    bool OpenLocked();
+    bool Create();
+    void Load();
+    bool CompactLocked(size_t size);
+    bool Reserve(size_t size);
+    bool IsPayloadValid(const IndexEntry& entry) const;
+
+    wxDECLARE_NO_COPY_CLASS(wxExplorerBrowserThumbnailStore);
+};
+
+/**
+    Properties of a list of items, stored in columns: one vector per property,
+    with the element for each item at the item's index.
+    Only the requested properties have their columns filled.
+*/
+class wxExplorerBrowserItemProperties
+{
+public:
+    enum Property
+    {
+        Property_Size             = 0x01, /*!< GetSizes(), in bytes */
+        Property_ModificationTime = 0x02, /*!< GetModificationTimes() */
+        Property_CreationTime     = 0x04, /*!< GetCreationTimes() */
+        Property_Attributes       = 0x08, /*!< GetAttributes(), the file attributes */
+        Property_TypeName         = 0x10, /*!< GetTypeNames(), e.g. "Text Document" */
+
+        Property_All = Property_Size | Property_ModificationTime | Property_CreationTime
+                       | Property_Attributes | Property_TypeName
+    };
+
+    wxExplorerBrowserItemProperties() {}
+
+    /** Sets the number of items and the properties, the columns are zeroed. */
+    void Reset(size_t count, wxUint32 properties);
+    void Clear() { Reset(0, 0); }
+
+    size_t GetCount() const { return m_fetched.size(); }
+    wxUint32 GetProperties() const { return m_properties; }
+
+    /*! Returns the properties which were obtained for the item, a subset of GetProperties(). */
+    wxUint32 GetFetched(size_t index) const { return m_fetched[index]; }
+    void SetFetched(size_t index, wxUint32 properties) { m_fetched[index] = static_cast<wxUint8>(properties); }
+
+    /*! The times are in 100-nanosecond intervals since January 1, 1601 (UTC), as FILETIME. */
+    const std::vector<wxUint64>& GetModificationTimes() const { return m_modificationTimes; }
+    std::vector<wxUint64>& GetModificationTimes() { return m_modificationTimes; }
+    const std::vector<wxUint64>& GetCreationTimes() const { return m_creationTimes; }
+    std::vector<wxUint64>& GetCreationTimes() { return m_creationTimes; }
+
+    const std::vector<wxUint64>& GetSizes() const { return m_sizes; }
+    std::vector<wxUint64>& GetSizes() { return m_sizes; }
+    const std::vector<wxUint32>& GetAttributes() const { return m_attributes; }
+    std::vector<wxUint32>& GetAttributes() { return m_attributes; }
+    const std::vector<wxString>& GetTypeNames() const { return m_typeNames; }
+    std::vector<wxString>& GetTypeNames() { return m_typeNames; }
+
+    size_t GetMemoryUsage() const;
+
+private:
+    wxUint32 m_properties {0};
+    std::vector<wxUint8>  m_fetched;
+    std::vector<wxUint64> m_sizes;
+    std::vector<wxUint64> m_modificationTimes;
+    std::vector<wxUint64> m_creationTimes;
+    std::vector<wxUint32> m_attributes;
+    std::vector<wxString> m_typeNames;
+};
+
+/**
+    Orders pending work on the items of a view by their distance from
+    the visible range of the view: the visible items come first, from the
+    top, then the nearby items, closest first, then the rest.
+
+    The items are identified by their index in the view. When the visible
+    range changes, the pending items farther than the cancel distance from it
+    are dropped, the owner is expected to cancel the work it started for them.
+*/
+class wxExplorerBrowserViewportScheduler
+{
+public:
+    enum Priority
+    {
+        Priority_Visible,  /*!< in the visible range */
+        Priority_Nearby,   /*!< within the nearby distance of the visible range */
+        Priority_Far       /*!< the rest */
+    };
+
+    wxExplorerBrowserViewportScheduler() {}
+
+    /**
+        Sets the distances, in items, from the visible range.
+        0 for @a nearbyDistance means the size of the visible range
+        and 0 for @a cancelDistance means that no items are dropped.
+    */
+    void SetDistances(size_t nearbyDistance, size_t cancelDistance);
+
+    /**
+        Sets the visible range of @a count items starting at @a first and drops
+        the pending items farther than the cancel distance from it, returning
+        their number. The dropped items are appended to @a cancelled, if not null.
+    */
+    size_t SetViewport(size_t first, size_t count, std::vector<size_t>* cancelled = nullptr);
+
+    size_t GetViewportFirst() const { return m_first; }
+    size_t GetViewportCount() const { return m_count; }
+
+    /** Queues work for the item, returns false if it was already pending. */
+    bool Add(size_t index);
+    /** Queues work for @a count items starting at @a first. */
+    void AddRange(size_t first, size_t count);
+    bool Remove(size_t index);
+    void Clear() { m_pending.clear(); }
+
+    /** Removes the pending item with the highest priority and returns it in @a index. */
+    bool Next(size_t& index);
+
+    /**
+        Removes all pending items, appending them to @a indices in the order
+        Next() would return them, and returns the number of the visible ones,
+        which come first.
+    */
+    size_t TakeAll(std::vector<size_t>& indices);
+
+    /** Returns 0 for the visible items. */
+    size_t GetDistance(size_t index) const;
+    Priority GetPriority(size_t index) const;
+
+    bool IsPending(size_t index) const { return m_pending.find(index) != m_pending.end(); }
+    bool HasPending() const { return !m_pending.empty(); }
+    size_t GetPendingCount() const { return m_pending.size(); }
+
+    size_t GetMemoryUsage() const;
+
+private:
+    size_t m_first {0};
+    size_t m_count {0};
+    size_t m_nearbyDistance {0};
+    size_t m_cancelDistance {0};
+
+    // ordered by index, so that the items closest to the visible range
+    // are found with a lookup on either side of it
+    std::set<size_t> m_pending;
+};
+
+/**
+    Walks directory trees in parallel. Each worker thread has its own queue
+    of the directories to enumerate: it takes the most recently queued one from
+    its own queue and, when the queue is empty, steals the oldest one from the
+    queue of another worker, so the work spreads over the threads whatever
+    the shape of the trees.
+
+    The entries are enumerated natively, with FindFirstFileEx() and the large
+    fetch on Windows and with getdents64() and a large buffer on Linux.
+    Symbolic links and junctions are reported but not followed.
+*/
+class wxExplorerBrowserDirectoryWalker
+{
+public:
+#ifdef __WINDOWS__
+    typedef wchar_t NativeChar;
+#else
+    typedef char NativeChar;
+#endif
+    typedef std::basic_string<NativeChar> NativeString;
+
+    typedef std::atomic<bool> CancelFlag;
+
+    struct Entry
+    {
+        const NativeString* directory {nullptr}; // ends with the path separator
+        const NativeChar*   name {nullptr};      // not null-terminated
+        size_t              nameLength {0};
+        unsigned            depth {0};           // 1 for the entries of a root
+        bool                isDirectory {false};
+        bool                isLink {false};      // a symbolic link or junction
+        // unless SetFileInfoNeeded(false) was called, 0 for directories
+        wxUint64            size {0};
+        // in 100-nanosecond intervals since January 1, 1601 (UTC), as FILETIME
+        wxUint64            modificationTime {0};
+
+        wxString GetName() const;
+        wxString GetPath() const;
+    };
+
+    /**
+        Called on worker @a threadIndex for each entry, concurrently on the workers.
+        For a directory, returns true to walk it.
+    */
+    typedef std::function<bool(unsigned threadIndex, const Entry& entry)> Visitor;
+
+    /**
+        If @a threadCount is 0, it is twice the number of cores,
+        as the walk mostly waits for the file system.
+    */
+    explicit wxExplorerBrowserDirectoryWalker(unsigned threadCount = 0);
+
+    unsigned GetThreadCount() const { return m_threadCount; }
+
+    /** The depth of the directories walked, 0 means no limit and 1 only the roots. */
+    void SetMaxDepth(unsigned maxDepth) { m_maxDepth = maxDepth; }
+    unsigned GetMaxDepth() const { return m_maxDepth; }
+
+    /**
+        The size and the modification time of the entries are not needed,
+        which saves a call per entry on the platforms where enumerating
+        does not provide them.
+    */
+    void SetFileInfoNeeded(bool needed) { m_fileInfoNeeded = needed; }
+
+    /**
+        Walks the trees of @a roots on the worker threads, the calling thread
+        being one of them, and returns when done. Returns false if it was
+        stopped by setting @a cancel.
+    */
+    bool Walk(const wxArrayString& roots, const Visitor& visitor, const CancelFlag* cancel = nullptr);
+
+    /*! These can be called during the walk from any thread. */
+    wxUint64 GetDirectoryCount() const { return m_directoryCount; }
+    /*! The number of directories which could not be enumerated. */
+    wxUint64 GetErrorCount() const { return m_errorCount; }
+
+    /** Returns @a path with the path separator appended. */
+    static NativeString ToNative(const wxString& path);
+
+private:
+    struct Task
+    {
+        NativeString path;
+        unsigned     depth {0};
+    };
+
+    struct Worker
+    {
+        std::mutex       lock;
+        std::deque<Task> tasks;
+    };
+
+    unsigned m_threadCount {1};
+    unsigned m_maxDepth {0};
+    bool     m_fileInfoNeeded {true};
+
+    std::atomic<wxUint64> m_directoryCount {0};
+    std::atomic<wxUint64> m_errorCount {0};
+
+    // the state of the walk in progress
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<size_t> m_unfinishedTasks {0}; // queued or being enumerated
+    std::atomic<size_t> m_queuedTasks {0};
+    std::atomic<size_t> m_idleWorkers {0};
+    std::mutex          m_idleLock;
+    std::condition_variable m_idleCondition;
+    const Visitor*      m_visitor {nullptr};
+    const CancelFlag*   m_cancel {nullptr};
+
+    bool IsCancelled() const { return m_cancel && m_cancel->load(std::memory_order_relaxed); }
+
+    void RunWorker(unsigned threadIndex);
+    bool TakeTask(unsigned threadIndex, Task& task);
+    void QueueTasks(unsigned threadIndex, std::vector<Task>& tasks);
+    bool Enumerate(unsigned threadIndex, const Task& task, std::vector<char>& buffer, std::vector<Task>& subdirectories);
+
+    wxDECLARE_NO_COPY_CLASS(wxExplorerBrowserDirectoryWalker);
+};
+
+/**
+    Computes the total size of the files in directory trees and the numbers of
+    the files and the subdirectories in them, with wxExplorerBrowserDirectoryWalker
+    on a background thread. GetTotals() can be called for the progress while
+    the computation is running. Symbolic links and junctions are not counted.
+*/
+class wxExplorerBrowserFolderSizer
+{
+public:
+    struct Totals
+    {
+        wxUint64 size {0};        // of the files, in bytes
+        wxUint64 fileCount {0};
+        wxUint64 folderCount {0}; // the roots are not included
+        wxUint64 errorCount {0};  // the folders which could not be enumerated
+    };
+
+    explicit wxExplorerBrowserFolderSizer(unsigned threadCount = 0) : m_walker(threadCount) {}
+    ~wxExplorerBrowserFolderSizer() { Cancel(); Wait(); }
+
+    /** Starts computing the totals of @a folders, returns false if it is already running. */
+    bool Start(const wxArrayString& folders);
+
+    /** Stops the computation, which may be still running when it returns, see Wait(). */
+    void Cancel() { m_cancel = true; }
+    void Wait();
+
+    bool IsRunning() const { return m_running; }
+    bool IsCancelled() const { return m_cancel; }
+
+    /*! The totals so far while running, the final ones when done. */
+    Totals GetTotals() const;
+
+private:
+    // written only by the worker they belong to,
+    // padded so that the workers do not share the cache lines
+    struct Counters
+    {
+        std::atomic<wxUint64> size {0};
+        std::atomic<wxUint64> fileCount {0};
+        std::atomic<wxUint64> folderCount {0};
+        char padding[64];
+    };
+
+    wxExplorerBrowserDirectoryWalker m_walker;
+    wxArrayString m_folders; // used by the background thread
+    wxExplorerBrowserDirectoryWalker::CancelFlag m_cancel {false};
+    std::atomic<bool> m_running {false};
+    std::vector<std::unique_ptr<Counters>> m_counters;
+    std::thread m_thread;
+
+    wxDECLARE_NO_COPY_CLASS(wxExplorerBrowserFolderSizer);
+};
+
+/**
+    Enumerates the items in a directory tree recursively with
+    wxExplorerBrowserDirectoryWalker on a background thread, filtering them
+    with a wxExplorerBrowserMaskMatcher as they are found. The matching items
+    are collected in batches by each worker and can be taken with TakeItems()
+    while the enumeration is running. The batches are taken when full or when
+    their oldest item waits for too long, e.g., because their worker is slowed
+    down by a large or remote directory or has no more directories to walk.
+
+    The items are File or Directory, their display name is the filename
+    and they have no id. Symbolic links and junctions are reported
+    but not followed.
+*/
+class wxExplorerBrowserRecursiveEnumerator
+{
+public:
+    explicit wxExplorerBrowserRecursiveEnumerator(unsigned threadCount = 0) : m_walker(threadCount) {}
+    ~wxExplorerBrowserRecursiveEnumerator() { Cancel(); Wait(); }
+
+    /**
+        Starts enumerating the items of @a itemTypes in the tree of @a root,
+        up to @a maxDepth levels below it, 0 meaning no limit. The items
+        of the types @a filter applies to must match it. The directories are
+        walked regardless of whether they match. Returns false if it is already running.
+
+        The items are made available to TakeItems() in batches of @a batchSize items
+        or, for an incomplete batch, @a maxBatchDelay milliseconds after its first item
+        was found.
+    */
+    bool Start(const wxString& root, wxUint32 itemTypes, const wxExplorerBrowserMaskMatcher& filter,
+               unsigned maxDepth = 0, size_t batchSize = 256, unsigned maxBatchDelay = 50);
+
+    /** Stops the enumeration, which may be still running when it returns, see Wait(). */
+    void Cancel() { m_cancel = true; }
+    void Wait();
+
+    bool IsRunning() const { return m_running; }
+    bool IsCancelled() const { return m_cancel; }
+
+    /**
+        Appends the items found since the previous call to @a items,
+        returns false if there are none.
+    */
+    bool TakeItems(wxExplorerBrowserItem::List& items);
+
+    /*! These can be called while the enumeration is running. */
+    wxUint64 GetFoundCount() const { return m_foundCount; }
+    wxUint64 GetDirectoryCount() const { return m_walker.GetDirectoryCount(); }
+    wxUint64 GetErrorCount() const { return m_walker.GetErrorCount(); }
+
+private:
+    struct WorkerState
+    {
+        // the batch is also taken by TakeItems() when it is too old
+        std::mutex                            lock;
+        wxExplorerBrowserItem::List           batch;
+        std::chrono::steady_clock::time_point batchStart; // when its first item was found
+
+        wxString                              matchName; // used only by the worker
+    };
+
+    wxExplorerBrowserDirectoryWalker m_walker;
+    wxExplorerBrowserDirectoryWalker::CancelFlag m_cancel {false};
+    std::atomic<bool> m_running {false};
+    std::atomic<wxUint64> m_foundCount {0};
+
+    // used by the background thread
+    wxString m_root;
+    wxUint32 m_itemTypes {0};
+    wxExplorerBrowserMaskMatcher m_filter;
+    size_t   m_batchSize {0};
+    std::chrono::milliseconds m_maxBatchDelay {0};
+    std::vector<std::unique_ptr<WorkerState>> m_workerStates;
+
+    std::mutex m_itemsLock;
+    wxExplorerBrowserItem::List m_items; // the complete batches not taken yet
+
+    std::thread m_thread;
+
+    bool Visit(unsigned threadIndex, const wxExplorerBrowserDirectoryWalker::Entry& entry);
+    // must be called with the lock of the state held
+    void FlushBatch(WorkerState& state);
+
+    wxDECLARE_NO_COPY_CLASS(wxExplorerBrowserRecursiveEnumerator);
+};
+
+/**
+    Hierarchical ignore rules in the format of .gitignore files. The rules
+    of the ignore file in a directory apply to its tree and override those
+    of the ignore files in its ancestors, a later rule overrides an earlier one.
+
+    Supported are the "!" negation, the trailing "/" matching only directories,
+    a leading or middle "/" anchoring the pattern to the directory of the file,
+    the "**" segments and the "*", "?" and "[...]" wild-cards. The patterns are
+    matched case-insensitively. As in git, the items in an ignored directory
+    cannot be re-included.
+
+    The rules for the items of a directory are compiled when the directory is
+    first used and cached: the patterns naming the items literally are looked up
+    in a hash map and the others are matched together by a bit-parallel automaton,
+    so deciding about an item takes time proportional to the length of its name.
+    The compiled rules are immutable, a view can get those of its folder once
+    with GetDirectoryRules() and then match its items without reading any file.
+*/
+class wxExplorerBrowserIgnoreRules
+{
+private:
+    struct Token
+    {
+        enum Kind
+        {
+            Kind_Char,
+            Kind_AnyChar, // "?"
+            Kind_Star,    // "*"
+            Kind_Class    // "[...]"
+        };
+
+        Kind   kind {Kind_Char};
+        wxChar ch {0};
+        bool   negated {false};
+        std::vector<std::pair<wxChar, wxChar>> ranges;
+
+        /*! Not for Kind_Star. */
+        bool Matches(wxChar c) const;
+    };
+
+    typedef std::vector<Token> Glob;
+
+public:
+    /** The compiled rules for the items of a directory. */
+    class DirectoryRules
+    {
+    public:
+        /**
+            The memory used for matching a name, reused for the items so that
+            matching does not allocate. Not shared by threads.
+        */
+        struct Buffer
+        {
+            wxString name; // uppercase
+            std::vector<wxUint64> states;
+        };
+
+        /*! Returns true if the directory is ignored, all its items are then. */
+        bool IsExcluded() const { return m_excluded; }
+
+        /** Returns true if the item of the directory named @a name is ignored. */
+        bool IsIgnored(const wxString& name, bool isDirectory, Buffer& buffer) const;
+
+        size_t GetMemoryUsage() const;
+
+    private:
+        friend class wxExplorerBrowserIgnoreRules;
+
+        struct RuleRef
+        {
+            bool negated {false};
+            bool dirOnly {false};
+        };
+
+        // the indices of the last rules naming an item
+        struct LiteralRules
+        {
+            int any {-1};
+            int dirOnly {-1};
+        };
+
+        bool m_excluded {false};
+        std::vector<RuleRef> m_rules; // the later, the higher the priority
+        std::unordered_map<wxString, LiteralRules, wxStringHash, wxStringEqual> m_literals;
+
+        // the automaton, as bit sets of its states: each pattern has a start state
+        // followed by a state per token, the patterns are in the order of their rules
+        size_t m_wordCount {0};
+        std::vector<wxUint64> m_startStates;
+        std::vector<wxUint64> m_starStates;
+        std::vector<wxUint64> m_acceptStates;
+        std::vector<wxUint64> m_anyCharStates;
+        std::vector<wxUint64> m_asciiStates; // the states entered on an ASCII character
+        std::unordered_map<wxChar, std::vector<wxUint64>> m_otherStates; // on the other literal characters
+        std::vector<std::pair<size_t, Token>> m_classStates; // tested for the other characters
+        std::vector<int> m_stateRules; // of the accept states
+
+        void AddPattern(const Glob& glob, int rule, size_t& state);
+        void GetCharStates(wxChar c, wxUint64* states) const;
+        void AddStarClosure(wxUint64* states) const;
+        int FindMatchingRule(const wxString& name, bool isDirectory, std::vector<wxUint64>& buffer) const;
+    };
+
+    typedef std::shared_ptr<const DirectoryRules> DirectoryRulesPtr;
+
+    wxExplorerBrowserIgnoreRules() {}
+
+    /**
+        Uses the ignore files named @a fileName in @a root and its subdirectories,
+        @a globalRules are the lines of an ignore file with a lower priority than
+        that in @a root. A file is read when its directory is first used.
+    */
+    void Set(const wxString& root, const wxString& fileName = wxS(".gitignore"),
+             const wxString& globalRules = wxString());
+    void Clear();
+
+    bool IsEmpty() const { return m_root.empty(); }
+    const wxString& GetRoot() const { return m_root; }
+
+    /**
+        Returns the rules for the items of @a directory, reading the ignore files
+        of it and its ancestors not read yet. Returns null if @a directory is
+        neither the root nor in its tree.
+    */
+    DirectoryRulesPtr GetDirectoryRules(const wxString& directory);
+
+    /**
+        Returns true if the item with @a path is ignored, reading the ignore files
+        of its directory when it is first used.
+    */
+    bool IsIgnored(const wxString& path, bool isDirectory);
+
+    size_t GetMemoryUsage() const;
+
+private:
+    struct Segment
+    {
+        Glob glob;
+        bool isDoubleStar {false}; // "**", any number of directories
+    };
+
+    struct Rule
+    {
+        std::vector<Segment> segments; // relative to the directory of the ignore file
+        bool negated {false};
+        bool dirOnly {false};
+    };
+
+    struct DirectoryNode
+    {
+        std::vector<Rule> rules; // of the ignore file in the directory
+        DirectoryRulesPtr compiled;
+    };
+
+    // the directories are discarded all at once when there are more
+    static const size_t MaxCachedDirectories = 1024;
+
+    wxString m_root;
+    wxString m_fileName;
+    std::vector<Rule> m_globalRules;
+    // by the uppercase path relative to the root, with "/" separators
+    std::unordered_map<wxString, std::unique_ptr<DirectoryNode>, wxStringHash, wxStringEqual> m_nodes;
+
+    // the directory of the last IsIgnored() call
+    wxString m_lastDirectory;
+    DirectoryRulesPtr m_lastRules;
+    wxString m_nameBuffer;
+    DirectoryRules::Buffer m_matchBuffer;
+
+    bool GetRelativeSegments(const wxString& directory, std::vector<wxString>& segments) const;
+    DirectoryNode& GetNode(const std::vector<wxString>& segments, size_t depth);
+    DirectoryRulesPtr GetDirectoryRules(const std::vector<wxString>& segments, size_t depth);
+    DirectoryRulesPtr Compile(const std::vector<wxString>& segments, size_t depth, bool excluded);
+
+    static void ParseRules(const wxString& contents, std::vector<Rule>& rules);
+    static void ParseGlob(const wxString& text, Glob& glob);
+    static bool MatchGlob(const Glob& glob, const wxString& name);
+    static bool IsLiteralGlob(const Glob& glob);
+
+    wxDECLARE_NO_COPY_CLASS(wxExplorerBrowserIgnoreRules);
+};
+
+/**
+    Finds the names matching a fuzzy pattern: the characters of the pattern must
+    appear in the name in the same order, case-insensitively, such as "prjrpt23"
+    in "Project_Report_2023.xlsx". The matches at the starts of words, camel-case
+    humps and digits, and in runs score higher, the gaps between them lower.
+
+    The names are folded once into contiguous buffers and then searched with any
+    number of patterns. A name is rejected by the set of its characters first,
+    then tested by a bit-parallel subsequence automaton, and only the shortest
+    window of a match is scored.
+
+    @see wxExplorerBrowser::QuickFind()
+*/
+class wxExplorerBrowserFuzzyMatcher
+{
+public:
+    struct Match
+    {
+        size_t index; // of the name
+        int    score;
+    };
+
+    typedef std::vector<Match> Matches;
+
+    /*! Only this many leading characters of a pattern are used. */
+    static const size_t MaxPatternLength = 64;
+
+    wxExplorerBrowserFuzzyMatcher() { Clear(); }
+
+    void Clear();
+    void Reserve(size_t nameCount, size_t totalLength);
+    void AddName(const wxString& name);
+
+    /** Replaces the names with the display names of @a items. */
+    void SetItems(const wxExplorerBrowserItem::List& items);
+
+    size_t GetCount() const { return m_starts.size() - 1; }
+
+    /**
+        Fills @a matches with up to @a maxResults names matching @a pattern, best first,
+        the names with the same score ordered by their length and then by their index.
+        Returns the number of matches, an empty pattern matches nothing.
+    */
+    size_t Find(const wxString& pattern, size_t maxResults, Matches& matches) const;
+
+    /** Returns the score of @a name, or -1 if it does not match @a pattern. */
+    static int Score(const wxString& pattern, const wxString& name);
+
+    size_t GetMemoryUsage() const;
+
+private:
+    struct Pattern;
+
+    std::vector<wxChar>   m_chars;    // the folded names one after another
+    std::vector<wxUint8>  m_bonuses;  // of their characters
+    std::vector<size_t>   m_starts;   // of the names in m_chars, followed by the end
+    std::vector<wxUint64> m_charSets; // of the names, bit (c % 64) is set for character c
+
+    int ScoreName(const Pattern& pattern, size_t index) const;
+
+    static bool PreparePattern(const wxString& text, Pattern& pattern);
+};
+
+/**
+    An in-memory trigram index of names, for case-insensitive substring search.
+
+    Each trigram of the uppercase names has a posting list of the ids of the names
+    containing it, sorted by the id. A query intersects the posting lists of its
+    trigrams, starting with the shortest one, and verifies the names left;
+    the queries shorter than a trigram scan the names.
+
+    The names are added and removed one at a time. A removed name leaves its id
+    in the posting lists until the removed names outnumber the others, then the
+    lists are rebuilt and the ids renumbered.
+
+    @see wxExplorerBrowser::SearchIndex()
+*/
+class wxExplorerBrowserTrigramIndex
+{
+public:
+    typedef wxUint32 Id;
+    typedef std::vector<Id> IdList;
+
+    wxExplorerBrowserTrigramIndex() {}
+
+    void Clear();
+    void Reserve(size_t count);
+
+    /** Returns false if a name equal to @a name case-insensitively is already there. */
+    bool Add(const wxString& name);
+
+    /** Returns false if there is no name equal to @a name case-insensitively. */
+    bool Remove(const wxString& name);
+
+    bool Contains(const wxString& name) const { return m_ids.find(name.Upper()) != m_ids.end(); }
+
+    /** Replaces the names with those of @a items, see wxExplorerBrowserMaskMatcher::GetItemName(). */
+    void SetItems(const wxExplorerBrowserItem::List& items);
+
+    size_t GetCount() const { return m_ids.size(); }
+
+    /**
+        Fills @a ids with the ids of the names containing @a str case-insensitively,
+        in increasing order. An empty @a str matches nothing.
+        The ids are valid until a name is added or removed.
+    */
+    void Find(const wxString& str, IdList& ids) const;
+
+    const wxString& GetName(Id id) const { return m_names[id]; }
+    const wxString& GetUpperName(Id id) const { return m_upperNames[id]; }
+
+    size_t GetMemoryUsage() const;
+
+private:
+    typedef wxUint64 Trigram;
+
+    // the removed names are empty
+    std::vector<wxString> m_names;
+    std::vector<wxString> m_upperNames;
+    size_t m_removedCount {0};
+
+    std::unordered_map<wxString, Id, wxStringHash, wxStringEqual> m_ids; // by the uppercase name
+    std::unordered_map<Trigram, IdList> m_postings;
+
+    void AddPostings(Id id);
+    void Compact();
+
+    static Trigram MakeTrigram(const wxStringCharType* s);
+};
+
+#endif //ifndef WX_EXPLORER_BROWSER_CORE_H_DEFINED